@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/anim/allocs.cpp" "CMakeFiles/nidx_bench.dir/src/anim/allocs.cpp.o" "gcc" "CMakeFiles/nidx_bench.dir/src/anim/allocs.cpp.o.d"
+  "/root/repo/src/anim/render/soft.cpp" "CMakeFiles/nidx_bench.dir/src/anim/render/soft.cpp.o" "gcc" "CMakeFiles/nidx_bench.dir/src/anim/render/soft.cpp.o.d"
+  "/root/repo/src/bench/bench.cpp" "CMakeFiles/nidx_bench.dir/src/bench/bench.cpp.o" "gcc" "CMakeFiles/nidx_bench.dir/src/bench/bench.cpp.o.d"
+  "/root/repo/src/bench/bench_main.cpp" "CMakeFiles/nidx_bench.dir/src/bench/bench_main.cpp.o" "gcc" "CMakeFiles/nidx_bench.dir/src/bench/bench_main.cpp.o.d"
+  "/root/repo/src/bench/bench_suite.cpp" "CMakeFiles/nidx_bench.dir/src/bench/bench_suite.cpp.o" "gcc" "CMakeFiles/nidx_bench.dir/src/bench/bench_suite.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
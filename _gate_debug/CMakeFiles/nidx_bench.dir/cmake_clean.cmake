@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/nidx_bench.dir/src/anim/allocs.cpp.o"
+  "CMakeFiles/nidx_bench.dir/src/anim/allocs.cpp.o.d"
+  "CMakeFiles/nidx_bench.dir/src/anim/render/soft.cpp.o"
+  "CMakeFiles/nidx_bench.dir/src/anim/render/soft.cpp.o.d"
+  "CMakeFiles/nidx_bench.dir/src/bench/bench.cpp.o"
+  "CMakeFiles/nidx_bench.dir/src/bench/bench.cpp.o.d"
+  "CMakeFiles/nidx_bench.dir/src/bench/bench_main.cpp.o"
+  "CMakeFiles/nidx_bench.dir/src/bench/bench_main.cpp.o.d"
+  "CMakeFiles/nidx_bench.dir/src/bench/bench_suite.cpp.o"
+  "CMakeFiles/nidx_bench.dir/src/bench/bench_suite.cpp.o.d"
+  "nidx_bench"
+  "nidx_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/nidx_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
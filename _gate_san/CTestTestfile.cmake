@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_gate_san
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(bench_checks "/root/repo/_gate_san/nidx_bench" "-quick" "-golden" "/root/repo/src/bench/golden" "-out" "/root/repo/_gate_san/bench_quick.json")
+set_tests_properties(bench_checks PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;43;add_test;/root/repo/CMakeLists.txt;0;")
@@ -0,0 +1,220 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : allocs.cpp
+  * PURPOSE     : T51DX12 project.
+  *               General heap allocations counter module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Platform independent, shared by game and benchmark
+  *               suite builds. Global 'operator new' is replaced only
+  *               in NIDX_COUNT_ALLOCS builds (benchmark target, debug
+  *               game configurations), shipping builds keep the CRT one.
+  *               Full set is replaced (plain, array, sized, nothrow and
+  *               C++17 aligned forms): library code such as temporary
+  *               buffer of 'std::stable_sort' uses nothrow form.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#include "allocs.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+std::atomic<UINT64> nidx::allocs::Counter(0);
+
+#ifdef NIDX_COUNT_ALLOCS
+/* Counting global allocation function.
+ * ARGUMENTS:
+ *   - size in bytes:
+ *       size_t Size;
+ * RETURNS:
+ *   (VOID *) allocated memory.
+ */
+VOID * operator new( size_t Size )
+{
+  VOID *P;
+
+  nidx::allocs::Counter.fetch_add(1, std::memory_order_relaxed);
+  if ((P = malloc(Size == 0 ? 1 : Size)) == nullptr)
+    throw std::bad_alloc();
+  return P;
+} /* End of 'operator new' function */
+
+/* Counting global array allocation function.
+ * ARGUMENTS:
+ *   - size in bytes:
+ *       size_t Size;
+ * RETURNS:
+ *   (VOID *) allocated memory.
+ */
+VOID * operator new[]( size_t Size )
+{
+  return operator new(Size);
+} /* End of 'operator new[]' function */
+
+/* Counting global allocation without exceptions function.
+ * ARGUMENTS:
+ *   - size in bytes:
+ *       size_t Size;
+ *   - no exceptions tag (not used):
+ *       const std::nothrow_t &;
+ * RETURNS:
+ *   (VOID *) allocated memory, nullptr on failure.
+ */
+VOID * operator new( size_t Size, const std::nothrow_t & ) noexcept
+{
+  nidx::allocs::Counter.fetch_add(1, std::memory_order_relaxed);
+  return malloc(Size == 0 ? 1 : Size);
+} /* End of 'operator new' function */
+
+/* Counting global array allocation without exceptions function.
+ * ARGUMENTS:
+ *   - size in bytes:
+ *       size_t Size;
+ *   - no exceptions tag:
+ *       const std::nothrow_t &Tag;
+ * RETURNS:
+ *   (VOID *) allocated memory, nullptr on failure.
+ */
+VOID * operator new[]( size_t Size, const std::nothrow_t &Tag ) noexcept
+{
+  return operator new(Size, Tag);
+} /* End of 'operator new[]' function */
+
+/* Global free functions */
+VOID operator delete( VOID *P ) noexcept
+{
+  free(P);
+} /* End of 'operator delete' function */
+
+VOID operator delete[]( VOID *P ) noexcept
+{
+  free(P);
+} /* End of 'operator delete[]' function */
+
+/* Sized global free functions (size is not needed by 'free') */
+VOID operator delete( VOID *P, size_t ) noexcept
+{
+  free(P);
+} /* End of 'operator delete' function */
+
+VOID operator delete[]( VOID *P, size_t ) noexcept
+{
+  free(P);
+} /* End of 'operator delete[]' function */
+
+/* Global free functions of allocations without exceptions */
+VOID operator delete( VOID *P, const std::nothrow_t & ) noexcept
+{
+  free(P);
+} /* End of 'operator delete' function */
+
+VOID operator delete[]( VOID *P, const std::nothrow_t & ) noexcept
+{
+  free(P);
+} /* End of 'operator delete[]' function */
+
+#ifdef __cpp_aligned_new
+/* Counting global over-aligned allocation function (C++17).
+ * ARGUMENTS:
+ *   - size in bytes:
+ *       size_t Size;
+ *   - alignment (power of 2):
+ *       std::align_val_t Align;
+ * RETURNS:
+ *   (VOID *) allocated memory, nullptr on failure.
+ */
+static VOID * AlignedAlloc( size_t Size, std::align_val_t Align ) noexcept
+{
+  size_t A = std::max((size_t)Align, sizeof(VOID *));
+
+  nidx::allocs::Counter.fetch_add(1, std::memory_order_relaxed);
+#  ifdef _WIN32
+  return _aligned_malloc(Size == 0 ? 1 : Size, A);
+#  else /* _WIN32 */
+  VOID *P;
+
+  return posix_memalign(&P, A, Size == 0 ? 1 : Size) == 0 ? P : nullptr;
+#  endif /* _WIN32 */
+} /* End of 'AlignedAlloc' function */
+
+/* Global over-aligned free function (C++17).
+ * ARGUMENTS:
+ *   - memory to free:
+ *       VOID *P;
+ * RETURNS: None.
+ */
+static VOID AlignedFree( VOID *P ) noexcept
+{
+#  ifdef _WIN32
+  _aligned_free(P);
+#  else /* _WIN32 */
+  free(P);
+#  endif /* _WIN32 */
+} /* End of 'AlignedFree' function */
+
+/* Over-aligned global allocation functions */
+VOID * operator new( size_t Size, std::align_val_t Align )
+{
+  VOID *P = AlignedAlloc(Size, Align);
+
+  if (P == nullptr)
+    throw std::bad_alloc();
+  return P;
+} /* End of 'operator new' function */
+
+VOID * operator new[]( size_t Size, std::align_val_t Align )
+{
+  return operator new(Size, Align);
+} /* End of 'operator new[]' function */
+
+VOID * operator new( size_t Size, std::align_val_t Align, const std::nothrow_t & ) noexcept
+{
+  return AlignedAlloc(Size, Align);
+} /* End of 'operator new' function */
+
+VOID * operator new[]( size_t Size, std::align_val_t Align, const std::nothrow_t & ) noexcept
+{
+  return AlignedAlloc(Size, Align);
+} /* End of 'operator new[]' function */
+
+/* Over-aligned global free functions */
+VOID operator delete( VOID *P, std::align_val_t ) noexcept
+{
+  AlignedFree(P);
+} /* End of 'operator delete' function */
+
+VOID operator delete[]( VOID *P, std::align_val_t ) noexcept
+{
+  AlignedFree(P);
+} /* End of 'operator delete[]' function */
+
+VOID operator delete( VOID *P, size_t, std::align_val_t ) noexcept
+{
+  AlignedFree(P);
+} /* End of 'operator delete' function */
+
+VOID operator delete[]( VOID *P, size_t, std::align_val_t ) noexcept
+{
+  AlignedFree(P);
+} /* End of 'operator delete[]' function */
+
+VOID operator delete( VOID *P, std::align_val_t, const std::nothrow_t & ) noexcept
+{
+  AlignedFree(P);
+} /* End of 'operator delete' function */
+
+VOID operator delete[]( VOID *P, std::align_val_t, const std::nothrow_t & ) noexcept
+{
+  AlignedFree(P);
+} /* End of 'operator delete[]' function */
+#endif /* __cpp_aligned_new */
+#endif /* NIDX_COUNT_ALLOCS */
+
+/* END OF 'allocs.cpp' FILE */
@@ -0,0 +1,48 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : allocs.h
+  * PURPOSE     : T51DX12 project.
+  *               General heap allocations counter declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Platform independent. Counter is increased by the
+  *               replaced global 'operator new' of NIDX_COUNT_ALLOCS
+  *               builds and stays zero otherwise.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _allocs_h_
+#define _allocs_h_
+
+#include "../def.h"
+
+#include <atomic>
+
+namespace nidx
+{
+  /* General heap allocations counter class */
+  class allocs
+  {
+  public:
+    /* Number of global 'operator new' calls (see 'allocs.cpp') */
+    static std::atomic<UINT64> Counter;
+
+    /* Obtain number of allocations function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (UINT64) number of allocations since program start.
+     */
+    static UINT64 Get( VOID )
+    {
+      return Counter.load(std::memory_order_relaxed);
+    } /* End of 'Get' function */
+  }; /* end of 'allocs' class */
+} /* end of 'nidx' spacename */
+#endif // !_allocs_h_
+
+/* END OF 'allocs.h' FILE */
@@ -7,8 +7,12 @@
   * PURPOSE     : T51DX12 project.
   *               Animation system declaration module.
   * PROGRAMMER  : ND4.
-  * LAST UPDATE : 02.10.2021
-  * NOTE        : None.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Window messages (input, simulation steps, frame packet
+  *               writing) run on message thread, device work (swap chain
+  *               wait, render, present, frame fence) runs on render thread.
+  *               Render thread reports presents back through atomics,
+  *               pacer state is touched by message thread only.
   *
   * No part of this file may be changed without agreement of
   * Computer Graphics Support Group of 30 Phys-Math Lyceum
@@ -21,18 +25,28 @@
 #include "../win/win.h"
 #include "timer.h"
 #include "input.h"
+#include "stepper.h"
+#include "pacer.h"
+#include "replay.h"
+#include "arena.h"
+#include "allocs.h"
 #include "render/render.h"
 
+#include <atomic>
+#include <fstream>
 #include <iostream>
 
 /* DirectX namespace */
 namespace nidx
 {
   /* Animation class */
-  class anim : public win, public timer, public input, public render
+  class anim : public win, public timer, public input, public render, public stepper, public pacer
   {
   private:
-    anim(HINSTANCE hInst = GetModuleHandle(nullptr)) : win(hInst), input(MouseWheel), render(win::hWnd)
+    anim(HINSTANCE hInst = GetModuleHandle(nullptr)) : win(hInst), input(Events), render(win::hWnd),
+      AllocsOld(0), Packets(2), RenderThread(Packets), NumOfFrames(0), NumOfPresented(0),
+      PresentTime(0), PresentLatency(0), PresentedOld(0),
+      CamView(matr::View(vec3(0, 0, 10), vec3(0, 0, 0), vec3(0, 1, 0))), FrameAllocs(0)
     {
     }
 
@@ -41,8 +55,46 @@ namespace nidx
     }
 
     static anim Instance;
+
+    std::ofstream Profile; /* Replay frame time profile */
+    UINT64 AllocsOld;      /* Heap allocations counter at frame start */
+    packet_ring Packets;   /* Frames written by message thread */
+    render_thread RenderThread; /* Frames consumer */
+    UINT64 NumOfFrames;    /* Number of written frames */
+    std::atomic<UINT64> NumOfPresented; /* Number of frames presented by render thread */
+    std::atomic<DBL>
+      PresentTime,         /* Last present time */
+      PresentLatency;      /* Last presented frame input to present time */
+    UINT64 PresentedOld;   /* Number of presents passed to pacer */
+    matr CamView;          /* Camera view matrix (set by simulation) */
+    std::vector<render_proxy> SceneProxies; /* Render proxies of simulated objects */
+
+    /* Render and present frame function (called on render thread).
+     * ARGUMENTS:
+     *   - frame to render:
+     *       const frame_packet &Packet;
+     * RETURNS: None.
+     */
+    VOID RenderFrame( const frame_packet &Packet )
+    {
+      DBL t;
+
+      arena::Frame().Reset();
+      WaitFrame(100);
+      render::Render(Packet);
+      Present(Packet.IsVSync);
+      EndFrame();
+
+      /* Same clock as pacer input sampling */
+      t = pacer::SystemClock();
+      PresentTime.store(t, std::memory_order_relaxed);
+      PresentLatency.store(t - Packet.InputTime, std::memory_order_relaxed);
+      NumOfPresented.fetch_add(1, std::memory_order_release);
+    } /* End of 'RenderFrame' function */
   public:
     static std::string Path;
+    replay Session;        /* Input record and replay session */
+    UINT64 FrameAllocs;    /* General heap allocations during last frame */
 
     static anim& Get(VOID)
     {
@@ -54,24 +106,171 @@ namespace nidx
       return &Instance;
     }
 
-    /* Render stock of unit function.
+    /* Render stock of unit function (simulates frame and passes it to render thread).
      * ARGUMENTS: None.
      * RETURNS: None.
      */
     VOID Render( VOID )
     {
+      BOOL IsPlay = Session.GetMode() == replay::mode::PLAY;
+      DBL StartTime = input_event::Now();
+      UINT64 Presents = NumOfPresented.load(std::memory_order_acquire);
+      frame_packet *P;
+
+      /* Transient data of previous frame is no longer referenced */
+      arena::Frame().Reset();
+      AllocsOld = allocs::Get();
+
+      /* Presents since last frame plan the next one, several collapse into last */
+      if (Presents != PresentedOld)
+      {
+        PresentedOld = Presents;
+        Presented(PresentTime.load(std::memory_order_relaxed), PresentLatency.load(std::memory_order_relaxed));
+      }
+      /* Sample as late as the pacer allows (render thread waits for swap chain) */
+      if (!IsPlay)
+        Pace();
+
+      InputSampled();
       TimerResponse();
-      KeyboardResponse();
-      MouseResponse(win::hWnd);
+      if (IsPlay)
+      {
+        DBL Dt;
 
+        /* Recorded events replace live ones, recorded interval - the real one */
+        if (!Session.PlayFrame(Dt, Events, *this))
+        {
+          Profile.close();
+          PostMessage(win::hWnd, WM_CLOSE, 0, 0);
+          return;
+        }
+        DeltaTime = GlobalDeltaTime = Dt;
+        Time = GlobalTime = Session.GetTime();
+      }
+      else
+      {
+        InputResponse();
+        JoystickResponse();
+        Session.WriteFrame(DeltaTime, *this);
+      }
+
+      /* Simulation rate does not depend on which message called us */
+      Advance(DeltaTime, [this]( DBL Dt ){ Update(Dt); });
+
+      /* Waits only while all packets are in flight */
+      P = Packets.BeginWrite();
+      P->Frame = NumOfFrames++;
+      P->Time = Time;
+      P->Alpha = Alpha;
+      P->InputTime = GetInputTime();
+      P->IsVSync = !IsPlay;
+      P->View = CamView;
+      P->Proj = GetProj();
+      /* Packet keeps its storage, steady scenes do not allocate */
+      P->Proxies.assign(SceneProxies.begin(), SceneProxies.end());
+      Packets.EndWrite();
+
+      if (IsPlay && Profile.is_open())
+        Profile << Session.FrameCounter << "," << (input_event::Now() - StartTime) * 1000 << "\n";
+      FrameAllocs = allocs::Get() - AllocsOld;
     } /* End of 'Render' function */
 
+    /* Set camera function (called by simulation on message thread).
+     * ARGUMENTS:
+     *   - camera location, point of interest and up direction:
+     *       const vec3 &Loc, &At, &Up;
+     * RETURNS: None.
+     */
+    VOID SetCamera( const vec3 &Loc, const vec3 &At, const vec3 &Up )
+    {
+      CamView = matr::View(Loc, At, Up);
+    } /* End of 'SetCamera' function */
+
+    /* Obtain projection matrix of current window size function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (matr) projection matrix.
+     */
+    matr GetProj( VOID ) const
+    {
+      FLT
+        Size = 0.1f, Near = 0.1f, Far = 1000,
+        rx = Size / 2, ry = Size / 2;
+
+      /* Keep square pixels, smaller window side gets projection size */
+      if (win::W > 0 && win::H > 0)
+      {
+        if (win::W > win::H)
+          rx *= (FLT)win::W / win::H;
+        else
+          ry *= (FLT)win::H / win::W;
+      }
+      return matr::Frustum(-rx, rx, -ry, ry, Near, Far);
+    } /* End of 'GetProj' function */
+
+    /* Obtain scene render proxies function (simulation writes visible objects here every step).
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (std::vector<render_proxy> &) proxies copied into every frame packet.
+     */
+    std::vector<render_proxy> & GetSceneProxies( VOID )
+    {
+      return SceneProxies;
+    } /* End of 'GetSceneProxies' function */
+
+    /* Start input recording function.
+     * ARGUMENTS:
+     *   - log file name:
+     *       const std::string &LogName;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    BOOL StartRecord( const std::string &LogName )
+    {
+      return Session.StartRecord(LogName);
+    } /* End of 'StartRecord' function */
+
+    /* Start replay run function.
+     * ARGUMENTS:
+     *   - log file name:
+     *       const std::string &LogName;
+     *   - frame time profile file name (CSV, may be empty):
+     *       const std::string &ProfileName;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    BOOL StartReplay( const std::string &LogName, const std::string &ProfileName )
+    {
+      if (!Session.StartPlay(LogName))
+        return FALSE;
+      /* Frames run back to back, simulation gets recorded intervals */
+      TargetFPS = 0;
+      stepper::Reset();
+      if (!ProfileName.empty())
+      {
+        Profile.open(ProfileName);
+        Profile << "frame,ms\n";
+      }
+      return TRUE;
+    } /* End of 'StartReplay' function */
+
+    /* Fixed step simulation update function.
+     * ARGUMENTS:
+     *   - fixed simulation interval in seconds:
+     *       DBL Dt;
+     * RETURNS: None.
+     */
+    VOID Update( DBL Dt )
+    {
+    } /* End of 'Update' function */
+
     /* Initialization function.
      * ARGUMENTS: None.
      * RETURNS: None.
      */
     VOID Init( VOID ) override
     {
+      RenderThread.Start([this]( const frame_packet &Packet ){ RenderFrame(Packet); });
     } /* End of 'Init' function */
     
     /* Close function.
@@ -80,6 +279,8 @@ namespace nidx
      */
     VOID Close(VOID) override
     {
+      /* Written frames are rendered before device goes away */
+      RenderThread.Stop();
     } /* End of 'Close' function */
     
     /* Resize function.
@@ -100,9 +301,9 @@ namespace nidx
     {
       this->Render();
       
-      CHAR Buf[30];
+      CHAR Buf[64];
     
-      sprintf_s(Buf, 30, "FPS: %f", FPS);
+      sprintf_s(Buf, 64, "FPS: %f, allocs/frame: %llu", FPS, FrameAllocs);
       SetWindowTextA(win::hWnd, Buf);
       
     } /* End of 'Timer' function */
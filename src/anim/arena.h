@@ -0,0 +1,245 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : arena.h
+  * PURPOSE     : T51DX12 project.
+  *               Per-frame linear memory arena declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Memory lives until the owning thread calls 'Reset'
+  *               at its frame boundary. Overflow blocks are freed on
+  *               reset and the main block grows to the peak usage, so
+  *               a steady-state frame does no heap allocations.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _arena_h_
+#define _arena_h_
+
+#include "../def.h"
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace nidx
+{
+  /* Linear (bump) memory arena class */
+  class arena
+  {
+  private:
+    /* Overflow block header */
+    struct block
+    {
+      block *Next;      /* Next overflow block */
+    }; /* End of 'block' structure */
+
+    BYTE *Base;         /* Main block */
+    size_t
+      Size,             /* Main block size */
+      Offset,           /* Used bytes of main block */
+      Used;             /* Used bytes including overflow and alignment padding */
+    block *Overflow;    /* Overflow blocks list */
+
+    /* Align offset function.
+     * ARGUMENTS:
+     *   - offset or address:
+     *       size_t Val;
+     *   - alignment (power of 2):
+     *       size_t Align;
+     * RETURNS:
+     *   (size_t) aligned value.
+     */
+    static size_t AlignUp( size_t Val, size_t Align )
+    {
+      return (Val + Align - 1) & ~(Align - 1);
+    } /* End of 'AlignUp' function */
+
+  public:
+    size_t Peak;              /* Peak usage in bytes since creation */
+    UINT64
+      AllocCounter,           /* Number of allocations since last reset */
+      OverflowCounter;        /* Number of overflow blocks since creation */
+
+    /* Arena initializing function.
+     * ARGUMENTS:
+     *   - main block size in bytes:
+     *       size_t BlockSize;
+     */
+    arena( size_t BlockSize = 1 << 20 ) :
+      Base((BYTE *)::operator new(BlockSize)), Size(BlockSize), Offset(0), Used(0),
+      Overflow(nullptr), Peak(0), AllocCounter(0), OverflowCounter(0)
+    {
+    } /* End of 'arena' function */
+
+    /* Arena deinitializing function.
+     * ARGUMENTS: None.
+     */
+    ~arena( VOID )
+    {
+      Reset();
+      ::operator delete(Base);
+    } /* End of '~arena' function */
+
+    /* No copying */
+    arena( const arena & ) = delete;
+    arena & operator=( const arena & ) = delete;
+
+    /* Allocate memory function.
+     * ARGUMENTS:
+     *   - size in bytes:
+     *       size_t Bytes;
+     *   - alignment (power of 2):
+     *       size_t Align;
+     * RETURNS:
+     *   (VOID *) allocated memory, valid until 'Reset'.
+     */
+    VOID * Alloc( size_t Bytes, size_t Align = alignof(std::max_align_t) )
+    {
+      /* Block start is only 'max_align_t' aligned, so align the address */
+      size_t Start = AlignUp((size_t)Base + Offset, Align) - (size_t)Base;
+      block *B;
+
+      AllocCounter++;
+      if (Start + Bytes <= Size)
+      {
+        Used += Start - Offset + Bytes;
+        if (Used > Peak)
+          Peak = Used;
+        Offset = Start + Bytes;
+        return Base + Start;
+      }
+      /* Worst case padding, so the grown main block fits this frame again */
+      Used += Bytes + Align - 1;
+      if (Used > Peak)
+        Peak = Used;
+      /* Fallback to heap until next reset */
+      B = (block *)::operator new(AlignUp(sizeof(block), Align) + Bytes + Align);
+      B->Next = Overflow;
+      Overflow = B;
+      OverflowCounter++;
+      return (BYTE *)AlignUp((size_t)(B + 1), Align);
+    } /* End of 'Alloc' function */
+
+    /* Allocate typed array function.
+     * ARGUMENTS:
+     *   - number of elements:
+     *       size_t Count;
+     * RETURNS:
+     *   (Type *) uninitialized array, valid until 'Reset'.
+     */
+    template<typename Type>
+      Type * Alloc( size_t Count )
+      {
+        return (Type *)Alloc(sizeof(Type) * Count, alignof(Type));
+      } /* End of 'Alloc' function */
+
+    /* Free all arena memory function (end of frame).
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Reset( VOID )
+    {
+      BOOL IsOverflow = Overflow != nullptr;
+
+      while (Overflow != nullptr)
+      {
+        block *B = Overflow;
+
+        Overflow = B->Next;
+        ::operator delete(B);
+      }
+      /* Grow once so the next frames fit into the main block */
+      if (IsOverflow && Peak > Size)
+      {
+        ::operator delete(Base);
+        Size = AlignUp(Peak + Peak / 4, 4096);
+        Base = (BYTE *)::operator new(Size);
+      }
+      Offset = 0;
+      Used = 0;
+      AllocCounter = 0;
+    } /* End of 'Reset' function */
+
+    /* Obtain calling thread frame arena function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (arena &) thread frame arena.
+     */
+    static arena & Frame( VOID )
+    {
+      thread_local arena A;
+
+      return A;
+    } /* End of 'Frame' function */
+  }; /* end of 'arena' class */
+
+  /* STL allocator over arena class */
+  template<typename Type>
+    class arena_allocator
+    {
+    public:
+      typedef Type value_type;
+      arena *Arena;   /* Memory source */
+
+      /* Allocator initializing function.
+       * ARGUMENTS:
+       *   - memory source (default - calling thread frame arena):
+       *       arena &A;
+       */
+      arena_allocator( arena &A = arena::Frame() ) : Arena(&A)
+      {
+      } /* End of 'arena_allocator' function */
+
+      /* Rebinding constructor */
+      template<typename Other>
+        arena_allocator( const arena_allocator<Other> &A ) : Arena(A.Arena)
+        {
+        } /* End of 'arena_allocator' function */
+
+      /* Allocate elements function.
+       * ARGUMENTS:
+       *   - number of elements:
+       *       size_t Count;
+       * RETURNS:
+       *   (Type *) memory.
+       */
+      Type * allocate( size_t Count )
+      {
+        return Arena->template Alloc<Type>(Count);
+      } /* End of 'allocate' function */
+
+      /* Free elements function (memory is reclaimed by arena reset).
+       * ARGUMENTS:
+       *   - memory and number of elements:
+       *       Type *P;
+       *       size_t Count;
+       * RETURNS: None.
+       */
+      VOID deallocate( Type *, size_t )
+      {
+      } /* End of 'deallocate' function */
+
+      template<typename Other>
+        BOOL operator==( const arena_allocator<Other> &A ) const
+        {
+          return Arena == A.Arena;
+        }
+      template<typename Other>
+        BOOL operator!=( const arena_allocator<Other> &A ) const
+        {
+          return Arena != A.Arena;
+        }
+    }; /* end of 'arena_allocator' class */
+
+  /* Frame lifetime vector */
+  template<typename Type>
+    using frame_vector = std::vector<Type, arena_allocator<Type>>;
+} /* end of 'nidx' spacename */
+#endif // !_arena_h_
+
+/* END OF 'arena.h' FILE */
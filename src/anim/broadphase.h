@@ -0,0 +1,572 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : broadphase.h
+  * PURPOSE     : T51DX12 project.
+  *               Collision broadphase declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Both broadphases find all pairs of overlapping AABBs
+  *               (touching boxes overlap), every pair once with A < B.
+  *               Sweep and prune keeps boxes sorted along axis of
+  *               largest spread between queries, so nearly static worlds
+  *               are resorted by insertion sort in O(N). Pairs of last
+  *               query are kept: when few boxes moved, only moved boxes
+  *               are checked (against sorted range found by binary search),
+  *               pairs of boxes both not moved are taken from last query.
+  *               Loose spatial hash puts every box into one cell by its
+  *               center and checks 27 neighbour cells; boxes larger than
+  *               cell are checked against all boxes. Hash is rebuilt by
+  *               counting sort on every query (no per-cell lists to keep).
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _broadphase_h_
+#define _broadphase_h_
+
+#include "../def.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define NIDX_BROADPHASE_SSE2
+#endif /* __SSE2__ */
+
+namespace nidx
+{
+  /* Overlapping boxes pair structure */
+  struct broadphase_pair
+  {
+    INT A, B; /* Box identifiers, A < B */
+  }; /* End of 'broadphase_pair' structure */
+
+  /* Broadphase base class */
+  class broadphase
+  {
+  protected:
+    /* Stored box structure (32 bytes, loaded by 4 floats) */
+    struct box
+    {
+      FLT Min[3];
+      INT Id;     /* Box identifier, -1 if removed */
+      FLT Max[3];
+      INT Pad;
+    }; /* End of 'box' structure */
+
+    std::vector<box> Boxes;   /* Boxes by identifier */
+    std::vector<INT>
+      Free,                   /* Removed identifiers */
+      Moved;                  /* Boxes changed since last query */
+    std::vector<BYTE> IsMoved; /* Box changed since last query flags */
+    INT NumOfBoxes;           /* Number of alive boxes */
+
+    /* Mark box as changed function.
+     * ARGUMENTS:
+     *   - box identifier:
+     *       INT Id;
+     * RETURNS: None.
+     */
+    VOID Touch( INT Id )
+    {
+      if (IsMoved.size() <= (size_t)Id)
+        IsMoved.resize(Boxes.size(), 0);
+      if (!IsMoved[Id])
+      {
+        IsMoved[Id] = 1;
+        Moved.push_back(Id);
+      }
+    } /* End of 'Touch' function */
+
+    /* Clear changed boxes function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID ClearMoved( VOID )
+    {
+      for (INT Id : Moved)
+        IsMoved[Id] = 0;
+      Moved.clear();
+    } /* End of 'ClearMoved' function */
+
+    /* Check boxes overlap function.
+     * ARGUMENTS:
+     *   - boxes:
+     *       const box &A, &B;
+     * RETURNS:
+     *   (BOOL) TRUE if boxes overlap.
+     */
+    static BOOL IsOverlap( const box &A, const box &B )
+    {
+#ifdef NIDX_BROADPHASE_SSE2
+      __m128 m = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(A.Min), _mm_loadu_ps(B.Max)),
+                            _mm_cmple_ps(_mm_loadu_ps(B.Min), _mm_loadu_ps(A.Max)));
+
+      return (_mm_movemask_ps(m) & 7) == 7;
+#else /* NIDX_BROADPHASE_SSE2 */
+      return A.Min[0] <= B.Max[0] && B.Min[0] <= A.Max[0] &&
+             A.Min[1] <= B.Max[1] && B.Min[1] <= A.Max[1] &&
+             A.Min[2] <= B.Max[2] && B.Min[2] <= A.Max[2];
+#endif /* NIDX_BROADPHASE_SSE2 */
+    } /* End of 'IsOverlap' function */
+
+    /* Add pair of identifiers function.
+     * ARGUMENTS:
+     *   - pairs to add to:
+     *       std::vector<broadphase_pair> &Pairs;
+     *   - identifiers:
+     *       INT A, B;
+     * RETURNS: None.
+     */
+    static VOID AddPair( std::vector<broadphase_pair> &Pairs, INT A, INT B )
+    {
+      Pairs.push_back(A < B ? broadphase_pair {A, B} : broadphase_pair {B, A});
+    } /* End of 'AddPair' function */
+
+  public:
+    /* Broadphase initializing function.
+     * ARGUMENTS: None.
+     */
+    broadphase( VOID ) : NumOfBoxes(0)
+    {
+    } /* End of 'broadphase' function */
+
+    /* Broadphase deinitializing function.
+     * ARGUMENTS: None.
+     */
+    virtual ~broadphase( VOID )
+    {
+    } /* End of '~broadphase' function */
+
+    /* Add box function.
+     * ARGUMENTS:
+     *   - box corners:
+     *       vec3 Min, Max;
+     * RETURNS:
+     *   (INT) box identifier.
+     */
+    INT Add( vec3 Min, vec3 Max )
+    {
+      INT Id;
+
+      if (Free.empty())
+      {
+        Id = (INT)Boxes.size();
+        Boxes.push_back(box());
+      }
+      else
+      {
+        Id = Free.back();
+        Free.pop_back();
+      }
+      Boxes[Id].Id = Id;
+      NumOfBoxes++;
+      Update(Id, Min, Max);
+      return Id;
+    } /* End of 'Add' function */
+
+    /* Move box function.
+     * ARGUMENTS:
+     *   - box identifier:
+     *       INT Id;
+     *   - new box corners:
+     *       vec3 Min, Max;
+     * RETURNS: None.
+     */
+    VOID Update( INT Id, vec3 Min, vec3 Max )
+    {
+      box &b = Boxes[Id];
+
+      for (INT k = 0; k < 3; k++)
+        b.Min[k] = Min[k], b.Max[k] = Max[k];
+      Touch(Id);
+    } /* End of 'Update' function */
+
+    /* Remove box function.
+     * ARGUMENTS:
+     *   - box identifier:
+     *       INT Id;
+     * RETURNS: None.
+     */
+    VOID Remove( INT Id )
+    {
+      Boxes[Id].Id = -1;
+      Free.push_back(Id);
+      NumOfBoxes--;
+      Touch(Id);
+    } /* End of 'Remove' function */
+
+    /* Obtain number of boxes function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) number of alive boxes.
+     */
+    INT GetNumOfBoxes( VOID ) const
+    {
+      return NumOfBoxes;
+    } /* End of 'GetNumOfBoxes' function */
+
+    /* Find overlapping pairs function.
+     * ARGUMENTS:
+     *   - pairs to fill (cleared first):
+     *       std::vector<broadphase_pair> &Pairs;
+     * RETURNS: None.
+     */
+    virtual VOID FindPairs( std::vector<broadphase_pair> &Pairs ) = 0;
+  }; /* end of 'broadphase' class */
+
+  /* Sweep and prune broadphase class */
+  class sweep_prune : public broadphase
+  {
+  private:
+    std::vector<box> Sorted;    /* Copies of boxes sorted by minimum along axis */
+    std::vector<FLT> Lanes[5];  /* Sorted bounds for sweep: axis minimum, ranges along two other axes */
+    std::vector<BYTE> IsSorted; /* Box is in sorted copies flags */
+    std::vector<broadphase_pair> Last; /* Pairs of last query */
+    BOOL IsLastValid;           /* Last pairs are kept flag */
+    INT Axis;                   /* Sort axis */
+
+    /* Sweep all boxes function.
+     * ARGUMENTS:
+     *   - pairs to add to:
+     *       std::vector<broadphase_pair> &Pairs;
+     * RETURNS: None.
+     */
+    VOID Sweep( std::vector<broadphase_pair> &Pairs )
+    {
+#ifdef NIDX_BROADPHASE_SSE2
+      INT A1 = (Axis + 1) % 3, A2 = (Axis + 2) % 3;
+      size_t Size = Sorted.size() + 4;
+
+      for (auto &l : Lanes)
+        l.resize(Size);
+      for (size_t i = 0; i < Size; i++)
+        if (i < Sorted.size())
+        {
+          const box &b = Sorted[i];
+
+          Lanes[0][i] = b.Min[Axis];
+          Lanes[1][i] = b.Min[A1], Lanes[2][i] = b.Max[A1];
+          Lanes[3][i] = b.Min[A2], Lanes[4][i] = b.Max[A2];
+        }
+        else
+          for (auto &l : Lanes)
+            l[i] = FLT_MAX;
+      /* 4 candidates per test, run ends on first candidate starting after box
+       * (lanes past last box are masked: box may end at FLT_MAX or infinity) */
+      for (size_t i = 0; i < Sorted.size(); i++)
+      {
+        const box &a = Sorted[i];
+        __m128
+          Max0 = _mm_set1_ps(a.Max[Axis]),
+          Min1 = _mm_set1_ps(a.Min[A1]), Max1 = _mm_set1_ps(a.Max[A1]),
+          Min2 = _mm_set1_ps(a.Min[A2]), Max2 = _mm_set1_ps(a.Max[A2]);
+
+        for (size_t j = i + 1; j < Sorted.size(); j += 4)
+        {
+          __m128 Run = _mm_cmple_ps(_mm_loadu_ps(&Lanes[0][j]), Max0);
+          INT r = _mm_movemask_ps(Run), m;
+
+          if (Sorted.size() - j < 4)
+            r &= (1 << (Sorted.size() - j)) - 1;
+          if (r == 0)
+            break;
+          m = r & _mm_movemask_ps(_mm_and_ps(
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&Lanes[1][j]), Max1), _mm_cmple_ps(Min1, _mm_loadu_ps(&Lanes[2][j]))),
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&Lanes[3][j]), Max2), _mm_cmple_ps(Min2, _mm_loadu_ps(&Lanes[4][j])))));
+          for (INT k = 0; m != 0; k++, m >>= 1)
+            if (m & 1)
+              AddPair(Pairs, a.Id, Sorted[j + k].Id);
+          if (r != 15)
+            break;
+        }
+      }
+#else /* NIDX_BROADPHASE_SSE2 */
+      for (size_t i = 0; i < Sorted.size(); i++)
+      {
+        const box &a = Sorted[i];
+
+        for (size_t j = i + 1; j < Sorted.size() && Sorted[j].Min[Axis] <= a.Max[Axis]; j++)
+          if (IsOverlap(a, Sorted[j]))
+            AddPair(Pairs, a.Id, Sorted[j].Id);
+      }
+#endif /* NIDX_BROADPHASE_SSE2 */
+    } /* End of 'Sweep' function */
+
+    /* Check moved boxes only function.
+     * ARGUMENTS:
+     *   - pairs to add to:
+     *       std::vector<broadphase_pair> &Pairs;
+     *   - largest box size along sort axis:
+     *       FLT MaxSize;
+     * RETURNS: None.
+     */
+    VOID SweepMoved( std::vector<broadphase_pair> &Pairs, FLT MaxSize )
+    {
+      /* Pairs of not moved boxes are kept */
+      Pairs.clear();
+      for (auto &p : Last)
+        if (!IsMoved[p.A] && !IsMoved[p.B])
+          Pairs.push_back(p);
+
+      /* Moved box overlaps only boxes starting in [Min - MaxSize, Max],
+       * pair of two moved boxes is added by box with smaller identifier */
+      for (INT Id : Moved)
+      {
+        const box &a = Boxes[Id];
+        FLT From = a.Min[Axis] - MaxSize;
+
+        if (a.Id < 0)
+          continue;
+        for (auto b = std::partition_point(Sorted.begin(), Sorted.end(), [this, From]( const box &B ){ return B.Min[Axis] < From; });
+             b != Sorted.end() && b->Min[Axis] <= a.Max[Axis]; ++b)
+          if (b->Id != a.Id && (!IsMoved[b->Id] || b->Id > a.Id) && IsOverlap(a, *b))
+            AddPair(Pairs, a.Id, b->Id);
+      }
+    } /* End of 'SweepMoved' function */
+
+  public:
+    /* Sweep and prune initializing function.
+     * ARGUMENTS: None.
+     */
+    sweep_prune( VOID ) : IsLastValid(FALSE), Axis(0)
+    {
+    } /* End of 'sweep_prune' function */
+
+    /* Find overlapping pairs function.
+     * ARGUMENTS:
+     *   - pairs to fill (cleared first):
+     *       std::vector<broadphase_pair> &Pairs;
+     * RETURNS: None.
+     */
+    VOID FindPairs( std::vector<broadphase_pair> &Pairs ) override
+    {
+      DBL Sum[3] = {0}, Sum2[3] = {0};
+      FLT MaxSize[3] = {0, 0, 0};
+      INT n = 0, NewAxis;
+
+      Pairs.clear();
+      IsSorted.assign(Boxes.size(), 0);
+
+      /* Refresh sorted copies keeping previous order, append new boxes */
+      for (auto &s : Sorted)
+        if (s.Id >= 0 && Boxes[s.Id].Id == s.Id && !IsSorted[s.Id])
+        {
+          IsSorted[s.Id] = 1;
+          Sorted[n++] = Boxes[s.Id];
+        }
+      Sorted.resize(n);
+      for (auto &b : Boxes)
+        if (b.Id >= 0 && !IsSorted[b.Id])
+          Sorted.push_back(b);
+
+      /* Axis of largest spread of centers (switched only when it is notably larger) */
+      for (auto &s : Sorted)
+        for (INT k = 0; k < 3; k++)
+        {
+          DBL c = s.Min[k] + s.Max[k];
+
+          Sum[k] += c, Sum2[k] += c * c;
+          MaxSize[k] = std::max(MaxSize[k], s.Max[k] - s.Min[k]);
+        }
+      for (INT k = 0; k < 3; k++)
+        Sum2[k] -= Sum[k] * Sum[k] / std::max(Sorted.size(), (size_t)1);
+      NewAxis = Axis;
+      for (INT k = 0; k < 3; k++)
+        if (Sum2[k] > Sum2[NewAxis] * 1.25)
+          NewAxis = k;
+
+      /* Insertion sort for coherent motion, full sort on axis change or many new boxes */
+      if (NewAxis != Axis || (INT)Sorted.size() - n > n / 8)
+      {
+        Axis = NewAxis;
+        std::sort(Sorted.begin(), Sorted.end(), [this]( const box &A, const box &B ){ return A.Min[Axis] < B.Min[Axis]; });
+      }
+      else
+        for (size_t i = 1; i < Sorted.size(); i++)
+        {
+          box b = Sorted[i];
+          size_t j = i;
+
+          for (; j > 0 && Sorted[j - 1].Min[Axis] > b.Min[Axis]; j--)
+            Sorted[j] = Sorted[j - 1];
+          Sorted[j] = b;
+        }
+
+      /* Few moved boxes (also added and removed ones) are checked alone */
+      if (IsLastValid && Moved.size() * 8 <= Sorted.size())
+        SweepMoved(Pairs, MaxSize[Axis]);
+      else
+        Sweep(Pairs);
+      Last = Pairs;
+      IsLastValid = TRUE;
+      ClearMoved();
+    } /* End of 'FindPairs' function */
+  }; /* end of 'sweep_prune' class */
+
+  /* Loose spatial hash broadphase class */
+  class spatial_hash : public broadphase
+  {
+  private:
+    std::vector<box> Cells;  /* Small boxes sorted by hash bucket */
+    std::vector<INT>
+      CellCoords,            /* Cell coordinates of sorted boxes, 3 per box */
+      Start,                 /* First sorted box of every bucket (and end) */
+      Pos,                   /* Next free place of every bucket during sort */
+      Coords,                /* Cell coordinates of boxes in identifier order */
+      Large;                 /* Boxes larger than cell */
+    std::vector<UINT> Keys;  /* Buckets of boxes in identifier order (large - past last) */
+    UINT Mask;               /* Buckets number - 1 */
+
+    /* Obtain bucket of cell function.
+     * ARGUMENTS:
+     *   - cell coordinates:
+     *       INT X, Y, Z;
+     * RETURNS:
+     *   (UINT) bucket index.
+     */
+    UINT Bucket( INT X, INT Y, INT Z ) const
+    {
+      return ((UINT)X + ((UINT)Y * 19349663u ^ (UINT)Z * 83492791u)) & Mask;
+    } /* End of 'Bucket' function */
+
+    /* Obtain cell coordinate function.
+     * ARGUMENTS:
+     *   - coordinate in cell sizes:
+     *       FLT X;
+     * RETURNS:
+     *   (INT) cell coordinate clamped to [-INT_MAX / 2, INT_MAX / 2] (0 for NaN),
+     *         so neighbour cell and distance arithmetic does not overflow.
+     */
+    static INT Cell( FLT X )
+    {
+      const FLT Lim = (FLT)(INT_MAX / 2);
+
+      X = floor(X);
+      return X >= Lim ? INT_MAX / 2 : X <= -Lim ? -(INT_MAX / 2) : X == X ? (INT)X : 0;
+    } /* End of 'Cell' function */
+
+  public:
+    FLT CellSize; /* Cell size, should be not less than typical box size */
+
+    /* Spatial hash initializing function.
+     * ARGUMENTS:
+     *   - cell size:
+     *       FLT NewCellSize;
+     */
+    spatial_hash( FLT NewCellSize ) : Mask(0), CellSize(NewCellSize)
+    {
+    } /* End of 'spatial_hash' function */
+
+    /* Find overlapping pairs function.
+     * ARGUMENTS:
+     *   - pairs to fill (cleared first):
+     *       std::vector<broadphase_pair> &Pairs;
+     * RETURNS: None.
+     */
+    VOID FindPairs( std::vector<broadphase_pair> &Pairs ) override
+    {
+      FLT Inv = 1 / CellSize;
+
+      Pairs.clear();
+      Coords.clear();
+      Keys.clear();
+      Large.clear();
+      ClearMoved();
+      for (Mask = 1; Mask < (UINT)NumOfBoxes * 2; Mask <<= 1)
+        ;
+      Mask--;
+      Start.assign(Mask + 2, 0);
+
+      /* Counting sort of small boxes by bucket */
+      for (auto &b : Boxes)
+      {
+        INT c[3] = {0, 0, 0};
+
+        if (b.Id < 0)
+          continue;
+        if (b.Max[0] - b.Min[0] > CellSize || b.Max[1] - b.Min[1] > CellSize || b.Max[2] - b.Min[2] > CellSize)
+        {
+          Large.push_back(b.Id);
+          Keys.push_back(Mask + 1);
+        }
+        else
+        {
+          for (INT k = 0; k < 3; k++)
+            c[k] = Cell((b.Min[k] * 0.5f + b.Max[k] * 0.5f) * Inv);
+          Keys.push_back(Bucket(c[0], c[1], c[2]));
+          Start[Keys.back() + 1]++;
+        }
+        Coords.insert(Coords.end(), c, c + 3);
+      }
+      for (UINT i = 0; i <= Mask; i++)
+        Start[i + 1] += Start[i];
+      Cells.resize(Keys.size() - Large.size());
+      CellCoords.resize(Cells.size() * 3);
+      {
+        size_t k = 0;
+
+        Pos.assign(Start.begin(), Start.end() - 1);
+
+        for (auto &b : Boxes)
+          if (b.Id >= 0 && Keys[k++] <= Mask)
+          {
+            INT p = Pos[Keys[k - 1]]++;
+
+            Cells[p] = b;
+            for (INT j = 0; j < 3; j++)
+              CellCoords[p * 3 + j] = Coords[(k - 1) * 3 + j];
+          }
+      }
+
+      /* Every box looks for boxes with larger identifiers in 27 neighbour cells,
+       * X neighbours are in adjacent buckets and scanned as one range */
+      for (size_t i = 0; i < Cells.size(); i++)
+      {
+        const box &a = Cells[i];
+        const INT *c = &CellCoords[i * 3];
+
+        for (INT dz = -1; dz <= 1; dz++)
+          for (INT dy = -1; dy <= 1; dy++)
+          {
+            INT y = c[1] + dy, z = c[2] + dz;
+            UINT h = Bucket(c[0] - 1, y, z);
+
+            for (INT r = 0; r < 3; r++)
+            {
+              INT Begin = Start[h], End = Start[h + 1];
+
+              /* Continue range while buckets do not wrap */
+              for (; r < 2 && h < Mask; r++)
+                End = Start[++h + 1];
+              h = (h + 1) & Mask;
+              for (INT j = Begin; j < End; j++)
+                if (Cells[j].Id > a.Id && CellCoords[j * 3 + 1] == y && CellCoords[j * 3 + 2] == z &&
+                    llabs((INT64)CellCoords[j * 3] - c[0]) <= 1 && IsOverlap(a, Cells[j]))
+                  AddPair(Pairs, a.Id, Cells[j].Id);
+            }
+          }
+      }
+
+      /* Large boxes against all */
+      for (size_t i = 0; i < Large.size(); i++)
+        for (auto &b : Boxes)
+          if (b.Id >= 0 && b.Id != Large[i] &&
+              (b.Id > Large[i] || !std::binary_search(Large.begin(), Large.end(), b.Id)) && IsOverlap(Boxes[Large[i]], b))
+            AddPair(Pairs, Large[i], b.Id);
+    } /* End of 'FindPairs' function */
+  }; /* end of 'spatial_hash' class */
+} /* end of 'nidx' spacename */
+
+#endif // !_broadphase_h_
+
+/* END OF 'broadphase.h' FILE */
@@ -0,0 +1,332 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : clip.h
+  * PURPOSE     : T51DX12 project.
+  *               Compressed animation clips declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Source clip is sampled with fixed rate. Every track is
+  *               quantized to 16 bits per component over its own range,
+  *               then keyframes are removed while linear interpolation
+  *               of kept keys stays within track tolerance (constant
+  *               tracks keep one key). Quaternions are interpolated by
+  *               'nlerp'. Clips are limited by 65536 frames.
+  *               Sampler keeps key cursor of every track, so forward
+  *               playback costs O(1) per track, seeking costs O(log N).
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _clip_h_
+#define _clip_h_
+
+#include "../def.h"
+#include "jobs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace nidx
+{
+  /* Animation track types */
+  enum struct clip_track_type
+  {
+    FLOAT = 1,      /* Scalar value */
+    VECTOR = 3,     /* Translation or scale */
+    QUATERNION = 4, /* Rotation quaternion (XYZW) */
+  }; /* End of 'clip_track_type' enum */
+
+  /* Source animation track structure */
+  struct clip_track_source
+  {
+    clip_track_type Type;    /* Track type */
+    FLT Tolerance;           /* Allowed absolute error per component */
+    std::vector<FLT> Values; /* Values of every frame ('Type' components each) */
+  }; /* End of 'clip_track_source' structure */
+
+  /* Source animation clip structure */
+  struct clip_source
+  {
+    FLT SampleRate;                        /* Frames per second */
+    INT NumOfFrames;                       /* Number of frames */
+    std::vector<clip_track_source> Tracks; /* Tracks */
+  }; /* End of 'clip_source' structure */
+
+  /* Compressed animation clip class */
+  class clip
+  {
+  public:
+    /* Compressed track structure */
+    struct track
+    {
+      clip_track_type Type; /* Track type */
+      INT
+        Dim,                /* Number of components */
+        Offset,             /* First component in sampled pose */
+        NumOfKeys,          /* Number of kept keys */
+        FirstKey,           /* First key in 'Frames' */
+        FirstValue;         /* First key value in 'Values' */
+      FLT Min[4], Step[4];  /* Quantization range of every component */
+    }; /* End of 'track' structure */
+
+    FLT
+      SampleRate,                /* Frames per second */
+      Duration;                  /* Clip duration in seconds */
+    INT
+      NumOfFrames,               /* Number of source frames */
+      NumOfValues;               /* Number of floats in sampled pose */
+    std::vector<track> Tracks;   /* Tracks */
+    std::vector<USHORT>
+      Frames,                    /* Key frame numbers */
+      Values;                    /* Quantized key values */
+
+  private:
+    /* Compress one track function.
+     * ARGUMENTS:
+     *   - source track:
+     *       const clip_track_source &Src;
+     *   - track to fill:
+     *       track &T;
+     * RETURNS: None.
+     */
+    VOID Compress( const clip_track_source &Src, track &T )
+    {
+      INT N = NumOfFrames, D = T.Dim;
+      std::vector<FLT> Val(Src.Values.begin(), Src.Values.begin() + (size_t)N * D);
+      std::vector<USHORT> Q((size_t)N * D);
+      FLT Max[4];
+      BOOL IsConst = TRUE;
+
+      /* Keep neighbour quaternions in one hemisphere */
+      if (T.Type == clip_track_type::QUATERNION)
+        for (INT f = 1; f < N; f++)
+        {
+          FLT *p = &Val[(size_t)(f - 1) * 4], *q = &Val[(size_t)f * 4];
+
+          if (p[0] * q[0] + p[1] * q[1] + p[2] * q[2] + p[3] * q[3] < 0)
+            for (INT k = 0; k < 4; k++)
+              q[k] = -q[k];
+        }
+
+      for (INT k = 0; k < D; k++)
+      {
+        T.Min[k] = Max[k] = Val[k];
+        for (INT f = 1; f < N; f++)
+          T.Min[k] = std::min(T.Min[k], Val[(size_t)f * D + k]), Max[k] = std::max(Max[k], Val[(size_t)f * D + k]);
+        IsConst &= Max[k] - T.Min[k] <= Src.Tolerance;
+      }
+      T.FirstKey = (INT)Frames.size();
+      T.FirstValue = (INT)Values.size();
+      if (IsConst)
+      {
+        T.NumOfKeys = 1;
+        Frames.push_back(0);
+        for (INT k = 0; k < D; k++)
+        {
+          T.Min[k] = (T.Min[k] + Max[k]) / 2, T.Step[k] = 0;
+          Values.push_back(0);
+        }
+        return;
+      }
+
+      for (INT k = 0; k < D; k++)
+      {
+        T.Step[k] = (Max[k] - T.Min[k]) / 65535;
+        for (INT f = 0; f < N; f++)
+          Q[(size_t)f * D + k] =
+            T.Step[k] == 0 ? 0 : (USHORT)std::min(65535.0f, (Val[(size_t)f * D + k] - T.Min[k]) / T.Step[k] + 0.5f);
+      }
+
+      /* Check if keys A and B interpolate all frames between them function */
+      auto Fits = [&]( INT A, INT B ) -> BOOL
+      {
+        const USHORT *qa = &Q[(size_t)A * D], *qb = &Q[(size_t)B * D];
+
+        for (INT f = A + 1; f < B; f++)
+        {
+          FLT t = (FLT)(f - A) / (B - A), v[4], Len = 1;
+
+          for (INT k = 0; k < D; k++)
+            v[k] = T.Min[k] + T.Step[k] * (qa[k] + t * (qb[k] - qa[k]));
+          if (T.Type == clip_track_type::QUATERNION)
+            Len = (FLT)sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]);
+          for (INT k = 0; k < D; k++)
+            if (fabs(v[k] / Len - Val[(size_t)f * D + k]) > Src.Tolerance)
+              return FALSE;
+        }
+        return TRUE;
+      };
+
+      /* Greedy reduction: extend every segment while it fits */
+      INT A = 0;
+
+      Frames.push_back(0);
+      Values.insert(Values.end(), Q.begin(), Q.begin() + D);
+      while (A < N - 1)
+      {
+        INT B = A + 1;
+
+        while (B + 1 < N && Fits(A, B + 1))
+          B++;
+        Frames.push_back((USHORT)B);
+        Values.insert(Values.end(), Q.begin() + (size_t)B * D, Q.begin() + (size_t)(B + 1) * D);
+        A = B;
+      }
+      T.NumOfKeys = (INT)Frames.size() - T.FirstKey;
+    } /* End of 'Compress' function */
+
+  public:
+    /* Clip compressing constructor.
+     * ARGUMENTS:
+     *   - source clip:
+     *       const clip_source &Src;
+     */
+    clip( const clip_source &Src ) :
+      SampleRate(Src.SampleRate), Duration((std::min(Src.NumOfFrames, 65536) - 1) / Src.SampleRate),
+      NumOfFrames(std::min(Src.NumOfFrames, 65536)), NumOfValues(0)
+    {
+      Tracks.resize(Src.Tracks.size());
+      for (size_t i = 0; i < Src.Tracks.size(); i++)
+      {
+        track &T = Tracks[i];
+
+        T.Type = Src.Tracks[i].Type;
+        T.Dim = (INT)T.Type;
+        T.Offset = NumOfValues;
+        NumOfValues += T.Dim;
+        Compress(Src.Tracks[i], T);
+      }
+      Frames.shrink_to_fit();
+      Values.shrink_to_fit();
+    } /* End of 'clip' function */
+
+    /* Obtain clip memory size function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (size_t) size in bytes.
+     */
+    size_t GetMemorySize( VOID ) const
+    {
+      return sizeof(clip) + Tracks.size() * sizeof(track) + (Frames.size() + Values.size()) * sizeof(USHORT);
+    } /* End of 'GetMemorySize' function */
+  }; /* end of 'clip' class */
+
+  /* Animation clip sampler class */
+  class clip_sampler
+  {
+  private:
+    const clip *Clip;         /* Sampled clip */
+    std::vector<INT> Cursors; /* Last key segment of every track */
+
+  public:
+    BOOL IsLoop;              /* Loop flag (otherwise time is clamped) */
+
+    /* Sampler initializing function.
+     * ARGUMENTS:
+     *   - sampled clip:
+     *       const clip &C;
+     *   - loop flag:
+     *       BOOL NewIsLoop;
+     */
+    clip_sampler( const clip &C, BOOL NewIsLoop = TRUE ) : Clip(&C), Cursors(C.Tracks.size(), 0), IsLoop(NewIsLoop)
+    {
+    } /* End of 'clip_sampler' function */
+
+    /* Obtain sampled clip function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const clip &) clip.
+     */
+    const clip & GetClip( VOID ) const
+    {
+      return *Clip;
+    } /* End of 'GetClip' function */
+
+    /* Sample clip pose function.
+     * ARGUMENTS:
+     *   - time in seconds (see 'timer::Time'):
+     *       DBL Time;
+     *   - pose to fill ('clip::NumOfValues' floats):
+     *       FLT *Out;
+     * RETURNS: None.
+     */
+    VOID Sample( DBL Time, FLT *Out )
+    {
+      const clip &C = *Clip;
+      DBL F = Time * C.SampleRate, Last = C.NumOfFrames - 1;
+
+      if (IsLoop && Last > 0)
+        F -= floor(F / Last) * Last;
+      F = std::min(std::max(F, 0.0), Last);
+
+      for (size_t i = 0; i < C.Tracks.size(); i++)
+      {
+        const clip::track &T = C.Tracks[i];
+        const USHORT *K = &C.Frames[T.FirstKey], *qa, *qb;
+        FLT *v = Out + T.Offset, t = 0;
+        INT &c = Cursors[i], n = T.NumOfKeys;
+
+        if (n > 1)
+        {
+          /* Step forward from cached segment, search on seek or rewind */
+          if (F < K[c] || (c + 4 < n && F >= K[c + 4]))
+            c = std::max((INT)(std::upper_bound(K, K + n - 1, F) - K) - 1, 0);
+          else
+            while (c + 2 < n && F >= K[c + 1])
+              c++;
+          t = (FLT)((F - K[c]) / (K[c + 1] - K[c]));
+          qa = &C.Values[T.FirstValue + (size_t)c * T.Dim];
+          qb = qa + T.Dim;
+        }
+        else
+          qa = qb = &C.Values[T.FirstValue];
+
+        for (INT k = 0; k < T.Dim; k++)
+          v[k] = T.Min[k] + T.Step[k] * (qa[k] + t * (qb[k] - qa[k]));
+        if (T.Type == clip_track_type::QUATERNION)
+        {
+          FLT Len = (FLT)sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]);
+
+          if (Len > 0)
+            for (INT k = 0; k < 4; k++)
+              v[k] /= Len;
+        }
+      }
+    } /* End of 'Sample' function */
+
+    /* Sample poses of many samplers on worker threads function.
+     * ARGUMENTS:
+     *   - samplers:
+     *       clip_sampler *Samplers;
+     *   - time of every sampler in seconds:
+     *       const DBL *Times;
+     *   - number of samplers:
+     *       INT N;
+     *   - poses to fill, pose of sampler I starts at Out + I * Stride:
+     *       FLT *Out;
+     *       INT Stride;
+     *   - worker threads:
+     *       jobs &Pool;
+     * RETURNS: None.
+     */
+    static VOID SampleBatch( clip_sampler *Samplers, const DBL *Times, INT N, FLT *Out, INT Stride, jobs &Pool = jobs::Get() )
+    {
+      const INT Chunk = 32;
+
+      Pool.ParallelFor((N + Chunk - 1) / Chunk, [&]( INT c, INT )
+        {
+          for (INT i = c * Chunk, End = std::min(N, i + Chunk); i < End; i++)
+            Samplers[i].Sample(Times[i], Out + (size_t)i * Stride);
+        });
+    } /* End of 'SampleBatch' function */
+  }; /* end of 'clip_sampler' class */
+} /* end of 'nidx' spacename */
+
+#endif // !_clip_h_
+
+/* END OF 'clip.h' FILE */
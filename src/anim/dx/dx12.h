@@ -7,8 +7,10 @@
   * PURPOSE     : T51DX12 project.
   *               Direct X 12 declaration module.
   * PROGRAMMER  : ND4.
-  * LAST UPDATE : 07.10.2021
-  * NOTE        : None.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Resource handle functions ('Create*', 'Add*', 'Get',
+  *               'Destroy') may be called from any thread, 'EndFrame'
+  *               and 'WaitIdle' reclaim resources under the same lock.
   *
   * No part of this file may be changed without agreement of
   * Computer Graphics Support Group of 30 Phys-Math Lyceum
@@ -23,7 +25,10 @@
 #include <d3d12sdklayers.h>
 #include <dxgidebug.h>
 
+#include <mutex>
+
 #include "../../def.h"
+#include "../render/pool.h"
 
 /* Direct X namespace */
 namespace nidx
@@ -34,11 +39,12 @@ namespace nidx
   private:
     INT Width = 0, Height = 0;
     // Direct3D12 interfaces
-    static const INT NumOfBuffers = 2;
+    static const INT NumOfBuffers = 3;
     IDXGIFactory5* Factory{};
     ID3D12Device5* Device{};
     IDXGISwapChain4* SwapChain{};
     ID3D12Resource* BackBuffers[NumOfBuffers];
+    HANDLE FrameWaitable{}; // swap chain frame latency waitable object
 
     ID3D12DescriptorHeap* RTVHeap{};
     ID3D12DescriptorHeap* SRVHeap{};
@@ -63,6 +69,17 @@ namespace nidx
 
     static const UINT BufferCount = 3;
 
+    // Resources addressed by handles, released after their frame fence.
+    // Created and destroyed on message thread, collected by 'EndFrame' on render thread:
+    // pools, retire queue and fence value are used only under 'ResLock'
+    std::mutex ResLock;
+    static const UINT NumOfDescriptors = 1024;
+    pool<ID3D12Resource*, buffer_tag> Buffers;
+    pool<ID3D12Resource*, texture_tag> Textures;
+    pool<ID3D12PipelineState*, pipeline_tag> Pipelines;
+    descriptor_allocator Descriptors{NumOfDescriptors}; // CBV/SRV/UAV heap indices
+    retire_queue Retired;
+
   public:
     /* Class main constructor */
     core( HWND &hWnd );
@@ -70,6 +87,96 @@ namespace nidx
     /* Class main destructor */
     ~core( VOID );
 
+    /* Wait for swap chain to accept a new frame function.
+     * ARGUMENTS:
+     *   - wait timeout in milliseconds:
+     *       DWORD Timeout;
+     * RETURNS:
+     *   (BOOL) TRUE if swap chain is ready, FALSE on timeout.
+     */
+    BOOL WaitFrame( DWORD Timeout );
+
+    /* Present back buffer function.
+     * ARGUMENTS:
+     *   - vertical sync flag:
+     *       BOOL IsVSync;
+     * RETURNS: None.
+     */
+    VOID Present( BOOL IsVSync );
+
+    /* End frame function: signals frame fence and frees retired resources.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID EndFrame( VOID );
+
+    /* Wait for GPU to finish all submitted work function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID WaitIdle( VOID );
+
+    /* Create buffer function.
+     * ARGUMENTS:
+     *   - buffer size in bytes:
+     *       UINT64 Size;
+     *   - heap type (default or upload):
+     *       D3D12_HEAP_TYPE HeapType;
+     * RETURNS:
+     *   (buffer_handle) buffer handle (null on failure).
+     */
+    buffer_handle CreateBuffer( UINT64 Size, D3D12_HEAP_TYPE HeapType );
+
+    /* Take ownership of texture function.
+     * ARGUMENTS:
+     *   - texture resource:
+     *       ID3D12Resource *Texture;
+     * RETURNS:
+     *   (texture_handle) texture handle.
+     */
+    texture_handle AddTexture( ID3D12Resource *Texture );
+
+    /* Take ownership of pipeline state function.
+     * ARGUMENTS:
+     *   - pipeline state:
+     *       ID3D12PipelineState *Pipeline;
+     * RETURNS:
+     *   (pipeline_handle) pipeline handle.
+     */
+    pipeline_handle AddPipeline( ID3D12PipelineState *Pipeline );
+
+    /* Allocate shader visible descriptor function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (descriptor_handle) descriptor handle (null if heap is full).
+     */
+    descriptor_handle AllocDescriptor( VOID );
+
+    /* Obtain resources by handle functions.
+     * ARGUMENTS:
+     *   - handle:
+     *       *_handle H;
+     * RETURNS:
+     *   resource or nullptr if handle is stale.
+     */
+    ID3D12Resource * Get( buffer_handle H );
+    ID3D12Resource * Get( texture_handle H );
+    ID3D12PipelineState * Get( pipeline_handle H );
+    D3D12_CPU_DESCRIPTOR_HANDLE Get( descriptor_handle H );
+
+    /* Destroy resources by handle functions.
+     * Handle becomes stale at once, object is released when GPU
+     * finishes the current frame.
+     * ARGUMENTS:
+     *   - handle:
+     *       *_handle H;
+     * RETURNS: None.
+     */
+    VOID Destroy( buffer_handle H );
+    VOID Destroy( texture_handle H );
+    VOID Destroy( pipeline_handle H );
+    VOID Destroy( descriptor_handle H );
+
   }; /* End of 'core' class */
 
 } /* end of 'nidx' spacename */
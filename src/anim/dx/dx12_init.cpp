@@ -7,7 +7,7 @@
   * PURPOSE     : T51DX12 project.
   *               Direct X 12 initialization module.
   * PROGRAMMER  : ND4.
-  * LAST UPDATE : 07.10.2021
+  * LAST UPDATE : 19.10.2026
   * NOTE        : None.
   *
   * No part of this file may be changed without agreement of
@@ -18,9 +18,7 @@
 #include "../../nidx.h"
 
 #include "dx12.h"
-
-#include <vector>
-#include <string>
+#include "../arena.h"
 
 /* Show adapter output display modes in log function.
  * ARGUMENTS:
@@ -35,17 +33,17 @@ VOID LogOutputDisplayModes(IDXGIOutput* output, DXGI_FORMAT format)
 {
   UINT count = 0;
   UINT flags = 0;
+  WCHAR text[128];
   // Call with nullptr to get list count.
   output->GetDisplayModeList(format, flags, &count, nullptr);
-  std::vector<DXGI_MODE_DESC> modeList(count);
-  output->GetDisplayModeList(format, flags, &count, &modeList[0]);
+  nidx::frame_vector<DXGI_MODE_DESC> modeList(count);
+  output->GetDisplayModeList(format, flags, &count, modeList.data());
   for(auto& x : modeList)
   {
     UINT n = x.RefreshRate.Numerator;
     UINT d = x.RefreshRate.Denominator;
-    std::wstring text =
-    L"Width = " + std::to_wstring(x.Width) + L" " + L"Height = " + std::to_wstring(x.Height) + L" " + L"Refresh = " + std::to_wstring(n) + L"/" + std::to_wstring(d) + L"\n";
-    ::OutputDebugString(text.c_str());
+    swprintf_s(text, L"Width = %u Height = %u Refresh = %u/%u\n", x.Width, x.Height, n, d);
+    ::OutputDebugString(text);
   }
 } /* End of 'LogOutputDisplayModes' function */
 
@@ -60,14 +58,13 @@ VOID LogAdapterOutputs( IDXGIAdapter* adapter )
 {
   UINT i = 0;
   IDXGIOutput* output = nullptr;
+  WCHAR text[64 + _countof(DXGI_OUTPUT_DESC::DeviceName)];
   while(adapter->EnumOutputs(i, &output) != DXGI_ERROR_NOT_FOUND)
   {
     DXGI_OUTPUT_DESC desc;
     output->GetDesc(&desc);
-    std::wstring text = L"***Output: ";
-    text += desc.DeviceName;
-    text += L"\n";
-    OutputDebugString(text.c_str());
+    swprintf_s(text, L"***Output: %s\n", desc.DeviceName);
+    OutputDebugString(text);
     LogOutputDisplayModes(output, DXGI_FORMAT_B8G8R8A8_UNORM);
     output->Release();
     ++i;
@@ -137,20 +134,25 @@ nidx::core::core( HWND &hWnd )
   SCD.Width = Width;
   SCD.Height = Height;
   SCD.AlphaMode = DXGI_ALPHA_MODE_IGNORE;
-  SCD.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
+  SCD.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
   SCD.Scaling = DXGI_SCALING_STRETCH;
   SCD.SampleDesc.Count = 1;
   SCD.SampleDesc.Quality = 0;
   SCD.BufferCount = NumOfBuffers;
   SCD.Stereo = FALSE;
   SCD.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-  SCD.Flags = 0;
+  SCD.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
 
   IDXGISwapChain1* SwapChain1{};
   Factory->CreateSwapChainForHwnd(ComQueue, hWnd, &SCD, nullptr, nullptr, &SwapChain1);
 
   SwapChain1->QueryInterface(IID_PPV_ARGS(&SwapChain));
   SwapChain1->Release();
+
+  // Keep only one queued frame, pacing waits on the latency object
+  SwapChain->SetMaximumFrameLatency(1);
+  FrameWaitable = SwapChain->GetFrameLatencyWaitableObject();
+
   for (INT i = 0; i < NumOfBuffers; i++)
     SwapChain->GetBuffer(i, IID_PPV_ARGS(&BackBuffers[i]));
 
@@ -158,7 +160,7 @@ nidx::core::core( HWND &hWnd )
   D3D12_DESCRIPTOR_HEAP_DESC DHD{};
   DHD.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
   DHD.NodeMask = 0;
-  DHD.NumDescriptors = 2 /* frame buffers */ + 1 /* render target */;
+  DHD.NumDescriptors = NumOfBuffers /* frame buffers */ + 1 /* render target */;
   DHD.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
   Device->CreateDescriptorHeap(&DHD, IID_PPV_ARGS(&RTVHeap));
 
@@ -168,7 +170,7 @@ nidx::core::core( HWND &hWnd )
   Device->CreateDescriptorHeap(&DHD, IID_PPV_ARGS(&DSVHeap));
 
   // Constant/shaders
-  DHD.NumDescriptors = 2 /* ??? */;
+  DHD.NumDescriptors = NumOfDescriptors;
   DHD.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
   DHD.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
   Device->CreateDescriptorHeap(&DHD, IID_PPV_ARGS(&SRVHeap));
@@ -187,6 +189,7 @@ nidx::core::core( HWND &hWnd )
   Device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, ComAllocator, nullptr, IID_PPV_ARGS(&ComList));
 
   Device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&Fence));
+  Event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
   RTVDescSize = Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
   DSVDescSize = Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
   SRVDescSize = Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
@@ -217,6 +220,17 @@ nidx::core::core( HWND &hWnd )
 /* Main class destructor */
 nidx::core::~core( VOID )
 {
+  WaitIdle();
+  Retired.Flush();
+  for (auto Res : Buffers)
+    Res->Release();
+  for (auto Res : Textures)
+    Res->Release();
+  for (auto Res : Pipelines)
+    Res->Release();
+  Fence->Release();
+  CloseHandle(Event);
+
   ComAllocator->Release();
   ComList->Release();
   ComQueue->Release();
@@ -226,6 +240,7 @@ nidx::core::~core( VOID )
   DSVHeap->Release();
   SRVHeap->Release();
 
+  CloseHandle(FrameWaitable);
   SwapChain->Release();
   Device->Release();
   Factory->Release();
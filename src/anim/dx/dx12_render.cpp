@@ -7,7 +7,7 @@
   * PURPOSE     : T51DX12 project.
   *               Direct X 12 render module.
   * PROGRAMMER  : ND4.
-  * LAST UPDATE : 05.10.2021
+  * LAST UPDATE : 19.10.2026
   * NOTE        : None.
   *
   * No part of this file may be changed without agreement of
@@ -19,4 +19,27 @@
 
 #include "dx12.h"
 
+/* Wait for swap chain to accept a new frame function.
+ * ARGUMENTS:
+ *   - wait timeout in milliseconds:
+ *       DWORD Timeout;
+ * RETURNS:
+ *   (BOOL) TRUE if swap chain is ready, FALSE on timeout.
+ */
+BOOL nidx::core::WaitFrame( DWORD Timeout )
+{
+  return WaitForSingleObjectEx(FrameWaitable, Timeout, TRUE) == WAIT_OBJECT_0;
+} /* End of 'nidx::core::WaitFrame' function */
+
+/* Present back buffer function.
+ * ARGUMENTS:
+ *   - vertical sync flag:
+ *       BOOL IsVSync;
+ * RETURNS: None.
+ */
+VOID nidx::core::Present( BOOL IsVSync )
+{
+  SwapChain->Present(IsVSync ? 1 : 0, 0);
+} /* End of 'nidx::core::Present' function */
+
 /* END OF 'dx12_render.cpp' FILE */
\ No newline at end of file
@@ -0,0 +1,213 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : dx12_res.cpp
+  * PURPOSE     : T51DX12 project.
+  *               Direct X 12 resources module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Handle functions run on message thread while render
+  *               thread ends frames, all of them take 'ResLock'.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#include <nidx.h>
+#include "../../nidx.h"
+
+#include "dx12.h"
+
+/* End frame function: signals frame fence and frees retired resources.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID nidx::core::EndFrame( VOID )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+
+  ComQueue->Signal(Fence, ++FenceValue);
+  Retired.Collect(Fence->GetCompletedValue());
+} /* End of 'nidx::core::EndFrame' function */
+
+/* Wait for GPU to finish all submitted work function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID nidx::core::WaitIdle( VOID )
+{
+  std::unique_lock<std::mutex> L(ResLock);
+  UINT64 Value = ++FenceValue;
+
+  ComQueue->Signal(Fence, Value);
+  /* Do not block handle functions of other threads while GPU works */
+  L.unlock();
+  if (Fence->GetCompletedValue() < Value)
+  {
+    Fence->SetEventOnCompletion(Value, Event);
+    WaitForSingleObject(Event, INFINITE);
+  }
+  L.lock();
+  Retired.Collect(Value);
+} /* End of 'nidx::core::WaitIdle' function */
+
+/* Create buffer function.
+ * ARGUMENTS:
+ *   - buffer size in bytes:
+ *       UINT64 Size;
+ *   - heap type (default or upload):
+ *       D3D12_HEAP_TYPE HeapType;
+ * RETURNS:
+ *   (buffer_handle) buffer handle (null on failure).
+ */
+nidx::buffer_handle nidx::core::CreateBuffer( UINT64 Size, D3D12_HEAP_TYPE HeapType )
+{
+  D3D12_HEAP_PROPERTIES HP{};
+  D3D12_RESOURCE_DESC RD{};
+  ID3D12Resource *Res = nullptr;
+
+  HP.Type = HeapType;
+  RD.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+  RD.Width = Size;
+  RD.Height = 1;
+  RD.DepthOrArraySize = 1;
+  RD.MipLevels = 1;
+  RD.Format = DXGI_FORMAT_UNKNOWN;
+  RD.SampleDesc.Count = 1;
+  RD.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+  if (FAILED(Device->CreateCommittedResource(&HP, D3D12_HEAP_FLAG_NONE, &RD,
+        HeapType == D3D12_HEAP_TYPE_UPLOAD ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COMMON,
+        nullptr, IID_PPV_ARGS(&Res))))
+    return buffer_handle();
+  std::lock_guard<std::mutex> L(ResLock);
+
+  return Buffers.Add(Res);
+} /* End of 'nidx::core::CreateBuffer' function */
+
+/* Take ownership of texture function.
+ * ARGUMENTS:
+ *   - texture resource:
+ *       ID3D12Resource *Texture;
+ * RETURNS:
+ *   (texture_handle) texture handle.
+ */
+nidx::texture_handle nidx::core::AddTexture( ID3D12Resource *Texture )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+
+  return Textures.Add(Texture);
+} /* End of 'nidx::core::AddTexture' function */
+
+/* Take ownership of pipeline state function.
+ * ARGUMENTS:
+ *   - pipeline state:
+ *       ID3D12PipelineState *Pipeline;
+ * RETURNS:
+ *   (pipeline_handle) pipeline handle.
+ */
+nidx::pipeline_handle nidx::core::AddPipeline( ID3D12PipelineState *Pipeline )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+
+  return Pipelines.Add(Pipeline);
+} /* End of 'nidx::core::AddPipeline' function */
+
+/* Allocate shader visible descriptor function.
+ * ARGUMENTS: None.
+ * RETURNS:
+ *   (descriptor_handle) descriptor handle (null if heap is full).
+ */
+nidx::descriptor_handle nidx::core::AllocDescriptor( VOID )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+
+  return Descriptors.Alloc();
+} /* End of 'nidx::core::AllocDescriptor' function */
+
+/* Obtain resources by handle functions.
+ * ARGUMENTS:
+ *   - handle:
+ *       *_handle H;
+ * RETURNS:
+ *   resource or nullptr if handle is stale.
+ */
+ID3D12Resource * nidx::core::Get( buffer_handle H )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+  ID3D12Resource **Res = Buffers.Get(H);
+
+  return Res == nullptr ? nullptr : *Res;
+} /* End of 'nidx::core::Get' function */
+
+ID3D12Resource * nidx::core::Get( texture_handle H )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+  ID3D12Resource **Res = Textures.Get(H);
+
+  return Res == nullptr ? nullptr : *Res;
+} /* End of 'nidx::core::Get' function */
+
+ID3D12PipelineState * nidx::core::Get( pipeline_handle H )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+  ID3D12PipelineState **Res = Pipelines.Get(H);
+
+  return Res == nullptr ? nullptr : *Res;
+} /* End of 'nidx::core::Get' function */
+
+D3D12_CPU_DESCRIPTOR_HANDLE nidx::core::Get( descriptor_handle H )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+  D3D12_CPU_DESCRIPTOR_HANDLE CDH{};
+  const UINT *Index = Descriptors.Get(H);
+
+  if (Index != nullptr)
+    CDH.ptr = SRVHeap->GetCPUDescriptorHandleForHeapStart().ptr + *Index * SRVDescSize;
+  return CDH;
+} /* End of 'nidx::core::Get' function */
+
+/* Destroy resources by handle functions.
+ * ARGUMENTS:
+ *   - handle:
+ *       *_handle H;
+ * RETURNS: None.
+ */
+VOID nidx::core::Destroy( buffer_handle H )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+  ID3D12Resource *Res;
+
+  /* Current frame is signaled with the next fence value */
+  if (Buffers.Remove(H, &Res))
+    Retired.Retire(FenceValue + 1, [Res]( VOID ){ Res->Release(); });
+} /* End of 'nidx::core::Destroy' function */
+
+VOID nidx::core::Destroy( texture_handle H )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+  ID3D12Resource *Res;
+
+  if (Textures.Remove(H, &Res))
+    Retired.Retire(FenceValue + 1, [Res]( VOID ){ Res->Release(); });
+} /* End of 'nidx::core::Destroy' function */
+
+VOID nidx::core::Destroy( pipeline_handle H )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+  ID3D12PipelineState *Res;
+
+  if (Pipelines.Remove(H, &Res))
+    Retired.Retire(FenceValue + 1, [Res]( VOID ){ Res->Release(); });
+} /* End of 'nidx::core::Destroy' function */
+
+VOID nidx::core::Destroy( descriptor_handle H )
+{
+  std::lock_guard<std::mutex> L(ResLock);
+
+  Descriptors.Free(H, FenceValue + 1, Retired);
+} /* End of 'nidx::core::Destroy' function */
+
+/* END OF 'dx12_res.cpp' FILE */
@@ -0,0 +1,234 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : events.h
+  * PURPOSE     : T51DX12 project.
+  *               Input events queue declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Queue is lock-free for one producer (window procedure
+  *               or headless source) and one consumer (input system).
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _events_h_
+#define _events_h_
+
+#include "../def.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace nidx
+{
+  /* Input event types */
+  enum struct event_type : BYTE
+  {
+    KEY_DOWN,    /* Key or mouse button pressed ('Key' - virtual key code) */
+    KEY_UP,      /* Key or mouse button released ('Key' - virtual key code) */
+    MOUSE_MOVE,  /* Mouse moved ('X', 'Y' - client coordinates) */
+    MOUSE_WHEEL, /* Mouse wheel rotated ('X' - wheel delta) */
+    FOCUS_LOST,  /* Window lost focus, all keys are released */
+  }; /* End of 'event_type' enum */
+
+  /* Input event structure */
+  struct input_event
+  {
+    DBL Time;        /* Event time in seconds */
+    event_type Type; /* Event type */
+    BYTE Key;        /* Virtual key code */
+    INT X, Y;        /* Coordinates or wheel delta */
+
+    /* Event time source function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (DBL) current time in seconds.
+     */
+    static DBL Now( VOID )
+    {
+      return std::chrono::duration<DBL>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    } /* End of 'Now' function */
+  }; /* End of 'input_event' struct */
+
+  /* Single producer single consumer input events queue class */
+  class event_queue
+  {
+  private:
+    static const UINT Size = 1024;     /* Queue capacity (power of 2) */
+    input_event Events[Size];          /* Events ring */
+    std::atomic<UINT> Head, Tail;      /* Read and write positions */
+
+  public:
+    std::atomic<UINT> LostCounter;     /* Number of events dropped on overflow */
+
+    /* Queue initializing function.
+     * ARGUMENTS: None.
+     */
+    event_queue( VOID ) : Events(), Head(0), Tail(0), LostCounter(0)
+    {
+    } /* End of 'event_queue' function */
+
+    /* Put event to queue function (producer side).
+     * ARGUMENTS:
+     *   - event to put:
+     *       const input_event &E;
+     * RETURNS:
+     *   (BOOL) TRUE if event is stored, FALSE on overflow.
+     */
+    BOOL Push( const input_event &E )
+    {
+      UINT t = Tail.load(std::memory_order_relaxed);
+
+      if (t - Head.load(std::memory_order_acquire) >= Size)
+      {
+        LostCounter++;
+        return FALSE;
+      }
+      Events[t & (Size - 1)] = E;
+      Tail.store(t + 1, std::memory_order_release);
+      return TRUE;
+    } /* End of 'Push' function */
+
+    /* Put event stamped with current time to queue function (producer side).
+     * ARGUMENTS:
+     *   - event type:
+     *       event_type Type;
+     *   - virtual key code:
+     *       BYTE Key;
+     *   - coordinates or wheel delta:
+     *       INT X, Y;
+     * RETURNS:
+     *   (BOOL) TRUE if event is stored, FALSE on overflow.
+     */
+    BOOL Push( event_type Type, BYTE Key = 0, INT X = 0, INT Y = 0 )
+    {
+      input_event E;
+
+      E.Time = input_event::Now();
+      E.Type = Type;
+      E.Key = Key;
+      E.X = X;
+      E.Y = Y;
+      return Push(E);
+    } /* End of 'Push' function */
+
+    /* Get event from queue function (consumer side).
+     * ARGUMENTS:
+     *   - event to fill:
+     *       input_event &E;
+     * RETURNS:
+     *   (BOOL) TRUE if event is obtained, FALSE if queue is empty.
+     */
+    BOOL Pop( input_event &E )
+    {
+      UINT h = Head.load(std::memory_order_relaxed);
+
+      if (h == Tail.load(std::memory_order_acquire))
+        return FALSE;
+      E = Events[h & (Size - 1)];
+      Head.store(h + 1, std::memory_order_release);
+      return TRUE;
+    } /* End of 'Pop' function */
+
+    /* Drop all queued events function (consumer side).
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Clear( VOID )
+    {
+      Head.store(Tail.load(std::memory_order_acquire), std::memory_order_release);
+    } /* End of 'Clear' function */
+  }; /* end of 'event_queue' class */
+
+  /* Scripted input events source class (headless input without window) */
+  class event_script
+  {
+  private:
+    /* Scripted event structure */
+    struct step
+    {
+      INT Frame;      /* Frame number the event arrives before */
+      input_event E;  /* Event */
+    }; /* End of 'step' structure */
+
+    std::vector<step> Steps;  /* Events in frame order */
+    size_t Next;              /* First not fed event */
+
+  public:
+    DBL FrameTime;            /* Frame interval for event time stamps */
+
+    /* Script initializing function.
+     * ARGUMENTS:
+     *   - frame interval for event time stamps in seconds:
+     *       DBL NewFrameTime;
+     */
+    event_script( DBL NewFrameTime = 1.0 / 60 ) : Next(0), FrameTime(NewFrameTime)
+    {
+    } /* End of 'event_script' function */
+
+    /* Add event function (events of one frame keep adding order).
+     * ARGUMENTS:
+     *   - frame number the event arrives before:
+     *       INT Frame;
+     *   - event type:
+     *       event_type Type;
+     *   - virtual key code:
+     *       BYTE Key;
+     *   - coordinates or wheel delta:
+     *       INT X, Y;
+     * RETURNS:
+     *   (event_script &) self reference.
+     */
+    event_script & Add( INT Frame, event_type Type, BYTE Key = 0, INT X = 0, INT Y = 0 )
+    {
+      step S;
+      auto Pos = std::upper_bound(Steps.begin(), Steps.end(), Frame,
+        []( INT F, const step &St ){ return F < St.Frame; });
+
+      S.Frame = Frame;
+      S.E.Type = Type;
+      S.E.Key = Key;
+      S.E.X = X;
+      S.E.Y = Y;
+      S.E.Time = Frame * FrameTime;
+      Steps.insert(Pos, S);
+      return *this;
+    } /* End of 'Add' function */
+
+    /* Put events of frame to queue function (call before input response of frame).
+     * ARGUMENTS:
+     *   - frame number:
+     *       INT Frame;
+     *   - queue to put events to:
+     *       event_queue &Queue;
+     * RETURNS:
+     *   (INT) number of put events.
+     */
+    INT Feed( INT Frame, event_queue &Queue )
+    {
+      INT n = 0;
+
+      for (; Next < Steps.size() && Steps[Next].Frame <= Frame; Next++, n++)
+        Queue.Push(Steps[Next].E);
+      return n;
+    } /* End of 'Feed' function */
+
+    /* Restart script from first event function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Rewind( VOID )
+    {
+      Next = 0;
+    } /* End of 'Rewind' function */
+  }; /* end of 'event_script' class */
+} /* end of 'nidx' spacename */
+#endif // !_events_h_
+
+/* END OF 'events.h' FILE */
@@ -7,8 +7,10 @@
   * PURPOSE     : T51DX12 project.
   *               Input system declaration module.
   * PROGRAMMER  : ND4.
-  * LAST UPDATE : 07.10.2021
-  * NOTE        : None.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Platform independent except joystick polling (Windows
+  *               only). Any 'event_queue' producer can drive it, e.g.
+  *               'event_script' for headless checks.
   *
   * No part of this file may be changed without agreement of
   * Computer Graphics Support Group of 30 Phys-Math Lyceum
@@ -18,23 +20,49 @@
 #define _input_h_
 
 #include "../def.h"
-#include "../win/win.h"
+#ifdef _WIN32
+#  include "../win/win.h"
+#endif /* _WIN32 */
+#include "events.h"
+
+#include <map>
+#include <string>
+#include <vector>
 
 #define GET_JOYSTIC_AXIS(A) \
    (2.0 * (ji.dw ## A ## pos - jc.w ## A ## min) / (jc.w ## A ## max - jc.w ## A ## min) - 1)
 
 namespace nidx
 {
-  /* Timer class */
+  /* Input class */
   class input
   {
   private:
-    INT &Wheel;
+    event_queue *Queue;                 /* Events source */
+    BYTE Changed[256], IsChanged[256];  /* Keys changed during last response */
+    INT NumOfChanged;                   /* Number of changed keys */
+    std::map<std::string, std::vector<BYTE>> Actions; /* Action to keys bindings */
+
+    /* Mark key as changed on current frame function.
+     * ARGUMENTS:
+     *   - virtual key code:
+     *       BYTE Key;
+     * RETURNS: None.
+     */
+    VOID MarkChanged( BYTE Key )
+    {
+      if (!IsChanged[Key])
+      {
+        IsChanged[Key] = 1;
+        Changed[NumOfChanged++] = Key;
+      }
+    } /* End of 'MarkChanged' function */
+
   public:
     /* keyboard responsing */
     BYTE Keys[256];                /* state of keys on the current frame */
     BYTE KeysClick[256];           /* signs of a single click of the keyboard */
-    BYTE KeysOld[256];             /* state of keys on the current frame */
+    BYTE KeysOld[256];             /* state of keys on the previous frame */
 
     /* mouse responsing */
     INT MouseX, MouseY, MouseZ,    /* mouse coordinates */
@@ -46,7 +74,10 @@ namespace nidx
     DBL
       JX, JY, JZ, JR;               /* joystick axes */
 
-    input( INT &WheelRef ) : Wheel(WheelRef)
+    /* events of the current frame in arrival order with timestamps */
+    std::vector<input_event> FrameEvents;
+
+    input( event_queue &EventsQueue ) : Queue(&EventsQueue), NumOfChanged(0)
     {
       /* Mouse */
       MouseX = 0;
@@ -60,55 +91,154 @@ namespace nidx
       JY = 0;
       JZ = 0;
       JR = 0;
+      JPov = -1;
       /* Keyboard */
       ZeroMemory(Keys, 256);
       ZeroMemory(KeysClick, 256);
       ZeroMemory(KeysOld, 256);
+      ZeroMemory(IsChanged, 256);
       /* Joystick */
       ZeroMemory(JBut, 32);
       ZeroMemory(JButClick, 32);
       ZeroMemory(JButOld, 32);
+      FrameEvents.reserve(256);
     }
-    
-    /* Animation input keyboard response function.
+
+    /* Set events source function.
+     * ARGUMENTS:
+     *   - events queue to read from:
+     *       event_queue &EventsQueue;
+     * RETURNS: None.
+     */
+    VOID SetQueue( event_queue &EventsQueue )
+    {
+      Queue = &EventsQueue;
+    } /* End of 'SetQueue' function */
+
+    /* Animation input events response function.
      * ARGUMENTS: None.
      * RETURNS: None.
      */
-    VOID KeyboardResponse( VOID )
-    {    
-      if (GetKeyboardState(Keys))
+    VOID InputResponse( VOID )
+    {
+      input_event E;
+      INT OldX = MouseX, OldY = MouseY;
+
+      /* Only keys changed on previous frame differ from their old state */
+      for (INT i = 0; i < NumOfChanged; i++)
+      {
+        BYTE k = Changed[i];
+
+        KeysOld[k] = Keys[k];
+        KeysClick[k] = 0;
+        IsChanged[k] = 0;
+      }
+      NumOfChanged = 0;
+      FrameEvents.clear();
+      MouseDZ = 0;
+
+      while (Queue->Pop(E))
       {
-        for (INT i = 0; i < 256; i++)
+        FrameEvents.push_back(E);
+        switch (E.Type)
         {
-          Keys[i] >>= 7;
-          KeysClick[i] = Keys[i] && !KeysOld[i];
+        case event_type::KEY_DOWN:
+          /* Press is kept as click even if released before frame end */
+          if (!Keys[E.Key])
+          {
+            Keys[E.Key] = 1;
+            KeysClick[E.Key] = 1;
+            MarkChanged(E.Key);
+          }
+          break;
+        case event_type::KEY_UP:
+          if (Keys[E.Key])
+          {
+            Keys[E.Key] = 0;
+            MarkChanged(E.Key);
+          }
+          break;
+        case event_type::MOUSE_MOVE:
+          MouseX = E.X;
+          MouseY = E.Y;
+          break;
+        case event_type::MOUSE_WHEEL:
+          MouseDZ += E.X;
+          break;
+        case event_type::FOCUS_LOST:
+          for (INT i = 0; i < 256; i++)
+            if (Keys[i])
+            {
+              Keys[i] = 0;
+              MarkChanged((BYTE)i);
+            }
+          break;
         }
-        memcpy(KeysOld, Keys, 256);
       }
-    } /* End of 'KeyboardResponse' function */
+      MouseDX = MouseX - OldX;
+      MouseDY = MouseY - OldY;
+      MouseZ += MouseDZ;
+    } /* End of 'InputResponse' function */
 
-    /* Animation input mouse response function.
-     * ARGUMENTS: None.
+    /* Bind key to action function.
+     * ARGUMENTS:
+     *   - action name:
+     *       const std::string &Action;
+     *   - virtual key code:
+     *       BYTE Key;
+     * RETURNS: None.
+     */
+    VOID Bind( const std::string &Action, BYTE Key )
+    {
+      Actions[Action].push_back(Key);
+    } /* End of 'Bind' function */
+
+    /* Remove all action bindings function.
+     * ARGUMENTS:
+     *   - action name:
+     *       const std::string &Action;
      * RETURNS: None.
      */
-    VOID MouseResponse( HWND hWnd )
+    VOID Unbind( const std::string &Action )
+    {
+      Actions.erase(Action);
+    } /* End of 'Unbind' function */
+
+    /* Check action is active function.
+     * ARGUMENTS:
+     *   - action name:
+     *       const std::string &Action;
+     * RETURNS:
+     *   (BOOL) TRUE if any bound key is pressed.
+     */
+    BOOL IsAction( const std::string &Action ) const
     {
-      POINT pt;
-    
-      GetCursorPos(&pt);
-      ScreenToClient(hWnd, &pt);
-    
-      /* transform coordinates on the screen */
-      MouseDX = pt.x - MouseX;
-      MouseDY = pt.y - MouseY;
-      MouseDZ = Wheel;
-      /* absolute val */
-      MouseX = pt.x;
-      MouseY = pt.y;
-      MouseZ += Wheel;
-    
-      Wheel = 0;
-    } /* End of 'MouseResponse' function */ 
+      auto a = Actions.find(Action);
+
+      if (a != Actions.end())
+        for (BYTE k : a->second)
+          if (Keys[k])
+            return TRUE;
+      return FALSE;
+    } /* End of 'IsAction' function */
+
+    /* Check action is triggered on current frame function.
+     * ARGUMENTS:
+     *   - action name:
+     *       const std::string &Action;
+     * RETURNS:
+     *   (BOOL) TRUE if any bound key is clicked.
+     */
+    BOOL IsActionClick( const std::string &Action ) const
+    {
+      auto a = Actions.find(Action);
+
+      if (a != Actions.end())
+        for (BYTE k : a->second)
+          if (KeysClick[k])
+            return TRUE;
+      return FALSE;
+    } /* End of 'IsActionClick' function */
 
     /* Animation joystick response function.
      * ARGUMENTS: None.
@@ -116,6 +246,7 @@ namespace nidx
      */
     VOID JoystickResponse( VOID )
     {
+#ifdef _WIN32
       /* Joystick */
       if (joyGetNumDevs() > 0)
       {
@@ -149,6 +280,7 @@ namespace nidx
           }
         }
       }
+#endif /* _WIN32 */
     } /* End of 'JoystickResponse' function */
   }; /* end of 'input' class */
 } /* end of 'nidx' spacename */
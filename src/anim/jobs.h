@@ -0,0 +1,205 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : jobs.h
+  * PURPOSE     : T51DX12 project.
+  *               Worker threads pool declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : 'ParallelFor' called from inside a job runs inline with
+  *               calling thread index, so nested parallel loops do not
+  *               deadlock and per thread scratch is not shared.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _jobs_h_
+#define _jobs_h_
+
+#include "../def.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nidx
+{
+  /* Worker threads pool class */
+  class jobs
+  {
+  public:
+    /* Job function type: called with item index and thread index */
+    typedef std::function<VOID( INT Index, INT Thread )> job;
+
+  private:
+    std::vector<std::thread> Workers;     /* Worker threads */
+    std::mutex Lock, Serial;              /* State and submission locks */
+    std::condition_variable Wake, Done;   /* Worker wake up and job done signals */
+    const job *Func;                      /* Current job */
+    INT Count;                            /* Number of current job items */
+    std::atomic<INT> Next;                /* Next item to take */
+    INT Active;                           /* Workers still busy with current job */
+    UINT64 Generation;                    /* Current job number */
+    BOOL IsExit;                          /* Workers exit flag */
+
+    /* Pool and thread index the calling thread runs jobs for */
+    struct runner
+    {
+      const jobs *Pool; /* Pool (nullptr if thread runs no jobs) */
+      INT Index;        /* Thread index in pool */
+    }; /* end of 'runner' structure */
+
+    /* Obtain calling thread runner function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (runner &) calling thread runner.
+     */
+    static runner & Runner( VOID )
+    {
+      thread_local runner R {nullptr, 0};
+
+      return R;
+    } /* End of 'Runner' function */
+
+    /* Take and run items of current job function.
+     * ARGUMENTS:
+     *   - thread index:
+     *       INT Thread;
+     * RETURNS: None.
+     */
+    VOID Work( INT Thread )
+    {
+      for (INT i; (i = Next.fetch_add(1)) < Count; )
+        (*Func)(i, Thread);
+    } /* End of 'Work' function */
+
+  public:
+    /* Pool initializing function.
+     * ARGUMENTS:
+     *   - number of worker threads (-1 - one less than hardware threads):
+     *       INT NumOfWorkers;
+     */
+    jobs( INT NumOfWorkers = -1 ) : Func(nullptr), Count(0), Next(0), Active(0), Generation(0), IsExit(FALSE)
+    {
+      if (NumOfWorkers < 0)
+        NumOfWorkers = (INT)std::thread::hardware_concurrency() - 1;
+      for (INT t = 1; t <= NumOfWorkers; t++)
+        Workers.push_back(std::thread([this, t]( VOID )
+          {
+            UINT64 Seen = 0;
+
+            Runner() = {this, t};
+            while (TRUE)
+            {
+              std::unique_lock<std::mutex> L(Lock);
+
+              Wake.wait(L, [&]( VOID ){ return IsExit || Generation != Seen; });
+              if (IsExit)
+                return;
+              Seen = Generation;
+              L.unlock();
+              Work(t);
+              L.lock();
+              if (--Active == 0)
+                Done.notify_all();
+            }
+          }));
+    } /* End of 'jobs' function */
+
+    /* Pool deinitializing function.
+     * ARGUMENTS: None.
+     */
+    ~jobs( VOID )
+    {
+      {
+        std::lock_guard<std::mutex> L(Lock);
+
+        IsExit = TRUE;
+      }
+      Wake.notify_all();
+      for (auto &w : Workers)
+        w.join();
+    } /* End of '~jobs' function */
+
+    /* Obtain number of threads including caller function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) number of threads, thread indices are less than it.
+     */
+    INT GetNumOfThreads( VOID ) const
+    {
+      return (INT)Workers.size() + 1;
+    } /* End of 'GetNumOfThreads' function */
+
+    /* Run job for every index in [0, Count) and wait function.
+     * Thread index passed to job is unique among threads running
+     * at the moment, nested calls keep index of calling thread.
+     * ARGUMENTS:
+     *   - number of items:
+     *       INT Count;
+     *   - job function:
+     *       const job &Func;
+     * RETURNS: None.
+     */
+    VOID ParallelFor( INT Count, const job &Func )
+    {
+      const runner Caller = Runner();
+
+      if (Count <= 0)
+        return;
+      if (Caller.Pool == this)
+      {
+        for (INT i = 0; i < Count; i++)
+          Func(i, Caller.Index);
+        return;
+      }
+      /* Index 0 belongs to one submitting thread at a time,
+       * it also runs its own nested calls inline */
+      std::lock_guard<std::mutex> S(Serial);
+
+      Runner() = {this, 0};
+      if (Workers.empty() || Count == 1)
+        for (INT i = 0; i < Count; i++)
+          Func(i, 0);
+      else
+      {
+        {
+          std::lock_guard<std::mutex> L(Lock);
+
+          this->Func = &Func;
+          this->Count = Count;
+          Next = 0;
+          Active = (INT)Workers.size();
+          Generation++;
+        }
+        Wake.notify_all();
+        Work(0);
+        std::unique_lock<std::mutex> L(Lock);
+
+        Done.wait(L, [this]( VOID ){ return Active == 0; });
+      }
+      Runner() = Caller;
+    } /* End of 'ParallelFor' function */
+
+    /* Obtain global pool function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (jobs &) global pool.
+     */
+    static jobs & Get( VOID )
+    {
+      static jobs Pool;
+
+      return Pool;
+    } /* End of 'Get' function */
+  }; /* end of 'jobs' class */
+} /* end of 'nidx' spacename */
+#endif // !_jobs_h_
+
+/* END OF 'jobs.h' FILE */
@@ -0,0 +1,201 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : pacer.h
+  * PURPOSE     : T51DX12 project.
+  *               Frame pacing declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Policy only - no platform calls. Clock and sleep are
+  *               supplied by the caller, so the pacer can be driven by
+  *               a simulated display clock ('pacer_fake_clock' benchmark).
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _pacer_h_
+#define _pacer_h_
+
+#include "../def.h"
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace nidx
+{
+  /* Frame pacing controller class */
+  class pacer
+  {
+  public:
+    /* Clock and sleep function types (time in seconds) */
+    typedef std::function<DBL( VOID )> clock;
+    typedef std::function<VOID( DBL )> sleeper;
+
+  private:
+    clock Clock;         /* Time source */
+    sleeper Sleep;       /* Wait function */
+    DBL
+      NextPresent,       /* Planned present time of current frame */
+      InputTime,         /* Input sampling time of current frame */
+      WorkTime;          /* Smoothed input-to-present work time */
+
+  public:
+    DBL
+      TargetFPS,         /* Target frame rate (0 - not limited) */
+      Margin,            /* Safety margin before planned present */
+      Latency,           /* Smoothed input-to-present latency */
+      LatencyMax,        /* Maximum input-to-present latency */
+      LastLatency;       /* Last frame input-to-present latency */
+    UINT64
+      PresentCounter,    /* Number of presented frames */
+      MissCounter;       /* Number of frames presented after plan */
+
+    /* System steady clock function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (DBL) time in seconds.
+     */
+    static DBL SystemClock( VOID )
+    {
+      return std::chrono::duration<DBL>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    } /* End of 'SystemClock' function */
+
+    /* System sleep function.
+     * ARGUMENTS:
+     *   - time to sleep in seconds:
+     *       DBL Time;
+     * RETURNS: None.
+     */
+    static VOID SystemSleep( DBL Time )
+    {
+      std::this_thread::sleep_for(std::chrono::duration<DBL>(Time));
+    } /* End of 'SystemSleep' function */
+
+    /* Pacer initializing function.
+     * ARGUMENTS:
+     *   - target frame rate (0 - not limited):
+     *       DBL FPS;
+     *   - time source and wait functions:
+     *       clock Clk;
+     *       sleeper Slp;
+     */
+    pacer( DBL FPS = 60, clock Clk = SystemClock, sleeper Slp = SystemSleep ) :
+      Clock(Clk), Sleep(Slp), NextPresent(0), InputTime(0), WorkTime(0),
+      TargetFPS(FPS), Margin(0.001), Latency(0), LatencyMax(0), LastLatency(0),
+      PresentCounter(0), MissCounter(0)
+    {
+      NextPresent = Clock();
+    } /* End of 'pacer' function */
+
+    /* Obtain time to wait before input sampling function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (DBL) time to wait in seconds (0 - sample now).
+     */
+    DBL GetWaitTime( VOID ) const
+    {
+      DBL Wait;
+
+      if (TargetFPS <= 0)
+        return 0;
+      /* Sample input as late as possible but finish before planned present */
+      Wait = NextPresent - WorkTime - Margin - Clock();
+      return Wait > 0 ? Wait : 0;
+    } /* End of 'GetWaitTime' function */
+
+    /* Obtain input sampling time of current frame function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (DBL) time in seconds of pacer clock.
+     */
+    DBL GetInputTime( VOID ) const
+    {
+      return InputTime;
+    } /* End of 'GetInputTime' function */
+
+    /* Wait until input sampling point function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Pace( VOID )
+    {
+      DBL Wait = GetWaitTime();
+
+      if (Wait > 0)
+        Sleep(Wait);
+    } /* End of 'Pace' function */
+
+    /* Mark input sampling of current frame function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID InputSampled( VOID )
+    {
+      InputTime = Clock();
+    } /* End of 'InputSampled' function */
+
+    /* Mark present of current frame function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Presented( VOID )
+    {
+      Presented(Clock());
+    } /* End of 'Presented' function */
+
+    /* Mark present of current frame with known present time function.
+     * ARGUMENTS:
+     *   - present time (e.g. from display statistics):
+     *       DBL PresentTime;
+     * RETURNS: None.
+     */
+    VOID Presented( DBL PresentTime )
+    {
+      Presented(PresentTime, PresentTime - InputTime);
+    } /* End of 'Presented' function */
+
+    /* Mark present of frame with known latency function (frame presented on other thread).
+     * ARGUMENTS:
+     *   - present time:
+     *       DBL PresentTime;
+     *   - input sampling to present time of presented frame:
+     *       DBL FrameLatency;
+     * RETURNS: None.
+     */
+    VOID Presented( DBL PresentTime, DBL FrameLatency )
+    {
+      DBL FrameTime = TargetFPS > 0 ? 1 / TargetFPS : 0;
+
+      LastLatency = FrameLatency;
+      if (LastLatency < 0)
+        LastLatency = 0;
+      if (PresentCounter == 0)
+        Latency = WorkTime = LastLatency;
+      else
+      {
+        Latency += (LastLatency - Latency) * 0.1;
+        /* Grow fast on spikes, shrink slowly */
+        WorkTime += (LastLatency - WorkTime) * (LastLatency > WorkTime ? 0.5 : 0.05);
+      }
+      if (LastLatency > LatencyMax)
+        LatencyMax = LastLatency;
+
+      /* Plan next frame, resync after a miss instead of bursting */
+      if (TargetFPS > 0 && PresentCounter > 0 && PresentTime > NextPresent + Margin)
+        MissCounter++;
+      NextPresent += FrameTime;
+      /* Skip whole missed intervals to stay in phase with display refresh */
+      if (NextPresent < PresentTime)
+        NextPresent = FrameTime > 0 ?
+          NextPresent + ceil((PresentTime - NextPresent) / FrameTime) * FrameTime : PresentTime;
+      PresentCounter++;
+    } /* End of 'Presented' function */
+  }; /* end of 'pacer' class */
+} /* end of 'nidx' spacename */
+#endif // !_pacer_h_
+
+/* END OF 'pacer.h' FILE */
@@ -0,0 +1,610 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : accel.h
+  * PURPOSE     : T51DX12 project.
+  *               Ray tracing acceleration structures scheduling module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Backend independent. Manager decides every frame which
+  *               bottom level structures are built, refit, rebuilt or
+  *               compacted within time budget estimated by cost model,
+  *               the backend records returned operations in order:
+  *               builds and refits (one batch sharing frame scratch
+  *               block), compaction copies, top level build.
+  *               Deformed structures are always refit; they are rebuilt
+  *               (in place) when refits degraded them and budget allows.
+  *               New structures wait in FIFO, at least one is built per
+  *               frame. Static structures are compacted after backend
+  *               reports their compacted size ('SetCompactedSize').
+  *               Memory is obtained through allocator callbacks, freed
+  *               memory and scratch blocks wait for frame fence in
+  *               'retire_queue', scratch blocks then return to pool.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _accel_h_
+#define _accel_h_
+
+#include "../../def.h"
+#include "pool.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace nidx
+{
+  struct accel_tag;
+
+  typedef handle<accel_tag> accel_handle;
+
+  /* Acceleration structure operation types */
+  enum struct accel_op_type
+  {
+    BUILD,    /* Build bottom level structure */
+    REFIT,    /* Update bottom level structure in place */
+    COMPACT,  /* Copy built structure into compacted memory */
+    TLAS,     /* Build top level structure */
+  }; /* End of 'accel_op_type' enum */
+
+  /* Backend memory allocation structure */
+  struct accel_alloc
+  {
+    UINT64
+      Id,    /* Backend allocation identifier (0 - none) */
+      Size;  /* Size in bytes */
+  }; /* End of 'accel_alloc' structure */
+
+  /* Backend memory callbacks structure (empty functions - bookkeeping only) */
+  struct accel_allocator
+  {
+    std::function<UINT64( UINT64 Size, BOOL IsScratch )> Create; /* Allocate memory, returns identifier */
+    std::function<VOID( UINT64 Id )> Release;                     /* Free memory (GPU is done with it) */
+  }; /* End of 'accel_allocator' structure */
+
+  /* Build cost model structure (fill from GPU timings and prebuild info) */
+  struct accel_cost
+  {
+    DBL
+      OpUs,                /* Fixed cost of every operation in microseconds */
+      BuildNsPerTri,       /* Build cost per triangle */
+      RefitNsPerTri,       /* Refit cost per triangle */
+      CopyNsPerKb,         /* Compaction copy cost per kilobyte */
+      TlasNsPerInstance;   /* Top level build cost per instance */
+    UINT64
+      ResultBytesPerTri,   /* Built structure size per triangle */
+      ScratchBytesPerTri,  /* Build scratch size per triangle */
+      RefitBytesPerTri,    /* Refit scratch size per triangle */
+      TlasBytesPerInstance; /* Top level structure and scratch size per instance */
+  }; /* End of 'accel_cost' structure */
+
+  /* Bottom level structure description structure */
+  struct accel_desc
+  {
+    INT NumOfTris;         /* Number of triangles */
+    BOOL IsDynamic;        /* Deformable (refit allowed, never compacted) */
+    UINT64
+      ResultSize,          /* Prebuild info sizes (0 - estimate by cost model) */
+      ScratchSize,
+      RefitSize;
+  }; /* End of 'accel_desc' structure */
+
+  /* Scheduled operation structure */
+  struct accel_op
+  {
+    accel_op_type Type;    /* Operation type */
+    accel_handle Blas;     /* Bottom level structure (null for top level) */
+    UINT64
+      Dest,                /* Destination memory identifier */
+      Src,                 /* Source memory identifier (refit and compaction) */
+      ScratchOffset;       /* Offset in frame scratch block */
+    DBL Ms;                /* Estimated cost in milliseconds */
+  }; /* End of 'accel_op' structure */
+
+  /* Frame schedule structure */
+  struct accel_frame
+  {
+    std::vector<accel_op> Ops; /* Operations in record order */
+    accel_alloc Scratch;       /* Scratch block of frame */
+    DBL Ms;                    /* Estimated cost in milliseconds */
+    INT
+      NumOfBuilds,             /* Numbers of operations by type */
+      NumOfRebuilds,
+      NumOfRefits,
+      NumOfCompactions,
+      NumOfWaiting;            /* Number of structures left for next frames */
+  }; /* End of 'accel_frame' structure */
+
+  /* Memory statistics structure */
+  struct accel_stats
+  {
+    UINT64
+      ResultBytes,             /* Bottom and top level structures memory */
+      ScratchBytes,            /* Scratch pool memory (used and free) */
+      CompactedBytes;          /* Memory saved by compaction */
+    INT
+      NumOfReady,              /* Number of built bottom level structures */
+      NumOfScratchBlocks;      /* Number of scratch blocks created */
+  }; /* End of 'accel_stats' structure */
+
+  /* Acceleration structures manager class */
+  class accel_manager
+  {
+  public:
+    static const UINT64 Alignment = 256; /* Structure and scratch placement alignment */
+
+    accel_cost Cost;           /* Cost model */
+    INT MaxRefits;             /* Refits after which structure asks for rebuild */
+    UINT64 MaxScratchSize;     /* Frame scratch limit */
+
+  private:
+    /* Bottom level structure state types */
+    enum struct state
+    {
+      WAITING,   /* Not built yet */
+      BUILT,     /* Built, compacted size unknown */
+      SIZED,     /* Compacted size reported, waiting for copy */
+      DONE,      /* Compacted (or dynamic) */
+    }; /* End of 'state' enum */
+
+    /* Bottom level structure */
+    struct blas
+    {
+      accel_handle Self;       /* Own handle */
+      accel_desc Desc;         /* Description */
+      state State;             /* State */
+      accel_alloc Memory;      /* Structure memory */
+      UINT64 CompactedSize;    /* Reported compacted size */
+      INT Refits;              /* Refits since last build */
+      FLT Deformation;         /* Deformation since last build */
+      BOOL IsDirty;            /* Deformed since last frame */
+    }; /* End of 'blas' structure */
+
+    accel_allocator Allocator; /* Backend memory callbacks */
+    pool<blas, accel_tag> Blases; /* Bottom level structures */
+    std::deque<accel_handle>
+      Waiting,                 /* Structures to build in order */
+      Sized;                   /* Structures to compact in order */
+    std::vector<accel_handle> Dirty; /* Structures deformed since last frame */
+    std::vector<std::pair<FLT, accel_op *>> Rebuilds; /* Rebuild candidates scratch */
+    std::vector<accel_alloc> FreeScratch; /* Scratch blocks ready for reuse */
+    retire_queue Retired;      /* Memory waiting for frame fences */
+    accel_alloc Tlas;          /* Top level structure memory */
+    accel_frame Frame;         /* Last frame schedule */
+    accel_stats Stats;         /* Memory statistics */
+    UINT64 NextId;             /* Identifier counter without allocator */
+
+    /* Align size function.
+     * ARGUMENTS:
+     *   - size:
+     *       UINT64 Size;
+     * RETURNS:
+     *   (UINT64) size rounded up to 'Alignment'.
+     */
+    static UINT64 Align( UINT64 Size )
+    {
+      return (Size + Alignment - 1) & ~(Alignment - 1);
+    } /* End of 'Align' function */
+
+    /* Allocate memory function.
+     * ARGUMENTS:
+     *   - size in bytes:
+     *       UINT64 Size;
+     *   - scratch memory flag:
+     *       BOOL IsScratch;
+     * RETURNS:
+     *   (accel_alloc) allocation.
+     */
+    accel_alloc Allocate( UINT64 Size, BOOL IsScratch )
+    {
+      accel_alloc A;
+
+      A.Id = Allocator.Create ? Allocator.Create(Size, IsScratch) : ++NextId;
+      A.Size = Size;
+      if (IsScratch)
+        Stats.ScratchBytes += Size, Stats.NumOfScratchBlocks++;
+      else
+        Stats.ResultBytes += Size;
+      return A;
+    } /* End of 'Allocate' function */
+
+    /* Free memory after fence function.
+     * ARGUMENTS:
+     *   - allocation:
+     *       accel_alloc A;
+     *   - fence value signaled after last use:
+     *       UINT64 FenceValue;
+     * RETURNS: None.
+     */
+    VOID Free( accel_alloc A, UINT64 FenceValue )
+    {
+      if (A.Id == 0)
+        return;
+      Stats.ResultBytes -= A.Size;
+      Retired.Retire(FenceValue, [this, A]( VOID )
+        {
+          if (Allocator.Release)
+            Allocator.Release(A.Id);
+        });
+    } /* End of 'Free' function */
+
+    /* Estimate operation cost function.
+     * ARGUMENTS:
+     *   - operation type:
+     *       accel_op_type Type;
+     *   - number of triangles, instances or compacted kilobytes:
+     *       DBL Count;
+     * RETURNS:
+     *   (DBL) cost in milliseconds.
+     */
+    DBL Estimate( accel_op_type Type, DBL Count ) const
+    {
+      DBL Ns =
+        Type == accel_op_type::BUILD ? Cost.BuildNsPerTri :
+        Type == accel_op_type::REFIT ? Cost.RefitNsPerTri :
+        Type == accel_op_type::COMPACT ? Cost.CopyNsPerKb : Cost.TlasNsPerInstance;
+
+      return Cost.OpUs * 1e-3 + Count * Ns * 1e-6;
+    } /* End of 'Estimate' function */
+
+  public:
+    /* Manager constructor.
+     * ARGUMENTS:
+     *   - backend memory callbacks:
+     *       const accel_allocator &NewAllocator;
+     */
+    accel_manager( const accel_allocator &NewAllocator = accel_allocator() ) :
+      Cost{5, 0.5, 0.1, 0.5, 2, 64, 32, 8, 128}, MaxRefits(32), MaxScratchSize((UINT64)64 << 20),
+      Allocator(NewAllocator), Tlas{0, 0}, Frame(), Stats(), NextId(0)
+    {
+    } /* End of 'accel_manager' function */
+
+    /* Manager destructor (GPU must be idle).
+     * ARGUMENTS: None.
+     */
+    ~accel_manager( VOID )
+    {
+      Retired.Flush();
+      if (Allocator.Release)
+      {
+        for (auto &B : Blases)
+          if (B.Memory.Id != 0)
+            Allocator.Release(B.Memory.Id);
+        for (auto &A : FreeScratch)
+          Allocator.Release(A.Id);
+        if (Tlas.Id != 0)
+          Allocator.Release(Tlas.Id);
+      }
+    } /* End of '~accel_manager' function */
+
+    /* Add bottom level structure function.
+     * ARGUMENTS:
+     *   - description:
+     *       const accel_desc &Desc;
+     * RETURNS:
+     *   (accel_handle) structure handle.
+     */
+    accel_handle Add( const accel_desc &Desc )
+    {
+      blas B {};
+      accel_handle H;
+
+      B.Desc = Desc;
+      if (B.Desc.ResultSize == 0)
+        B.Desc.ResultSize = Desc.NumOfTris * Cost.ResultBytesPerTri;
+      if (B.Desc.ScratchSize == 0)
+        B.Desc.ScratchSize = Desc.NumOfTris * Cost.ScratchBytesPerTri;
+      if (B.Desc.RefitSize == 0)
+        B.Desc.RefitSize = Desc.NumOfTris * Cost.RefitBytesPerTri;
+      B.State = state::WAITING;
+      H = Blases.Add(B);
+      Blases.Get(H)->Self = H;
+      Waiting.push_back(H);
+      return H;
+    } /* End of 'Add' function */
+
+    /* Remove bottom level structure function.
+     * ARGUMENTS:
+     *   - structure handle:
+     *       accel_handle H;
+     *   - fence value signaled after last frame using structure:
+     *       UINT64 FenceValue;
+     * RETURNS: None.
+     */
+    VOID Remove( accel_handle H, UINT64 FenceValue )
+    {
+      blas B;
+
+      /* Queues drop stale handles lazily */
+      if (Blases.Remove(H, &B))
+        Free(B.Memory, FenceValue);
+    } /* End of 'Remove' function */
+
+    /* Mark deformed structure function.
+     * ARGUMENTS:
+     *   - structure handle:
+     *       accel_handle H;
+     *   - deformation amount (1 - structure needs rebuild):
+     *       FLT Amount;
+     * RETURNS: None.
+     */
+    VOID Deform( accel_handle H, FLT Amount = 0 )
+    {
+      blas *B = Blases.Get(H);
+
+      if (B == nullptr || !B->Desc.IsDynamic)
+        return;
+      B->Deformation += Amount;
+      if (!B->IsDirty)
+      {
+        B->IsDirty = TRUE;
+        Dirty.push_back(H);
+      }
+    } /* End of 'Deform' function */
+
+    /* Report compacted size of built structure function.
+     * ARGUMENTS:
+     *   - structure handle:
+     *       accel_handle H;
+     *   - compacted size from postbuild info:
+     *       UINT64 Size;
+     * RETURNS: None.
+     */
+    VOID SetCompactedSize( accel_handle H, UINT64 Size )
+    {
+      blas *B = Blases.Get(H);
+
+      if (B == nullptr || B->State != state::BUILT)
+        return;
+      B->CompactedSize = Align(Size);
+      if (B->CompactedSize >= B->Memory.Size)
+        B->State = state::DONE;
+      else
+      {
+        B->State = state::SIZED;
+        Sized.push_back(H);
+      }
+    } /* End of 'SetCompactedSize' function */
+
+    /* Check structure is built function.
+     * ARGUMENTS:
+     *   - structure handle:
+     *       accel_handle H;
+     * RETURNS:
+     *   (BOOL) TRUE if structure may be instanced in top level.
+     */
+    BOOL IsReady( accel_handle H )
+    {
+      blas *B = Blases.Get(H);
+
+      return B != nullptr && B->State != state::WAITING;
+    } /* End of 'IsReady' function */
+
+    /* Obtain structure memory function.
+     * ARGUMENTS:
+     *   - structure handle:
+     *       accel_handle H;
+     * RETURNS:
+     *   (accel_alloc) memory (zero identifier if not built).
+     */
+    accel_alloc GetMemory( accel_handle H )
+    {
+      blas *B = Blases.Get(H);
+
+      return B == nullptr ? accel_alloc{0, 0} : B->Memory;
+    } /* End of 'GetMemory' function */
+
+    /* Schedule frame operations function.
+     * ARGUMENTS:
+     *   - time budget in milliseconds:
+     *       DBL BudgetMs;
+     *   - fence value signaled after frame operations:
+     *       UINT64 FenceValue;
+     * RETURNS:
+     *   (const accel_frame &) frame schedule.
+     */
+    const accel_frame & Schedule( DBL BudgetMs, UINT64 FenceValue )
+    {
+      UINT64 ScratchSize = 0;
+      INT NumOfInstances = 0;
+      DBL TlasMs;
+
+      Frame.Ops.clear();
+      Frame.Ms = 0;
+      Frame.NumOfBuilds = Frame.NumOfRebuilds = Frame.NumOfRefits = Frame.NumOfCompactions = 0;
+
+      /* Top level is rebuilt every frame, reserve its cost first */
+      for (auto &B : Blases)
+        NumOfInstances += B.State != state::WAITING;
+      Frame.Ms = Estimate(accel_op_type::TLAS, NumOfInstances);
+
+      /* Refits are required for correct image, so they ignore budget */
+      Rebuilds.clear();
+      for (accel_handle H : Dirty)
+      {
+        blas *B = Blases.Get(H);
+
+        if (B == nullptr)
+          continue;
+        B->IsDirty = FALSE;
+        if (B->State == state::WAITING)
+          continue;
+        Frame.Ops.push_back({accel_op_type::REFIT, H, B->Memory.Id, B->Memory.Id, ScratchSize,
+          Estimate(accel_op_type::REFIT, B->Desc.NumOfTris)});
+        Frame.Ms += Frame.Ops.back().Ms;
+        ScratchSize += Align(B->Desc.RefitSize);
+        B->Refits++;
+        Frame.NumOfRefits++;
+      }
+      Dirty.clear();
+
+      /* New structures in order, first one regardless of budget */
+      while (!Waiting.empty())
+      {
+        blas *B = Blases.Get(Waiting.front());
+        DBL Ms, TlasGrowthMs;
+
+        if (B == nullptr)
+        {
+          Waiting.pop_front();
+          continue;
+        }
+        /* New instance also makes top level build longer */
+        Ms = Estimate(accel_op_type::BUILD, B->Desc.NumOfTris);
+        TlasGrowthMs = Estimate(accel_op_type::TLAS, NumOfInstances + Frame.NumOfBuilds + 1) -
+                       Estimate(accel_op_type::TLAS, NumOfInstances + Frame.NumOfBuilds);
+        if (Frame.NumOfBuilds > 0 &&
+            (Frame.Ms + Ms + TlasGrowthMs > BudgetMs || ScratchSize + B->Desc.ScratchSize > MaxScratchSize))
+          break;
+        B->Memory = Allocate(Align(B->Desc.ResultSize), FALSE);
+        B->State = B->Desc.IsDynamic ? state::DONE : state::BUILT;
+        Frame.Ops.push_back({accel_op_type::BUILD, B->Self, B->Memory.Id, 0, ScratchSize, Ms});
+        Frame.Ms += Ms + TlasGrowthMs;
+        ScratchSize += Align(B->Desc.ScratchSize);
+        Frame.NumOfBuilds++;
+        Waiting.pop_front();
+      }
+      Frame.NumOfWaiting = (INT)Waiting.size();
+
+      /* Most degraded refits are replaced by rebuilds while budget allows */
+      for (auto &Op : Frame.Ops)
+        if (Op.Type == accel_op_type::REFIT)
+        {
+          blas *B = Blases.Get(Op.Blas);
+          FLT Degradation = (FLT)B->Refits / MaxRefits + B->Deformation;
+
+          if (Degradation >= 1)
+            Rebuilds.push_back({Degradation, &Op});
+        }
+      std::sort(Rebuilds.begin(), Rebuilds.end(),
+        []( const std::pair<FLT, accel_op *> &A, const std::pair<FLT, accel_op *> &B )
+        {
+          return A.first > B.first;
+        });
+      for (auto &R : Rebuilds)
+      {
+        blas *B = Blases.Get(R.second->Blas);
+        DBL Ms = Estimate(accel_op_type::BUILD, B->Desc.NumOfTris);
+
+        if (Frame.Ms - R.second->Ms + Ms > BudgetMs ||
+            ScratchSize + Align(B->Desc.ScratchSize) > MaxScratchSize)
+          continue;
+        /* Rebuild in place into scratch appended at the end */
+        Frame.Ms += Ms - R.second->Ms;
+        R.second->Type = accel_op_type::BUILD;
+        R.second->Src = 0;
+        R.second->Ms = Ms;
+        R.second->ScratchOffset = ScratchSize;
+        ScratchSize += Align(B->Desc.ScratchSize);
+        B->Refits = 0;
+        B->Deformation = 0;
+        Frame.NumOfRefits--;
+        Frame.NumOfRebuilds++;
+      }
+
+      /* Compaction copies with the rest of budget */
+      while (!Sized.empty())
+      {
+        blas *B = Blases.Get(Sized.front());
+        accel_alloc Old;
+        DBL Ms;
+
+        if (B == nullptr || B->State != state::SIZED)
+        {
+          Sized.pop_front();
+          continue;
+        }
+        Ms = Estimate(accel_op_type::COMPACT, B->CompactedSize / 1024.0);
+        if (Frame.Ms + Ms > BudgetMs)
+          break;
+        Old = B->Memory;
+        B->Memory = Allocate(B->CompactedSize, FALSE);
+        B->State = state::DONE;
+        Stats.CompactedBytes += Old.Size - B->CompactedSize;
+        Free(Old, FenceValue);
+        Frame.Ops.push_back({accel_op_type::COMPACT, B->Self, B->Memory.Id, Old.Id, 0, Ms});
+        Frame.Ms += Ms;
+        Frame.NumOfCompactions++;
+        Sized.pop_front();
+      }
+
+      /* Top level structure over all built ones (grows twice), its cost is already counted */
+      TlasMs = Estimate(accel_op_type::TLAS, NumOfInstances + Frame.NumOfBuilds);
+      NumOfInstances += Frame.NumOfBuilds;
+      if (Tlas.Size < NumOfInstances * Cost.TlasBytesPerInstance)
+      {
+        Free(Tlas, FenceValue);
+        Tlas = Allocate(Align(NumOfInstances * Cost.TlasBytesPerInstance * 2), FALSE);
+      }
+      if (NumOfInstances > 0)
+      {
+        Frame.Ops.push_back({accel_op_type::TLAS, accel_handle(), Tlas.Id, 0, ScratchSize, TlasMs});
+        ScratchSize += Align(NumOfInstances * Cost.TlasBytesPerInstance);
+      }
+
+      /* Frame scratch block: best fitting free one or new power of 2 block */
+      Frame.Scratch = {0, 0};
+      if (ScratchSize > 0)
+      {
+        auto Best = FreeScratch.end();
+
+        for (auto It = FreeScratch.begin(); It != FreeScratch.end(); ++It)
+          if (It->Size >= ScratchSize && (Best == FreeScratch.end() || It->Size < Best->Size))
+            Best = It;
+        if (Best != FreeScratch.end())
+        {
+          Frame.Scratch = *Best;
+          *Best = FreeScratch.back();
+          FreeScratch.pop_back();
+        }
+        else
+        {
+          UINT64 Size = (UINT64)1 << 20;
+
+          while (Size < ScratchSize)
+            Size *= 2;
+          Frame.Scratch = Allocate(Size, TRUE);
+        }
+        Retired.Retire(FenceValue, [this, Block = Frame.Scratch]( VOID )
+          {
+            FreeScratch.push_back(Block);
+          });
+      }
+      return Frame;
+    } /* End of 'Schedule' function */
+
+    /* Release memory of completed frames function.
+     * ARGUMENTS:
+     *   - last completed fence value:
+     *       UINT64 CompletedValue;
+     * RETURNS: None.
+     */
+    VOID Collect( UINT64 CompletedValue )
+    {
+      Retired.Collect(CompletedValue);
+    } /* End of 'Collect' function */
+
+    /* Obtain memory statistics function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (accel_stats) statistics.
+     */
+    accel_stats GetStats( VOID )
+    {
+      Stats.NumOfReady = 0;
+      for (auto &B : Blases)
+        Stats.NumOfReady += B.State != state::WAITING;
+      return Stats;
+    } /* End of 'GetStats' function */
+  }; /* end of 'accel_manager' class */
+} /* end of 'nidx' spacename */
+
+#endif // !_accel_h_
+
+/* END OF 'accel.h' FILE */
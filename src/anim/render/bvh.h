@@ -0,0 +1,640 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : bvh.h
+  * PURPOSE     : T51DX12 project.
+  *               Triangle bounding volume hierarchy and picking module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Hierarchy is built by binned SAH (16 bins), leaves keep
+  *               up to 4 triangles copied in build order.
+  *               Triangles are intersected by watertight test (Woop,
+  *               Benthin, Wald), both sides are hit, rays through shared
+  *               edges and vertices never fall between triangles.
+  *               Batched rays are traced by packets of 4 with SSE box
+  *               tests, so coherent rays (hover, gizmos) share nodes.
+  *               Picking uses GL-style projection ('matr::Frustum').
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _bvh_h_
+#define _bvh_h_
+
+#include "../../def.h"
+#include "../jobs.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define NIDX_BVH_SSE2
+#endif /* __SSE2__ */
+
+namespace nidx
+{
+  /* Ray structure */
+  struct bvh_ray
+  {
+    FLT
+      Org[3],   /* Origin */
+      Dir[3],   /* Direction (not necessary normalized) */
+      TMax;     /* Maximal distance in direction lengths */
+  }; /* End of 'bvh_ray' structure */
+
+  /* Ray hit structure */
+  struct bvh_hit
+  {
+    FLT T, U, V; /* Distance and barycentric coordinates of 2nd and 3rd vertices */
+    INT Tri;     /* Triangle index, -1 if nothing is hit */
+  }; /* End of 'bvh_hit' structure */
+
+  /* Triangle bounding volume hierarchy class */
+  class bvh
+  {
+  private:
+    static const INT
+      NumOfBins = 16,        /* SAH bins per axis */
+      MaxLeaf = 4,           /* Maximal triangles in leaf */
+      MaxDepth = 128,        /* Traversal stack size */
+      Packet = 4;            /* Rays in packet */
+
+    /* Node structure (32 bytes) */
+    struct node
+    {
+      FLT Min[3];
+      INT Start;             /* Left child (right is next) or first triangle */
+      FLT Max[3];
+      INT Count;             /* Number of triangles, 0 for inner node */
+    }; /* End of 'node' structure */
+
+    /* Prepared ray structure (watertight test shear) */
+    struct ray_pre
+    {
+      INT Kx, Ky, Kz;        /* Axes permutation, Kz - largest direction component */
+      FLT Sx, Sy, Sz;        /* Shear constants */
+      FLT Org[3];            /* Origin */
+    }; /* End of 'ray_pre' structure */
+
+    std::vector<node> Nodes; /* Nodes, root first */
+    std::vector<FLT> Tris;   /* Triangle vertices in leaf order, 9 per triangle */
+    std::vector<INT> TriIds; /* Source triangle indices in leaf order */
+
+    /* Prepare ray for triangle tests function.
+     * ARGUMENTS:
+     *   - ray:
+     *       const bvh_ray &R;
+     *   - prepared ray to fill:
+     *       ray_pre &P;
+     * RETURNS: None.
+     */
+    static VOID Prepare( const bvh_ray &R, ray_pre &P )
+    {
+      const FLT *d = R.Dir;
+
+      P.Kz = fabs(d[0]) > fabs(d[1]) ? (fabs(d[0]) > fabs(d[2]) ? 0 : 2) : (fabs(d[1]) > fabs(d[2]) ? 1 : 2);
+      P.Kx = (P.Kz + 1) % 3;
+      P.Ky = (P.Kx + 1) % 3;
+      /* Keep winding */
+      if (d[P.Kz] < 0)
+        std::swap(P.Kx, P.Ky);
+      P.Sx = d[P.Kx] / d[P.Kz];
+      P.Sy = d[P.Ky] / d[P.Kz];
+      P.Sz = 1 / d[P.Kz];
+      P.Org[0] = R.Org[0], P.Org[1] = R.Org[1], P.Org[2] = R.Org[2];
+    } /* End of 'Prepare' function */
+
+    /* Watertight ray-triangle intersection function.
+     * ARGUMENTS:
+     *   - prepared ray:
+     *       const ray_pre &P;
+     *   - triangle in leaf order:
+     *       INT T;
+     *   - closest hit to update (its 'T' limits distance):
+     *       bvh_hit &Hit;
+     * RETURNS:
+     *   (BOOL) TRUE if closer hit is found.
+     */
+    BOOL IntersectTri( const ray_pre &P, INT T, bvh_hit &Hit ) const
+    {
+      const FLT *v = &Tris[(size_t)T * 9];
+      FLT a[3], b[3], c[3], Ax, Ay, Bx, By, Cx, Cy, U, V, W, Det, Dist;
+
+      for (INT k = 0; k < 3; k++)
+        a[k] = v[k] - P.Org[k], b[k] = v[3 + k] - P.Org[k], c[k] = v[6 + k] - P.Org[k];
+      Ax = a[P.Kx] - P.Sx * a[P.Kz], Ay = a[P.Ky] - P.Sy * a[P.Kz];
+      Bx = b[P.Kx] - P.Sx * b[P.Kz], By = b[P.Ky] - P.Sy * b[P.Kz];
+      Cx = c[P.Kx] - P.Sx * c[P.Kz], Cy = c[P.Ky] - P.Sy * c[P.Kz];
+      U = Cx * By - Cy * Bx;
+      V = Ax * Cy - Ay * Cx;
+      W = Bx * Ay - By * Ax;
+      /* Edge exactly through ray - recompute in double precision */
+      if (U == 0 || V == 0 || W == 0)
+      {
+        U = (FLT)((DBL)Cx * By - (DBL)Cy * Bx);
+        V = (FLT)((DBL)Ax * Cy - (DBL)Ay * Cx);
+        W = (FLT)((DBL)Bx * Ay - (DBL)By * Ax);
+      }
+      if ((U < 0 || V < 0 || W < 0) && (U > 0 || V > 0 || W > 0))
+        return FALSE;
+      if ((Det = U + V + W) == 0)
+        return FALSE;
+      Dist = (U * P.Sz * a[P.Kz] + V * P.Sz * b[P.Kz] + W * P.Sz * c[P.Kz]) / Det;
+      if (Dist <= 0 || Dist >= Hit.T)
+        return FALSE;
+      Hit.T = Dist;
+      Hit.U = V / Det;
+      Hit.V = W / Det;
+      Hit.Tri = T;
+      return TRUE;
+    } /* End of 'IntersectTri' function */
+
+    /* Ray-box slab test function.
+     * ARGUMENTS:
+     *   - node:
+     *       const node &N;
+     *   - ray origin and inverse direction:
+     *       const FLT *O, *InvD;
+     *   - maximal distance:
+     *       FLT TMax;
+     *   - entry distance to fill:
+     *       FLT &TNear;
+     * RETURNS:
+     *   (BOOL) TRUE if box is hit closer than TMax.
+     */
+    static BOOL IsBoxHit( const node &N, const FLT *O, const FLT *InvD, FLT TMax, FLT &TNear )
+    {
+      FLT t0 = 0, t1 = TMax;
+
+      for (INT k = 0; k < 3; k++)
+      {
+        FLT a = (N.Min[k] - O[k]) * InvD[k], b = (N.Max[k] - O[k]) * InvD[k];
+
+        t0 = std::max(t0, std::min(a, b));
+        t1 = std::min(t1, std::max(a, b));
+      }
+      TNear = t0;
+      return t0 <= t1;
+    } /* End of 'IsBoxHit' function */
+
+#ifdef NIDX_BVH_SSE2
+    /* Trace packet of rays function.
+     * ARGUMENTS:
+     *   - rays (Packet of them, inactive lanes are nullptr):
+     *       const bvh_ray **R;
+     *   - hits to fill:
+     *       bvh_hit **H;
+     * RETURNS: None.
+     */
+    VOID TracePacket( const bvh_ray **R, bvh_hit **H ) const
+    {
+      __m128 O[3], InvD[3], TMax, TNear;
+      ray_pre P[Packet];
+      FLT Tm[Packet], Buf[Packet];
+      INT Stack[MaxDepth], Sp = 0, Ni = 0, Active = 0;
+
+      for (INT l = 0; l < Packet; l++)
+      {
+        H[l]->T = R[l] != nullptr ? R[l]->TMax : 0;
+        H[l]->Tri = -1;
+        H[l]->U = H[l]->V = 0;
+        Tm[l] = H[l]->T;
+        if (R[l] != nullptr)
+        {
+          Prepare(*R[l], P[l]);
+          Active |= 1 << l;
+        }
+      }
+      for (INT k = 0; k < 3; k++)
+      {
+        for (INT l = 0; l < Packet; l++)
+          Buf[l] = R[l] != nullptr ? R[l]->Org[k] : 0;
+        O[k] = _mm_loadu_ps(Buf);
+        for (INT l = 0; l < Packet; l++)
+          Buf[l] = R[l] != nullptr ? 1 / R[l]->Dir[k] : 0;
+        InvD[k] = _mm_loadu_ps(Buf);
+      }
+      TMax = _mm_loadu_ps(Tm);
+
+      /* Packet box test: lanes mask and entry distances */
+      auto BoxTest = [&]( const node &N, __m128 &TNear ) -> INT
+      {
+        __m128 t0 = _mm_setzero_ps(), t1 = TMax;
+
+        for (INT k = 0; k < 3; k++)
+        {
+          __m128
+            a = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(N.Min[k]), O[k]), InvD[k]),
+            b = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(N.Max[k]), O[k]), InvD[k]);
+
+          t0 = _mm_max_ps(t0, _mm_min_ps(a, b));
+          t1 = _mm_min_ps(t1, _mm_max_ps(a, b));
+        }
+        TNear = t0;
+        return _mm_movemask_ps(_mm_cmple_ps(t0, t1)) & Active;
+      };
+
+      if (Nodes.empty())
+        return;
+      if (BoxTest(Nodes[0], TNear) == 0)
+        return;
+      for (;;)
+      {
+        const node &N = Nodes[Ni];
+
+        if (N.Count == 0)
+        {
+          __m128 tl, tr;
+          INT ml = BoxTest(Nodes[N.Start], tl), mr = BoxTest(Nodes[N.Start + 1], tr);
+
+          if (ml != 0 && mr != 0)
+          {
+            FLT Nl[Packet], Nr[Packet], Dl = FLT_MAX, Dr = FLT_MAX;
+
+            /* Nearer child first by closest entry of hitting lanes */
+            _mm_storeu_ps(Nl, tl);
+            _mm_storeu_ps(Nr, tr);
+            for (INT l = 0; l < Packet; l++)
+            {
+              if (ml & (1 << l))
+                Dl = std::min(Dl, Nl[l]);
+              if (mr & (1 << l))
+                Dr = std::min(Dr, Nr[l]);
+            }
+            Stack[Sp++] = Dl <= Dr ? N.Start + 1 : N.Start;
+            Ni = Dl <= Dr ? N.Start : N.Start + 1;
+            continue;
+          }
+          if (ml != 0 || mr != 0)
+          {
+            Ni = ml != 0 ? N.Start : N.Start + 1;
+            continue;
+          }
+        }
+        else
+        {
+          for (INT l = 0; l < Packet; l++)
+            if (Active & (1 << l))
+              for (INT t = N.Start; t < N.Start + N.Count; t++)
+                IntersectTri(P[l], t, *H[l]);
+          for (INT l = 0; l < Packet; l++)
+            Tm[l] = H[l]->T;
+          TMax = _mm_loadu_ps(Tm);
+        }
+        /* Stacked node may be farther than hits found since */
+        do
+        {
+          if (Sp == 0)
+            return;
+          Ni = Stack[--Sp];
+        } while (BoxTest(Nodes[Ni], TNear) == 0);
+      }
+    } /* End of 'TracePacket' function */
+#endif /* NIDX_BVH_SSE2 */
+
+  public:
+    /* Build hierarchy by binned SAH function.
+     * ARGUMENTS:
+     *   - vertices, 3 floats per vertex:
+     *       const FLT *Pos;
+     *   - triangle indices, 3 per triangle:
+     *       const INT *Ind;
+     *   - number of triangles:
+     *       INT NumOfTris;
+     * RETURNS: None.
+     */
+    VOID Build( const FLT *Pos, const INT *Ind, INT NumOfTris )
+    {
+      std::vector<FLT> Center((size_t)NumOfTris * 3), Box((size_t)NumOfTris * 6);
+      std::vector<INT> Ids(NumOfTris), Stack;
+
+      Nodes.clear();
+      Tris.clear();
+      TriIds.clear();
+      if (NumOfTris <= 0)
+        return;
+      for (INT t = 0; t < NumOfTris; t++)
+      {
+        FLT *b = &Box[(size_t)t * 6];
+
+        Ids[t] = t;
+        for (INT k = 0; k < 3; k++)
+        {
+          b[k] = FLT_MAX, b[3 + k] = -FLT_MAX;
+          for (INT j = 0; j < 3; j++)
+            b[k] = std::min(b[k], Pos[Ind[t * 3 + j] * 3 + k]), b[3 + k] = std::max(b[3 + k], Pos[Ind[t * 3 + j] * 3 + k]);
+          Center[(size_t)t * 3 + k] = (b[k] + b[3 + k]) / 2;
+        }
+      }
+      Nodes.reserve((size_t)NumOfTris * 2);
+      Nodes.push_back({{0, 0, 0}, 0, {0, 0, 0}, NumOfTris});
+      Stack.push_back(0);
+      while (!Stack.empty())
+      {
+        INT Ni = Stack.back(), First, Count, BestAxis = -1, BestBin = 0, Mid;
+        FLT CMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, CMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX}, BestCost, Area;
+
+        Stack.pop_back();
+        First = Nodes[Ni].Start, Count = Nodes[Ni].Count;
+
+        /* Node bound and centers bound */
+        for (INT k = 0; k < 3; k++)
+          Nodes[Ni].Min[k] = FLT_MAX, Nodes[Ni].Max[k] = -FLT_MAX;
+        for (INT i = First; i < First + Count; i++)
+        {
+          const FLT *b = &Box[(size_t)Ids[i] * 6], *c = &Center[(size_t)Ids[i] * 3];
+
+          for (INT k = 0; k < 3; k++)
+          {
+            Nodes[Ni].Min[k] = std::min(Nodes[Ni].Min[k], b[k]), Nodes[Ni].Max[k] = std::max(Nodes[Ni].Max[k], b[3 + k]);
+            CMin[k] = std::min(CMin[k], c[k]), CMax[k] = std::max(CMax[k], c[k]);
+          }
+        }
+        if (Count <= MaxLeaf / 2)
+          continue;
+
+        /* Evaluate SAH of bin borders: cost = Area(L) * N(L) + Area(R) * N(R) + traversal,
+         * leaf costs Area * N (node traversal is counted as one triangle test) */
+        {
+          const FLT *m = Nodes[Ni].Min, *M = Nodes[Ni].Max;
+
+          Area = (M[0] - m[0]) * (M[1] - m[1]) + (M[1] - m[1]) * (M[2] - m[2]) + (M[2] - m[2]) * (M[0] - m[0]);
+        }
+        BestCost = Area * Count;
+        for (INT k = 0; k < 3; k++)
+        {
+          FLT BinMin[NumOfBins][3], BinMax[NumOfBins][3], Scale, L[NumOfBins], Lm[3], LM[3], Rm[3], RM[3];
+          INT BinCount[NumOfBins] = {0}, Ln = 0, Rn = 0;
+
+          if (CMax[k] - CMin[k] <= 0)
+            continue;
+          Scale = NumOfBins / (CMax[k] - CMin[k]);
+          for (INT b = 0; b < NumOfBins; b++)
+            for (INT j = 0; j < 3; j++)
+              BinMin[b][j] = FLT_MAX, BinMax[b][j] = -FLT_MAX;
+          for (INT i = First; i < First + Count; i++)
+          {
+            const FLT *b = &Box[(size_t)Ids[i] * 6];
+            INT Bin = std::min(NumOfBins - 1, (INT)((Center[(size_t)Ids[i] * 3 + k] - CMin[k]) * Scale));
+
+            BinCount[Bin]++;
+            for (INT j = 0; j < 3; j++)
+              BinMin[Bin][j] = std::min(BinMin[Bin][j], b[j]), BinMax[Bin][j] = std::max(BinMax[Bin][j], b[3 + j]);
+          }
+          /* Left sweep stores costs, right sweep adds them */
+          for (INT j = 0; j < 3; j++)
+            Lm[j] = Rm[j] = FLT_MAX, LM[j] = RM[j] = -FLT_MAX;
+          for (INT b = 0; b < NumOfBins - 1; b++)
+          {
+            Ln += BinCount[b];
+            for (INT j = 0; j < 3; j++)
+              Lm[j] = std::min(Lm[j], BinMin[b][j]), LM[j] = std::max(LM[j], BinMax[b][j]);
+            L[b] = Ln == 0 ? 0 : Ln * ((LM[0] - Lm[0]) * (LM[1] - Lm[1]) + (LM[1] - Lm[1]) * (LM[2] - Lm[2]) + (LM[2] - Lm[2]) * (LM[0] - Lm[0]));
+          }
+          for (INT b = NumOfBins - 1; b > 0; b--)
+          {
+            FLT Cost;
+
+            Rn += BinCount[b];
+            for (INT j = 0; j < 3; j++)
+              Rm[j] = std::min(Rm[j], BinMin[b][j]), RM[j] = std::max(RM[j], BinMax[b][j]);
+            Cost = Area + L[b - 1] + (Rn == 0 ? 0 : Rn * ((RM[0] - Rm[0]) * (RM[1] - Rm[1]) + (RM[1] - Rm[1]) * (RM[2] - Rm[2]) + (RM[2] - Rm[2]) * (RM[0] - Rm[0])));
+            if (Rn != 0 && Rn != Count && Cost < BestCost)
+              BestCost = Cost, BestAxis = k, BestBin = b;
+          }
+        }
+
+        /* No useful split - leaf, but too large leaves are split by median */
+        if (BestAxis < 0)
+        {
+          if (Count <= MaxLeaf)
+            continue;
+          Mid = First + Count / 2;
+          BestAxis = CMax[0] - CMin[0] > CMax[1] - CMin[1] ? (CMax[0] - CMin[0] > CMax[2] - CMin[2] ? 0 : 2) : (CMax[1] - CMin[1] > CMax[2] - CMin[2] ? 1 : 2);
+          std::nth_element(Ids.begin() + First, Ids.begin() + Mid, Ids.begin() + First + Count,
+            [&]( INT A, INT B ){ return Center[(size_t)A * 3 + BestAxis] < Center[(size_t)B * 3 + BestAxis]; });
+        }
+        else
+        {
+          FLT Scale = NumOfBins / (CMax[BestAxis] - CMin[BestAxis]);
+
+          Mid = (INT)(std::partition(Ids.begin() + First, Ids.begin() + First + Count,
+            [&]( INT t ){ return std::min(NumOfBins - 1, (INT)((Center[(size_t)t * 3 + BestAxis] - CMin[BestAxis]) * Scale)) < BestBin; }) - Ids.begin());
+        }
+        Nodes[Ni].Start = (INT)Nodes.size();
+        Nodes[Ni].Count = 0;
+        Nodes.push_back({{0, 0, 0}, First, {0, 0, 0}, Mid - First});
+        Nodes.push_back({{0, 0, 0}, Mid, {0, 0, 0}, First + Count - Mid});
+        Stack.push_back(Nodes[Ni].Start);
+        Stack.push_back(Nodes[Ni].Start + 1);
+      }
+
+      /* Copy triangles in leaf order */
+      Tris.resize((size_t)NumOfTris * 9);
+      TriIds = Ids;
+      for (INT i = 0; i < NumOfTris; i++)
+        for (INT j = 0; j < 3; j++)
+          for (INT k = 0; k < 3; k++)
+            Tris[(size_t)i * 9 + j * 3 + k] = Pos[Ind[Ids[i] * 3 + j] * 3 + k];
+    } /* End of 'Build' function */
+
+    /* Obtain number of nodes function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) number of nodes.
+     */
+    INT GetNumOfNodes( VOID ) const
+    {
+      return (INT)Nodes.size();
+    } /* End of 'GetNumOfNodes' function */
+
+    /* Obtain source triangle of hit function.
+     * ARGUMENTS:
+     *   - hit:
+     *       const bvh_hit &Hit;
+     * RETURNS:
+     *   (INT) triangle index in 'Build' indices, -1 if nothing is hit.
+     */
+    INT GetTriangle( const bvh_hit &Hit ) const
+    {
+      return Hit.Tri < 0 ? -1 : TriIds[Hit.Tri];
+    } /* End of 'GetTriangle' function */
+
+    /* Obtain vertices of hit triangle function.
+     * ARGUMENTS:
+     *   - hit (must hit anything):
+     *       const bvh_hit &Hit;
+     * RETURNS:
+     *   (const FLT *) 3 vertices, 3 floats each.
+     */
+    const FLT * GetVertices( const bvh_hit &Hit ) const
+    {
+      return &Tris[(size_t)Hit.Tri * 9];
+    } /* End of 'GetVertices' function */
+
+    /* Trace one ray function.
+     * ARGUMENTS:
+     *   - ray:
+     *       const bvh_ray &R;
+     *   - closest hit to fill:
+     *       bvh_hit &Hit;
+     * RETURNS:
+     *   (BOOL) TRUE if anything is hit.
+     */
+    BOOL Intersect( const bvh_ray &R, bvh_hit &Hit ) const
+    {
+      ray_pre P;
+      FLT InvD[3] = {1 / R.Dir[0], 1 / R.Dir[1], 1 / R.Dir[2]}, TNear, Tl, Tr;
+      INT Stack[MaxDepth], Sp = 0, Ni = 0;
+
+      Hit.T = R.TMax, Hit.U = Hit.V = 0, Hit.Tri = -1;
+      if (Nodes.empty() || !IsBoxHit(Nodes[0], R.Org, InvD, Hit.T, TNear))
+        return FALSE;
+      Prepare(R, P);
+      for (;;)
+      {
+        const node &N = Nodes[Ni];
+
+        if (N.Count == 0)
+        {
+          BOOL
+            IsL = IsBoxHit(Nodes[N.Start], R.Org, InvD, Hit.T, Tl),
+            IsR = IsBoxHit(Nodes[N.Start + 1], R.Org, InvD, Hit.T, Tr);
+
+          if (IsL && IsR)
+          {
+            Stack[Sp++] = Tl <= Tr ? N.Start + 1 : N.Start;
+            Ni = Tl <= Tr ? N.Start : N.Start + 1;
+            continue;
+          }
+          if (IsL || IsR)
+          {
+            Ni = IsL ? N.Start : N.Start + 1;
+            continue;
+          }
+        }
+        else
+          for (INT t = N.Start; t < N.Start + N.Count; t++)
+            IntersectTri(P, t, Hit);
+        do
+        {
+          if (Sp == 0)
+            return Hit.Tri >= 0;
+          Ni = Stack[--Sp];
+        } while (!IsBoxHit(Nodes[Ni], R.Org, InvD, Hit.T, TNear));
+      }
+    } /* End of 'Intersect' function */
+
+    /* Trace stream of rays on calling thread function.
+     * ARGUMENTS:
+     *   - rays:
+     *       const bvh_ray *R;
+     *   - number of rays:
+     *       INT N;
+     *   - closest hits to fill:
+     *       bvh_hit *H;
+     * RETURNS: None.
+     */
+    VOID IntersectStream( const bvh_ray *R, INT N, bvh_hit *H ) const
+    {
+#ifdef NIDX_BVH_SSE2
+      for (INT i = 0; i < N; i += Packet)
+      {
+        const bvh_ray *Pr[Packet];
+        bvh_hit *Ph[Packet], Dummy[Packet];
+
+        for (INT l = 0; l < Packet; l++)
+          Pr[l] = i + l < N ? &R[i + l] : nullptr, Ph[l] = i + l < N ? &H[i + l] : &Dummy[l];
+        TracePacket(Pr, Ph);
+      }
+#else /* NIDX_BVH_SSE2 */
+      for (INT i = 0; i < N; i++)
+        Intersect(R[i], H[i]);
+#endif /* NIDX_BVH_SSE2 */
+    } /* End of 'IntersectStream' function */
+
+    /* Trace batch of rays on worker threads function.
+     * ARGUMENTS:
+     *   - rays:
+     *       const bvh_ray *R;
+     *   - number of rays:
+     *       INT N;
+     *   - closest hits to fill:
+     *       bvh_hit *H;
+     *   - worker threads:
+     *       jobs &Pool;
+     * RETURNS: None.
+     */
+    VOID Intersect( const bvh_ray *R, INT N, bvh_hit *H, jobs &Pool = jobs::Get() ) const
+    {
+      const INT Chunk = 256;
+
+      Pool.ParallelFor((N + Chunk - 1) / Chunk, [&]( INT c, INT )
+        {
+          IntersectStream(R + c * Chunk, std::min(Chunk, N - c * Chunk), H + c * Chunk);
+        });
+    } /* End of 'Intersect' function */
+
+    /* Build picking ray through window point function.
+     * ARGUMENTS:
+     *   - view-projection matrix:
+     *       const matr &VP;
+     *   - point in client coordinates (see 'input::MouseX'):
+     *       FLT X, Y;
+     *   - window size:
+     *       INT W, H;
+     * RETURNS:
+     *   (bvh_ray) ray from near to far plane (TMax = 1).
+     */
+    static bvh_ray Unproject( const matr &VP, FLT X, FLT Y, INT W, INT H )
+    {
+      matr Inv = VP;
+      const FLT *m;
+      FLT Nx = 2 * (X + 0.5f) / W - 1, Ny = 1 - 2 * (Y + 0.5f) / H, P[2][3];
+      bvh_ray R;
+
+      Inv = Inv.Inverse();
+      m = Inv;
+      /* Row vector (Nx, Ny, Nz, 1) * Inv, Nz = -1 (near) and 1 (far) */
+      for (INT z = 0; z < 2; z++)
+      {
+        FLT Nz = z == 0 ? -1.0f : 1.0f, Wd = Nx * m[3] + Ny * m[7] + Nz * m[11] + m[15];
+
+        for (INT k = 0; k < 3; k++)
+          P[z][k] = (Nx * m[k] + Ny * m[4 + k] + Nz * m[8 + k] + m[12 + k]) / Wd;
+      }
+      for (INT k = 0; k < 3; k++)
+        R.Org[k] = P[0][k], R.Dir[k] = P[1][k] - P[0][k];
+      R.TMax = 1;
+      return R;
+    } /* End of 'Unproject' function */
+
+    /* Pick triangle under mouse function.
+     * ARGUMENTS:
+     *   - view-projection matrix:
+     *       const matr &VP;
+     *   - mouse position in client coordinates:
+     *       INT MouseX, MouseY;
+     *   - window size:
+     *       INT W, H;
+     *   - closest hit to fill:
+     *       bvh_hit &Hit;
+     * RETURNS:
+     *   (BOOL) TRUE if anything is hit.
+     */
+    BOOL Pick( const matr &VP, INT MouseX, INT MouseY, INT W, INT H, bvh_hit &Hit ) const
+    {
+      return Intersect(Unproject(VP, (FLT)MouseX, (FLT)MouseY, W, H), Hit);
+    } /* End of 'Pick' function */
+  }; /* end of 'bvh' class */
+} /* end of 'nidx' spacename */
+
+#endif // !_bvh_h_
+
+/* END OF 'bvh.h' FILE */
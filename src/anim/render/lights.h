@@ -0,0 +1,439 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : lights.h
+  * PURPOSE     : T51DX12 project.
+  *               Clustered light culling declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : View frustum (same parameters as 'matr::Frustum') is
+  *               split into SizeX x SizeY tiles on near plane (Y from
+  *               bottom to top) and SizeZ exponential depth slices.
+  *               Cluster of view space point with depth D = -Z is
+  *               slice floor(log(D) * SliceScale + SliceBias).
+  *               Lights are assigned by sphere (and cone for spots)
+  *               against cluster bounds tests, lists keep light order.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _lights_h_
+#define _lights_h_
+
+#include "../../def.h"
+#include "../jobs.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define NIDX_LIGHTS_SSE2
+#endif /* __SSE2__ */
+
+namespace nidx
+{
+  /* Light source types */
+  enum struct light_type : UINT
+  {
+    POINT, /* Omni light within sphere */
+    SPOT,  /* Cone light */
+  }; /* End of 'light_type' enum */
+
+  /* Light source structure */
+  struct light
+  {
+    FLT
+      Pos[3], Radius,      /* World position and range */
+      Dir[3], CosAngle,    /* Spot unit direction and cosine of half angle */
+      Color[3];            /* Color */
+    light_type Type;       /* Light type */
+  }; /* End of 'light' structure */
+
+  /* Clustered light culling class */
+  class light_clusters
+  {
+  public:
+    static const INT
+      SizeX = 16,
+      SizeY = 9,
+      SizeZ = 24,
+      NumOfClusters = SizeX * SizeY * SizeZ;
+
+    /* Cluster light list structure */
+    struct cell
+    {
+      UINT Offset, Count; /* Range in light indices */
+    }; /* End of 'cell' structure */
+
+  private:
+    /* Clusters row (same slice and tile Y) structure */
+    struct row
+    {
+      FLT
+        MinX[SizeX], MaxX[SizeX],         /* View space bound box (Z is depth) */
+        MinY[SizeX], MaxY[SizeX],
+        MinZ[SizeX], MaxZ[SizeX],
+        CX[SizeX], CY[SizeX], CZ[SizeX],  /* Bound sphere */
+        CR[SizeX];
+      std::vector<UINT> Lists[SizeX];     /* Lights of clusters */
+    }; /* End of 'row' structure */
+
+    /* View space light structure */
+    struct light_view
+    {
+      FLT
+        C[3], R,       /* Sphere (Z is depth) */
+        D[3],          /* Spot direction (Z is depth) */
+        Cos, Sin;      /* Spot half angle */
+      INT
+        X0, X1,        /* Tiles range, X0 < 0 - out of frustum */
+        Y0, Y1,
+        Z0, Z1;        /* Slices range */
+      BOOL IsSpot;     /* Spot light flag */
+    }; /* End of 'light_view' structure */
+
+    jobs &Pool;                          /* Worker threads */
+    FLT L, R, B, T, Near, Far;           /* Frustum parameters */
+    std::vector<row> Rows;               /* Cluster rows, slice major */
+    std::vector<light_view> Views;       /* Lights in view space */
+    std::vector<std::vector<UINT>> Bins; /* Lights of every slice */
+    std::vector<cell> Grid;              /* Cluster lists */
+    std::vector<UINT> Indices;           /* Light indices of all lists */
+
+    /* Obtain slice of view depth function.
+     * ARGUMENTS:
+     *   - depth:
+     *       FLT D;
+     * RETURNS:
+     *   (INT) slice clamped to grid.
+     */
+    INT GetSlice( FLT D ) const
+    {
+      if (D <= Near)
+        return 0;
+      return std::min(SizeZ - 1, (INT)(log(D) * SliceScale + SliceBias));
+    } /* End of 'GetSlice' function */
+
+    /* Obtain view depth of slice start function.
+     * ARGUMENTS:
+     *   - slice:
+     *       INT K;
+     * RETURNS:
+     *   (FLT) depth.
+     */
+    FLT GetSliceDepth( INT K ) const
+    {
+      return Near * (FLT)pow(Far / Near, (DBL)K / SizeZ);
+    } /* End of 'GetSliceDepth' function */
+
+    /* Transform light to view space and find its clusters range function.
+     * ARGUMENTS:
+     *   - view matrix:
+     *       const FLT *M;
+     *   - light:
+     *       const light &Lt;
+     *   - view space light to fill:
+     *       light_view &V;
+     * RETURNS: None.
+     */
+    VOID SetupLight( const FLT *M, const light &Lt, light_view &V ) const
+    {
+      const FLT *p = Lt.Pos, *d = Lt.Dir;
+      FLT x0, x1, y0, y1, dmin, dmax;
+
+      V.C[0] = p[0] * M[0] + p[1] * M[4] + p[2] * M[8] + M[12];
+      V.C[1] = p[0] * M[1] + p[1] * M[5] + p[2] * M[9] + M[13];
+      V.C[2] = -(p[0] * M[2] + p[1] * M[6] + p[2] * M[10] + M[14]);
+      V.R = Lt.Radius;
+      V.IsSpot = Lt.Type == light_type::SPOT;
+      V.D[0] = d[0] * M[0] + d[1] * M[4] + d[2] * M[8];
+      V.D[1] = d[0] * M[1] + d[1] * M[5] + d[2] * M[9];
+      V.D[2] = -(d[0] * M[2] + d[1] * M[6] + d[2] * M[10]);
+      V.Cos = Lt.CosAngle;
+      V.Sin = (FLT)sqrt(std::max(0.0f, 1 - Lt.CosAngle * Lt.CosAngle));
+      V.X0 = -1;
+
+      dmin = std::max(V.C[2] - V.R, Near);
+      dmax = std::min(V.C[2] + V.R, Far);
+      if (dmin > dmax)
+        return;
+      /* Project view space box of sphere to near plane */
+      x0 = std::min((V.C[0] - V.R) / dmin, (V.C[0] - V.R) / dmax) * Near;
+      x1 = std::max((V.C[0] + V.R) / dmin, (V.C[0] + V.R) / dmax) * Near;
+      y0 = std::min((V.C[1] - V.R) / dmin, (V.C[1] - V.R) / dmax) * Near;
+      y1 = std::max((V.C[1] + V.R) / dmin, (V.C[1] + V.R) / dmax) * Near;
+      if (x1 < L || x0 > R || y1 < B || y0 > T)
+        return;
+      V.X0 = std::max(0, (INT)floor((x0 - L) / (R - L) * SizeX));
+      V.X1 = std::min(SizeX - 1, (INT)floor((x1 - L) / (R - L) * SizeX));
+      V.Y0 = std::max(0, (INT)floor((y0 - B) / (T - B) * SizeY));
+      V.Y1 = std::min(SizeY - 1, (INT)floor((y1 - B) / (T - B) * SizeY));
+      V.Z0 = GetSlice(dmin);
+      V.Z1 = GetSlice(dmax);
+    } /* End of 'SetupLight' function */
+
+    /* Assign lights of slice to clusters row function.
+     * ARGUMENTS:
+     *   - slice and row:
+     *       INT K, Y;
+     * RETURNS: None.
+     */
+    VOID AssignRow( INT K, INT Y )
+    {
+      row &Rw = Rows[(size_t)K * SizeY + Y];
+
+      for (INT x = 0; x < SizeX; x++)
+        Rw.Lists[x].clear();
+      for (UINT i : Bins[K])
+      {
+        const light_view &V = Views[i];
+        INT Mask = 0;
+
+        if (Y < V.Y0 || Y > V.Y1)
+          continue;
+#ifdef NIDX_LIGHTS_SSE2
+        const __m128
+          cx = _mm_set1_ps(V.C[0]), cy = _mm_set1_ps(V.C[1]), cz = _mm_set1_ps(V.C[2]),
+          r2 = _mm_set1_ps(V.R * V.R), Zero = _mm_setzero_ps();
+
+        for (INT x = V.X0 & ~3; x <= V.X1; x += 4)
+        {
+          __m128
+            dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(Rw.MinX + x), cx), _mm_sub_ps(cx, _mm_loadu_ps(Rw.MaxX + x))), Zero),
+            dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(Rw.MinY + x), cy), _mm_sub_ps(cy, _mm_loadu_ps(Rw.MaxY + x))), Zero),
+            dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(Rw.MinZ + x), cz), _mm_sub_ps(cz, _mm_loadu_ps(Rw.MaxZ + x))), Zero),
+            In = _mm_cmple_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)), r2);
+
+          if (V.IsSpot && _mm_movemask_ps(In) != 0)
+          {
+            /* Cone against cluster bound sphere */
+            __m128
+              vx = _mm_sub_ps(_mm_loadu_ps(Rw.CX + x), cx),
+              vy = _mm_sub_ps(_mm_loadu_ps(Rw.CY + x), cy),
+              vz = _mm_sub_ps(_mm_loadu_ps(Rw.CZ + x), cz),
+              sr = _mm_loadu_ps(Rw.CR + x),
+              Len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)),
+              v1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(V.D[0])), _mm_mul_ps(vy, _mm_set1_ps(V.D[1]))),
+                              _mm_mul_ps(vz, _mm_set1_ps(V.D[2]))),
+              Dist = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(V.Cos), _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(Len2, _mm_mul_ps(v1, v1)), Zero))),
+                                _mm_mul_ps(v1, _mm_set1_ps(V.Sin)));
+
+            In = _mm_and_ps(In, _mm_cmple_ps(Dist, sr));
+            In = _mm_and_ps(In, _mm_cmple_ps(v1, _mm_add_ps(sr, _mm_set1_ps(V.R))));
+            In = _mm_and_ps(In, _mm_cmpge_ps(v1, _mm_sub_ps(Zero, sr)));
+          }
+          Mask |= _mm_movemask_ps(In) << x;
+        }
+#else /* NIDX_LIGHTS_SSE2 */
+        for (INT x = V.X0; x <= V.X1; x++)
+        {
+          FLT
+            dx = std::max(std::max(Rw.MinX[x] - V.C[0], V.C[0] - Rw.MaxX[x]), 0.0f),
+            dy = std::max(std::max(Rw.MinY[x] - V.C[1], V.C[1] - Rw.MaxY[x]), 0.0f),
+            dz = std::max(std::max(Rw.MinZ[x] - V.C[2], V.C[2] - Rw.MaxZ[x]), 0.0f);
+
+          if (dx * dx + dy * dy + dz * dz > V.R * V.R)
+            continue;
+          if (V.IsSpot)
+          {
+            FLT
+              vx = Rw.CX[x] - V.C[0], vy = Rw.CY[x] - V.C[1], vz = Rw.CZ[x] - V.C[2],
+              v1 = vx * V.D[0] + vy * V.D[1] + vz * V.D[2],
+              Dist = V.Cos * (FLT)sqrt(std::max(vx * vx + vy * vy + vz * vz - v1 * v1, 0.0f)) - v1 * V.Sin;
+
+            if (Dist > Rw.CR[x] || v1 > Rw.CR[x] + V.R || v1 < -Rw.CR[x])
+              continue;
+          }
+          Mask |= 1 << x;
+        }
+#endif /* NIDX_LIGHTS_SSE2 */
+        /* Drop lanes out of light tiles range */
+        Mask &= ((1 << (V.X1 + 1)) - 1) & ~((1 << V.X0) - 1);
+        for (INT x = V.X0; x <= V.X1; x++)
+          if (Mask & (1 << x))
+            Rw.Lists[x].push_back(i);
+      }
+    } /* End of 'AssignRow' function */
+
+  public:
+    FLT SliceScale, SliceBias; /* Slice of depth parameters */
+
+    /* Light clusters initializing function.
+     * ARGUMENTS:
+     *   - worker threads:
+     *       jobs &NewPool;
+     */
+    light_clusters( jobs &NewPool = jobs::Get() ) :
+      Pool(NewPool), L(0), R(0), B(0), T(0), Near(0), Far(0),
+      Rows((size_t)SizeY * SizeZ), Bins(SizeZ), Grid(NumOfClusters), SliceScale(0), SliceBias(0)
+    {
+      for (auto &c : Grid)
+        c = {0, 0};
+    } /* End of 'light_clusters' function */
+
+    /* Set projection function (same arguments as 'matr::Frustum').
+     * ARGUMENTS:
+     *   - near plane rectangle:
+     *       FLT NewL, NewR, NewB, NewT;
+     *   - near and far planes distance:
+     *       FLT NewNear, NewFar;
+     * RETURNS: None.
+     */
+    VOID SetProjection( FLT NewL, FLT NewR, FLT NewB, FLT NewT, FLT NewNear, FLT NewFar )
+    {
+      if (L == NewL && R == NewR && B == NewB && T == NewT && Near == NewNear && Far == NewFar)
+        return;
+      L = NewL, R = NewR, B = NewB, T = NewT, Near = NewNear, Far = NewFar;
+      SliceScale = SizeZ / (FLT)log(Far / Near);
+      SliceBias = -(FLT)log(Near) * SliceScale;
+
+      for (INT k = 0; k < SizeZ; k++)
+      {
+        FLT d0 = GetSliceDepth(k), d1 = GetSliceDepth(k + 1);
+
+        for (INT y = 0; y < SizeY; y++)
+        {
+          row &Rw = Rows[(size_t)k * SizeY + y];
+          FLT
+            ty0 = (B + (T - B) * y / SizeY) / Near,
+            ty1 = (B + (T - B) * (y + 1) / SizeY) / Near;
+
+          for (INT x = 0; x < SizeX; x++)
+          {
+            FLT
+              tx0 = (L + (R - L) * x / SizeX) / Near,
+              tx1 = (L + (R - L) * (x + 1) / SizeX) / Near,
+              hx, hy, hz;
+
+            Rw.MinX[x] = std::min(tx0 * d0, tx0 * d1), Rw.MaxX[x] = std::max(tx1 * d0, tx1 * d1);
+            Rw.MinY[x] = std::min(ty0 * d0, ty0 * d1), Rw.MaxY[x] = std::max(ty1 * d0, ty1 * d1);
+            Rw.MinZ[x] = d0, Rw.MaxZ[x] = d1;
+            hx = (Rw.MaxX[x] - Rw.MinX[x]) / 2, hy = (Rw.MaxY[x] - Rw.MinY[x]) / 2, hz = (d1 - d0) / 2;
+            Rw.CX[x] = Rw.MinX[x] + hx, Rw.CY[x] = Rw.MinY[x] + hy, Rw.CZ[x] = d0 + hz;
+            Rw.CR[x] = (FLT)sqrt(hx * hx + hy * hy + hz * hz);
+          }
+        }
+      }
+    } /* End of 'SetProjection' function */
+
+    /* Assign lights to clusters function.
+     * ARGUMENTS:
+     *   - view matrix:
+     *       const matr &View;
+     *   - lights:
+     *       const light *Lights;
+     *       INT N;
+     * RETURNS:
+     *   (UINT) total number of light indices in lists.
+     */
+    UINT Assign( const matr &View, const light *Lights, INT N )
+    {
+      const INT Chunk = 1024;
+      const FLT *M = View;
+      UINT Total = 0;
+
+      Views.resize(N);
+      Pool.ParallelFor((N + Chunk - 1) / Chunk, [&]( INT c, INT )
+        {
+          for (INT i = c * Chunk; i < std::min(N, c * Chunk + Chunk); i++)
+            SetupLight(M, Lights[i], Views[i]);
+        });
+      for (auto &b : Bins)
+        b.clear();
+      for (INT i = 0; i < N; i++)
+        if (Views[i].X0 >= 0)
+          for (INT k = Views[i].Z0; k <= Views[i].Z1; k++)
+            Bins[k].push_back((UINT)i);
+
+      Pool.ParallelFor(SizeZ * SizeY, [this]( INT r, INT )
+        {
+          AssignRow(r / SizeY, r % SizeY);
+        });
+
+      /* Compact lists */
+      for (INT r = 0; r < SizeZ * SizeY; r++)
+        for (INT x = 0; x < SizeX; x++)
+        {
+          cell &c = Grid[(size_t)r * SizeX + x];
+
+          c.Offset = Total;
+          c.Count = (UINT)Rows[r].Lists[x].size();
+          Total += c.Count;
+        }
+      Indices.resize(Total);
+      Pool.ParallelFor(SizeZ * SizeY, [this]( INT r, INT )
+        {
+          for (INT x = 0; x < SizeX; x++)
+            if (!Rows[r].Lists[x].empty())
+              memcpy(&Indices[Grid[(size_t)r * SizeX + x].Offset], Rows[r].Lists[x].data(), Rows[r].Lists[x].size() * sizeof(UINT));
+        });
+      return Total;
+    } /* End of 'Assign' function */
+
+    /* Obtain cluster index function.
+     * ARGUMENTS:
+     *   - tile:
+     *       INT X, Y;
+     *   - view depth:
+     *       FLT D;
+     * RETURNS:
+     *   (INT) cluster index.
+     */
+    INT GetCluster( INT X, INT Y, FLT D ) const
+    {
+      return (GetSlice(D) * SizeY + Y) * SizeX + X;
+    } /* End of 'GetCluster' function */
+
+    /* Obtain cluster lists function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const std::vector<cell> &) lists of all clusters.
+     */
+    const std::vector<cell> & GetGrid( VOID ) const
+    {
+      return Grid;
+    } /* End of 'GetGrid' function */
+
+    /* Obtain light indices function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const std::vector<UINT> &) indices.
+     */
+    const std::vector<UINT> & GetIndices( VOID ) const
+    {
+      return Indices;
+    } /* End of 'GetIndices' function */
+
+    /* Obtain upload data size function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (size_t) size in bytes.
+     */
+    size_t GetUploadSize( VOID ) const
+    {
+      return Grid.size() * sizeof(cell) + Indices.size() * sizeof(UINT);
+    } /* End of 'GetUploadSize' function */
+
+    /* Write lists to upload buffer function (once per frame).
+     * ARGUMENTS:
+     *   - mapped buffer of 'GetUploadSize' bytes, grid then indices:
+     *       VOID *Dst;
+     * RETURNS: None.
+     */
+    VOID Upload( VOID *Dst ) const
+    {
+      memcpy(Dst, Grid.data(), Grid.size() * sizeof(cell));
+      if (!Indices.empty())
+        memcpy((BYTE *)Dst + Grid.size() * sizeof(cell), Indices.data(), Indices.size() * sizeof(UINT));
+    } /* End of 'Upload' function */
+  }; /* end of 'light_clusters' class */
+} /* end of 'nidx' spacename */
+
+#endif // !_lights_h_
+
+/* END OF 'lights.h' FILE */
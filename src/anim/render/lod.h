@@ -0,0 +1,466 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : lod.h
+  * PURPOSE     : T51DX12 project.
+  *               Mesh levels of detail declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Simplification collapses edges into one of their
+  *               vertices ordered by quadric error, so every level
+  *               indexes the original vertex buffer. Border (and so
+  *               attribute seam) edges get strong perpendicular planes
+  *               and barely move. Level errors are world space
+  *               distances, selection converts them to pixels.
+  *               File format (little endian): 'NDLD', UINT32 version,
+  *               UINT32 numbers of levels and indices, levels, indices.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _lod_h_
+#define _lod_h_
+
+#include "../../def.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nidx
+{
+  /* Mesh levels of detail chain class */
+  class lod_chain
+  {
+  public:
+    /* Detail level structure */
+    struct level
+    {
+      UINT
+        IndexOffset,  /* First index in 'Indices' */
+        IndexCount;   /* Number of indices */
+      FLT Error;      /* Geometric error in world units (0 - original mesh) */
+    }; /* End of 'level' structure */
+
+    std::vector<level> Levels;  /* Levels from finest to coarsest */
+    std::vector<UINT> Indices;  /* Indices of all levels */
+
+  private:
+    static const UINT Version = 1;
+
+    /* Symmetric 4x4 error quadric structure */
+    struct quadric
+    {
+      DBL
+        A[10],  /* a2 ab ac ad b2 bc bd c2 cd d2 */
+        W;      /* Sum of plane weights */
+
+      /* Add weighted plane 'a * x + b * y + c * z + d = 0' function.
+       * ARGUMENTS:
+       *   - plane (unit normal):
+       *       DBL a, b, c, d;
+       *   - weight:
+       *       DBL w;
+       * RETURNS: None.
+       */
+      VOID AddPlane( DBL a, DBL b, DBL c, DBL d, DBL w )
+      {
+        A[0] += w * a * a, A[1] += w * a * b, A[2] += w * a * c, A[3] += w * a * d;
+        A[4] += w * b * b, A[5] += w * b * c, A[6] += w * b * d;
+        A[7] += w * c * c, A[8] += w * c * d;
+        A[9] += w * d * d;
+        W += w;
+      } /* End of 'AddPlane' function */
+
+      /* Evaluate squared distance sum at point function.
+       * ARGUMENTS:
+       *   - point:
+       *       const FLT *P;
+       * RETURNS:
+       *   (DBL) weighted sum of squared distances to planes.
+       */
+      DBL Eval( const FLT *P ) const
+      {
+        DBL x = P[0], y = P[1], z = P[2];
+
+        return A[0] * x * x + 2 * A[1] * x * y + 2 * A[2] * x * z + 2 * A[3] * x +
+               A[4] * y * y + 2 * A[5] * y * z + 2 * A[6] * y +
+               A[7] * z * z + 2 * A[8] * z + A[9];
+      } /* End of 'Eval' function */
+    }; /* End of 'quadric' structure */
+
+    /* Collapse candidate structure */
+    struct collapse
+    {
+      DBL Cost;             /* Mean squared distance after collapse */
+      UINT U, V;            /* Removed and kept vertices */
+      UINT VerU, VerV;      /* Vertex versions at evaluation */
+
+      BOOL operator<( const collapse &C ) const
+      {
+        return Cost > C.Cost;
+      }
+    }; /* End of 'collapse' structure */
+
+  public:
+    /* Simplify triangle list function.
+     * ARGUMENTS:
+     *   - vertex positions (3 floats at stride):
+     *       const FLT *Pos;
+     *       INT NumOfV;
+     *       size_t Stride;
+     *   - triangle list indices:
+     *       const UINT *Ind;
+     *       INT NumOfI;
+     *   - target number of indices:
+     *       INT TargetI;
+     *   - simplified indices to fill:
+     *       std::vector<UINT> &Out;
+     * RETURNS:
+     *   (FLT) largest collapse error in world units.
+     */
+    static FLT Simplify( const FLT *Pos, INT NumOfV, size_t Stride, const UINT *Ind, INT NumOfI,
+                         INT TargetI, std::vector<UINT> &Out )
+    {
+      INT NumOfT = NumOfI / 3, Alive = NumOfT;
+      std::vector<UINT> T(Ind, Ind + NumOfT * 3), Ver(NumOfV, 0);
+      std::vector<BYTE> Dead(NumOfT, 0), Removed(NumOfV, 0);
+      std::vector<std::vector<INT>> VT(NumOfV);
+      std::vector<quadric> Q(NumOfV, quadric {{0}, 0});
+      std::unordered_map<UINT64, INT> Edges;
+      std::priority_queue<collapse> Heap;
+      DBL MaxCost = 0;
+
+      auto P = [&]( UINT v ) -> const FLT *
+      {
+        return (const FLT *)((const BYTE *)Pos + v * Stride);
+      };
+      auto Normal = [&]( const FLT *p0, const FLT *p1, const FLT *p2, DBL *n )
+      {
+        DBL
+          e1[3] = {(DBL)p1[0] - p0[0], (DBL)p1[1] - p0[1], (DBL)p1[2] - p0[2]},
+          e2[3] = {(DBL)p2[0] - p0[0], (DBL)p2[1] - p0[1], (DBL)p2[2] - p0[2]};
+
+        n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+      };
+      auto Push = [&]( UINT a, UINT b )
+      {
+        quadric S = Q[a];
+        DBL Cab, Cba;
+
+        for (INT k = 0; k < 10; k++)
+          S.A[k] += Q[b].A[k];
+        S.W += Q[b].W;
+        Cab = std::max(0.0, S.Eval(P(b))) / std::max(S.W, 1e-30);
+        Cba = std::max(0.0, S.Eval(P(a))) / std::max(S.W, 1e-30);
+        if (Cab <= Cba)
+          Heap.push({Cab, a, b, Ver[a], Ver[b]});
+        else
+          Heap.push({Cba, b, a, Ver[b], Ver[a]});
+      };
+
+      /* Face quadrics weighted by area */
+      for (INT t = 0; t < NumOfT; t++)
+      {
+        const UINT *v = &T[t * 3];
+        DBL n[3], Len;
+
+        Normal(P(v[0]), P(v[1]), P(v[2]), n);
+        Len = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        for (INT k = 0; k < 3; k++)
+        {
+          VT[v[k]].push_back(t);
+          Edges[(UINT64)std::min(v[k], v[(k + 1) % 3]) << 32 | std::max(v[k], v[(k + 1) % 3])]++;
+        }
+        if (Len == 0)
+          continue;
+        for (INT k = 0; k < 3; k++)
+        {
+          const FLT *p = P(v[0]);
+
+          Q[v[k]].AddPlane(n[0] / Len, n[1] / Len, n[2] / Len,
+                           -(n[0] * p[0] + n[1] * p[1] + n[2] * p[2]) / Len, Len / 2);
+        }
+      }
+      /* Border edges: plane through edge perpendicular to face */
+      for (INT t = 0; t < NumOfT; t++)
+        for (INT k = 0; k < 3; k++)
+        {
+          UINT a = T[t * 3 + k], b = T[t * 3 + (k + 1) % 3];
+          const FLT *pa = P(a), *pb = P(b);
+          DBL n[3], e[3] = {(DBL)pb[0] - pa[0], (DBL)pb[1] - pa[1], (DBL)pb[2] - pa[2]}, m[3], Len, w;
+
+          if (Edges[(UINT64)std::min(a, b) << 32 | std::max(a, b)] != 1)
+            continue;
+          Normal(P(T[t * 3]), P(T[t * 3 + 1]), P(T[t * 3 + 2]), n);
+          m[0] = e[1] * n[2] - e[2] * n[1];
+          m[1] = e[2] * n[0] - e[0] * n[2];
+          m[2] = e[0] * n[1] - e[1] * n[0];
+          if ((Len = sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2])) == 0)
+            continue;
+          w = 10 * (e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+          for (UINT v : {a, b})
+            Q[v].AddPlane(m[0] / Len, m[1] / Len, m[2] / Len,
+                          -(m[0] * pa[0] + m[1] * pa[1] + m[2] * pa[2]) / Len, w);
+        }
+      for (INT t = 0; t < NumOfT; t++)
+        for (INT k = 0; k < 3; k++)
+          Push(T[t * 3 + k], T[t * 3 + (k + 1) % 3]);
+
+      while (Alive * 3 > TargetI && !Heap.empty())
+      {
+        collapse C = Heap.top();
+        BOOL IsFlip = FALSE;
+
+        Heap.pop();
+        if (Removed[C.U] || Removed[C.V] || Ver[C.U] != C.VerU || Ver[C.V] != C.VerV)
+          continue;
+        /* Reject collapses folding triangles over */
+        for (INT t : VT[C.U])
+        {
+          UINT *v = &T[t * 3];
+          DBL n0[3], n1[3];
+          const FLT *p[3];
+
+          if (Dead[t] || v[0] == C.V || v[1] == C.V || v[2] == C.V)
+            continue;
+          Normal(P(v[0]), P(v[1]), P(v[2]), n0);
+          for (INT k = 0; k < 3; k++)
+            p[k] = P(v[k] == C.U ? C.V : v[k]);
+          Normal(p[0], p[1], p[2], n1);
+          if (n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0)
+          {
+            IsFlip = TRUE;
+            break;
+          }
+        }
+        if (IsFlip)
+          continue;
+
+        MaxCost = std::max(MaxCost, C.Cost);
+        for (INT k = 0; k < 10; k++)
+          Q[C.V].A[k] += Q[C.U].A[k];
+        Q[C.V].W += Q[C.U].W;
+        for (INT t : VT[C.U])
+        {
+          UINT *v = &T[t * 3];
+
+          if (Dead[t])
+            continue;
+          if (v[0] == C.V || v[1] == C.V || v[2] == C.V)
+          {
+            Dead[t] = 1;
+            Alive--;
+            continue;
+          }
+          for (INT k = 0; k < 3; k++)
+            if (v[k] == C.U)
+              v[k] = C.V;
+          VT[C.V].push_back(t);
+        }
+        VT[C.U].clear();
+        Removed[C.U] = 1;
+        Ver[C.U]++;
+        Ver[C.V]++;
+        VT[C.V].erase(std::remove_if(VT[C.V].begin(), VT[C.V].end(), [&]( INT t ){ return Dead[t] != 0; }), VT[C.V].end());
+        for (INT t : VT[C.V])
+          for (INT k = 0; k < 3; k++)
+            if (T[t * 3 + k] != C.V)
+              Push(C.V, T[t * 3 + k]);
+      }
+
+      Out.clear();
+      for (INT t = 0; t < NumOfT; t++)
+        if (!Dead[t])
+          Out.insert(Out.end(), &T[t * 3], &T[t * 3 + 3]);
+      return (FLT)sqrt(MaxCost);
+    } /* End of 'Simplify' function */
+
+    /* Build levels chain function.
+     * ARGUMENTS:
+     *   - vertex positions (3 floats at stride):
+     *       const FLT *Pos;
+     *       INT NumOfV;
+     *       size_t Stride;
+     *   - triangle list indices:
+     *       const UINT *Ind;
+     *       INT NumOfI;
+     *   - maximal number of levels:
+     *       INT MaxLevels;
+     *   - number of triangles ratio between levels:
+     *       FLT Ratio;
+     * RETURNS: None.
+     */
+    VOID Build( const FLT *Pos, INT NumOfV, size_t Stride, const UINT *Ind, INT NumOfI,
+                INT MaxLevels = 5, FLT Ratio = 0.5f )
+    {
+      std::vector<UINT> Cur(Ind, Ind + NumOfI), Next;
+      FLT Error = 0;
+
+      Levels.clear();
+      Indices.assign(Ind, Ind + NumOfI);
+      Levels.push_back({0, (UINT)NumOfI, 0});
+      while ((INT)Levels.size() < MaxLevels)
+      {
+        /* Each level is simplified from the previous one, errors add up */
+        Error += Simplify(Pos, NumOfV, Stride, Cur.data(), (INT)Cur.size(), (INT)(Cur.size() * Ratio) / 3 * 3, Next);
+        if (Next.empty() || Next.size() > Cur.size() * 0.95)
+          break;
+        Levels.push_back({(UINT)Indices.size(), (UINT)Next.size(), Error});
+        Indices.insert(Indices.end(), Next.begin(), Next.end());
+        Cur.swap(Next);
+      }
+    } /* End of 'Build' function */
+
+    /* Save chain to file function.
+     * ARGUMENTS:
+     *   - file name:
+     *       const std::string &FileName;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    BOOL Save( const std::string &FileName ) const
+    {
+      std::ofstream F(FileName, std::ios::binary);
+      UINT32 Head[3] = {Version, (UINT32)Levels.size(), (UINT32)Indices.size()};
+
+      if (!F.is_open())
+        return FALSE;
+      F.write("NDLD", 4);
+      F.write((const CHAR *)Head, sizeof(Head));
+      F.write((const CHAR *)Levels.data(), Levels.size() * sizeof(level));
+      F.write((const CHAR *)Indices.data(), Indices.size() * sizeof(UINT));
+      return (BOOL)F.good();
+    } /* End of 'Save' function */
+
+    /* Load chain from file written by 'Save' function.
+     * ARGUMENTS:
+     *   - file name:
+     *       const std::string &FileName;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    BOOL Load( const std::string &FileName )
+    {
+      std::ifstream F(FileName, std::ios::binary);
+      CHAR Magic[4];
+      UINT32 Head[3];
+
+      if (!F.read(Magic, 4) || memcmp(Magic, "NDLD", 4) != 0 ||
+          !F.read((CHAR *)Head, sizeof(Head)) || Head[0] != Version)
+        return FALSE;
+      Levels.resize(Head[1]);
+      Indices.resize(Head[2]);
+      F.read((CHAR *)Levels.data(), Levels.size() * sizeof(level));
+      F.read((CHAR *)Indices.data(), Indices.size() * sizeof(UINT));
+      if (!F)
+      {
+        Levels.clear();
+        Indices.clear();
+        return FALSE;
+      }
+      return TRUE;
+    } /* End of 'Load' function */
+  }; /* end of 'lod_chain' class */
+
+  /* Level of detail instance structure */
+  struct lod_instance
+  {
+    const lod_chain *Chain;   /* Mesh levels */
+    FLT Center[3], Radius;    /* World space bounding sphere */
+    INT Level;                /* Current level (selection state) */
+  }; /* End of 'lod_instance' structure */
+
+  /* Screen space level of detail selector class */
+  class lod_selector
+  {
+  private:
+    FLT
+      Eye[3],           /* Camera position */
+      ProjScale;        /* World size at unit distance to pixels factor */
+
+  public:
+    FLT
+      Threshold,        /* Allowed error in pixels */
+      Hysteresis;       /* Relative error margin before switching to coarser level */
+
+    /* Selector initializing function.
+     * ARGUMENTS: None.
+     */
+    lod_selector( VOID ) : Eye {0, 0, 0}, ProjScale(1), Threshold(1), Hysteresis(0.25f)
+    {
+    } /* End of 'lod_selector' function */
+
+    /* Set camera function.
+     * ARGUMENTS:
+     *   - camera position:
+     *       vec3 Loc;
+     *   - projection matrix (see 'matr::Frustum'):
+     *       const matr &Proj;
+     *   - frame height in pixels:
+     *       INT FrameH;
+     * RETURNS: None.
+     */
+    VOID SetCamera( vec3 Loc, const matr &Proj, INT FrameH )
+    {
+      const FLT *M = Proj;
+
+      for (INT k = 0; k < 3; k++)
+        Eye[k] = Loc[k];
+      ProjScale = M[5] * FrameH / 2;
+    } /* End of 'SetCamera' function */
+
+    /* Select instance level function.
+     * ARGUMENTS:
+     *   - instance to update level of:
+     *       lod_instance &I;
+     * RETURNS:
+     *   (INT) selected level.
+     */
+    INT Select( lod_instance &I ) const
+    {
+      const std::vector<lod_chain::level> &L = I.Chain->Levels;
+      FLT
+        d[3] = {I.Center[0] - Eye[0], I.Center[1] - Eye[1], I.Center[2] - Eye[2]},
+        Dist = std::max((FLT)sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) - I.Radius, 1e-3f),
+        Scale = ProjScale / Dist;
+      INT n = (INT)L.size(), l = std::min(std::max(I.Level, 0), n - 1);
+
+      /* Too coarse - refine, well below threshold - coarsen */
+      while (l > 0 && L[l].Error * Scale > Threshold)
+        l--;
+      while (l + 1 < n && L[l + 1].Error * Scale <= Threshold * (1 - Hysteresis))
+        l++;
+      return I.Level = l;
+    } /* End of 'Select' function */
+
+    /* Select levels of instances function.
+     * ARGUMENTS:
+     *   - instances:
+     *       lod_instance *I;
+     *       INT N;
+     * RETURNS:
+     *   (UINT64) number of selected triangles.
+     */
+    UINT64 SelectAll( lod_instance *I, INT N ) const
+    {
+      UINT64 Tris = 0;
+
+      for (INT i = 0; i < N; i++)
+        Tris += I[i].Chain->Levels[Select(I[i])].IndexCount / 3;
+      return Tris;
+    } /* End of 'SelectAll' function */
+  }; /* end of 'lod_selector' class */
+} /* end of 'nidx' spacename */
+#endif // !_lod_h_
+
+/* END OF 'lod.h' FILE */
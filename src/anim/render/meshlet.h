@@ -0,0 +1,414 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : meshlet.h
+  * PURPOSE     : T51DX12 project.
+  *               Meshlets builder and culling declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Meshlets are grown greedily over shared vertices, so
+  *               every meshlet is a connected, compact patch. Normal
+  *               cones follow the apex form: meshlet is backfacing if
+  *               dot(normalize(Apex - Eye), Axis) >= Cutoff; cutoff
+  *               above 1 means the cone is too wide to cull.
+  *               File format (little endian): 'NDML', UINT32 version,
+  *               UINT32 numbers of meshlets, vertices, triangle bytes,
+  *               then the arrays in the same order as in the class.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _meshlet_h_
+#define _meshlet_h_
+
+#include "../../def.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace nidx
+{
+  /* Meshlet structure */
+  struct meshlet
+  {
+    UINT
+      VertexOffset,   /* First vertex in 'Vertices' */
+      TriangleOffset, /* First byte in 'Triangles' */
+      VertexCount,    /* Number of vertices */
+      TriangleCount;  /* Number of triangles */
+  }; /* End of 'meshlet' structure */
+
+  /* Meshlet culling data structure */
+  struct meshlet_bounds
+  {
+    FLT
+      Center[3], Radius,     /* Bounding sphere */
+      ConeApex[3],           /* Normal cone apex */
+      ConeAxis[3],           /* Normal cone axis */
+      ConeCutoff;            /* Sine of cone spread (> 1 - no cone) */
+  }; /* End of 'meshlet_bounds' structure */
+
+  /* Meshlet culling view structure */
+  struct meshlet_view
+  {
+    FLT
+      Planes[6][4],          /* Frustum planes, positive inside */
+      Eye[3];                /* Camera position */
+
+    /* Build view from camera function.
+     * ARGUMENTS:
+     *   - view projection matrix:
+     *       const matr &VP;
+     *   - camera position:
+     *       vec3 Loc;
+     * RETURNS:
+     *   (meshlet_view) view.
+     */
+    static meshlet_view Build( const matr &VP, vec3 Loc )
+    {
+      const FLT *M = VP;
+      meshlet_view V;
+
+      /* Clip planes are combinations of matrix columns (row vectors) */
+      for (INT p = 0; p < 6; p++)
+      {
+        INT c = p / 2;
+        FLT s = p % 2 == 0 ? 1.0f : -1.0f, Len = 0;
+
+        for (INT k = 0; k < 4; k++)
+          V.Planes[p][k] = M[k * 4 + 3] + s * M[k * 4 + c];
+        for (INT k = 0; k < 3; k++)
+          Len += V.Planes[p][k] * V.Planes[p][k];
+        Len = sqrt(Len);
+        for (INT k = 0; k < 4; k++)
+          V.Planes[p][k] /= Len;
+      }
+      for (INT k = 0; k < 3; k++)
+        V.Eye[k] = Loc[k];
+      return V;
+    } /* End of 'Build' function */
+  }; /* End of 'meshlet_view' structure */
+
+  /* Meshlets of one mesh class */
+  class meshlet_mesh
+  {
+  public:
+    static const INT
+      MaxVertices = 64,
+      MaxTriangles = 124;
+
+    std::vector<meshlet> Meshlets;       /* Meshlets */
+    std::vector<UINT> Vertices;          /* Mesh vertex indices of meshlets */
+    std::vector<BYTE> Triangles;         /* Meshlet local vertex indices, 3 per triangle */
+    std::vector<meshlet_bounds> Bounds;  /* Culling data of every meshlet */
+
+  private:
+    static const UINT Version = 1;
+
+    /* Compute meshlet culling data function.
+     * ARGUMENTS:
+     *   - meshlet:
+     *       const meshlet &M;
+     *   - vertex positions:
+     *       const BYTE *Pos;
+     *       size_t Stride;
+     *   - triangle normals scratch:
+     *       std::vector<FLT> &N;
+     * RETURNS:
+     *   (meshlet_bounds) culling data.
+     */
+    meshlet_bounds ComputeBounds( const meshlet &M, const BYTE *Pos, size_t Stride, std::vector<FLT> &N ) const
+    {
+      meshlet_bounds B;
+      FLT Min[3] = {HUGE_VALF, HUGE_VALF, HUGE_VALF}, Max[3] = {-HUGE_VALF, -HUGE_VALF, -HUGE_VALF}, R2 = 0;
+      FLT Axis[3] = {0, 0, 0}, Len, MinDot = 1, MaxT = 0;
+
+      auto P = [&]( UINT Local ) -> const FLT *
+      {
+        return (const FLT *)(Pos + Vertices[M.VertexOffset + Local] * Stride);
+      };
+
+      for (UINT i = 0; i < M.VertexCount; i++)
+        for (INT k = 0; k < 3; k++)
+          Min[k] = std::min(Min[k], P(i)[k]), Max[k] = std::max(Max[k], P(i)[k]);
+      for (INT k = 0; k < 3; k++)
+        B.Center[k] = (Min[k] + Max[k]) / 2;
+      for (UINT i = 0; i < M.VertexCount; i++)
+      {
+        FLT d[3] = {P(i)[0] - B.Center[0], P(i)[1] - B.Center[1], P(i)[2] - B.Center[2]};
+
+        R2 = std::max(R2, d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+      }
+      B.Radius = sqrt(R2);
+      N.resize(M.TriangleCount * 3);
+
+      /* Triangle normals and their average direction */
+      for (UINT t = 0; t < M.TriangleCount; t++)
+      {
+        const BYTE *Tri = &Triangles[M.TriangleOffset + t * 3];
+        const FLT *p0 = P(Tri[0]), *p1 = P(Tri[1]), *p2 = P(Tri[2]);
+        FLT
+          e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]},
+          e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]},
+          *n = &N[t * 3];
+
+        n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+        Len = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        for (INT k = 0; k < 3; k++)
+          n[k] = Len > 0 ? n[k] / Len : 0, Axis[k] += n[k];
+      }
+      Len = sqrt(Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2]);
+      for (INT k = 0; k < 3; k++)
+      {
+        B.ConeAxis[k] = Len > 0 ? Axis[k] / Len : 0;
+        B.ConeApex[k] = B.Center[k];
+      }
+      B.ConeCutoff = 2;
+      if (Len == 0)
+        return B;
+      for (UINT t = 0; t < M.TriangleCount; t++)
+      {
+        const FLT *n = &N[t * 3];
+
+        if (n[0] != 0 || n[1] != 0 || n[2] != 0)
+          MinDot = std::min(MinDot, n[0] * B.ConeAxis[0] + n[1] * B.ConeAxis[1] + n[2] * B.ConeAxis[2]);
+      }
+      /* Cones wider than ~84 degrees cull almost nothing */
+      if (MinDot <= 0.1f)
+        return B;
+      /* Move apex back so every triangle plane is in front of it */
+      for (UINT t = 0; t < M.TriangleCount; t++)
+      {
+        const FLT *n = &N[t * 3], *p0 = P(Triangles[M.TriangleOffset + t * 3]);
+        FLT
+          dc = (B.Center[0] - p0[0]) * n[0] + (B.Center[1] - p0[1]) * n[1] + (B.Center[2] - p0[2]) * n[2],
+          dn = B.ConeAxis[0] * n[0] + B.ConeAxis[1] * n[1] + B.ConeAxis[2] * n[2];
+
+        if (dn > 0)
+          MaxT = std::max(MaxT, dc / dn);
+      }
+      for (INT k = 0; k < 3; k++)
+        B.ConeApex[k] = B.Center[k] - B.ConeAxis[k] * MaxT;
+      B.ConeCutoff = sqrt(1 - MinDot * MinDot);
+      return B;
+    } /* End of 'ComputeBounds' function */
+
+  public:
+    /* Build meshlets function.
+     * ARGUMENTS:
+     *   - vertex positions (3 floats at stride):
+     *       const FLT *Pos;
+     *       INT NumOfV;
+     *       size_t Stride;
+     *   - triangle list indices:
+     *       const UINT *Ind;
+     *       INT NumOfI;
+     * RETURNS: None.
+     */
+    VOID Build( const FLT *Pos, INT NumOfV, size_t Stride, const UINT *Ind, INT NumOfI )
+    {
+      const BYTE None = 0xFF;
+      INT NumOfT = NumOfI / 3, Cursor = 0;
+      std::vector<INT> Offsets(NumOfV + 1, 0), Adj(NumOfT * 3);
+      std::vector<BYTE> Used(NumOfT, 0), Local(NumOfV, None);
+      std::vector<FLT> Normals;
+      meshlet M = {0, 0, 0, 0};
+
+      Meshlets.clear();
+      Vertices.clear();
+      Triangles.clear();
+      Bounds.clear();
+
+      /* Vertex to triangles adjacency */
+      for (INT i = 0; i < NumOfT * 3; i++)
+        Offsets[Ind[i] + 1]++;
+      for (INT v = 0; v < NumOfV; v++)
+        Offsets[v + 1] += Offsets[v];
+      {
+        std::vector<INT> Fill(Offsets.begin(), Offsets.end() - 1);
+
+        for (INT i = 0; i < NumOfT * 3; i++)
+          Adj[Fill[Ind[i]]++] = i / 3;
+      }
+
+      auto NewVertices = [&]( INT t )
+      {
+        return (Local[Ind[t * 3]] == None) + (Local[Ind[t * 3 + 1]] == None) + (Local[Ind[t * 3 + 2]] == None);
+      };
+      auto Add = [&]( INT t )
+      {
+        for (INT k = 0; k < 3; k++)
+        {
+          UINT v = Ind[t * 3 + k];
+
+          if (Local[v] == None)
+          {
+            Local[v] = (BYTE)M.VertexCount++;
+            Vertices.push_back(v);
+          }
+          Triangles.push_back(Local[v]);
+        }
+        M.TriangleCount++;
+        Used[t] = 1;
+      };
+      auto Finish = [&]( VOID )
+      {
+        Meshlets.push_back(M);
+        Bounds.push_back(ComputeBounds(M, (const BYTE *)Pos, Stride, Normals));
+        for (UINT i = 0; i < M.VertexCount; i++)
+          Local[Vertices[M.VertexOffset + i]] = None;
+        M.VertexOffset = (UINT)Vertices.size();
+        M.TriangleOffset = (UINT)Triangles.size();
+        M.VertexCount = M.TriangleCount = 0;
+      };
+
+      while (TRUE)
+      {
+        while (Cursor < NumOfT && Used[Cursor])
+          Cursor++;
+        if (Cursor == NumOfT)
+          break;
+        Add(Cursor);
+        /* Grow by the neighbour adding fewest vertices */
+        while (M.TriangleCount < (UINT)MaxTriangles)
+        {
+          INT Best = -1, BestNew = 4;
+
+          for (UINT i = 0; i < M.VertexCount && BestNew > 0; i++)
+          {
+            UINT v = Vertices[M.VertexOffset + i];
+
+            for (INT a = Offsets[v]; a < Offsets[v + 1]; a++)
+            {
+              INT t = Adj[a], n;
+
+              if (Used[t] || (n = NewVertices(t)) >= BestNew || M.VertexCount + n > (UINT)MaxVertices)
+                continue;
+              Best = t;
+              if ((BestNew = n) == 0)
+                break;
+            }
+          }
+          if (Best < 0)
+            break;
+          Add(Best);
+        }
+        Finish();
+      }
+    } /* End of 'Build' function */
+
+    /* Test meshlet visibility function.
+     * ARGUMENTS:
+     *   - meshlet culling data:
+     *       const meshlet_bounds &B;
+     *   - view:
+     *       const meshlet_view &V;
+     * RETURNS:
+     *   (BOOL) TRUE if meshlet may be visible.
+     */
+    static BOOL IsVisible( const meshlet_bounds &B, const meshlet_view &V )
+    {
+      for (INT p = 0; p < 6; p++)
+        if (V.Planes[p][0] * B.Center[0] + V.Planes[p][1] * B.Center[1] +
+            V.Planes[p][2] * B.Center[2] + V.Planes[p][3] < -B.Radius)
+          return FALSE;
+      if (B.ConeCutoff <= 1)
+      {
+        FLT
+          d[3] = {B.ConeApex[0] - V.Eye[0], B.ConeApex[1] - V.Eye[1], B.ConeApex[2] - V.Eye[2]},
+          Len = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+        if (d[0] * B.ConeAxis[0] + d[1] * B.ConeAxis[1] + d[2] * B.ConeAxis[2] >= B.ConeCutoff * Len)
+          return FALSE;
+      }
+      return TRUE;
+    } /* End of 'IsVisible' function */
+
+    /* Cull meshlets function.
+     * ARGUMENTS:
+     *   - view:
+     *       const meshlet_view &V;
+     *   - visible meshlet indices to fill:
+     *       std::vector<UINT> &Visible;
+     * RETURNS:
+     *   (INT) number of visible meshlets.
+     */
+    INT Cull( const meshlet_view &V, std::vector<UINT> &Visible ) const
+    {
+      Visible.clear();
+      for (size_t i = 0; i < Bounds.size(); i++)
+        if (IsVisible(Bounds[i], V))
+          Visible.push_back((UINT)i);
+      return (INT)Visible.size();
+    } /* End of 'Cull' function */
+
+    /* Save meshlets to file function (offline build).
+     * ARGUMENTS:
+     *   - file name:
+     *       const std::string &FileName;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    BOOL Save( const std::string &FileName ) const
+    {
+      std::ofstream F(FileName, std::ios::binary);
+      UINT32 Head[4] = {Version, (UINT32)Meshlets.size(), (UINT32)Vertices.size(), (UINT32)Triangles.size()};
+
+      if (!F.is_open())
+        return FALSE;
+      F.write("NDML", 4);
+      F.write((const CHAR *)Head, sizeof(Head));
+      F.write((const CHAR *)Meshlets.data(), Meshlets.size() * sizeof(meshlet));
+      F.write((const CHAR *)Vertices.data(), Vertices.size() * sizeof(UINT));
+      F.write((const CHAR *)Triangles.data(), Triangles.size());
+      F.write((const CHAR *)Bounds.data(), Bounds.size() * sizeof(meshlet_bounds));
+      return (BOOL)F.good();
+    } /* End of 'Save' function */
+
+    /* Load meshlets from file written by 'Save' function.
+     * ARGUMENTS:
+     *   - file name:
+     *       const std::string &FileName;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    BOOL Load( const std::string &FileName )
+    {
+      std::ifstream F(FileName, std::ios::binary);
+      CHAR Magic[4];
+      UINT32 Head[4];
+
+      if (!F.read(Magic, 4) || memcmp(Magic, "NDML", 4) != 0 ||
+          !F.read((CHAR *)Head, sizeof(Head)) || Head[0] != Version)
+        return FALSE;
+      Meshlets.resize(Head[1]);
+      Vertices.resize(Head[2]);
+      Triangles.resize(Head[3]);
+      Bounds.resize(Head[1]);
+      F.read((CHAR *)Meshlets.data(), Meshlets.size() * sizeof(meshlet));
+      F.read((CHAR *)Vertices.data(), Vertices.size() * sizeof(UINT));
+      F.read((CHAR *)Triangles.data(), Triangles.size());
+      F.read((CHAR *)Bounds.data(), Bounds.size() * sizeof(meshlet_bounds));
+      if (!F)
+      {
+        Meshlets.clear();
+        Vertices.clear();
+        Triangles.clear();
+        Bounds.clear();
+        return FALSE;
+      }
+      return TRUE;
+    } /* End of 'Load' function */
+  }; /* end of 'meshlet_mesh' class */
+} /* end of 'nidx' spacename */
+#endif // !_meshlet_h_
+
+/* END OF 'meshlet.h' FILE */
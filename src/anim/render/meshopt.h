@@ -0,0 +1,369 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : meshopt.h
+  * PURPOSE     : T51DX12 project.
+  *               Index and vertex buffers optimization declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Vertex cache order is built with Tipsify (Sander,
+  *               Nehab, Barczak 2007) against a FIFO cache model, the
+  *               same model 'AnalyzeVertexCache' simulates. Overdraw
+  *               pass keeps cache order inside clusters starting at
+  *               cache restarts and sorts clusters outward facing first.
+  *               Passes are meant to run in order cache, overdraw,
+  *               fetch at import.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _meshopt_h_
+#define _meshopt_h_
+
+#include "../../def.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace nidx
+{
+  /* Mesh buffers optimizer class */
+  class mesh_optimizer
+  {
+  public:
+    /* Vertex cache statistics structure */
+    struct cache_stats
+    {
+      UINT Transformed;   /* Number of vertex shader invocations */
+      FLT
+        ACMR,             /* Average transformed vertices per triangle (0.5 best) */
+        ATVR;             /* Transformed vertices per used vertex (1 best) */
+    }; /* End of 'cache_stats' structure */
+
+    /* Vertex fetch statistics structure */
+    struct fetch_stats
+    {
+      UINT BytesFetched;  /* Number of bytes read in cache lines */
+      FLT Overfetch;      /* Fetched bytes per vertex buffer byte (1 best) */
+    }; /* End of 'fetch_stats' structure */
+
+    /* Simulate FIFO post-transform cache function.
+     * ARGUMENTS:
+     *   - triangle list indices:
+     *       const UINT *Ind;
+     *       INT NumOfI;
+     *   - number of vertices:
+     *       INT NumOfV;
+     *   - cache size:
+     *       INT CacheSize;
+     * RETURNS:
+     *   (cache_stats) statistics.
+     */
+    static cache_stats AnalyzeVertexCache( const UINT *Ind, INT NumOfI, INT NumOfV, INT CacheSize = 16 )
+    {
+      std::vector<UINT> Stamp(NumOfV, 0);
+      std::vector<BYTE> IsUsed(NumOfV, 0);
+      UINT Time = CacheSize + 1, Used = 0;
+      cache_stats S = {0, 0, 0};
+
+      for (INT i = 0; i < NumOfI; i++)
+      {
+        UINT v = Ind[i];
+
+        /* Entries older than cache size are evicted */
+        if (Time - Stamp[v] > (UINT)CacheSize)
+        {
+          Stamp[v] = Time++;
+          S.Transformed++;
+        }
+        Used += !IsUsed[v];
+        IsUsed[v] = 1;
+      }
+      S.ACMR = NumOfI < 3 ? 0 : (FLT)S.Transformed / (NumOfI / 3);
+      S.ATVR = Used == 0 ? 0 : (FLT)S.Transformed / Used;
+      return S;
+    } /* End of 'AnalyzeVertexCache' function */
+
+    /* Simulate vertex fetch through cache lines function.
+     * ARGUMENTS:
+     *   - triangle list indices:
+     *       const UINT *Ind;
+     *       INT NumOfI;
+     *   - number of vertices and vertex size:
+     *       INT NumOfV;
+     *       size_t VertexSize;
+     * RETURNS:
+     *   (fetch_stats) statistics.
+     */
+    static fetch_stats AnalyzeVertexFetch( const UINT *Ind, INT NumOfI, INT NumOfV, size_t VertexSize )
+    {
+      const INT LineSize = 64, NumOfLines = 64;
+      std::vector<size_t> Lines(NumOfLines, ~(size_t)0);
+      INT Next = 0;
+      fetch_stats S = {0, 0};
+
+      for (INT i = 0; i < NumOfI; i++)
+      {
+        size_t First = Ind[i] * VertexSize / LineSize, Last = (Ind[i] * VertexSize + VertexSize - 1) / LineSize;
+
+        for (size_t l = First; l <= Last; l++)
+          if (std::find(Lines.begin(), Lines.end(), l) == Lines.end())
+          {
+            Lines[Next] = l;
+            Next = (Next + 1) % NumOfLines;
+            S.BytesFetched += LineSize;
+          }
+      }
+      S.Overfetch = NumOfV == 0 ? 0 : (FLT)S.BytesFetched / (NumOfV * VertexSize);
+      return S;
+    } /* End of 'AnalyzeVertexFetch' function */
+
+    /* Reorder triangles for post-transform cache function.
+     * ARGUMENTS:
+     *   - output indices (may not alias input):
+     *       UINT *Dst;
+     *   - triangle list indices:
+     *       const UINT *Ind;
+     *       INT NumOfI;
+     *   - number of vertices:
+     *       INT NumOfV;
+     *   - cache size:
+     *       INT CacheSize;
+     * RETURNS: None.
+     */
+    static VOID OptimizeVertexCache( UINT *Dst, const UINT *Ind, INT NumOfI, INT NumOfV, INT CacheSize = 16 )
+    {
+      INT NumOfT = NumOfI / 3, Out = 0, Fan = 0, Cursor = 0;
+      std::vector<INT> Offsets(NumOfV + 1, 0), Adj(NumOfT * 3), Live(NumOfV, 0), Stack;
+      std::vector<UINT> Stamp(NumOfV, 0);
+      std::vector<BYTE> Emitted(NumOfT, 0);
+      std::vector<INT> Candidates;
+      UINT Time = CacheSize + 1;
+
+      if (NumOfT == 0)
+        return;
+      for (INT i = 0; i < NumOfT * 3; i++)
+        Offsets[Ind[i] + 1]++, Live[Ind[i]]++;
+      for (INT v = 0; v < NumOfV; v++)
+        Offsets[v + 1] += Offsets[v];
+      {
+        std::vector<INT> Fill(Offsets.begin(), Offsets.end() - 1);
+
+        for (INT i = 0; i < NumOfT * 3; i++)
+          Adj[Fill[Ind[i]]++] = i / 3;
+      }
+      Fan = Ind[0];
+
+      while (Fan >= 0)
+      {
+        INT Best = -1, BestP = -1;
+
+        /* Emit all remaining triangles around fanning vertex */
+        Candidates.clear();
+        for (INT a = Offsets[Fan]; a < Offsets[Fan + 1]; a++)
+        {
+          INT t = Adj[a];
+
+          if (Emitted[t])
+            continue;
+          Emitted[t] = 1;
+          for (INT k = 0; k < 3; k++)
+          {
+            UINT v = Ind[t * 3 + k];
+
+            Dst[Out++] = v;
+            Stack.push_back(v);
+            Candidates.push_back(v);
+            Live[v]--;
+            if (Time - Stamp[v] > (UINT)CacheSize)
+              Stamp[v] = Time++;
+          }
+        }
+        /* Next fan: candidate staying in cache after its own fan */
+        for (INT v : Candidates)
+          if (Live[v] > 0)
+          {
+            INT p = 0;
+
+            if ((INT)(Time - Stamp[v]) + 2 * Live[v] <= CacheSize)
+              p = Time - Stamp[v];
+            if (p > BestP)
+              BestP = p, Best = v;
+          }
+        if (Best < 0)
+        {
+          /* Dead end: recently used vertices, then input order */
+          while (!Stack.empty() && Best < 0)
+          {
+            if (Live[Stack.back()] > 0)
+              Best = Stack.back();
+            Stack.pop_back();
+          }
+          while (Best < 0 && Cursor < NumOfV)
+            if (Live[Cursor++] > 0)
+              Best = Cursor - 1;
+        }
+        Fan = Best;
+      }
+    } /* End of 'OptimizeVertexCache' function */
+
+    /* Reorder cache optimized triangles to reduce overdraw function.
+     * ARGUMENTS:
+     *   - output indices (may not alias input):
+     *       UINT *Dst;
+     *   - cache optimized triangle list indices:
+     *       const UINT *Ind;
+     *       INT NumOfI;
+     *   - vertex positions (3 floats at stride):
+     *       const FLT *Pos;
+     *       INT NumOfV;
+     *       size_t Stride;
+     *   - cache size:
+     *       INT CacheSize;
+     * RETURNS: None.
+     */
+    static VOID OptimizeOverdraw( UINT *Dst, const UINT *Ind, INT NumOfI, const FLT *Pos, INT NumOfV, size_t Stride,
+                                  INT CacheSize = 16 )
+    {
+      /* Cluster structure */
+      struct cluster
+      {
+        INT Start, Count; /* Triangles range */
+        FLT Sort;         /* Outward facing measure */
+      };
+      std::vector<UINT> Stamp(NumOfV, 0);
+      std::vector<cluster> Clusters;
+      UINT Time = CacheSize + 1;
+      INT NumOfT = NumOfI / 3, Out = 0;
+      DBL Center[3] = {0, 0, 0};
+
+      auto P = [&]( UINT v ) -> const FLT *
+      {
+        return (const FLT *)((const BYTE *)Pos + v * Stride);
+      };
+
+      /* Split at triangles missing all three vertices: cache restarts */
+      for (INT t = 0; t < NumOfT; t++)
+      {
+        INT Misses = 0;
+
+        for (INT k = 0; k < 3; k++)
+        {
+          UINT v = Ind[t * 3 + k];
+
+          if (Time - Stamp[v] > (UINT)CacheSize)
+          {
+            Stamp[v] = Time++;
+            Misses++;
+          }
+        }
+        if (t == 0 || Misses == 3)
+          Clusters.push_back({t, 0, 0});
+        Clusters.back().Count++;
+      }
+      for (INT i = 0; i < NumOfT * 3; i++)
+        for (INT k = 0; k < 3; k++)
+          Center[k] += P(Ind[i])[k];
+      for (INT k = 0; k < 3; k++)
+        Center[k] /= std::max(NumOfT * 3, 1);
+
+      /* Clusters facing away from mesh center are likely occluders */
+      for (auto &C : Clusters)
+      {
+        DBL N[3] = {0, 0, 0}, M[3] = {0, 0, 0}, Area = 0, Len;
+
+        for (INT t = C.Start; t < C.Start + C.Count; t++)
+        {
+          const FLT *p0 = P(Ind[t * 3]), *p1 = P(Ind[t * 3 + 1]), *p2 = P(Ind[t * 3 + 2]);
+          DBL
+            e1[3] = {(DBL)p1[0] - p0[0], (DBL)p1[1] - p0[1], (DBL)p1[2] - p0[2]},
+            e2[3] = {(DBL)p2[0] - p0[0], (DBL)p2[1] - p0[1], (DBL)p2[2] - p0[2]},
+            n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]},
+            a = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+          for (INT k = 0; k < 3; k++)
+          {
+            N[k] += n[k];
+            M[k] += (p0[k] + p1[k] + p2[k]) / 3 * a;
+          }
+          Area += a;
+        }
+        Len = sqrt(N[0] * N[0] + N[1] * N[1] + N[2] * N[2]);
+        if (Area == 0 || Len == 0)
+          continue;
+        C.Sort = (FLT)(((M[0] / Area - Center[0]) * N[0] + (M[1] / Area - Center[1]) * N[1] +
+                        (M[2] / Area - Center[2]) * N[2]) / Len);
+      }
+      std::stable_sort(Clusters.begin(), Clusters.end(), []( const cluster &A, const cluster &B )
+        {
+          return A.Sort > B.Sort;
+        });
+      for (auto &C : Clusters)
+        for (INT i = C.Start * 3; i < (C.Start + C.Count) * 3; i++)
+          Dst[Out++] = Ind[i];
+    } /* End of 'OptimizeOverdraw' function */
+
+    /* Reorder vertices in first use order function.
+     * ARGUMENTS:
+     *   - output vertices (may not alias input):
+     *       VOID *DstVerts;
+     *   - triangle list indices to remap in place:
+     *       UINT *Ind;
+     *       INT NumOfI;
+     *   - vertices:
+     *       const VOID *Verts;
+     *       INT NumOfV;
+     *       size_t VertexSize;
+     * RETURNS:
+     *   (INT) number of output vertices (unused ones are dropped).
+     */
+    static INT OptimizeVertexFetch( VOID *DstVerts, UINT *Ind, INT NumOfI, const VOID *Verts, INT NumOfV, size_t VertexSize )
+    {
+      std::vector<UINT> Remap(NumOfV, ~0u);
+      UINT n = 0;
+
+      for (INT i = 0; i < NumOfI; i++)
+      {
+        UINT &r = Remap[Ind[i]];
+
+        if (r == ~0u)
+        {
+          memcpy((BYTE *)DstVerts + n * VertexSize, (const BYTE *)Verts + Ind[i] * VertexSize, VertexSize);
+          r = n++;
+        }
+        Ind[i] = r;
+      }
+      return (INT)n;
+    } /* End of 'OptimizeVertexFetch' function */
+
+    /* Run all passes function.
+     * ARGUMENTS:
+     *   - triangle list indices to optimize in place:
+     *       std::vector<UINT> &Ind;
+     *   - vertices to reorder in place (position is first 3 floats):
+     *       std::vector<BYTE> &Verts;
+     *       size_t VertexSize;
+     *   - cache size:
+     *       INT CacheSize;
+     * RETURNS: None.
+     */
+    static VOID Optimize( std::vector<UINT> &Ind, std::vector<BYTE> &Verts, size_t VertexSize, INT CacheSize = 16 )
+    {
+      INT NumOfV = (INT)(Verts.size() / VertexSize);
+      std::vector<UINT> Tmp(Ind.size());
+      std::vector<BYTE> V(Verts.size());
+
+      OptimizeVertexCache(Tmp.data(), Ind.data(), (INT)Ind.size(), NumOfV, CacheSize);
+      OptimizeOverdraw(Ind.data(), Tmp.data(), (INT)Ind.size(), (const FLT *)Verts.data(), NumOfV, VertexSize, CacheSize);
+      V.resize(OptimizeVertexFetch(V.data(), Ind.data(), (INT)Ind.size(), Verts.data(), NumOfV, VertexSize) * VertexSize);
+      Verts.swap(V);
+    } /* End of 'Optimize' function */
+  }; /* end of 'mesh_optimizer' class */
+} /* end of 'nidx' spacename */
+#endif // !_meshopt_h_
+
+/* END OF 'meshopt.h' FILE */
@@ -0,0 +1,303 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : occlusion.h
+  * PURPOSE     : T51DX12 project.
+  *               Software occlusion culling declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Occluders are rasterized depth only by 'soft_raster'
+  *               into a low resolution buffer, which is reduced to 8x8
+  *               tiles farthest depth. Bound boxes are tested against
+  *               tiles they cover fully and against pixels of partially
+  *               covered tiles. Occluder coverage is sampled at pixel
+  *               centers, so boxes peeking through gaps thinner than a
+  *               low resolution pixel may be culled.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _occlusion_h_
+#define _occlusion_h_
+
+#include "../../def.h"
+#include "../jobs.h"
+#include "soft.h"
+
+#include <atomic>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define NIDX_OCCLUSION_SSE2
+#endif /* __SSE2__ */
+
+namespace nidx
+{
+  /* Software occlusion culling class */
+  class occlusion
+  {
+  public:
+    static const INT TileSize = 8;
+
+    /* Bound box test results */
+    enum struct result
+    {
+      VISIBLE,  /* Box may be visible */
+      OUTSIDE,  /* Box is out of frustum */
+      OCCLUDED, /* Box is hidden by occluders */
+    }; /* End of 'result' enum */
+
+    /* Axis aligned bound box structure */
+    struct box
+    {
+      vec3 Min, Max; /* Box corners */
+    }; /* End of 'box' structure */
+
+  private:
+    jobs &Pool;               /* Worker threads */
+    soft_raster Raster;       /* Occluders depth rasterizer */
+    INT W, H, TilesX, TilesY; /* Depth buffer and tiles grid sizes */
+    std::vector<FLT> TileMax; /* Tiles farthest depth */
+    matr VP;                  /* View projection matrix */
+
+    /* Check any depth of row span is farther than given function.
+     * ARGUMENTS:
+     *   - depth row span:
+     *       const FLT *D;
+     *       INT N;
+     *   - depth to compare with:
+     *       FLT Z;
+     * RETURNS:
+     *   (BOOL) TRUE if some depth is farther than Z.
+     */
+    static BOOL IsSpanFarther( const FLT *D, INT N, FLT Z )
+    {
+      INT i = 0;
+
+#ifdef NIDX_OCCLUSION_SSE2
+      __m128 z = _mm_set1_ps(Z);
+
+      for (; i + 4 <= N; i += 4)
+        if (_mm_movemask_ps(_mm_cmplt_ps(z, _mm_loadu_ps(D + i))) != 0)
+          return TRUE;
+#endif /* NIDX_OCCLUSION_SSE2 */
+      for (; i < N; i++)
+        if (Z < D[i])
+          return TRUE;
+      return FALSE;
+    } /* End of 'IsSpanFarther' function */
+
+  public:
+    std::atomic<UINT64>
+      TestCounter,            /* Number of tested boxes since 'Begin' */
+      OutsideCounter,         /* Number of out of frustum boxes since 'Begin' */
+      OccludedCounter;        /* Number of occluded boxes since 'Begin' */
+
+    /* Occlusion culling initializing function.
+     * ARGUMENTS:
+     *   - depth buffer size:
+     *       INT NewW, NewH;
+     *   - worker threads:
+     *       jobs &NewPool;
+     */
+    occlusion( INT NewW = 256, INT NewH = 128, jobs &NewPool = jobs::Get() ) :
+      Pool(NewPool), Raster(NewW, NewH, NewPool), W(NewW), H(NewH),
+      TilesX((NewW + TileSize - 1) / TileSize), TilesY((NewH + TileSize - 1) / TileSize),
+      TileMax((size_t)TilesX * TilesY, 1), VP(matr::Identity()),
+      TestCounter(0), OutsideCounter(0), OccludedCounter(0)
+    {
+      Raster.IsColorWrite = FALSE;
+    } /* End of 'occlusion' function */
+
+    /* Start frame function.
+     * ARGUMENTS:
+     *   - view projection matrix:
+     *       const matr &M;
+     * RETURNS: None.
+     */
+    VOID Begin( const matr &M )
+    {
+      VP = M;
+      Raster.SetTransform(M);
+      Raster.Clear(0, 1);
+      TestCounter = 0;
+      OutsideCounter = 0;
+      OccludedCounter = 0;
+    } /* End of 'Begin' function */
+
+    /* Add occluder triangles function.
+     * ARGUMENTS:
+     *   - vertices (attributes are ignored):
+     *       const soft_vertex *V;
+     *       INT NumOfV;
+     *   - indices (nullptr - non-indexed):
+     *       const INT *Ind;
+     *       INT NumOfI;
+     * RETURNS: None.
+     */
+    VOID AddOccluder( const soft_vertex *V, INT NumOfV, const INT *Ind = nullptr, INT NumOfI = 0 )
+    {
+      Raster.Draw(V, NumOfV, Ind, NumOfI);
+    } /* End of 'AddOccluder' function */
+
+    /* Add box occluder function.
+     * ARGUMENTS:
+     *   - box:
+     *       const box &B;
+     * RETURNS: None.
+     */
+    VOID AddOccluder( const box &B )
+    {
+      static const INT Ind[36] =
+      {
+        0, 2, 3, 0, 3, 1,  4, 5, 7, 4, 7, 6,  0, 1, 5, 0, 5, 4,
+        2, 6, 7, 2, 7, 3,  0, 4, 6, 0, 6, 2,  1, 3, 7, 1, 7, 5,
+      };
+      vec3 Min = B.Min, Max = B.Max;
+      soft_vertex V[8];
+
+      for (INT i = 0; i < 8; i++)
+        V[i] = {(i & 1) ? Max[0] : Min[0], (i & 2) ? Max[1] : Min[1], (i & 4) ? Max[2] : Min[2], {0, 0, 0, 0}};
+      Raster.Draw(V, 8, Ind, 36);
+    } /* End of 'AddOccluder' function */
+
+    /* Rasterize occluders and build tiles depth function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Build( VOID )
+    {
+      const FLT *D = Raster.GetDepth();
+
+      Raster.Flush();
+      Pool.ParallelFor(TilesY, [this, D]( INT ty, INT )
+        {
+          INT y0 = ty * TileSize, y1 = std::min(y0 + TileSize, H);
+
+          for (INT tx = 0; tx < TilesX; tx++)
+          {
+            INT x0 = tx * TileSize, x1 = std::min(x0 + TileSize, W);
+            FLT m = 0;
+
+            for (INT y = y0; y < y1; y++)
+              for (INT x = x0; x < x1; x++)
+                m = std::max(m, D[(size_t)y * W + x]);
+            TileMax[(size_t)ty * TilesX + tx] = m;
+          }
+        });
+    } /* End of 'Build' function */
+
+    /* Test bound box function (thread safe after 'Build').
+     * ARGUMENTS:
+     *   - world space box:
+     *       const box &B;
+     * RETURNS:
+     *   (result) test result.
+     */
+    result Test( const box &B ) const
+    {
+      const FLT *M = VP, *D = Raster.GetDepth();
+      vec3 Min = B.Min, Max = B.Max;
+      FLT C[8][4], MinX = W, MinY = H, MaxX = 0, MaxY = 0, MinZ = 1;
+      INT X0, Y0, X1, Y1, AllOut = 0x3F, AnyNear = 0;
+
+      for (INT i = 0; i < 8; i++)
+      {
+        FLT x = (i & 1) ? Max[0] : Min[0], y = (i & 2) ? Max[1] : Min[1], z = (i & 4) ? Max[2] : Min[2];
+
+        C[i][0] = x * M[0] + y * M[4] + z * M[8] + M[12];
+        C[i][1] = x * M[1] + y * M[5] + z * M[9] + M[13];
+        C[i][2] = x * M[2] + y * M[6] + z * M[10] + M[14];
+        C[i][3] = x * M[3] + y * M[7] + z * M[11] + M[15];
+        AllOut &=
+          (C[i][0] < -C[i][3]) | (C[i][0] > C[i][3]) << 1 |
+          (C[i][1] < -C[i][3]) << 2 | (C[i][1] > C[i][3]) << 3 |
+          (C[i][2] < -C[i][3]) << 4 | (C[i][2] > C[i][3]) << 5;
+        AnyNear |= C[i][2] < -C[i][3];
+      }
+      if (AllOut != 0)
+        return result::OUTSIDE;
+      /* Crossing near plane - keep it */
+      if (AnyNear)
+        return result::VISIBLE;
+      for (INT i = 0; i < 8; i++)
+      {
+        FLT
+          cx = (C[i][0] / C[i][3] * 0.5f + 0.5f) * W,
+          cy = (0.5f - C[i][1] / C[i][3] * 0.5f) * H,
+          cz = C[i][2] / C[i][3] * 0.5f + 0.5f;
+
+        MinX = std::min(MinX, cx), MaxX = std::max(MaxX, cx);
+        MinY = std::min(MinY, cy), MaxY = std::max(MaxY, cy);
+        MinZ = std::min(MinZ, cz);
+      }
+      if (MaxX < 0 || MaxY < 0 || MinX >= W || MinY >= H)
+        return result::OUTSIDE;
+      X0 = std::max(0, (INT)MinX), X1 = std::min(W - 1, (INT)MaxX);
+      Y0 = std::max(0, (INT)MinY), Y1 = std::min(H - 1, (INT)MaxY);
+
+      for (INT ty = Y0 / TileSize; ty <= Y1 / TileSize; ty++)
+        for (INT tx = X0 / TileSize; tx <= X1 / TileSize; tx++)
+        {
+          INT
+            x0 = std::max(X0, tx * TileSize), x1 = std::min(X1, tx * TileSize + TileSize - 1),
+            y0 = std::max(Y0, ty * TileSize), y1 = std::min(Y1, ty * TileSize + TileSize - 1);
+
+          if (MinZ >= TileMax[(size_t)ty * TilesX + tx])
+            continue;
+          /* Fully covered tile is farther somewhere */
+          if (x0 == tx * TileSize && y0 == ty * TileSize &&
+              (x1 == tx * TileSize + TileSize - 1 || x1 == W - 1) &&
+              (y1 == ty * TileSize + TileSize - 1 || y1 == H - 1))
+            return result::VISIBLE;
+          for (INT y = y0; y <= y1; y++)
+            if (IsSpanFarther(D + (size_t)y * W + x0, x1 - x0 + 1, MinZ))
+              return result::VISIBLE;
+        }
+      return result::OCCLUDED;
+    } /* End of 'Test' function */
+
+    /* Test bound boxes on worker threads function.
+     * ARGUMENTS:
+     *   - boxes:
+     *       const box *Boxes;
+     *       INT N;
+     *   - visibility flags to fill:
+     *       BYTE *Visible;
+     * RETURNS:
+     *   (INT) number of visible boxes.
+     */
+    INT Cull( const box *Boxes, INT N, BYTE *Visible )
+    {
+      const INT Chunk = 256;
+      std::atomic<INT> NumOfVisible(0);
+
+      Pool.ParallelFor((N + Chunk - 1) / Chunk, [&]( INT c, INT )
+        {
+          INT nv = 0, no = 0, nc = 0;
+
+          for (INT i = c * Chunk; i < std::min(N, c * Chunk + Chunk); i++)
+          {
+            result r = Test(Boxes[i]);
+
+            Visible[i] = r == result::VISIBLE;
+            nv += r == result::VISIBLE;
+            no += r == result::OUTSIDE;
+            nc += r == result::OCCLUDED;
+          }
+          NumOfVisible += nv;
+          OutsideCounter += no;
+          OccludedCounter += nc;
+        });
+      TestCounter += N;
+      return NumOfVisible;
+    } /* End of 'Cull' function */
+  }; /* end of 'occlusion' class */
+} /* end of 'nidx' spacename */
+#endif // !_occlusion_h_
+
+/* END OF 'occlusion.h' FILE */
@@ -0,0 +1,242 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : packet.h
+  * PURPOSE     : T51DX12 project.
+  *               Frame packets and render thread declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Backend independent. Simulation thread writes render
+  *               proxies of every frame into a packet of the ring, render
+  *               thread consumes packets in order. Ring of 1 packet makes
+  *               threads alternate, 2 packets let simulation of next frame
+  *               overlap rendering, 3 packets also absorb single slow
+  *               frames of either side. Every written frame is rendered
+  *               (replays stay deterministic).
+  *               Single producer single consumer, no locks: positions
+  *               are atomic counters, waiting side yields. Packets keep
+  *               their storage, so steady frames do not allocate.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _packet_h_
+#define _packet_h_
+
+#include "../../def.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace nidx
+{
+  /* Render proxy structure */
+  struct render_proxy
+  {
+    matr World;      /* Object to world transform */
+    UINT
+      Mesh,          /* Mesh identifier */
+      Material;      /* Material identifier */
+  }; /* End of 'render_proxy' structure */
+
+  /* Frame packet structure */
+  struct frame_packet
+  {
+    UINT64 Frame;                      /* Frame number */
+    DBL
+      Time,                            /* Simulation time in seconds */
+      Alpha,                           /* Interpolation factor between steps */
+      InputTime;                       /* Input sampling time (pacer clock) */
+    BOOL IsVSync;                      /* Present with vertical sync */
+    matr View, Proj;                   /* Camera matrices */
+    std::vector<render_proxy> Proxies; /* Visible objects */
+  }; /* End of 'frame_packet' structure */
+
+  /* Frame packets ring class */
+  class packet_ring
+  {
+  public:
+    /* Enumerator, not static member: 'std::min' takes it by reference */
+    enum
+    {
+      MaxPackets = 3
+    };
+
+  private:
+    frame_packet Packets[MaxPackets];  /* Packets */
+    INT NumOfPackets;                  /* Number of used packets */
+    BYTE Pad0[64];                     /* Keep counters on own cache lines */
+    std::atomic<UINT64> Written;       /* Number of published packets */
+    BYTE Pad1[64];
+    std::atomic<UINT64> Read;          /* Number of consumed packets */
+    BYTE Pad2[64];
+    std::atomic<BOOL> IsClosed;        /* No more packets will be written */
+
+  public:
+    std::atomic<UINT64>
+      WriteWaits,                      /* Number of times producer waited */
+      ReadWaits;                       /* Number of times consumer waited */
+
+    /* Ring initializing function.
+     * ARGUMENTS:
+     *   - number of packets [1..MaxPackets]:
+     *       INT NewNumOfPackets;
+     */
+    packet_ring( INT NewNumOfPackets = 2 ) :
+      NumOfPackets(std::min<INT>(std::max(NewNumOfPackets, 1), MaxPackets)),
+      Written(0), Read(0), IsClosed(FALSE), WriteWaits(0), ReadWaits(0)
+    {
+    } /* End of 'packet_ring' function */
+
+    /* Obtain packet to write function (producer side, waits for free packet).
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (frame_packet *) packet to fill, its previous contents are kept for reuse.
+     */
+    frame_packet * BeginWrite( VOID )
+    {
+      UINT64 w = Written.load(std::memory_order_relaxed);
+
+      if (w - Read.load(std::memory_order_acquire) >= (UINT64)NumOfPackets)
+      {
+        WriteWaits++;
+        while (w - Read.load(std::memory_order_acquire) >= (UINT64)NumOfPackets)
+          std::this_thread::yield();
+      }
+      return &Packets[w % NumOfPackets];
+    } /* End of 'BeginWrite' function */
+
+    /* Publish written packet function (producer side).
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID EndWrite( VOID )
+    {
+      Written.store(Written.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    } /* End of 'EndWrite' function */
+
+    /* Stop writing function (producer side).
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Close( VOID )
+    {
+      IsClosed.store(TRUE, std::memory_order_release);
+    } /* End of 'Close' function */
+
+    /* Obtain packet to read function (consumer side, waits for packet).
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const frame_packet *) oldest published packet, nullptr if ring is closed and empty.
+     */
+    const frame_packet * BeginRead( VOID )
+    {
+      UINT64 r = Read.load(std::memory_order_relaxed);
+
+      if (r == Written.load(std::memory_order_acquire))
+      {
+        ReadWaits++;
+        while (r == Written.load(std::memory_order_acquire))
+        {
+          /* Check written counter once more after close to catch last packet */
+          if (IsClosed.load(std::memory_order_acquire) && r == Written.load(std::memory_order_acquire))
+            return nullptr;
+          std::this_thread::yield();
+        }
+      }
+      return &Packets[r % NumOfPackets];
+    } /* End of 'BeginRead' function */
+
+    /* Release read packet function (consumer side).
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID EndRead( VOID )
+    {
+      Read.store(Read.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    } /* End of 'EndRead' function */
+
+    /* Obtain number of packets function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) number of packets.
+     */
+    INT GetNumOfPackets( VOID ) const
+    {
+      return NumOfPackets;
+    } /* End of 'GetNumOfPackets' function */
+  }; /* end of 'packet_ring' class */
+
+  /* Render thread class */
+  class render_thread
+  {
+  public:
+    /* Packet consumer function type */
+    typedef std::function<VOID( const frame_packet & )> consumer;
+
+  private:
+    packet_ring &Ring;     /* Consumed ring */
+    std::thread Worker;    /* Render thread */
+
+  public:
+    /* Render thread initializing function.
+     * ARGUMENTS:
+     *   - consumed ring:
+     *       packet_ring &NewRing;
+     */
+    render_thread( packet_ring &NewRing ) : Ring(NewRing)
+    {
+    } /* End of 'render_thread' function */
+
+    /* Render thread deinitializing function.
+     * ARGUMENTS: None.
+     */
+    ~render_thread( VOID )
+    {
+      Stop();
+    } /* End of '~render_thread' function */
+
+    /* Start rendering packets on own thread function.
+     * ARGUMENTS:
+     *   - packet consumer (renders and presents frame):
+     *       const consumer &Render;
+     * RETURNS: None.
+     */
+    VOID Start( const consumer &Render )
+    {
+      if (Worker.joinable())
+        return;
+      Worker = std::thread([this, Render]( VOID )
+        {
+          const frame_packet *P;
+
+          while ((P = Ring.BeginRead()) != nullptr)
+          {
+            Render(*P);
+            Ring.EndRead();
+          }
+        });
+    } /* End of 'Start' function */
+
+    /* Close ring and wait for render of written packets function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Stop( VOID )
+    {
+      if (!Worker.joinable())
+        return;
+      Ring.Close();
+      Worker.join();
+    } /* End of 'Stop' function */
+  }; /* end of 'render_thread' class */
+} /* end of 'nidx' spacename */
+#endif // !_packet_h_
+
+/* END OF 'packet.h' FILE */
@@ -0,0 +1,369 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : particles.h
+  * PURPOSE     : T51DX12 project.
+  *               Particle system declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Attributes are stored in separate arrays (padded to 8)
+  *               and updated by 8 particles per instruction with AVX.
+  *               Requires /arch:AVX2 (MSVC, set in all project
+  *               configurations) or -mavx, otherwise scalar loops run.
+  *               Alive particles are always [0, Count), dead ones are
+  *               replaced by last alive (order is not kept).
+  *               Depth sort produces back to front order of indices by
+  *               parallel LSD radix sort of 32-bit keys (8 bits per
+  *               pass, passes with single digit are skipped).
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _particles_h_
+#define _particles_h_
+
+#include "../../def.h"
+#include "../jobs.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX__) || defined(__AVX2__)
+#  include <immintrin.h>
+#  define NIDX_PARTICLES_AVX
+#endif /* __AVX__ */
+
+namespace nidx
+{
+  /* Particle system class */
+  class particles
+  {
+  private:
+    static const INT
+      Chunk = 16384,                      /* Particles per update job */
+      SortChunk = 65536;                  /* Minimal particles per sort job */
+
+    jobs &Pool;                           /* Worker threads */
+    INT Capacity, Count;                  /* Maximal and alive number of particles */
+    std::vector<FLT>
+      X, Y, Z,                            /* Positions */
+      VX, VY, VZ,                         /* Velocities */
+      Age, Life;                          /* Age and life time in seconds */
+    std::vector<UINT>
+      Keys[2], Order[2];                  /* Sort keys and indices (double buffered) */
+    std::vector<UINT> Hist;               /* Digit histograms of every sort job */
+    INT Sorted;                           /* Buffer with sorted indices */
+
+    /* Move particle function.
+     * ARGUMENTS:
+     *   - source and destination indices:
+     *       INT From, To;
+     * RETURNS: None.
+     */
+    VOID Move( INT From, INT To )
+    {
+      X[To] = X[From], Y[To] = Y[From], Z[To] = Z[From];
+      VX[To] = VX[From], VY[To] = VY[From], VZ[To] = VZ[From];
+      Age[To] = Age[From], Life[To] = Life[From];
+    } /* End of 'Move' function */
+
+    /* Update particles range function.
+     * ARGUMENTS:
+     *   - range (begin is multiple of 8):
+     *       INT Begin, End;
+     *   - time step:
+     *       FLT Dt;
+     * RETURNS: None.
+     */
+    VOID UpdateRange( INT Begin, INT End, FLT Dt )
+    {
+      FLT
+        Damp = std::max(0.0f, 1 - Drag * Dt),
+        gx = Gravity[0] * Dt, gy = Gravity[1] * Dt, gz = Gravity[2] * Dt;
+      INT i = Begin;
+
+#ifdef NIDX_PARTICLES_AVX
+      __m256
+        d = _mm256_set1_ps(Damp), t = _mm256_set1_ps(Dt),
+        g0 = _mm256_set1_ps(gx), g1 = _mm256_set1_ps(gy), g2 = _mm256_set1_ps(gz);
+
+      /* Arrays are padded, so tail is processed by whole vector */
+      for (; i < End; i += 8)
+      {
+        __m256
+          vx = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&VX[i]), g0), d),
+          vy = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&VY[i]), g1), d),
+          vz = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&VZ[i]), g2), d);
+
+        _mm256_storeu_ps(&VX[i], vx);
+        _mm256_storeu_ps(&VY[i], vy);
+        _mm256_storeu_ps(&VZ[i], vz);
+        _mm256_storeu_ps(&X[i], _mm256_add_ps(_mm256_loadu_ps(&X[i]), _mm256_mul_ps(vx, t)));
+        _mm256_storeu_ps(&Y[i], _mm256_add_ps(_mm256_loadu_ps(&Y[i]), _mm256_mul_ps(vy, t)));
+        _mm256_storeu_ps(&Z[i], _mm256_add_ps(_mm256_loadu_ps(&Z[i]), _mm256_mul_ps(vz, t)));
+        _mm256_storeu_ps(&Age[i], _mm256_add_ps(_mm256_loadu_ps(&Age[i]), t));
+      }
+#endif /* NIDX_PARTICLES_AVX */
+      for (; i < End; i++)
+      {
+        VX[i] = (VX[i] + gx) * Damp, VY[i] = (VY[i] + gy) * Damp, VZ[i] = (VZ[i] + gz) * Damp;
+        X[i] += VX[i] * Dt, Y[i] += VY[i] * Dt, Z[i] += VZ[i] * Dt;
+        Age[i] += Dt;
+      }
+    } /* End of 'UpdateRange' function */
+
+    /* Remove dead particles function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Compact( VOID )
+    {
+      for (INT i = 0; i < Count;)
+      {
+#ifdef NIDX_PARTICLES_AVX
+        /* Skip 8 alive particles at once */
+        if ((i & 7) == 0 && i + 8 <= Count &&
+            _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(&Age[i]), _mm256_loadu_ps(&Life[i]), _CMP_GE_OQ)) == 0)
+        {
+          i += 8;
+          continue;
+        }
+#endif /* NIDX_PARTICLES_AVX */
+        if (Age[i] >= Life[i])
+          Move(--Count, i);
+        else
+          i++;
+      }
+    } /* End of 'Compact' function */
+
+    /* Compute depth sort keys of particles range function.
+     * ARGUMENTS:
+     *   - range (begin is multiple of 8):
+     *       INT Begin, End;
+     *   - eye position and view direction:
+     *       const FLT *E, *D;
+     * RETURNS: None.
+     */
+    VOID KeysRange( INT Begin, INT End, const FLT *E, const FLT *D )
+    {
+      UINT *K = Keys[0].data(), *O = Order[0].data();
+      FLT Bias = -(E[0] * D[0] + E[1] * D[1] + E[2] * D[2]);
+      INT i = Begin;
+
+#ifdef NIDX_PARTICLES_AVX
+      __m256
+        d0 = _mm256_set1_ps(D[0]), d1 = _mm256_set1_ps(D[1]), d2 = _mm256_set1_ps(D[2]), b = _mm256_set1_ps(Bias),
+        Zero = _mm256_setzero_ps(), Mant = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+      for (; i + 8 <= End; i += 8)
+      {
+        __m256 z = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&X[i]), d0), _mm256_mul_ps(_mm256_loadu_ps(&Y[i]), d1)),
+                                 _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&Z[i]), d2), b));
+
+        /* Descending order: flip all but sign bit of non-negative depths */
+        _mm256_storeu_ps((FLT *)(K + i), _mm256_xor_ps(z, _mm256_andnot_ps(_mm256_cmp_ps(z, Zero, _CMP_LT_OQ), Mant)));
+      }
+#endif /* NIDX_PARTICLES_AVX */
+      for (; i < End; i++)
+      {
+        FLT z = X[i] * D[0] + Y[i] * D[1] + Z[i] * D[2] + Bias;
+        UINT u;
+
+        memcpy(&u, &z, sizeof(UINT));
+        K[i] = z < 0 ? u : u ^ 0x7FFFFFFF;
+      }
+      for (i = Begin; i < End; i++)
+        O[i] = i;
+    } /* End of 'KeysRange' function */
+
+  public:
+    FLT
+      Gravity[3],                         /* Acceleration */
+      Drag;                               /* Velocity damping per second */
+
+    /* Particle system initializing function.
+     * ARGUMENTS:
+     *   - maximal number of particles:
+     *       INT NewCapacity;
+     *   - worker threads:
+     *       jobs &NewPool;
+     */
+    particles( INT NewCapacity, jobs &NewPool = jobs::Get() ) :
+      Pool(NewPool), Capacity(NewCapacity), Count(0), Sorted(0), Gravity{0, -9.8f, 0}, Drag(0)
+    {
+      size_t Size = (NewCapacity + 7) & ~7;
+
+      for (auto *a : {&X, &Y, &Z, &VX, &VY, &VZ, &Age, &Life})
+        a->resize(Size, 0);
+      for (INT b = 0; b < 2; b++)
+      {
+        Keys[b].resize(Size);
+        Order[b].resize(Size);
+      }
+    } /* End of 'particles' function */
+
+    /* Obtain number of alive particles function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) number of particles.
+     */
+    INT GetCount( VOID ) const
+    {
+      return Count;
+    } /* End of 'GetCount' function */
+
+    /* Obtain particle position function.
+     * ARGUMENTS:
+     *   - particle index:
+     *       INT I;
+     *   - position to fill:
+     *       FLT *P;
+     * RETURNS: None.
+     */
+    VOID GetPos( INT I, FLT *P ) const
+    {
+      P[0] = X[I], P[1] = Y[I], P[2] = Z[I];
+    } /* End of 'GetPos' function */
+
+    /* Obtain particle age function.
+     * ARGUMENTS:
+     *   - particle index:
+     *       INT I;
+     * RETURNS:
+     *   (FLT) age in seconds.
+     */
+    FLT GetAge( INT I ) const
+    {
+      return Age[I];
+    } /* End of 'GetAge' function */
+
+    /* Spawn particles function.
+     * ARGUMENTS:
+     *   - number of particles:
+     *       INT N;
+     *   - positions and velocities, 3 floats per particle:
+     *       const FLT *P, *V;
+     *   - life times in seconds:
+     *       const FLT *L;
+     * RETURNS:
+     *   (INT) number of spawned particles (limited by capacity).
+     */
+    INT Spawn( INT N, const FLT *P, const FLT *V, const FLT *L )
+    {
+      N = std::min(N, Capacity - Count);
+      for (INT k = 0; k < N; k++, P += 3, V += 3)
+      {
+        INT i = Count + k;
+
+        X[i] = P[0], Y[i] = P[1], Z[i] = P[2];
+        VX[i] = V[0], VY[i] = V[1], VZ[i] = V[2];
+        Age[i] = 0, Life[i] = L[k];
+      }
+      Count += N;
+      return N;
+    } /* End of 'Spawn' function */
+
+    /* Simulate particles and remove dead ones function.
+     * ARGUMENTS:
+     *   - time step in seconds:
+     *       FLT Dt;
+     * RETURNS: None.
+     */
+    VOID Update( FLT Dt )
+    {
+      INT N = Count;
+
+      Pool.ParallelFor((N + Chunk - 1) / Chunk, [&]( INT c, INT )
+        {
+          UpdateRange(c * Chunk, std::min(N, c * Chunk + Chunk), Dt);
+        });
+      Compact();
+    } /* End of 'Update' function */
+
+    /* Sort particles back to front function.
+     * ARGUMENTS:
+     *   - eye position and normalized view direction:
+     *       const vec3 &Eye, &Dir;
+     * RETURNS: None.
+     */
+    VOID Sort( const vec3 &Eye, const vec3 &Dir )
+    {
+      vec3 E = Eye, D = Dir;
+      FLT e[3] = {E[0], E[1], E[2]}, d[3] = {D[0], D[1], D[2]};
+      INT
+        N = Count,
+        NumOfJobs = std::max(1, std::min(N / SortChunk, Pool.GetNumOfThreads() * 4)),
+        Step = ((N + NumOfJobs - 1) / NumOfJobs + 7) & ~7;
+
+      Pool.ParallelFor(NumOfJobs, [&]( INT c, INT )
+        {
+          KeysRange(std::min(N, c * Step), std::min(N, c * Step + Step), e, d);
+        });
+      Hist.resize((size_t)NumOfJobs * 256);
+      Sorted = 0;
+      for (INT Shift = 0; Shift < 32; Shift += 8)
+      {
+        const UINT *Ks = Keys[Sorted].data(), *Os = Order[Sorted].data();
+        UINT *Kd = Keys[Sorted ^ 1].data(), *Od = Order[Sorted ^ 1].data(), Sum = 0;
+        BOOL IsSingle = FALSE;
+
+        Pool.ParallelFor(NumOfJobs, [&]( INT c, INT )
+          {
+            UINT *H = &Hist[(size_t)c * 256];
+
+            memset(H, 0, sizeof(UINT) * 256);
+            for (INT i = std::min(N, c * Step), End = std::min(N, c * Step + Step); i < End; i++)
+              H[(Ks[i] >> Shift) & 255]++;
+          });
+        /* Exclusive prefix sums in (digit, job) order keep sort stable */
+        for (INT Digit = 0; Digit < 256; Digit++)
+        {
+          UINT Total = 0;
+
+          for (INT c = 0; c < NumOfJobs; c++)
+          {
+            UINT Cnt = Hist[(size_t)c * 256 + Digit];
+
+            Hist[(size_t)c * 256 + Digit] = Sum + Total;
+            Total += Cnt;
+          }
+          IsSingle |= Total == (UINT)N;
+          Sum += Total;
+        }
+        if (IsSingle)
+          continue;
+        Pool.ParallelFor(NumOfJobs, [&]( INT c, INT )
+          {
+            UINT *H = &Hist[(size_t)c * 256];
+
+            for (INT i = std::min(N, c * Step), End = std::min(N, c * Step + Step); i < End; i++)
+            {
+              UINT p = H[(Ks[i] >> Shift) & 255]++;
+
+              Kd[p] = Ks[i];
+              Od[p] = Os[i];
+            }
+          });
+        Sorted ^= 1;
+      }
+    } /* End of 'Sort' function */
+
+    /* Obtain back to front order of last sort function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const UINT *) particle indices.
+     */
+    const UINT * GetOrder( VOID ) const
+    {
+      return Order[Sorted].data();
+    } /* End of 'GetOrder' function */
+  }; /* end of 'particles' class */
+} /* end of 'nidx' spacename */
+
+#endif // !_particles_h_
+
+/* END OF 'particles.h' FILE */
@@ -0,0 +1,377 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : pool.h
+  * PURPOSE     : T51DX12 project.
+  *               Render resource pools declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Backend independent. Fence values are plain numbers,
+  *               the owner passes the last completed one to 'Collect'
+  *               (checked by 'resource_pool_retire' benchmark).
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _pool_h_
+#define _pool_h_
+
+#include "../../def.h"
+
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace nidx
+{
+  /* Generational handle structure */
+  template<typename Tag>
+    struct handle
+    {
+      UINT
+        Index,      /* Slot index */
+        Generation; /* Slot generation (0 - null handle) */
+
+      /* Null handle construction function.
+       * ARGUMENTS: None.
+       */
+      handle( VOID ) : Index(0), Generation(0)
+      {
+      } /* End of 'handle' function */
+
+      /* Check handle is not null function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (BOOL) TRUE if handle was obtained from pool.
+       */
+      BOOL IsValid( VOID ) const
+      {
+        return Generation != 0;
+      } /* End of 'IsValid' function */
+
+      BOOL operator==( const handle &H ) const
+      {
+        return Index == H.Index && Generation == H.Generation;
+      }
+      BOOL operator!=( const handle &H ) const
+      {
+        return !(*this == H);
+      }
+    }; /* End of 'handle' structure */
+
+  /* Handle type tags */
+  struct buffer_tag;
+  struct texture_tag;
+  struct pipeline_tag;
+  struct descriptor_tag;
+
+  typedef handle<buffer_tag> buffer_handle;
+  typedef handle<texture_tag> texture_handle;
+  typedef handle<pipeline_tag> pipeline_handle;
+  typedef handle<descriptor_tag> descriptor_handle;
+
+  /* Dense pool addressed by generational handles class */
+  template<typename Type, typename Tag>
+    class pool
+    {
+    private:
+      /* Sparse slot structure */
+      struct slot
+      {
+        UINT
+          Generation, /* Current generation (odd - alive) */
+          Dense,      /* Index in dense array */
+          NextFree;   /* Next free slot */
+      }; /* End of 'slot' structure */
+
+      static const UINT None = 0xFFFFFFFF;
+
+      std::vector<Type> Items;  /* Dense items */
+      std::vector<UINT> Owners; /* Slot of every dense item */
+      std::vector<slot> Slots;  /* Sparse slots */
+      UINT FreeHead;            /* First free slot */
+
+      /* Obtain slot of alive handle function.
+       * ARGUMENTS:
+       *   - handle:
+       *       handle<Tag> H;
+       * RETURNS:
+       *   (slot *) slot or nullptr if handle is stale.
+       */
+      slot * GetSlot( handle<Tag> H )
+      {
+        if (H.Index >= Slots.size() || Slots[H.Index].Generation != H.Generation || !(H.Generation & 1))
+          return nullptr;
+        return &Slots[H.Index];
+      } /* End of 'GetSlot' function */
+
+    public:
+      /* Pool initializing function.
+       * ARGUMENTS: None.
+       */
+      pool( VOID ) : FreeHead(None)
+      {
+      } /* End of 'pool' function */
+
+      /* Add item function.
+       * ARGUMENTS:
+       *   - item:
+       *       Type Val;
+       * RETURNS:
+       *   (handle<Tag>) item handle.
+       */
+      handle<Tag> Add( Type Val )
+      {
+        handle<Tag> H;
+        UINT Index;
+
+        if (FreeHead != None)
+        {
+          Index = FreeHead;
+          FreeHead = Slots[Index].NextFree;
+        }
+        else
+        {
+          Index = (UINT)Slots.size();
+          Slots.push_back({0, 0, None});
+        }
+        /* Odd generations are alive, so stale handles never match */
+        Slots[Index].Generation++;
+        Slots[Index].Dense = (UINT)Items.size();
+        Items.push_back(std::move(Val));
+        Owners.push_back(Index);
+        H.Index = Index;
+        H.Generation = Slots[Index].Generation;
+        return H;
+      } /* End of 'Add' function */
+
+      /* Obtain item function.
+       * ARGUMENTS:
+       *   - handle:
+       *       handle<Tag> H;
+       * RETURNS:
+       *   (Type *) item or nullptr if handle is stale.
+       */
+      Type * Get( handle<Tag> H )
+      {
+        slot *S = GetSlot(H);
+
+        return S == nullptr ? nullptr : &Items[S->Dense];
+      } /* End of 'Get' function */
+
+      /* Remove item function.
+       * ARGUMENTS:
+       *   - handle:
+       *       handle<Tag> H;
+       *   - removed item to fill (may be nullptr):
+       *       Type *Removed;
+       * RETURNS:
+       *   (BOOL) TRUE if handle was alive.
+       */
+      BOOL Remove( handle<Tag> H, Type *Removed = nullptr )
+      {
+        slot *S = GetSlot(H);
+        UINT Dense, Last;
+
+        if (S == nullptr)
+          return FALSE;
+        Dense = S->Dense;
+        Last = (UINT)Items.size() - 1;
+        if (Removed != nullptr)
+          *Removed = std::move(Items[Dense]);
+        /* Keep items dense: move last item into the hole */
+        if (Dense != Last)
+        {
+          Items[Dense] = std::move(Items[Last]);
+          Owners[Dense] = Owners[Last];
+          Slots[Owners[Dense]].Dense = Dense;
+        }
+        Items.pop_back();
+        Owners.pop_back();
+        S->Generation++;
+        S->NextFree = FreeHead;
+        FreeHead = H.Index;
+        return TRUE;
+      } /* End of 'Remove' function */
+
+      /* Obtain number of items function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (size_t) number of alive items.
+       */
+      size_t Size( VOID ) const
+      {
+        return Items.size();
+      } /* End of 'Size' function */
+
+      /* Dense items iteration */
+      typename std::vector<Type>::iterator begin( VOID )
+      {
+        return Items.begin();
+      }
+      typename std::vector<Type>::iterator end( VOID )
+      {
+        return Items.end();
+      }
+    }; /* end of 'pool' class */
+
+  /* Fence deferred destruction queue class */
+  class retire_queue
+  {
+  private:
+    /* Retired object structure */
+    struct entry
+    {
+      UINT64 FenceValue;                /* Fence value of last frame using object */
+      std::function<VOID( VOID )> Free; /* Destruction function */
+    }; /* End of 'entry' structure */
+
+    std::deque<entry> Entries;          /* Retired objects in fence order */
+
+  public:
+    /* Retire object function.
+     * ARGUMENTS:
+     *   - fence value signaled after last use of object:
+     *       UINT64 FenceValue;
+     *   - destruction function:
+     *       std::function<VOID( VOID )> Free;
+     * RETURNS: None.
+     */
+    VOID Retire( UINT64 FenceValue, std::function<VOID( VOID )> Free )
+    {
+      Entries.push_back({FenceValue, std::move(Free)});
+    } /* End of 'Retire' function */
+
+    /* Destroy objects whose fence has completed function.
+     * ARGUMENTS:
+     *   - last completed fence value:
+     *       UINT64 CompletedValue;
+     * RETURNS:
+     *   (INT) number of destroyed objects.
+     */
+    INT Collect( UINT64 CompletedValue )
+    {
+      INT n = 0;
+
+      /* Fence values are retired in non-decreasing order */
+      while (!Entries.empty() && Entries.front().FenceValue <= CompletedValue)
+      {
+        Entries.front().Free();
+        Entries.pop_front();
+        n++;
+      }
+      return n;
+    } /* End of 'Collect' function */
+
+    /* Destroy all objects function (GPU must be idle).
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Flush( VOID )
+    {
+      Collect(~(UINT64)0);
+    } /* End of 'Flush' function */
+
+    /* Obtain number of pending objects function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (size_t) number of pending objects.
+     */
+    size_t Size( VOID ) const
+    {
+      return Entries.size();
+    } /* End of 'Size' function */
+  }; /* end of 'retire_queue' class */
+
+  /* Descriptor heap slots allocator class */
+  class descriptor_allocator
+  {
+  private:
+    pool<UINT, descriptor_tag> Descriptors; /* Heap index of every alive descriptor */
+    std::vector<UINT> FreeIndices;         /* Heap indices released by fences */
+    UINT
+      NumOfUsed,                           /* Number of ever used heap indices */
+      Capacity;                            /* Heap size */
+
+  public:
+    /* Allocator initializing function.
+     * ARGUMENTS:
+     *   - heap size:
+     *       UINT NewCapacity;
+     */
+    descriptor_allocator( UINT NewCapacity ) : NumOfUsed(0), Capacity(NewCapacity)
+    {
+    } /* End of 'descriptor_allocator' function */
+
+    /* Allocate descriptor function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (descriptor_handle) descriptor handle (null if heap is full).
+     */
+    descriptor_handle Alloc( VOID )
+    {
+      UINT Index;
+
+      if (!FreeIndices.empty())
+      {
+        Index = FreeIndices.back();
+        FreeIndices.pop_back();
+      }
+      else if (NumOfUsed < Capacity)
+        Index = NumOfUsed++;
+      else
+        return descriptor_handle();
+      return Descriptors.Add(Index);
+    } /* End of 'Alloc' function */
+
+    /* Obtain heap index function.
+     * ARGUMENTS:
+     *   - handle:
+     *       descriptor_handle H;
+     * RETURNS:
+     *   (const UINT *) heap index or nullptr if handle is stale.
+     */
+    const UINT * Get( descriptor_handle H )
+    {
+      return Descriptors.Get(H);
+    } /* End of 'Get' function */
+
+    /* Free descriptor function (heap index is reused after fence completes).
+     * ARGUMENTS:
+     *   - handle:
+     *       descriptor_handle H;
+     *   - fence value signaled after last use of descriptor:
+     *       UINT64 FenceValue;
+     *   - queue to defer release in:
+     *       retire_queue &Retired;
+     * RETURNS:
+     *   (BOOL) TRUE if handle was alive.
+     */
+    BOOL Free( descriptor_handle H, UINT64 FenceValue, retire_queue &Retired )
+    {
+      UINT Index;
+
+      if (!Descriptors.Remove(H, &Index))
+        return FALSE;
+      Retired.Retire(FenceValue, [this, Index]( VOID ){ FreeIndices.push_back(Index); });
+      return TRUE;
+    } /* End of 'Free' function */
+
+    /* Obtain number of allocatable descriptors function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (UINT) number of descriptors 'Alloc' can return now.
+     */
+    UINT GetNumOfFree( VOID ) const
+    {
+      return Capacity - NumOfUsed + (UINT)FreeIndices.size();
+    } /* End of 'GetNumOfFree' function */
+  }; /* end of 'descriptor_allocator' class */
+} /* end of 'nidx' spacename */
+#endif // !_pool_h_
+
+/* END OF 'pool.h' FILE */
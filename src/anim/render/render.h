@@ -18,6 +18,7 @@
 #define _render_h_
 
 #include "../dx/dx12.h"
+#include "packet.h"
 
 #include "../../def.h"
 
@@ -60,11 +61,13 @@ namespace nidx
     {
     } /* End of 'Close' function */
 
-    /* Render system function.
-     * ARGUMENTS: None.
+    /* Render system function (called on render thread).
+     * ARGUMENTS:
+     *   - frame to render:
+     *       const frame_packet &Packet;
      * RETURNS: None.
      */
-    VOID Render( VOID )
+    VOID Render( const frame_packet &Packet )
     {
     } /* End of 'Render' function */
 
@@ -0,0 +1,324 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : shadow.h
+  * PURPOSE     : T51DX12 project.
+  *               Cascaded shadow maps setup declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Splits follow practical scheme (Lambda mixes log and
+  *               uniform splits). Every cascade covers bound sphere of
+  *               its view frustum slice, radius is rounded up and center
+  *               is snapped to shadow map texels in fixed light basis,
+  *               so shadow edges do not shimmer under camera motion.
+  *               Casters of all cascades are culled in one pass, near
+  *               plane of every cascade is then fitted to its casters.
+  *               View matrix is expected to be rigid ('matr::View').
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _shadow_h_
+#define _shadow_h_
+
+#include "../../def.h"
+#include "../jobs.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define NIDX_SHADOW_SSE2
+#endif /* __SSE2__ */
+
+namespace nidx
+{
+  /* Shadow caster bound sphere structure */
+  struct shadow_caster
+  {
+    FLT Center[3], Radius; /* World space sphere */
+  }; /* End of 'shadow_caster' structure */
+
+  /* Cascaded shadow maps class */
+  class shadow_cascades
+  {
+  public:
+    /* Enumerator, not static member: 'std::min' takes it by reference */
+    enum
+    {
+      MaxCascades = 4
+    };
+
+    /* Cascade structure */
+    struct cascade
+    {
+      FLT
+        SplitNear, SplitFar,  /* View depth range */
+        Center[3],            /* Snapped light space center (Z is depth along light) */
+        Radius,               /* Half size of light space rectangle */
+        TexelSize,            /* World size of shadow map texel */
+        CasterNear;           /* Nearest caster depth along light */
+      matr Proj, VP;          /* Light projection and view projection matrices */
+    }; /* End of 'cascade' structure */
+
+  private:
+    jobs &Pool;                                    /* Worker threads */
+    FLT Basis[3][3];                               /* Light space axes: right, up, direction */
+    std::vector<std::vector<UINT>> ChunkCasters;   /* Per chunk and cascade caster lists */
+    std::vector<FLT> ChunkNear;                    /* Per chunk and cascade nearest casters */
+    static const INT Chunk = 4096;
+
+    /* Build cascade matrices function.
+     * ARGUMENTS:
+     *   - cascade:
+     *       cascade &C;
+     * RETURNS: None.
+     */
+    VOID BuildMatrices( cascade &C )
+    {
+      C.Proj = matr::Ortho(C.Center[0] - C.Radius, C.Center[0] + C.Radius,
+                           C.Center[1] - C.Radius, C.Center[1] + C.Radius,
+                           C.CasterNear, C.Center[2] + C.Radius);
+      C.VP = LightView * C.Proj;
+    } /* End of 'BuildMatrices' function */
+
+  public:
+    INT
+      NumOfCascades,      /* Number of used cascades */
+      MapSize;            /* Shadow map size in texels */
+    FLT
+      Lambda,             /* Log to uniform splits mix factor */
+      RadiusStep;         /* Cascade radius rounding step */
+    cascade Cascades[MaxCascades];           /* Cascades */
+    matr LightView;                          /* Light view matrix (fixed basis) */
+    std::vector<BYTE> Masks;                 /* Cascades mask of every caster */
+    std::vector<UINT> Casters[MaxCascades];  /* Casters of every cascade */
+
+    /* Shadow cascades initializing function.
+     * ARGUMENTS:
+     *   - number of cascades [1..MaxCascades]:
+     *       INT NewNumOfCascades;
+     *   - shadow map size:
+     *       INT NewMapSize;
+     *   - worker threads:
+     *       jobs &NewPool;
+     */
+    shadow_cascades( INT NewNumOfCascades = 4, INT NewMapSize = 2048, jobs &NewPool = jobs::Get() ) :
+      Pool(NewPool), NumOfCascades(std::min<INT>(std::max(NewNumOfCascades, 1), MaxCascades)), MapSize(NewMapSize),
+      Lambda(0.75f), RadiusStep(1.0f / 16), LightView(matr::Identity())
+    {
+      memset(Basis, 0, sizeof(Basis));
+    } /* End of 'shadow_cascades' function */
+
+    /* Compute cascades for frame function.
+     * ARGUMENTS:
+     *   - camera view matrix:
+     *       const matr &View;
+     *   - camera projection parameters (same as 'matr::Frustum'):
+     *       FLT L, R, B, T, Near, Far;
+     *   - direction of light rays:
+     *       vec3 LightDir;
+     * RETURNS: None.
+     */
+    VOID Setup( const matr &View, FLT L, FLT R, FLT B, FLT T, FLT Near, FLT Far, vec3 LightDir )
+    {
+      const FLT *M = View;
+      vec3 D = LightDir.Normalizing(), Up = fabs(D[1]) > 0.99f ? vec3(1, 0, 0) : vec3(0, 1, 0);
+
+      /* Light basis does not depend on camera */
+      LightView = matr::View(vec3(0, 0, 0), D, Up);
+      for (INT k = 0; k < 3; k++)
+      {
+        const FLT *lv = LightView;
+
+        Basis[0][k] = lv[k * 4 + 0];
+        Basis[1][k] = lv[k * 4 + 1];
+        Basis[2][k] = -lv[k * 4 + 2];
+      }
+
+      for (INT i = 0; i < NumOfCascades; i++)
+      {
+        cascade &C = Cascades[i];
+        FLT Split[2], Corner[8][3], Center[3] = {0, 0, 0}, Radius = 0, World[3];
+
+        for (INT s = 0; s < 2; s++)
+        {
+          FLT t = (FLT)(i + s) / NumOfCascades;
+
+          Split[s] = Lambda * Near * (FLT)pow(Far / Near, t) + (1 - Lambda) * (Near + (Far - Near) * t);
+        }
+        C.SplitNear = Split[0], C.SplitFar = Split[1];
+
+        /* Slice bound sphere in view space does not change with camera motion */
+        for (INT c = 0; c < 8; c++)
+        {
+          FLT d = Split[c >> 2];
+
+          Corner[c][0] = ((c & 1) ? R : L) * d / Near;
+          Corner[c][1] = ((c & 2) ? T : B) * d / Near;
+          Corner[c][2] = -d;
+          for (INT k = 0; k < 3; k++)
+            Center[k] += Corner[c][k] / 8;
+        }
+        for (INT c = 0; c < 8; c++)
+        {
+          FLT dx = Corner[c][0] - Center[0], dy = Corner[c][1] - Center[1], dz = Corner[c][2] - Center[2];
+
+          Radius = std::max(Radius, (FLT)sqrt(dx * dx + dy * dy + dz * dz));
+        }
+        C.Radius = (FLT)ceil(Radius / RadiusStep) * RadiusStep;
+        C.TexelSize = 2 * C.Radius / MapSize;
+
+        /* View to world (transposed rotation of rigid view matrix) */
+        for (INT j = 0; j < 3; j++)
+          World[j] = (Center[0] - M[12]) * M[j * 4 + 0] + (Center[1] - M[13]) * M[j * 4 + 1] + (Center[2] - M[14]) * M[j * 4 + 2];
+        for (INT a = 0; a < 3; a++)
+          C.Center[a] = World[0] * Basis[a][0] + World[1] * Basis[a][1] + World[2] * Basis[a][2];
+        C.Center[0] = (FLT)floor(C.Center[0] / C.TexelSize) * C.TexelSize;
+        C.Center[1] = (FLT)floor(C.Center[1] / C.TexelSize) * C.TexelSize;
+        C.CasterNear = C.Center[2] - C.Radius;
+        BuildMatrices(C);
+      }
+    } /* End of 'Setup' function */
+
+    /* Cull shadow casters for all cascades function.
+     * ARGUMENTS:
+     *   - casters:
+     *       const shadow_caster *Objects;
+     *       INT N;
+     * RETURNS:
+     *   (UINT) total number of cascade casters.
+     */
+    UINT Cull( const shadow_caster *Objects, INT N )
+    {
+      INT NumOfChunks = (N + Chunk - 1) / Chunk, Nc = NumOfCascades;
+      UINT Total = 0;
+
+      Masks.resize(N);
+      if ((INT)ChunkCasters.size() < NumOfChunks * MaxCascades)
+        ChunkCasters.resize((size_t)NumOfChunks * MaxCascades);
+      ChunkNear.resize((size_t)NumOfChunks * MaxCascades);
+
+      Pool.ParallelFor(NumOfChunks, [&]( INT Ch, INT )
+        {
+          INT i = Ch * Chunk, End = std::min(N, i + Chunk);
+          FLT Nearest[MaxCascades];
+
+          for (INT c = 0; c < Nc; c++)
+          {
+            ChunkCasters[(size_t)Ch * MaxCascades + c].clear();
+            Nearest[c] = FLT_MAX;
+          }
+#ifdef NIDX_SHADOW_SSE2
+          __m128 Near4[MaxCascades];
+
+          for (INT c = 0; c < Nc; c++)
+            Near4[c] = _mm_set1_ps(FLT_MAX);
+          for (; i + 4 <= End; i += 4)
+          {
+            __m128
+              x = _mm_loadu_ps(Objects[i].Center), y = _mm_loadu_ps(Objects[i + 1].Center),
+              z = _mm_loadu_ps(Objects[i + 2].Center), r = _mm_loadu_ps(Objects[i + 3].Center), lx, ly, lz;
+            INT Mask = 0;
+
+            /* Rows are objects, make lanes objects */
+            _MM_TRANSPOSE4_PS(x, y, z, r);
+            lx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(Basis[0][0])), _mm_mul_ps(y, _mm_set1_ps(Basis[0][1]))), _mm_mul_ps(z, _mm_set1_ps(Basis[0][2])));
+            ly = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(Basis[1][0])), _mm_mul_ps(y, _mm_set1_ps(Basis[1][1]))), _mm_mul_ps(z, _mm_set1_ps(Basis[1][2])));
+            lz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(Basis[2][0])), _mm_mul_ps(y, _mm_set1_ps(Basis[2][1]))), _mm_mul_ps(z, _mm_set1_ps(Basis[2][2])));
+            lz = _mm_sub_ps(lz, r);
+            for (INT c = 0; c < Nc; c++)
+            {
+              const cascade &C = Cascades[c];
+              __m128
+                Ext = _mm_add_ps(r, _mm_set1_ps(C.Radius)),
+                Abs = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)),
+                In = _mm_and_ps(
+                  _mm_and_ps(_mm_cmple_ps(_mm_and_ps(_mm_sub_ps(lx, _mm_set1_ps(C.Center[0])), Abs), Ext),
+                             _mm_cmple_ps(_mm_and_ps(_mm_sub_ps(ly, _mm_set1_ps(C.Center[1])), Abs), Ext)),
+                  _mm_cmple_ps(lz, _mm_set1_ps(C.Center[2] + C.Radius)));
+              INT m = _mm_movemask_ps(In);
+
+              Near4[c] = _mm_min_ps(Near4[c], _mm_or_ps(_mm_and_ps(In, lz), _mm_andnot_ps(In, _mm_set1_ps(FLT_MAX))));
+              for (INT k = 0; k < 4; k++)
+                if (m & (1 << k))
+                  ChunkCasters[(size_t)Ch * MaxCascades + c].push_back((UINT)(i + k));
+              Mask |= m << (c * 4);
+            }
+            for (INT k = 0; k < 4; k++)
+            {
+              BYTE b = 0;
+
+              for (INT c = 0; c < Nc; c++)
+                b |= ((Mask >> (c * 4 + k)) & 1) << c;
+              Masks[i + k] = b;
+            }
+          }
+          for (INT c = 0; c < Nc; c++)
+          {
+            FLT v[4];
+
+            _mm_storeu_ps(v, Near4[c]);
+            Nearest[c] = std::min(std::min(v[0], v[1]), std::min(v[2], v[3]));
+          }
+#endif /* NIDX_SHADOW_SSE2 */
+          for (; i < End; i++)
+          {
+            const FLT *p = Objects[i].Center, r = Objects[i].Radius;
+            FLT
+              lx = p[0] * Basis[0][0] + p[1] * Basis[0][1] + p[2] * Basis[0][2],
+              ly = p[0] * Basis[1][0] + p[1] * Basis[1][1] + p[2] * Basis[1][2],
+              lz = p[0] * Basis[2][0] + p[1] * Basis[2][1] + p[2] * Basis[2][2] - r;
+            BYTE b = 0;
+
+            for (INT c = 0; c < Nc; c++)
+            {
+              const cascade &C = Cascades[c];
+
+              /* Casters toward light are unbounded */
+              if (fabs(lx - C.Center[0]) <= r + C.Radius && fabs(ly - C.Center[1]) <= r + C.Radius &&
+                  lz <= C.Center[2] + C.Radius)
+              {
+                b |= 1 << c;
+                Nearest[c] = std::min(Nearest[c], lz);
+                ChunkCasters[(size_t)Ch * MaxCascades + c].push_back((UINT)i);
+              }
+            }
+            Masks[i] = b;
+          }
+          for (INT c = 0; c < Nc; c++)
+            ChunkNear[(size_t)Ch * MaxCascades + c] = Nearest[c];
+        });
+
+      /* Merge chunks in order and fit near planes */
+      for (INT c = 0; c < Nc; c++)
+      {
+        cascade &C = Cascades[c];
+        FLT Nearest = C.Center[2] - C.Radius;
+
+        Casters[c].clear();
+        for (INT Ch = 0; Ch < NumOfChunks; Ch++)
+        {
+          const std::vector<UINT> &L = ChunkCasters[(size_t)Ch * MaxCascades + c];
+
+          Casters[c].insert(Casters[c].end(), L.begin(), L.end());
+          Nearest = std::min(Nearest, ChunkNear[(size_t)Ch * MaxCascades + c]);
+        }
+        C.CasterNear = Nearest;
+        BuildMatrices(C);
+        Total += (UINT)Casters[c].size();
+      }
+      return Total;
+    } /* End of 'Cull' function */
+  }; /* end of 'shadow_cascades' class */
+} /* end of 'nidx' spacename */
+
+#endif // !_shadow_h_
+
+/* END OF 'shadow.h' FILE */
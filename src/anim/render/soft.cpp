@@ -0,0 +1,76 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : soft.cpp
+  * PURPOSE     : T51DX12 project.
+  *               Tiled software rasterizer AVX kernels module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : The only file built with AVX2 (/arch:AVX2, -mavx2),
+  *               kernels are called only after 'IsAVX2Supported' check.
+  *               Do not use inline library or engine functions here:
+  *               their AVX copies could be picked by linker for other
+  *               files. No precompiled header for the same reason.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#include "soft.h"
+
+#ifndef __AVX2__
+#  error "soft.cpp must be built with AVX2 (/arch:AVX2, -mavx2)"
+#endif /* __AVX2__ */
+
+#include <immintrin.h>
+
+/* Evaluate 8 pixels block coverage and depth test function (AVX).
+ * ARGUMENTS:
+ *   - triangle:
+ *       const triangle &T;
+ *   - block first pixel and row:
+ *       INT X, Y;
+ *   - covered columns range:
+ *       INT X0, X1;
+ *   - depth buffer row:
+ *       const FLT *Dp;
+ *   - interpolated depth of block to fill:
+ *       FLT *Z;
+ * RETURNS:
+ *   (UINT) mask of pixels to write.
+ */
+UINT nidx::soft_raster::BlockMaskAVX( const triangle &T, INT X, INT Y, INT X0, INT X1, const FLT *Dp, FLT *Z )
+{
+  const __m256 Lane = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7), Zero = _mm256_setzero_ps();
+  __m256
+    xi = _mm256_add_ps(_mm256_set1_ps((FLT)X), Lane),
+    px = _mm256_add_ps(xi, _mm256_set1_ps(0.5f)),
+    py = _mm256_set1_ps(Y + 0.5f),
+    m = _mm256_and_ps(_mm256_cmp_ps(xi, _mm256_set1_ps((FLT)X0), _CMP_GE_OQ),
+                      _mm256_cmp_ps(xi, _mm256_set1_ps((FLT)X1), _CMP_LE_OQ)),
+    z, d;
+
+  for (INT i = 0; i < 3; i++)
+  {
+    __m256 e = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(T.EA[i]), px),
+                             _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(T.EB[i]), py), _mm256_set1_ps(T.EC[i])));
+    __m256 tl = _mm256_castsi256_ps(_mm256_set1_epi32(T.TopLeft[i]));
+
+    m = _mm256_and_ps(m, _mm256_or_ps(_mm256_cmp_ps(e, Zero, _CMP_GT_OQ),
+                                      _mm256_and_ps(tl, _mm256_cmp_ps(e, Zero, _CMP_EQ_OQ))));
+  }
+  if (_mm256_movemask_ps(m) == 0)
+    return 0;
+  z = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(T.ZA), px),
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(T.ZB), py), _mm256_set1_ps(T.ZC)));
+  /* Lanes outside the row are masked off, so the load does not read past it */
+  d = _mm256_maskload_ps(Dp + X, _mm256_castps_si256(m));
+  m = _mm256_and_ps(m, _mm256_cmp_ps(z, d, _CMP_LT_OQ));
+  m = _mm256_and_ps(m, _mm256_cmp_ps(z, _mm256_set1_ps(1), _CMP_LE_OQ));
+  _mm256_storeu_ps(Z, z);
+  return (UINT)_mm256_movemask_ps(m);
+} /* End of 'nidx::soft_raster::BlockMaskAVX' function */
+
+/* END OF 'soft.cpp' FILE */
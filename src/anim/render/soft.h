@@ -0,0 +1,641 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : soft.h
+  * PURPOSE     : T51DX12 project.
+  *               Tiled software rasterizer declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Device independent. Triangles are binned into
+  *               64x64 tiles in submission order, tiles are rasterized
+  *               by pool workers 8 pixels at a time, so the image does
+  *               not depend on number of threads. AVX block kernel
+  *               ('soft.cpp') is used if processor supports AVX2 and
+  *               gives bit identical image to the scalar one.
+  *               Conventions match the GPU path: row vector matrices,
+  *               [-1..1] clip depth mapped to [0..1], counter-clockwise
+  *               front faces, top-left fill rule.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _soft_h_
+#define _soft_h_
+
+#include "../../def.h"
+#include "../jobs.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* AVX kernels are in 'soft.cpp', the only file built with AVX2 (/arch:AVX2, -mavx2),
+ * game is built for baseline x86 and picks them at run time */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  endif /* _MSC_VER */
+#  define NIDX_SOFT_AVX
+#endif /* x86 */
+
+namespace nidx
+{
+  /* Software rasterizer vertex structure */
+  struct soft_vertex
+  {
+    FLT X, Y, Z;    /* Object space position */
+    FLT A[4];       /* Attributes (RGBA color), interpolated perspective correct */
+  }; /* End of 'soft_vertex' structure */
+
+  /* Tiled software rasterizer class */
+  class soft_raster
+  {
+  public:
+    static const INT TileSize = 64;
+
+  private:
+    /* Clip space vertex structure */
+    struct clip_vertex
+    {
+      FLT X, Y, Z, W; /* Clip space position */
+      FLT A[4];       /* Attributes */
+    }; /* End of 'clip_vertex' structure */
+
+    /* Set up triangle structure (planes are 'A * x + B * y + C' in pixels) */
+    struct triangle
+    {
+      FLT EA[3], EB[3], EC[3];  /* Edge functions, positive inside */
+      INT TopLeft[3];           /* Top-left edge masks (-1 - zero value is inside) */
+      FLT ZA, ZB, ZC;           /* Screen depth plane */
+      FLT WA, WB, WC;           /* 1 / W plane */
+      FLT AA[4], AB[4], AC[4];  /* Attribute / W planes */
+      INT MinX, MinY, MaxX, MaxY; /* Covered pixels bound box */
+    }; /* End of 'triangle' structure */
+
+    static const INT MaxClip = 9;  /* 3 vertices + one per clip plane */
+    static constexpr FLT GuardBand = 4; /* Guard band size in viewports */
+
+    jobs &Pool;                    /* Worker threads */
+    INT W, H, TilesX, TilesY;      /* Frame and tile grid sizes */
+    std::vector<UINT> Color;       /* Color buffer (0xAARRGGBB) */
+    std::vector<FLT> Depth;        /* Depth buffer */
+    std::vector<triangle> Tris;    /* Set up triangles of current frame */
+    std::vector<std::vector<UINT>> Bins; /* Triangle indices of every tile */
+    std::vector<clip_vertex> Verts;  /* Transformed vertices scratch */
+    matr VP;                       /* View projection matrix */
+
+    /* Pack color function.
+     * ARGUMENTS:
+     *   - RGBA components [0..1]:
+     *       const FLT *C;
+     * RETURNS:
+     *   (UINT) 0xAARRGGBB color.
+     */
+    static UINT Pack( const FLT *C )
+    {
+      UINT R = 0;
+
+      for (INT i = 0; i < 4; i++)
+      {
+        FLT c = C[i] < 0 ? 0 : C[i] > 1 ? 1 : C[i];
+
+        R |= (UINT)(c * 255 + 0.5f) << (i == 3 ? 24 : 16 - i * 8);
+      }
+      return R;
+    } /* End of 'Pack' function */
+
+    /* Distance to clip plane function.
+     * ARGUMENTS:
+     *   - clip space vertex:
+     *       const clip_vertex &V;
+     *   - plane number:
+     *       INT Plane;
+     * RETURNS:
+     *   (FLT) signed distance, positive inside.
+     */
+    static FLT PlaneDist( const clip_vertex &V, INT Plane )
+    {
+      switch (Plane)
+      {
+      case 0:
+        return V.Z + V.W;
+      case 1:
+        return V.W - V.Z;
+      case 2:
+        return GuardBand * V.W - V.X;
+      case 3:
+        return GuardBand * V.W + V.X;
+      case 4:
+        return GuardBand * V.W - V.Y;
+      default:
+        return GuardBand * V.W + V.Y;
+      }
+    } /* End of 'PlaneDist' function */
+
+    /* Clip polygon by plane function.
+     * ARGUMENTS:
+     *   - polygon vertices:
+     *       const clip_vertex *In;
+     *       INT N;
+     *   - output vertices:
+     *       clip_vertex *Out;
+     *   - plane number:
+     *       INT Plane;
+     * RETURNS:
+     *   (INT) number of output vertices.
+     */
+    static INT ClipPolygon( const clip_vertex *In, INT N, clip_vertex *Out, INT Plane )
+    {
+      INT n = 0;
+
+      for (INT i = 0; i < N; i++)
+      {
+        const clip_vertex &P0 = In[i], &P1 = In[(i + 1) % N];
+        FLT d0 = PlaneDist(P0, Plane), d1 = PlaneDist(P1, Plane);
+
+        if (d0 >= 0)
+          Out[n++] = P0;
+        if ((d0 >= 0) != (d1 >= 0))
+        {
+          FLT t = d0 / (d0 - d1);
+          clip_vertex &R = Out[n++];
+
+          R.X = P0.X + (P1.X - P0.X) * t;
+          R.Y = P0.Y + (P1.Y - P0.Y) * t;
+          R.Z = P0.Z + (P1.Z - P0.Z) * t;
+          R.W = P0.W + (P1.W - P0.W) * t;
+          for (INT k = 0; k < 4; k++)
+            R.A[k] = P0.A[k] + (P1.A[k] - P0.A[k]) * t;
+        }
+      }
+      return n;
+    } /* End of 'ClipPolygon' function */
+
+    /* Set up and bin clipped triangle function.
+     * ARGUMENTS:
+     *   - clip space vertices (all W > 0):
+     *       const clip_vertex &V0, &V1, &V2;
+     * RETURNS: None.
+     */
+    VOID Setup( const clip_vertex &V0, const clip_vertex &V1, const clip_vertex &V2 )
+    {
+      const clip_vertex *V[3] = {&V0, &V1, &V2};
+      FLT x[3], y[3], z[3], iw[3], a[3][4], Area, MinX, MinY, MaxX, MaxY;
+      triangle T;
+
+      for (INT i = 0; i < 3; i++)
+      {
+        iw[i] = 1 / V[i]->W;
+        /* Snap to 1/256 pixel so shared edges evaluate identically */
+        x[i] = floor(((V[i]->X * iw[i]) * 0.5f + 0.5f) * W * 256 + 0.5f) / 256;
+        y[i] = floor((0.5f - (V[i]->Y * iw[i]) * 0.5f) * H * 256 + 0.5f) / 256;
+        z[i] = V[i]->Z * iw[i] * 0.5f + 0.5f;
+        for (INT k = 0; k < 4; k++)
+          a[i][k] = V[i]->A[k] * iw[i];
+      }
+      Area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+      /* Screen Y goes down, so front (counter-clockwise) faces have negative area */
+      if (Area == 0 || (IsCullBack && Area > 0))
+        return;
+
+      MinX = std::min(x[0], std::min(x[1], x[2]));
+      MaxX = std::max(x[0], std::max(x[1], x[2]));
+      MinY = std::min(y[0], std::min(y[1], y[2]));
+      MaxY = std::max(y[0], std::max(y[1], y[2]));
+      T.MinX = std::max(0, (INT)ceil(MinX - 0.5f));
+      T.MaxX = std::min(W - 1, (INT)floor(MaxX - 0.5f));
+      T.MinY = std::max(0, (INT)ceil(MinY - 0.5f));
+      T.MaxY = std::min(H - 1, (INT)floor(MaxY - 0.5f));
+      if (T.MinX > T.MaxX || T.MinY > T.MaxY)
+        return;
+
+      for (INT i = 0; i < 3; i++)
+      {
+        INT i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        FLT s = Area < 0 ? -1.0f : 1.0f;
+
+        /* Edge opposite to vertex i, equals area at vertex i */
+        T.EA[i] = s * (y[i1] - y[i2]);
+        T.EB[i] = s * (x[i2] - x[i1]);
+        T.EC[i] = s * (x[i1] * y[i2] - x[i2] * y[i1]);
+        T.TopLeft[i] = T.EA[i] > 0 || (T.EA[i] == 0 && T.EB[i] > 0) ? -1 : 0;
+      }
+      Area = fabs(Area);
+
+      /* Plane through vertex 0 keeps constant term small */
+      auto Plane = [&]( const FLT *q, FLT &PA, FLT &PB, FLT &PC )
+      {
+        FLT d1 = q[1] - q[0], d2 = q[2] - q[0];
+
+        PA = (d1 * T.EA[1] + d2 * T.EA[2]) / Area;
+        PB = (d1 * T.EB[1] + d2 * T.EB[2]) / Area;
+        PC = q[0] - PA * x[0] - PB * y[0];
+      };
+      Plane(z, T.ZA, T.ZB, T.ZC);
+      Plane(iw, T.WA, T.WB, T.WC);
+      for (INT k = 0; k < 4; k++)
+      {
+        FLT q[3] = {a[0][k], a[1][k], a[2][k]};
+
+        Plane(q, T.AA[k], T.AB[k], T.AC[k]);
+      }
+
+      for (INT ty = T.MinY / TileSize; ty <= T.MaxY / TileSize; ty++)
+        for (INT tx = T.MinX / TileSize; tx <= T.MaxX / TileSize; tx++)
+          Bins[ty * TilesX + tx].push_back((UINT)Tris.size());
+      Tris.push_back(T);
+    } /* End of 'Setup' function */
+
+    /* Evaluate 8 pixels block coverage and depth test function.
+     * ARGUMENTS:
+     *   - triangle:
+     *       const triangle &T;
+     *   - block first pixel and row:
+     *       INT X, Y;
+     *   - covered columns range:
+     *       INT X0, X1;
+     *   - depth buffer row:
+     *       const FLT *Dp;
+     *   - interpolated depth of block to fill:
+     *       FLT *Z;
+     * RETURNS:
+     *   (UINT) mask of pixels to write.
+     */
+    static UINT BlockMask( const triangle &T, INT X, INT Y, INT X0, INT X1, const FLT *Dp, FLT *Z )
+    {
+      FLT px[8], py = Y + 0.5f;
+      INT m[8];
+      UINT Mask = 0;
+
+      for (INT k = 0; k < 8; k++)
+      {
+        px[k] = X + k + 0.5f;
+        m[k] = X + k >= X0 && X + k <= X1;
+      }
+      for (INT i = 0; i < 3; i++)
+        for (INT k = 0; k < 8; k++)
+        {
+          FLT e = T.EA[i] * px[k] + (T.EB[i] * py + T.EC[i]);
+
+          m[k] &= e > 0 || (T.TopLeft[i] && e == 0);
+        }
+      for (INT k = 0; k < 8; k++)
+      {
+        Z[k] = T.ZA * px[k] + (T.ZB * py + T.ZC);
+        if (m[k] && Z[k] < Dp[X + k] && Z[k] <= 1)
+          Mask |= 1 << k;
+      }
+      return Mask;
+    } /* End of 'BlockMask' function */
+
+#ifdef NIDX_SOFT_AVX
+    /* Evaluate 8 pixels block coverage and depth test function (AVX, 'soft.cpp').
+     * ARGUMENTS:
+     *   - same as 'BlockMask'.
+     * RETURNS:
+     *   (UINT) mask of pixels to write.
+     */
+    static UINT BlockMaskAVX( const triangle &T, INT X, INT Y, INT X0, INT X1, const FLT *Dp, FLT *Z );
+#endif /* NIDX_SOFT_AVX */
+
+    /* Rasterize tile function.
+     * ARGUMENTS:
+     *   - tile index:
+     *       INT Tile;
+     * RETURNS: None.
+     */
+    VOID RasterTile( INT Tile )
+    {
+      INT
+        X0 = Tile % TilesX * TileSize, Y0 = Tile / TilesX * TileSize,
+        X1 = std::min(X0 + TileSize, W) - 1, Y1 = std::min(Y0 + TileSize, H) - 1;
+
+      for (UINT t : Bins[Tile])
+      {
+        const triangle &T = Tris[t];
+        INT
+          xs = std::max(T.MinX, X0), xe = std::min(T.MaxX, X1),
+          ys = std::max(T.MinY, Y0), ye = std::min(T.MaxY, Y1);
+
+        for (INT y = ys; y <= ye; y++)
+        {
+          UINT *Cl = &Color[(size_t)y * W];
+          FLT *Dp = &Depth[(size_t)y * W], py = y + 0.5f;
+
+          for (INT x = xs & ~7; x <= xe; x += 8)
+          {
+            FLT Z[8];
+            UINT Mask;
+
+#ifdef NIDX_SOFT_AVX
+            if (IsAVX)
+              Mask = BlockMaskAVX(T, x, y, xs, xe, Dp, Z);
+            else
+#endif /* NIDX_SOFT_AVX */
+              Mask = BlockMask(T, x, y, xs, xe, Dp, Z);
+
+            for (INT k = 0; Mask != 0; k++, Mask >>= 1)
+              if (Mask & 1)
+              {
+                Dp[x + k] = Z[k];
+                if (IsColorWrite)
+                {
+                  FLT px = x + k + 0.5f, c[4], w = 1 / (T.WA * px + (T.WB * py + T.WC));
+
+                  for (INT i = 0; i < 4; i++)
+                    c[i] = (T.AA[i] * px + (T.AB[i] * py + T.AC[i])) * w;
+                  Cl[x + k] = Pack(c);
+                }
+              }
+          }
+        }
+      }
+    } /* End of 'RasterTile' function */
+
+  public:
+    BOOL
+      IsCullBack,         /* Back faces culling flag */
+      IsColorWrite,       /* Color buffer write flag (FALSE - depth only) */
+      IsAVX;              /* Use AVX block kernel (set if processor supports it) */
+    UINT64 TriCounter;    /* Number of submitted triangles not rejected by frustum */
+
+    /* Rasterizer initializing function.
+     * ARGUMENTS:
+     *   - frame size:
+     *       INT NewW, NewH;
+     *   - worker threads:
+     *       jobs &NewPool;
+     */
+    soft_raster( INT NewW = 0, INT NewH = 0, jobs &NewPool = jobs::Get() ) :
+      Pool(NewPool), W(0), H(0), TilesX(0), TilesY(0), VP(matr::Identity()),
+      IsCullBack(TRUE), IsColorWrite(TRUE), IsAVX(IsAVX2Supported()), TriCounter(0)
+    {
+      Resize(NewW, NewH);
+    } /* End of 'soft_raster' function */
+
+    /* Check processor and system support of AVX2 and FMA function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if AVX kernels may run.
+     */
+    static BOOL IsAVX2Supported( VOID )
+    {
+#ifdef NIDX_SOFT_AVX
+#  ifdef _MSC_VER
+      static const BOOL IsSupported = []( VOID )
+        {
+          INT r[4];
+
+          __cpuid(r, 0);
+          if (r[0] < 7)
+            return FALSE;
+          __cpuid(r, 1);
+          /* AVX, FMA and OS saved YMM registers */
+          if ((r[2] & (1 << 28)) == 0 || (r[2] & (1 << 12)) == 0 || (r[2] & (1 << 27)) == 0 ||
+              (_xgetbv(0) & 6) != 6)
+            return FALSE;
+          __cpuidex(r, 7, 0);
+          return (r[1] & (1 << 5)) != 0;
+        }();
+#  else /* _MSC_VER */
+      static const BOOL IsSupported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#  endif /* _MSC_VER */
+
+      return IsSupported;
+#else /* NIDX_SOFT_AVX */
+      return FALSE;
+#endif /* NIDX_SOFT_AVX */
+    } /* End of 'IsAVX2Supported' function */
+
+    /* Resize frame function.
+     * ARGUMENTS:
+     *   - new frame size:
+     *       INT NewW, NewH;
+     * RETURNS: None.
+     */
+    VOID Resize( INT NewW, INT NewH )
+    {
+      W = std::max(NewW, 0);
+      H = std::max(NewH, 0);
+      TilesX = (W + TileSize - 1) / TileSize;
+      TilesY = (H + TileSize - 1) / TileSize;
+      /* Padding keeps 8 pixel blocks inside buffers */
+      Color.assign((size_t)W * H + 8, 0);
+      Depth.assign((size_t)W * H + 8, 1);
+      Bins.assign((size_t)TilesX * TilesY, std::vector<UINT>());
+      Tris.clear();
+    } /* End of 'Resize' function */
+
+    /* Obtain frame width function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) width in pixels.
+     */
+    INT GetW( VOID ) const
+    {
+      return W;
+    } /* End of 'GetW' function */
+
+    /* Obtain frame height function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) height in pixels.
+     */
+    INT GetH( VOID ) const
+    {
+      return H;
+    } /* End of 'GetH' function */
+
+    /* Obtain color buffer function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const UINT *) W x H colors (0xAARRGGBB), valid after 'Flush'.
+     */
+    const UINT * GetColor( VOID ) const
+    {
+      return Color.data();
+    } /* End of 'GetColor' function */
+
+    /* Obtain depth buffer function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const FLT *) W x H depths [0..1], valid after 'Flush'.
+     */
+    const FLT * GetDepth( VOID ) const
+    {
+      return Depth.data();
+    } /* End of 'GetDepth' function */
+
+    /* Clear frame function.
+     * ARGUMENTS:
+     *   - clear color (0xAARRGGBB):
+     *       UINT ClearColor;
+     *   - clear depth:
+     *       FLT ClearDepth;
+     * RETURNS: None.
+     */
+    VOID Clear( UINT ClearColor, FLT ClearDepth = 1 )
+    {
+      std::fill(Color.begin(), Color.end(), ClearColor);
+      std::fill(Depth.begin(), Depth.end(), ClearDepth);
+    } /* End of 'Clear' function */
+
+    /* Set view projection matrix function.
+     * ARGUMENTS:
+     *   - matrix:
+     *       const matr &M;
+     * RETURNS: None.
+     */
+    VOID SetTransform( const matr &M )
+    {
+      VP = M;
+    } /* End of 'SetTransform' function */
+
+    /* Submit indexed triangle list function.
+     * ARGUMENTS:
+     *   - vertices:
+     *       const soft_vertex *V;
+     *       INT NumOfV;
+     *   - indices (nullptr - non-indexed):
+     *       const INT *Ind;
+     *       INT NumOfI;
+     * RETURNS: None.
+     */
+    VOID Draw( const soft_vertex *V, INT NumOfV, const INT *Ind = nullptr, INT NumOfI = 0 )
+    {
+      const FLT *M = VP;
+
+      Verts.resize(NumOfV);
+      for (INT i = 0; i < NumOfV; i++)
+      {
+        clip_vertex &C = Verts[i];
+
+        C.X = V[i].X * M[0] + V[i].Y * M[4] + V[i].Z * M[8] + M[12];
+        C.Y = V[i].X * M[1] + V[i].Y * M[5] + V[i].Z * M[9] + M[13];
+        C.Z = V[i].X * M[2] + V[i].Y * M[6] + V[i].Z * M[10] + M[14];
+        C.W = V[i].X * M[3] + V[i].Y * M[7] + V[i].Z * M[11] + M[15];
+        memcpy(C.A, V[i].A, sizeof(C.A));
+      }
+      if (Ind == nullptr)
+        NumOfI = NumOfV;
+      for (INT i = 0; i + 2 < NumOfI; i += 3)
+      {
+        clip_vertex P[2][MaxClip];
+        INT n = 3, Out = 0, Cur = 0;
+
+        for (INT k = 0; k < 3; k++)
+          P[0][k] = Verts[Ind == nullptr ? i + k : Ind[i + k]];
+        /* Reject outside any plane, clip only if some vertex is outside */
+        for (INT p = 0; p < 6; p++)
+        {
+          INT o = (PlaneDist(P[0][0], p) < 0) + (PlaneDist(P[0][1], p) < 0) + (PlaneDist(P[0][2], p) < 0);
+
+          if (o == 3)
+          {
+            Out = -1;
+            break;
+          }
+          Out |= o != 0;
+        }
+        if (Out < 0)
+          continue;
+        if (Out)
+          for (INT p = 0; p < 6 && n >= 3; p++)
+            n = ClipPolygon(P[Cur], n, P[Cur ^ 1], p), Cur ^= 1;
+        for (INT k = 2; k < n; k++)
+          Setup(P[Cur][0], P[Cur][k - 1], P[Cur][k]);
+        TriCounter++;
+      }
+    } /* End of 'Draw' function */
+
+    /* Rasterize submitted triangles function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Flush( VOID )
+    {
+      Pool.ParallelFor(TilesX * TilesY, [this]( INT Tile, INT )
+        {
+          RasterTile(Tile);
+        });
+      for (auto &b : Bins)
+        b.clear();
+      Tris.clear();
+    } /* End of 'Flush' function */
+
+    /* Save color buffer to TGA file function.
+     * ARGUMENTS:
+     *   - file name:
+     *       const std::string &FileName;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    BOOL SaveTGA( const std::string &FileName ) const
+    {
+      std::ofstream F(FileName, std::ios::binary);
+      /* Uncompressed true color, 32 bpp, top-left origin */
+      BYTE Header[18] = {0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                         (BYTE)W, (BYTE)(W >> 8), (BYTE)H, (BYTE)(H >> 8), 32, 0x28};
+
+      if (!F.is_open())
+        return FALSE;
+      F.write((const CHAR *)Header, sizeof(Header));
+      for (size_t i = 0; i < (size_t)W * H; i++)
+      {
+        BYTE P[4] = {(BYTE)Color[i], (BYTE)(Color[i] >> 8), (BYTE)(Color[i] >> 16), (BYTE)(Color[i] >> 24)};
+
+        F.write((const CHAR *)P, 4);
+      }
+      return (BOOL)F.good();
+    } /* End of 'SaveTGA' function */
+
+    /* Compare color buffer with golden TGA image written by 'SaveTGA' function.
+     * ARGUMENTS:
+     *   - golden image file name:
+     *       const std::string &FileName;
+     *   - allowed per channel difference:
+     *       INT Tolerance;
+     * RETURNS:
+     *   (INT) number of different pixels, -1 if image cannot be read or size differs.
+     */
+    INT CompareTGA( const std::string &FileName, INT Tolerance = 0 ) const
+    {
+      std::ifstream F(FileName, std::ios::binary);
+      BYTE Header[18];
+      INT n = 0;
+
+      if (!F.read((CHAR *)Header, sizeof(Header)) || Header[2] != 2 || Header[16] != 32 ||
+          Header[12] + (Header[13] << 8) != W || Header[14] + (Header[15] << 8) != H)
+        return -1;
+      F.seekg(Header[0], std::ios::cur);
+      for (INT y = 0; y < H; y++)
+      {
+        /* Bottom-left origin images are stored upside down */
+        INT row = (Header[17] & 0x20) ? y : H - 1 - y;
+
+        for (INT x = 0; x < W; x++)
+        {
+          BYTE P[4];
+          UINT C = Color[(size_t)row * W + x];
+
+          if (!F.read((CHAR *)P, 4))
+            return -1;
+          for (INT i = 0; i < 4; i++)
+            if (abs((INT)P[i] - (INT)((C >> (i * 8)) & 0xFF)) > Tolerance)
+            {
+              n++;
+              break;
+            }
+        }
+      }
+      return n;
+    } /* End of 'CompareTGA' function */
+  }; /* end of 'soft_raster' class */
+} /* end of 'nidx' spacename */
+#endif // !_soft_h_
+
+/* END OF 'soft.h' FILE */
@@ -0,0 +1,429 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : trace.h
+  * PURPOSE     : T51DX12 project.
+  *               CPU reference path tracer module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Device independent reference for hardware ray tracing
+  *               path. Scene is shared with picking ('bvh'), surfaces are
+  *               lambertian with emission, lit by sky and directional sun
+  *               (sampled by shadow rays every bounce).
+  *               Image is split into 16x16 tiles traced by pool workers.
+  *               Every tile is traced as a wavefront: all its paths make
+  *               one ray stream per bounce, traced by 'bvh' packets, and
+  *               terminated paths are compacted away before next bounce.
+  *               Every 'Render' call adds one sample per pixel to the
+  *               accumulated image. Random numbers depend on pixel and
+  *               sample only, so the image does not depend on number of
+  *               threads.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _trace_h_
+#define _trace_h_
+
+#include "../../def.h"
+#include "../jobs.h"
+#include "bvh.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace nidx
+{
+  /* Path tracer material structure */
+  struct trace_material
+  {
+    FLT
+      Color[3],    /* Diffuse albedo */
+      Emission[3]; /* Emitted radiance */
+  }; /* End of 'trace_material' structure */
+
+  /* CPU path tracer class */
+  class path_tracer
+  {
+  public:
+    static const INT TileSize = 16;
+
+    FLT
+      Sky[3],          /* Sky radiance */
+      SunDir[3],       /* Direction to sun (normalized) */
+      Sun[3];          /* Sun irradiance */
+    INT MaxBounces;    /* Maximal number of bounces */
+
+  private:
+    static const INT MaxPaths = TileSize * TileSize;
+
+    /* Path state structure */
+    struct path
+    {
+      INT Pixel;       /* Pixel index */
+      UINT Seed;       /* Random generator state */
+      FLT Weight[3];   /* Path throughput */
+    }; /* End of 'path' structure */
+
+    /* Per thread wavefront storage structure */
+    struct wavefront
+    {
+      path Paths[MaxPaths], Shadows[MaxPaths]; /* Active paths and shadow ray contributions */
+      bvh_ray Rays[MaxPaths], ShadowRays[MaxPaths]; /* Ray streams */
+      bvh_hit Hits[MaxPaths], ShadowHits[MaxPaths]; /* Hits of ray streams */
+      UINT64 NumOfRays;                         /* Traced rays counter */
+    }; /* End of 'wavefront' structure */
+
+    jobs &Pool;                           /* Worker threads */
+    INT W, H, TilesX, TilesY;             /* Frame and tile grid sizes */
+    INT NumOfSamples;                     /* Number of accumulated samples per pixel */
+    UINT64 NumOfRays;                     /* Number of rays traced by last pass */
+    const bvh *Scene;                     /* Scene hierarchy */
+    std::vector<INT> TriMaterials;        /* Material of every source triangle */
+    std::vector<trace_material> Materials; /* Materials */
+    std::vector<FLT> Accum;               /* Accumulated radiance, 3 floats per pixel */
+    std::vector<UINT> Color;              /* Tone mapped image (0xAARRGGBB) */
+    std::vector<wavefront> Fronts;        /* Wavefront storage of every thread */
+    bvh_ray Camera[3];                    /* Ray of pixel (0, 0) and its X, Y pixel derivatives */
+
+    /* Obtain random number function.
+     * ARGUMENTS:
+     *   - generator state:
+     *       UINT &Seed;
+     * RETURNS:
+     *   (FLT) random number in [0..1).
+     */
+    static FLT Random( UINT &Seed )
+    {
+      UINT x;
+
+      /* PCG-style: LCG step with permuted output */
+      Seed = Seed * 747796405u + 2891336453u;
+      x = ((Seed >> ((Seed >> 28) + 4)) ^ Seed) * 277803737u;
+      x ^= x >> 22;
+      return (x >> 8) * (1.0f / 16777216);
+    } /* End of 'Random' function */
+
+    /* Hash integer function.
+     * ARGUMENTS:
+     *   - value to hash:
+     *       UINT X;
+     * RETURNS:
+     *   (UINT) hashed value.
+     */
+    static UINT Hash( UINT X )
+    {
+      X ^= X >> 16;
+      X *= 0x7FEB352Du;
+      X ^= X >> 15;
+      X *= 0x846CA68Bu;
+      X ^= X >> 16;
+      return X;
+    } /* End of 'Hash' function */
+
+    /* Tone map and pack accumulated pixel function.
+     * ARGUMENTS:
+     *   - accumulated radiance:
+     *       const FLT *L;
+     *   - radiance scale (1 / number of samples):
+     *       FLT Scale;
+     * RETURNS:
+     *   (UINT) 0xAARRGGBB color.
+     */
+    static UINT Pack( const FLT *L, FLT Scale )
+    {
+      UINT R = 0xFF000000;
+
+      for (INT i = 0; i < 3; i++)
+      {
+        FLT c = L[i] * Scale;
+
+        /* Reinhard operator, gamma 2.2 */
+        c = (FLT)pow(c / (1 + c), 1 / 2.2);
+        R |= (UINT)(c * 255 + 0.5f) << (16 - i * 8);
+      }
+      return R;
+    } /* End of 'Pack' function */
+
+    /* Trace one sample of every tile pixel function.
+     * ARGUMENTS:
+     *   - tile number:
+     *       INT Tile;
+     *   - wavefront storage:
+     *       wavefront &F;
+     * RETURNS: None.
+     */
+    VOID TraceTile( INT Tile, wavefront &F )
+    {
+      const FLT Pi = 3.14159265358979f;
+      INT
+        X0 = Tile % TilesX * TileSize, Y0 = Tile / TilesX * TileSize,
+        X1 = std::min(X0 + TileSize, W), Y1 = std::min(Y0 + TileSize, H), N = 0;
+
+      /* Primary rays with jittered pixel positions */
+      for (INT y = Y0; y < Y1; y++)
+        for (INT x = X0; x < X1; x++)
+        {
+          path &P = F.Paths[N];
+          bvh_ray &R = F.Rays[N++];
+          FLT dx, dy;
+
+          P.Pixel = y * W + x;
+          P.Seed = Hash((UINT)P.Pixel * 9781u + Hash((UINT)NumOfSamples));
+          P.Weight[0] = P.Weight[1] = P.Weight[2] = 1;
+          dx = x + Random(P.Seed) - 0.5f;
+          dy = y + Random(P.Seed) - 0.5f;
+          for (INT k = 0; k < 3; k++)
+          {
+            R.Org[k] = Camera[0].Org[k] + dx * Camera[1].Org[k] + dy * Camera[2].Org[k];
+            R.Dir[k] = Camera[0].Dir[k] + dx * Camera[1].Dir[k] + dy * Camera[2].Dir[k];
+          }
+          R.TMax = 1;
+        }
+
+      for (INT Bounce = 0; N > 0 && Bounce <= MaxBounces; Bounce++)
+      {
+        INT Alive = 0, NumOfShadows = 0;
+
+        Scene->IntersectStream(F.Rays, N, F.Hits);
+        F.NumOfRays += N;
+        for (INT i = 0; i < N; i++)
+        {
+          path P = F.Paths[i];
+          const bvh_ray &R = F.Rays[i];
+          const bvh_hit &Hit = F.Hits[i];
+          FLT *L = &Accum[(size_t)P.Pixel * 3], Pos[3], Norm[3], Len, Eps = 0, Cos, T[3], B[3], u, v, r, s;
+
+          if (Hit.Tri < 0)
+          {
+            for (INT k = 0; k < 3; k++)
+              L[k] += P.Weight[k] * Sky[k];
+            continue;
+          }
+
+          const trace_material &M = Materials[TriMaterials[Scene->GetTriangle(Hit)]];
+          const FLT *V = Scene->GetVertices(Hit);
+
+          /* Geometric normal facing the ray */
+          Norm[0] = (V[4] - V[1]) * (V[8] - V[2]) - (V[5] - V[2]) * (V[7] - V[1]);
+          Norm[1] = (V[5] - V[2]) * (V[6] - V[0]) - (V[3] - V[0]) * (V[8] - V[2]);
+          Norm[2] = (V[3] - V[0]) * (V[7] - V[1]) - (V[4] - V[1]) * (V[6] - V[0]);
+          Len = (FLT)sqrt(Norm[0] * Norm[0] + Norm[1] * Norm[1] + Norm[2] * Norm[2]);
+          if (Norm[0] * R.Dir[0] + Norm[1] * R.Dir[1] + Norm[2] * R.Dir[2] > 0)
+            Len = -Len;
+          for (INT k = 0; k < 3; k++)
+          {
+            Norm[k] /= Len;
+            Pos[k] = R.Org[k] + R.Dir[k] * Hit.T;
+            Eps = std::max(Eps, (FLT)fabs(Pos[k]));
+            L[k] += P.Weight[k] * M.Emission[k];
+            P.Weight[k] *= M.Color[k];
+          }
+          /* Offset grows with coordinates magnitude to skip self intersections */
+          Eps = 1e-4f * (1 + Eps);
+          for (INT k = 0; k < 3; k++)
+            Pos[k] += Norm[k] * Eps;
+
+          /* Sun shadow ray */
+          Cos = Norm[0] * SunDir[0] + Norm[1] * SunDir[1] + Norm[2] * SunDir[2];
+          if (Cos > 0)
+          {
+            path &S = F.Shadows[NumOfShadows];
+            bvh_ray &Sr = F.ShadowRays[NumOfShadows++];
+
+            S.Pixel = P.Pixel;
+            for (INT k = 0; k < 3; k++)
+            {
+              S.Weight[k] = P.Weight[k] * Sun[k] * Cos / Pi;
+              Sr.Org[k] = Pos[k];
+              Sr.Dir[k] = SunDir[k];
+            }
+            Sr.TMax = FLT_MAX;
+          }
+
+          /* Russian roulette */
+          if (Bounce >= 2)
+          {
+            FLT Survive = std::min(std::max(std::max(P.Weight[0], P.Weight[1]), P.Weight[2]), 0.95f);
+
+            if (Random(P.Seed) >= Survive)
+              continue;
+            for (INT k = 0; k < 3; k++)
+              P.Weight[k] /= Survive;
+          }
+          if (Bounce == MaxBounces || (P.Weight[0] == 0 && P.Weight[1] == 0 && P.Weight[2] == 0))
+            continue;
+
+          /* Cosine distributed bounce direction in normal basis (Duff et al.) */
+          s = Norm[2] >= 0 ? 1.0f : -1.0f;
+          u = -1 / (s + Norm[2]);
+          v = Norm[0] * Norm[1] * u;
+          T[0] = 1 + s * Norm[0] * Norm[0] * u, T[1] = s * v, T[2] = -s * Norm[0];
+          B[0] = v, B[1] = s + Norm[1] * Norm[1] * u, B[2] = -Norm[1];
+          u = Random(P.Seed);
+          v = 2 * Pi * Random(P.Seed);
+          r = (FLT)sqrt(u);
+          s = (FLT)sqrt(1 - u);
+
+          bvh_ray &Next = F.Rays[Alive];
+
+          for (INT k = 0; k < 3; k++)
+          {
+            Next.Org[k] = Pos[k];
+            Next.Dir[k] = T[k] * r * (FLT)cos(v) + B[k] * r * (FLT)sin(v) + Norm[k] * s;
+          }
+          Next.TMax = FLT_MAX;
+          F.Paths[Alive++] = P;
+        }
+
+        /* Add sun light of unoccluded shadow rays */
+        Scene->IntersectStream(F.ShadowRays, NumOfShadows, F.ShadowHits);
+        F.NumOfRays += NumOfShadows;
+        for (INT i = 0; i < NumOfShadows; i++)
+          if (F.ShadowHits[i].Tri < 0)
+          {
+            FLT *L = &Accum[(size_t)F.Shadows[i].Pixel * 3];
+
+            for (INT k = 0; k < 3; k++)
+              L[k] += F.Shadows[i].Weight[k];
+          }
+        N = Alive;
+      }
+
+      FLT Scale = 1.0f / (NumOfSamples + 1);
+
+      for (INT y = Y0; y < Y1; y++)
+        for (INT x = X0; x < X1; x++)
+          Color[(size_t)y * W + x] = Pack(&Accum[((size_t)y * W + x) * 3], Scale);
+    } /* End of 'TraceTile' function */
+
+  public:
+    /* Path tracer constructor.
+     * ARGUMENTS:
+     *   - frame size:
+     *       INT NewW, NewH;
+     *   - worker threads:
+     *       jobs &NewPool;
+     */
+    path_tracer( INT NewW, INT NewH, jobs &NewPool = jobs::Get() ) :
+      Sky{0.6f, 0.7f, 0.9f}, SunDir{0.48f, 0.8f, 0.36f}, Sun{3, 2.8f, 2.5f}, MaxBounces(4),
+      Pool(NewPool), W(NewW), H(NewH),
+      TilesX((NewW + TileSize - 1) / TileSize), TilesY((NewH + TileSize - 1) / TileSize),
+      NumOfSamples(0), NumOfRays(0), Scene(nullptr),
+      Accum((size_t)NewW * NewH * 3), Color((size_t)NewW * NewH), Fronts(NewPool.GetNumOfThreads())
+    {
+    } /* End of 'path_tracer' function */
+
+    /* Set scene function.
+     * ARGUMENTS:
+     *   - built scene hierarchy (must stay alive while rendering):
+     *       const bvh &NewScene;
+     *   - material of every source triangle (nullptr - all triangles use first):
+     *       const INT *TriMaterial;
+     *   - number of source triangles:
+     *       INT NumOfTris;
+     *   - materials (at least one):
+     *       const trace_material *NewMaterials;
+     *       INT NumOfMaterials;
+     * RETURNS: None.
+     */
+    VOID SetScene( const bvh &NewScene, const INT *TriMaterial, INT NumOfTris,
+                   const trace_material *NewMaterials, INT NumOfMaterials )
+    {
+      Scene = &NewScene;
+      TriMaterials.assign(NumOfTris, 0);
+      if (TriMaterial != nullptr)
+        for (INT i = 0; i < NumOfTris; i++)
+          TriMaterials[i] = std::min(std::max(TriMaterial[i], 0), NumOfMaterials - 1);
+      Materials.assign(NewMaterials, NewMaterials + NumOfMaterials);
+      Reset();
+    } /* End of 'SetScene' function */
+
+    /* Set camera function.
+     * ARGUMENTS:
+     *   - view projection matrix (see 'bvh::Unproject'):
+     *       const matr &VP;
+     * RETURNS: None.
+     */
+    VOID SetCamera( const matr &VP )
+    {
+      /* Projection is linear in pixel coordinates, so rays are interpolated */
+      Camera[0] = bvh::Unproject(VP, 0, 0, W, H);
+      Camera[1] = bvh::Unproject(VP, 1, 0, W, H);
+      Camera[2] = bvh::Unproject(VP, 0, 1, W, H);
+      for (INT i = 1; i < 3; i++)
+        for (INT k = 0; k < 3; k++)
+          Camera[i].Org[k] -= Camera[0].Org[k], Camera[i].Dir[k] -= Camera[0].Dir[k];
+      Reset();
+    } /* End of 'SetCamera' function */
+
+    /* Drop accumulated samples function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Reset( VOID )
+    {
+      std::fill(Accum.begin(), Accum.end(), 0.0f);
+      NumOfSamples = 0;
+    } /* End of 'Reset' function */
+
+    /* Add one sample per pixel function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Render( VOID )
+    {
+      if (Scene == nullptr || Materials.empty())
+        return;
+      for (auto &F : Fronts)
+        F.NumOfRays = 0;
+      Pool.ParallelFor(TilesX * TilesY, [&]( INT Tile, INT Thread )
+        {
+          TraceTile(Tile, Fronts[Thread]);
+        });
+      NumOfSamples++;
+      NumOfRays = 0;
+      for (auto &F : Fronts)
+        NumOfRays += F.NumOfRays;
+    } /* End of 'Render' function */
+
+    /* Obtain tone mapped image function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const std::vector<UINT> &) 0xAARRGGBB pixels, row by row.
+     */
+    const std::vector<UINT> & GetColor( VOID ) const
+    {
+      return Color;
+    } /* End of 'GetColor' function */
+
+    /* Obtain number of accumulated samples per pixel function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) number of samples.
+     */
+    INT GetNumOfSamples( VOID ) const
+    {
+      return NumOfSamples;
+    } /* End of 'GetNumOfSamples' function */
+
+    /* Obtain number of rays traced by last pass function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (UINT64) number of primary, bounce and shadow rays.
+     */
+    UINT64 GetNumOfRays( VOID ) const
+    {
+      return NumOfRays;
+    } /* End of 'GetNumOfRays' function */
+  }; /* end of 'path_tracer' class */
+} /* end of 'nidx' spacename */
+
+#endif // !_trace_h_
+
+/* END OF 'trace.h' FILE */
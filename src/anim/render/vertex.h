@@ -0,0 +1,542 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : vertex.h
+  * PURPOSE     : T51DX12 project.
+  *               Vertex formats declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Layout is a list of attribute codecs, its size,
+  *               offsets and input layout are built at compile time.
+  *               Quantized positions are relative to mesh bounds:
+  *               P = Decoded * Scale + Offset, the shader folds it
+  *               into the world matrix. Format values match DXGI_FORMAT,
+  *               input layout is available if d3d12.h is included first.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _vertex_h_
+#define _vertex_h_
+
+#include "../../def.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define NIDX_VERTEX_SSE2
+#endif /* __SSE2__ */
+
+namespace nidx
+{
+  /* Vertex element formats (same values as DXGI_FORMAT) */
+  enum struct vertex_format : UINT
+  {
+    R32G32B32A32_FLOAT = 2,
+    R32G32B32_FLOAT = 6,
+    R16G16B16A16_SNORM = 13,
+    R32G32_FLOAT = 16,
+    R8G8B8A8_SNORM = 31,
+    R16G16_FLOAT = 34,
+    R16G16_SNORM = 37,
+  }; /* End of 'vertex_format' enum */
+
+  /* Input layout element structure */
+  struct vertex_element
+  {
+    const CHAR *Semantic;  /* HLSL semantic name */
+    UINT SemanticIndex;    /* HLSL semantic index */
+    vertex_format Format;  /* Element format */
+    UINT Offset;           /* Offset in vertex */
+  }; /* End of 'vertex_element' structure */
+
+  /* Uncompressed source vertex structure */
+  struct vertex_src
+  {
+    FLT
+      P[3],   /* Position */
+      N[3],   /* Unit normal */
+      T[4],   /* Unit tangent and bitangent sign */
+      UV[2];  /* Texture coordinates */
+  }; /* End of 'vertex_src' structure */
+
+  /* Position quantization parameters structure */
+  struct vertex_quant
+  {
+    FLT
+      Offset[3],  /* Bounds center */
+      Scale[3];   /* Bounds half size */
+
+    /* Compute parameters from vertices bounds function.
+     * ARGUMENTS:
+     *   - vertices:
+     *       const vertex_src *V;
+     *       INT N;
+     * RETURNS:
+     *   (vertex_quant) parameters.
+     */
+    static vertex_quant Compute( const vertex_src *V, INT N )
+    {
+      vertex_quant Q;
+      FLT Min[3] = {0, 0, 0}, Max[3] = {0, 0, 0};
+
+      for (INT i = 0; i < N; i++)
+        for (INT k = 0; k < 3; k++)
+        {
+          Min[k] = i == 0 ? V[i].P[k] : std::min(Min[k], V[i].P[k]);
+          Max[k] = i == 0 ? V[i].P[k] : std::max(Max[k], V[i].P[k]);
+        }
+      for (INT k = 0; k < 3; k++)
+      {
+        Q.Offset[k] = (Min[k] + Max[k]) / 2;
+        Q.Scale[k] = std::max((Max[k] - Min[k]) / 2, 1e-20f);
+      }
+      return Q;
+    } /* End of 'Compute' function */
+  }; /* End of 'vertex_quant' structure */
+
+  /* Vertex codec helpers */
+  namespace vertex_codec
+  {
+    /* Convert [-1..1] value to signed normalized integer function.
+     * ARGUMENTS:
+     *   - value:
+     *       FLT F;
+     *   - maximal integer:
+     *       INT Max;
+     * RETURNS:
+     *   (INT) integer.
+     */
+    inline INT ToSnorm( FLT F, INT Max )
+    {
+      F = F < -1 ? -1 : F > 1 ? 1 : F;
+      return (INT)floor(F * Max + 0.5f);
+    } /* End of 'ToSnorm' function */
+
+    /* Encode unit vector to octahedral map function.
+     * ARGUMENTS:
+     *   - unit vector:
+     *       const FLT *N;
+     *   - octahedral coordinates [-1..1] to fill:
+     *       FLT *O;
+     * RETURNS: None.
+     */
+    inline VOID OctEncode( const FLT *N, FLT *O )
+    {
+      FLT L = fabs(N[0]) + fabs(N[1]) + fabs(N[2]), x, y;
+
+      L = L == 0 ? 1 : L;
+      x = N[0] / L, y = N[1] / L;
+      if (N[2] < 0)
+      {
+        FLT ox = x;
+
+        x = (1 - fabs(y)) * (ox >= 0 ? 1 : -1);
+        y = (1 - fabs(ox)) * (y >= 0 ? 1 : -1);
+      }
+      O[0] = x, O[1] = y;
+    } /* End of 'OctEncode' function */
+
+    /* Decode unit vector from octahedral map function.
+     * ARGUMENTS:
+     *   - octahedral coordinates:
+     *       FLT X, Y;
+     *   - unit vector to fill:
+     *       FLT *N;
+     * RETURNS: None.
+     */
+    inline VOID OctDecode( FLT X, FLT Y, FLT *N )
+    {
+      FLT z = 1 - fabs(X) - fabs(Y), L;
+
+      if (z < 0)
+      {
+        FLT ox = X;
+
+        X = (1 - fabs(Y)) * (ox >= 0 ? 1 : -1);
+        Y = (1 - fabs(ox)) * (Y >= 0 ? 1 : -1);
+      }
+      L = (FLT)sqrt(X * X + Y * Y + z * z);
+      N[0] = X / L, N[1] = Y / L, N[2] = z / L;
+    } /* End of 'OctDecode' function */
+  } /* end of 'vertex_codec' namespace */
+
+  /* Full precision position attribute */
+  struct attr_pos_f32
+  {
+    static const UINT Size = 12;
+    static const vertex_format Format = vertex_format::R32G32B32_FLOAT;
+    static const CHAR * Semantic( VOID ) { return "POSITION"; }
+    static VOID Encode( BYTE *D, const vertex_src &V, const vertex_quant & ) { memcpy(D, V.P, 12); }
+    static VOID Decode( vertex_src &V, const BYTE *D, const vertex_quant & ) { memcpy(V.P, D, 12); }
+  }; /* End of 'attr_pos_f32' structure */
+
+  /* 16 bit normalized position attribute (relative to bounds) */
+  struct attr_pos_snorm16
+  {
+    static const UINT Size = 8;
+    static const vertex_format Format = vertex_format::R16G16B16A16_SNORM;
+    static const CHAR * Semantic( VOID ) { return "POSITION"; }
+    static VOID Encode( BYTE *D, const vertex_src &V, const vertex_quant &Q )
+    {
+      SHORT S[4] = {0, 0, 0, 32767};
+
+      for (INT k = 0; k < 3; k++)
+        S[k] = (SHORT)vertex_codec::ToSnorm((V.P[k] - Q.Offset[k]) / Q.Scale[k], 32767);
+      memcpy(D, S, 8);
+    }
+    static VOID Decode( vertex_src &V, const BYTE *D, const vertex_quant &Q )
+    {
+      SHORT S[4];
+
+      memcpy(S, D, 8);
+      for (INT k = 0; k < 3; k++)
+        V.P[k] = std::max(S[k] / 32767.0f, -1.0f) * Q.Scale[k] + Q.Offset[k];
+    }
+  }; /* End of 'attr_pos_snorm16' structure */
+
+  /* Full precision normal attribute */
+  struct attr_normal_f32
+  {
+    static const UINT Size = 12;
+    static const vertex_format Format = vertex_format::R32G32B32_FLOAT;
+    static const CHAR * Semantic( VOID ) { return "NORMAL"; }
+    static VOID Encode( BYTE *D, const vertex_src &V, const vertex_quant & ) { memcpy(D, V.N, 12); }
+    static VOID Decode( vertex_src &V, const BYTE *D, const vertex_quant & ) { memcpy(V.N, D, 12); }
+  }; /* End of 'attr_normal_f32' structure */
+
+  /* Octahedral 2 x 16 bit normal attribute */
+  struct attr_normal_oct16
+  {
+    static const UINT Size = 4;
+    static const vertex_format Format = vertex_format::R16G16_SNORM;
+    static const CHAR * Semantic( VOID ) { return "NORMAL"; }
+    static VOID Encode( BYTE *D, const vertex_src &V, const vertex_quant & )
+    {
+      FLT O[2];
+      SHORT S[2];
+
+      vertex_codec::OctEncode(V.N, O);
+      S[0] = (SHORT)vertex_codec::ToSnorm(O[0], 32767);
+      S[1] = (SHORT)vertex_codec::ToSnorm(O[1], 32767);
+      memcpy(D, S, 4);
+    }
+    static VOID Decode( vertex_src &V, const BYTE *D, const vertex_quant & )
+    {
+      SHORT S[2];
+
+      memcpy(S, D, 4);
+      vertex_codec::OctDecode(std::max(S[0] / 32767.0f, -1.0f), std::max(S[1] / 32767.0f, -1.0f), V.N);
+    }
+  }; /* End of 'attr_normal_oct16' structure */
+
+  /* Full precision tangent attribute */
+  struct attr_tangent_f32
+  {
+    static const UINT Size = 16;
+    static const vertex_format Format = vertex_format::R32G32B32A32_FLOAT;
+    static const CHAR * Semantic( VOID ) { return "TANGENT"; }
+    static VOID Encode( BYTE *D, const vertex_src &V, const vertex_quant & ) { memcpy(D, V.T, 16); }
+    static VOID Decode( vertex_src &V, const BYTE *D, const vertex_quant & ) { memcpy(V.T, D, 16); }
+  }; /* End of 'attr_tangent_f32' structure */
+
+  /* Octahedral 2 x 8 bit tangent attribute, bitangent sign in third byte */
+  struct attr_tangent_oct8
+  {
+    static const UINT Size = 4;
+    static const vertex_format Format = vertex_format::R8G8B8A8_SNORM;
+    static const CHAR * Semantic( VOID ) { return "TANGENT"; }
+    static VOID Encode( BYTE *D, const vertex_src &V, const vertex_quant & )
+    {
+      FLT O[2];
+      INT8 S[4];
+
+      vertex_codec::OctEncode(V.T, O);
+      S[0] = (INT8)vertex_codec::ToSnorm(O[0], 127);
+      S[1] = (INT8)vertex_codec::ToSnorm(O[1], 127);
+      S[2] = V.T[3] < 0 ? -127 : 127;
+      S[3] = 0;
+      memcpy(D, S, 4);
+    }
+    static VOID Decode( vertex_src &V, const BYTE *D, const vertex_quant & )
+    {
+      INT8 S[4];
+
+      memcpy(S, D, 4);
+      vertex_codec::OctDecode(std::max(S[0] / 127.0f, -1.0f), std::max(S[1] / 127.0f, -1.0f), V.T);
+      V.T[3] = S[2] < 0 ? -1.0f : 1.0f;
+    }
+  }; /* End of 'attr_tangent_oct8' structure */
+
+  /* Full precision texture coordinates attribute */
+  struct attr_uv_f32
+  {
+    static const UINT Size = 8;
+    static const vertex_format Format = vertex_format::R32G32_FLOAT;
+    static const CHAR * Semantic( VOID ) { return "TEXCOORD"; }
+    static VOID Encode( BYTE *D, const vertex_src &V, const vertex_quant & ) { memcpy(D, V.UV, 8); }
+    static VOID Decode( vertex_src &V, const BYTE *D, const vertex_quant & ) { memcpy(V.UV, D, 8); }
+  }; /* End of 'attr_uv_f32' structure */
+
+  /* Half float texture coordinates attribute */
+  struct attr_uv_half
+  {
+    static const UINT Size = 4;
+    static const vertex_format Format = vertex_format::R16G16_FLOAT;
+    static const CHAR * Semantic( VOID ) { return "TEXCOORD"; }
+    static VOID Encode( BYTE *D, const vertex_src &V, const vertex_quant & )
+    {
+      half H[2] = {V.UV[0], V.UV[1]};
+
+      memcpy(D, H, 4);
+    }
+    static VOID Decode( vertex_src &V, const BYTE *D, const vertex_quant & )
+    {
+      half H[2];
+
+      memcpy(H, D, 4);
+      V.UV[0] = H[0];
+      V.UV[1] = H[1];
+    }
+  }; /* End of 'attr_uv_half' structure */
+
+  /* Encode one attribute of vertices function.
+   * ARGUMENTS:
+   *   - destination attribute of first vertex and vertex stride:
+   *       BYTE *D;
+   *       size_t Stride;
+   *   - source vertices:
+   *       const vertex_src *V;
+   *       INT N;
+   *   - position quantization:
+   *       const vertex_quant &Q;
+   * RETURNS: None.
+   */
+  template<typename Attr>
+    inline VOID EncodeStream( BYTE *D, size_t Stride, const vertex_src *V, INT N, const vertex_quant &Q )
+    {
+      for (INT i = 0; i < N; i++)
+        Attr::Encode(D + i * Stride, V[i], Q);
+    } /* End of 'EncodeStream' function */
+
+  /* Encode quantized positions of vertices function (SSE2 if available).
+   * ARGUMENTS:
+   *   - destination attribute of first vertex and vertex stride:
+   *       BYTE *D;
+   *       size_t Stride;
+   *   - source vertices:
+   *       const vertex_src *V;
+   *       INT N;
+   *   - position quantization:
+   *       const vertex_quant &Q;
+   * RETURNS: None.
+   */
+  template<>
+    inline VOID EncodeStream<attr_pos_snorm16>( BYTE *D, size_t Stride, const vertex_src *V, INT N, const vertex_quant &Q )
+    {
+      INT i = 0;
+
+#ifdef NIDX_VERTEX_SSE2
+      const __m128
+        Off = _mm_setr_ps(Q.Offset[0], Q.Offset[1], Q.Offset[2], 0),
+        Mul = _mm_setr_ps(1 / Q.Scale[0], 1 / Q.Scale[1], 1 / Q.Scale[2], 0),
+        Lo = _mm_set1_ps(-1), Hi = _mm_set1_ps(1), One = _mm_setr_ps(0, 0, 0, 1), Max = _mm_set1_ps(32767);
+
+      for (; i < N; i++)
+      {
+        /* Fourth lane loads N[0] and is replaced by 1 */
+        __m128 p = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(V[i].P), Off), Mul);
+        __m128i s;
+
+        p = _mm_add_ps(_mm_and_ps(_mm_min_ps(_mm_max_ps(p, Lo), Hi), _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0))), One);
+        s = _mm_cvtps_epi32(_mm_mul_ps(p, Max));
+        _mm_storel_epi64((__m128i *)(D + i * Stride), _mm_packs_epi32(s, s));
+      }
+#endif /* NIDX_VERTEX_SSE2 */
+      for (; i < N; i++)
+        attr_pos_snorm16::Encode(D + i * Stride, V[i], Q);
+    } /* End of 'EncodeStream' function */
+
+  /* Compile time vertex layout class */
+  template<typename... Attrs>
+    class vertex_layout;
+
+  /* Empty layout (recursion end) */
+  template<>
+    class vertex_layout<>
+    {
+    public:
+      static const UINT Size = 0;
+
+      static VOID EncodeOne( BYTE *, const vertex_src &, const vertex_quant & )
+      {
+      }
+      static VOID DecodeOne( vertex_src &, const BYTE *, const vertex_quant & )
+      {
+      }
+      static VOID EncodeStreams( BYTE *, size_t, const vertex_src *, INT, const vertex_quant & )
+      {
+      }
+      static VOID AddElements( std::vector<vertex_element> &, UINT )
+      {
+      }
+    }; /* end of 'vertex_layout' class */
+
+  /* Layout of first attribute followed by the rest */
+  template<typename First, typename... Rest>
+    class vertex_layout<First, Rest...>
+    {
+    public:
+      typedef vertex_layout<Rest...> rest;
+
+      /* Vertex size in bytes */
+      static const UINT Size = First::Size + rest::Size;
+
+      /* Encode one vertex function.
+       * ARGUMENTS:
+       *   - destination:
+       *       BYTE *D;
+       *   - source vertex:
+       *       const vertex_src &V;
+       *   - position quantization:
+       *       const vertex_quant &Q;
+       * RETURNS: None.
+       */
+      static VOID EncodeOne( BYTE *D, const vertex_src &V, const vertex_quant &Q )
+      {
+        First::Encode(D, V, Q);
+        rest::EncodeOne(D + First::Size, V, Q);
+      } /* End of 'EncodeOne' function */
+
+      /* Decode one vertex function.
+       * ARGUMENTS:
+       *   - vertex to fill:
+       *       vertex_src &V;
+       *   - source:
+       *       const BYTE *D;
+       *   - position quantization:
+       *       const vertex_quant &Q;
+       * RETURNS: None.
+       */
+      static VOID DecodeOne( vertex_src &V, const BYTE *D, const vertex_quant &Q )
+      {
+        First::Decode(V, D, Q);
+        rest::DecodeOne(V, D + First::Size, Q);
+      } /* End of 'DecodeOne' function */
+
+      /* Encode vertices attribute by attribute function.
+       * ARGUMENTS:
+       *   - destination first attribute of first vertex and vertex stride:
+       *       BYTE *D;
+       *       size_t Stride;
+       *   - source vertices:
+       *       const vertex_src *V;
+       *       INT N;
+       *   - position quantization:
+       *       const vertex_quant &Q;
+       * RETURNS: None.
+       */
+      static VOID EncodeStreams( BYTE *D, size_t Stride, const vertex_src *V, INT N, const vertex_quant &Q )
+      {
+        EncodeStream<First>(D, Stride, V, N, Q);
+        rest::EncodeStreams(D + First::Size, Stride, V, N, Q);
+      } /* End of 'EncodeStreams' function */
+
+      /* Append input layout elements function.
+       * ARGUMENTS:
+       *   - elements to append to:
+       *       std::vector<vertex_element> &E;
+       *   - first attribute offset:
+       *       UINT Offset;
+       * RETURNS: None.
+       */
+      static VOID AddElements( std::vector<vertex_element> &E, UINT Offset )
+      {
+        UINT Index = 0;
+
+        for (auto &e : E)
+          Index += strcmp(e.Semantic, First::Semantic()) == 0;
+        E.push_back({First::Semantic(), Index, First::Format, Offset});
+        rest::AddElements(E, Offset + First::Size);
+      } /* End of 'AddElements' function */
+
+      /* Obtain input layout function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (std::vector<vertex_element>) elements.
+       */
+      static std::vector<vertex_element> GetElements( VOID )
+      {
+        std::vector<vertex_element> E;
+
+        AddElements(E, 0);
+        return E;
+      } /* End of 'GetElements' function */
+
+#ifdef __d3d12_h__
+      /* Obtain Direct3D 12 input layout function.
+       * ARGUMENTS:
+       *   - input slot:
+       *       UINT Slot;
+       * RETURNS:
+       *   (std::vector<D3D12_INPUT_ELEMENT_DESC>) elements.
+       */
+      static std::vector<D3D12_INPUT_ELEMENT_DESC> GetInputLayout( UINT Slot = 0 )
+      {
+        std::vector<D3D12_INPUT_ELEMENT_DESC> L;
+
+        for (auto &e : GetElements())
+          L.push_back({e.Semantic, e.SemanticIndex, (DXGI_FORMAT)e.Format, Slot, e.Offset,
+                       D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0});
+        return L;
+      } /* End of 'GetInputLayout' function */
+#endif /* __d3d12_h__ */
+
+      /* Encode vertices function.
+       * ARGUMENTS:
+       *   - destination (N * Size bytes):
+       *       VOID *Dst;
+       *   - source vertices:
+       *       const vertex_src *V;
+       *       INT N;
+       *   - position quantization:
+       *       const vertex_quant &Q;
+       * RETURNS: None.
+       */
+      static VOID Encode( VOID *Dst, const vertex_src *V, INT N, const vertex_quant &Q )
+      {
+        EncodeStreams((BYTE *)Dst, Size, V, N, Q);
+      } /* End of 'Encode' function */
+
+      /* Decode vertices function.
+       * ARGUMENTS:
+       *   - vertices to fill:
+       *       vertex_src *V;
+       *   - source (N * Size bytes):
+       *       const VOID *Src;
+       *       INT N;
+       *   - position quantization:
+       *       const vertex_quant &Q;
+       * RETURNS: None.
+       */
+      static VOID Decode( vertex_src *V, const VOID *Src, INT N, const vertex_quant &Q )
+      {
+        for (INT i = 0; i < N; i++)
+          DecodeOne(V[i], (const BYTE *)Src + (size_t)i * Size, Q);
+      } /* End of 'Decode' function */
+    }; /* end of 'vertex_layout' class */
+
+  /* Standard layouts */
+  typedef vertex_layout<attr_pos_f32, attr_normal_f32, attr_tangent_f32, attr_uv_f32> vertex_full;
+  typedef vertex_layout<attr_pos_snorm16, attr_normal_oct16, attr_tangent_oct8, attr_uv_half> vertex_compact;
+} /* end of 'nidx' spacename */
+#endif // !_vertex_h_
+
+/* END OF 'vertex.h' FILE */
@@ -0,0 +1,365 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : replay.h
+  * PURPOSE     : T51DX12 project.
+  *               Input record and replay declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Log format (little endian):
+  *                 header: 'NDRP', UINT32 version;
+  *                 frame:  DBL DeltaTime, UINT16 NumOfEvents, BYTE Flags,
+  *                         events (FLT offset, BYTE type, BYTE key,
+  *                         INT16 X, INT16 Y), joystick block if
+  *                         flags bit 0 is set (UINT32 buttons, CHAR POV,
+  *                         4 x INT16 axes).
+  *               'PlayHeadless' drives input and fixed step simulation
+  *               from a log without window and device (tests, tools).
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _replay_h_
+#define _replay_h_
+
+#include "../def.h"
+#include "input.h"
+#include "stepper.h"
+
+#include <fstream>
+#include <string>
+
+namespace nidx
+{
+  /* Input session record and replay class */
+  class replay
+  {
+  public:
+    /* Session modes */
+    enum struct mode
+    {
+      NONE,   /* Live input */
+      RECORD, /* Live input is written to log */
+      PLAY,   /* Input is read from log */
+    }; /* End of 'mode' enum */
+
+  private:
+    static const UINT Version = 1;
+    std::fstream File;    /* Log file */
+    event_queue Played;   /* Played events (live events are not mixed in) */
+    mode Mode;            /* Current mode */
+    DBL FrameBase;        /* Time events of current frame are stored relative to */
+    /* Last stored joystick state */
+    UINT JButtons;
+    INT JPov;
+    SHORT JAxes[4];
+
+    /* Write value to log function.
+     * ARGUMENTS:
+     *   - value to write:
+     *       const Type &Val;
+     * RETURNS: None.
+     */
+    template<typename Type>
+      VOID Write( const Type &Val )
+      {
+        File.write(reinterpret_cast<const CHAR *>(&Val), sizeof(Type));
+      } /* End of 'Write' function */
+
+    /* Read value from log function.
+     * ARGUMENTS:
+     *   - value to read:
+     *       Type &Val;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    template<typename Type>
+      BOOL Read( Type &Val )
+      {
+        return File.read(reinterpret_cast<CHAR *>(&Val), sizeof(Type)) ? TRUE : FALSE;
+      } /* End of 'Read' function */
+
+    /* Quantize joystick axis function.
+     * ARGUMENTS:
+     *   - axis value [-1..1]:
+     *       DBL A;
+     * RETURNS:
+     *   (SHORT) quantized axis.
+     */
+    static SHORT QuantizeAxis( DBL A )
+    {
+      return (SHORT)(A < -1 ? -32767 : A > 1 ? 32767 : floor(A * 32767 + 0.5));
+    } /* End of 'QuantizeAxis' function */
+
+  public:
+    UINT64 FrameCounter;  /* Number of recorded or played frames */
+
+    /* Replay initializing function.
+     * ARGUMENTS: None.
+     */
+    replay( VOID ) : Mode(mode::NONE), FrameBase(0), JButtons(0), JPov(-1), JAxes(), FrameCounter(0)
+    {
+    } /* End of 'replay' function */
+
+    /* Obtain current mode function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (mode) current mode.
+     */
+    mode GetMode( VOID ) const
+    {
+      return Mode;
+    } /* End of 'GetMode' function */
+
+    /* Obtain replay clock function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (DBL) sum of played frame intervals.
+     */
+    DBL GetTime( VOID ) const
+    {
+      return FrameBase;
+    } /* End of 'GetTime' function */
+
+    /* Start recording function.
+     * ARGUMENTS:
+     *   - log file name:
+     *       const std::string &FileName;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    BOOL StartRecord( const std::string &FileName )
+    {
+      Stop();
+      File.open(FileName, std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!File.is_open())
+        return FALSE;
+      File.write("NDRP", 4);
+      Write((UINT32)Version);
+      Mode = mode::RECORD;
+      FrameBase = input_event::Now();
+      JButtons = 0;
+      JPov = -1;
+      ZeroMemory(JAxes, sizeof(JAxes));
+      FrameCounter = 0;
+      return TRUE;
+    } /* End of 'StartRecord' function */
+
+    /* Start playing function.
+     * ARGUMENTS:
+     *   - log file name:
+     *       const std::string &FileName;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    BOOL StartPlay( const std::string &FileName )
+    {
+      CHAR Magic[4];
+      UINT32 Ver;
+
+      Stop();
+      File.open(FileName, std::ios::in | std::ios::binary);
+      if (!File.is_open())
+        return FALSE;
+      if (!File.read(Magic, 4) || memcmp(Magic, "NDRP", 4) != 0 || !Read(Ver) || Ver != Version)
+      {
+        File.close();
+        return FALSE;
+      }
+      Mode = mode::PLAY;
+      FrameBase = 0;
+      JButtons = 0;
+      JPov = -1;
+      ZeroMemory(JAxes, sizeof(JAxes));
+      FrameCounter = 0;
+      return TRUE;
+    } /* End of 'StartPlay' function */
+
+    /* Stop recording or playing function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Stop( VOID )
+    {
+      if (File.is_open())
+        File.close();
+      Mode = mode::NONE;
+    } /* End of 'Stop' function */
+
+    /* Store frame input to log function.
+     * ARGUMENTS:
+     *   - frame interval:
+     *       DBL DeltaTime;
+     *   - input state after response:
+     *       const input &In;
+     * RETURNS: None.
+     */
+    VOID WriteFrame( DBL DeltaTime, const input &In )
+    {
+      UINT Buttons = 0;
+      SHORT Axes[4] = {QuantizeAxis(In.JX), QuantizeAxis(In.JY), QuantizeAxis(In.JZ), QuantizeAxis(In.JR)};
+      BYTE Flags = 0;
+      USHORT n = (USHORT)(In.FrameEvents.size() > 0xFFFF ? 0xFFFF : In.FrameEvents.size());
+
+      if (Mode != mode::RECORD)
+        return;
+      for (INT i = 0; i < 32; i++)
+        Buttons |= (UINT)(In.JBut[i] != 0) << i;
+      if (Buttons != JButtons || In.JPov != JPov || memcmp(Axes, JAxes, sizeof(Axes)) != 0)
+        Flags |= 1;
+
+      Write(DeltaTime);
+      Write(n);
+      Write(Flags);
+      for (INT i = 0; i < n; i++)
+      {
+        const input_event &E = In.FrameEvents[i];
+
+        Write((FLT)(E.Time - FrameBase));
+        Write((BYTE)E.Type);
+        Write(E.Key);
+        Write((SHORT)E.X);
+        Write((SHORT)E.Y);
+      }
+      if (Flags & 1)
+      {
+        JButtons = Buttons;
+        JPov = In.JPov;
+        memcpy(JAxes, Axes, sizeof(Axes));
+        Write((UINT32)JButtons);
+        Write((CHAR)JPov);
+        File.write(reinterpret_cast<const CHAR *>(JAxes), sizeof(JAxes));
+      }
+      FrameBase = input_event::Now();
+      FrameCounter++;
+    } /* End of 'WriteFrame' function */
+
+    /* Load next frame input from log function.
+     * ARGUMENTS:
+     *   - frame interval to fill:
+     *       DBL &DeltaTime;
+     *   - queue to put recorded events to:
+     *       event_queue &Queue;
+     *   - input to set joystick state to:
+     *       input &In;
+     * RETURNS:
+     *   (BOOL) TRUE if frame is loaded, FALSE at the end of log.
+     */
+    BOOL ReadFrame( DBL &DeltaTime, event_queue &Queue, input &In )
+    {
+      USHORT n;
+      BYTE Flags;
+
+      if (Mode != mode::PLAY || !Read(DeltaTime) || !Read(n) || !Read(Flags))
+      {
+        Stop();
+        return FALSE;
+      }
+      for (INT i = 0; i < n; i++)
+      {
+        input_event E;
+        FLT Offset;
+        BYTE Type;
+        SHORT X, Y;
+
+        if (!Read(Offset) || !Read(Type) || !Read(E.Key) || !Read(X) || !Read(Y))
+        {
+          Stop();
+          return FALSE;
+        }
+        /* Replay clock is the sum of recorded intervals */
+        E.Time = FrameBase + Offset;
+        E.Type = (event_type)Type;
+        E.X = X;
+        E.Y = Y;
+        Queue.Push(E);
+      }
+      if (Flags & 1)
+      {
+        UINT32 Buttons;
+        CHAR Pov;
+
+        if (!Read(Buttons) || !Read(Pov) || !File.read(reinterpret_cast<CHAR *>(JAxes), sizeof(JAxes)))
+        {
+          Stop();
+          return FALSE;
+        }
+        JButtons = Buttons;
+        JPov = Pov;
+      }
+      for (INT i = 0; i < 32; i++)
+      {
+        In.JBut[i] = (JButtons >> i) & 1;
+        In.JButClick[i] = In.JBut[i] && !In.JButOld[i];
+        In.JButOld[i] = In.JBut[i];
+      }
+      In.JPov = JPov;
+      In.JX = JAxes[0] / 32767.0;
+      In.JY = JAxes[1] / 32767.0;
+      In.JZ = JAxes[2] / 32767.0;
+      In.JR = JAxes[3] / 32767.0;
+      FrameBase += DeltaTime;
+      FrameCounter++;
+      return TRUE;
+    } /* End of 'ReadFrame' function */
+
+    /* Load next frame input and respond to it function (PLAY mode).
+     * ARGUMENTS:
+     *   - frame interval to fill:
+     *       DBL &DeltaTime;
+     *   - live events queue (dropped, played input must not depend on it):
+     *       event_queue &Live;
+     *   - input to respond:
+     *       input &In;
+     * RETURNS:
+     *   (BOOL) TRUE if frame is played, FALSE at the end of log (input reads live queue again).
+     */
+    BOOL PlayFrame( DBL &DeltaTime, event_queue &Live, input &In )
+    {
+      Live.Clear();
+      if (!ReadFrame(DeltaTime, Played, In))
+      {
+        In.SetQueue(Live);
+        return FALSE;
+      }
+      In.SetQueue(Played);
+      In.InputResponse();
+      return TRUE;
+    } /* End of 'PlayFrame' function */
+
+    /* Play whole log without window function (frames run back to back).
+     * ARGUMENTS:
+     *   - log file name:
+     *       const std::string &FileName;
+     *   - live events queue of input (input reads it again after log end):
+     *       event_queue &Live;
+     *   - input to respond:
+     *       input &In;
+     *   - simulation scheduler (reset before play):
+     *       stepper &Sim;
+     *   - fixed step update callback, called with played input and 'StepTime':
+     *       Func Update;
+     * RETURNS:
+     *   (BOOL) TRUE if log is opened and played.
+     */
+    template<typename Func>
+      BOOL PlayHeadless( const std::string &FileName, event_queue &Live, input &In, stepper &Sim, Func Update )
+      {
+        DBL Dt;
+
+        if (!StartPlay(FileName))
+          return FALSE;
+        /* Same frame order as 'anim::Render': input response, then simulation */
+        Sim.Reset();
+        while (PlayFrame(Dt, Live, In))
+          Sim.Advance(Dt, [&]( DBL StepDt ){ Update(In, StepDt); });
+        return TRUE;
+      } /* End of 'PlayHeadless' function */
+  }; /* end of 'replay' class */
+} /* end of 'nidx' spacename */
+#endif // !_replay_h_
+
+/* END OF 'replay.h' FILE */
@@ -0,0 +1,553 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : skin.h
+  * PURPOSE     : T51DX12 project.
+  *               CPU skinning declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Vertices have 4 or 8 influences, weights sum to 1.
+  *               Sparse morph target deltas are applied before skinning.
+  *               Linear skinning transforms normals by blended matrix and
+  *               renormalizes them (no non-uniform scale expected), dual
+  *               quaternion skinning ignores bone scale at all.
+  *               With AVX (/arch:AVX2) linear skinning blends matrices
+  *               in 8 lanes, dual quaternion skinning runs 8 vertices
+  *               per lane group (transposed bone loads).
+  *               Bone matrices are 'matr' (row vectors, P' = P * M).
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _skin_h_
+#define _skin_h_
+
+#include "../def.h"
+#include "jobs.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+/* MSVC defines '__AVX__'/'__AVX2__' only with /arch:AVX, /arch:AVX2 and
+ * never defines '__FMA__' (every AVX2 processor has FMA3) */
+#if defined(__AVX__) || defined(__AVX2__)
+#  include <immintrin.h>
+#  define NIDX_SKIN_AVX
+#  if defined(__FMA__) || defined(__AVX2__)
+#    define NIDX_SKIN_FMA
+#  endif /* __FMA__ */
+#endif /* __AVX__ */
+
+namespace nidx
+{
+  /* Sparse morph target structure */
+  struct morph_target
+  {
+    std::vector<UINT> Indices; /* Sorted indices of changed vertices */
+    std::vector<FLT>
+      DPos,                    /* Position deltas, 3 per index */
+      DNormal;                 /* Normal deltas, 3 per index */
+  }; /* End of 'morph_target' structure */
+
+  /* Skinned mesh structure */
+  struct skin_mesh
+  {
+    INT
+      NumOfVertices,             /* Number of vertices */
+      NumOfInfluences;           /* Influences per vertex: 4 or 8 */
+    std::vector<FLT>
+      Pos,                       /* Bind pose positions, 3 per vertex */
+      Normal,                    /* Bind pose normals, 3 per vertex */
+      Weights;                   /* Influence weights */
+    std::vector<USHORT> Bones;   /* Influence bones */
+    std::vector<morph_target> Morphs; /* Morph targets */
+  }; /* End of 'skin_mesh' structure */
+
+  /* Skinning methods */
+  enum struct skin_method
+  {
+    LINEAR,          /* Blended matrices */
+    DUAL_QUATERNION, /* Blended dual quaternions */
+  }; /* End of 'skin_method' enum */
+
+  /* CPU skinning class */
+  class skinner
+  {
+  private:
+    static const INT Chunk = 2048;
+
+    jobs &Pool;                             /* Worker threads */
+    std::vector<FLT>
+      Palette,                              /* Bone matrices, 16 per bone, last column zero */
+      DualQuats;                            /* Bone dual quaternions, 8 per bone: real XYZW, dual XYZW */
+    std::vector<std::vector<FLT>> Scratch;  /* Morphed vertices of every thread */
+
+    /* Store 3 floats of vector function.
+     * ARGUMENTS:
+     *   - destination:
+     *       FLT *D;
+     *   - source:
+     *       const FLT *S;
+     * RETURNS: None.
+     */
+    static VOID Store3( FLT *D, const FLT *S )
+    {
+      D[0] = S[0], D[1] = S[1], D[2] = S[2];
+    } /* End of 'Store3' function */
+
+    /* Linear skinning of vertices range function.
+     * ARGUMENTS:
+     *   - mesh:
+     *       const skin_mesh &M;
+     *   - source positions and normals of first vertex:
+     *       const FLT *P, *N;
+     *   - vertices range:
+     *       INT Begin, End;
+     *   - results:
+     *       FLT *OutP, *OutN;
+     * RETURNS: None.
+     */
+    template<INT NumOfInf>
+      VOID LinearRange( const skin_mesh &M, const FLT *P, const FLT *N, INT Begin, INT End, FLT *OutP, FLT *OutN ) const
+      {
+        const FLT *Pal = Palette.data();
+
+        for (INT v = Begin; v < End; v++, P += 3, N += 3)
+        {
+          const USHORT *b = &M.Bones[(size_t)v * NumOfInf];
+          const FLT *w = &M.Weights[(size_t)v * NumOfInf];
+          FLT r[4], n[4], Len;
+
+#ifdef NIDX_SKIN_AVX
+          __m256 h01 = _mm256_setzero_ps(), h23 = _mm256_setzero_ps();
+          __m128 p, q;
+
+          for (INT k = 0; k < NumOfInf; k++)
+          {
+            const FLT *m = Pal + (size_t)b[k] * 16;
+            __m256 wk = _mm256_set1_ps(w[k]);
+
+#  ifdef NIDX_SKIN_FMA
+            h01 = _mm256_fmadd_ps(wk, _mm256_loadu_ps(m), h01);
+            h23 = _mm256_fmadd_ps(wk, _mm256_loadu_ps(m + 8), h23);
+#  else /* NIDX_SKIN_FMA */
+            h01 = _mm256_add_ps(h01, _mm256_mul_ps(wk, _mm256_loadu_ps(m)));
+            h23 = _mm256_add_ps(h23, _mm256_mul_ps(wk, _mm256_loadu_ps(m + 8)));
+#  endif /* NIDX_SKIN_FMA */
+          }
+          /* Rows: P' = x * R0 + y * R1 + z * R2 + R3 */
+          q = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(N[0]), _mm256_castps256_ps128(h01)),
+                                    _mm_mul_ps(_mm_set1_ps(N[1]), _mm256_extractf128_ps(h01, 1))),
+                         _mm_mul_ps(_mm_set1_ps(N[2]), _mm256_castps256_ps128(h23)));
+          p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(P[0]), _mm256_castps256_ps128(h01)),
+                                    _mm_mul_ps(_mm_set1_ps(P[1]), _mm256_extractf128_ps(h01, 1))),
+                         _mm_add_ps(_mm_mul_ps(_mm_set1_ps(P[2]), _mm256_castps256_ps128(h23)), _mm256_extractf128_ps(h23, 1)));
+          _mm_storeu_ps(r, p);
+          _mm_storeu_ps(n, q);
+#else /* NIDX_SKIN_AVX */
+          FLT h[16] = {0};
+
+          for (INT k = 0; k < NumOfInf; k++)
+          {
+            const FLT *m = Pal + (size_t)b[k] * 16;
+
+            for (INT j = 0; j < 16; j++)
+              h[j] += w[k] * m[j];
+          }
+          for (INT j = 0; j < 3; j++)
+          {
+            r[j] = P[0] * h[j] + P[1] * h[4 + j] + P[2] * h[8 + j] + h[12 + j];
+            n[j] = N[0] * h[j] + N[1] * h[4 + j] + N[2] * h[8 + j];
+          }
+#endif /* NIDX_SKIN_AVX */
+          Len = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+          Len = Len > 0 ? 1 / (FLT)sqrt(Len) : 0;
+          n[0] *= Len, n[1] *= Len, n[2] *= Len;
+          Store3(OutP + (size_t)v * 3, r);
+          Store3(OutN + (size_t)v * 3, n);
+        }
+      } /* End of 'LinearRange' function */
+
+#ifdef NIDX_SKIN_AVX
+    /* Multiply and add function.
+     * ARGUMENTS:
+     *   - factors and addend:
+     *       __m256 A, B, C;
+     * RETURNS:
+     *   (__m256) A * B + C.
+     */
+    static __m256 MulAdd( __m256 A, __m256 B, __m256 C )
+    {
+#  ifdef NIDX_SKIN_FMA
+      return _mm256_fmadd_ps(A, B, C);
+#  else /* NIDX_SKIN_FMA */
+      return _mm256_add_ps(_mm256_mul_ps(A, B), C);
+#  endif /* NIDX_SKIN_FMA */
+    } /* End of 'MulAdd' function */
+
+    /* Transpose 8x8 floats in place function.
+     * ARGUMENTS:
+     *   - rows:
+     *       __m256 *R;
+     * RETURNS: None.
+     */
+    static VOID Transpose8( __m256 *R )
+    {
+      __m256 t[8], u[8];
+
+      for (INT i = 0; i < 8; i += 2)
+      {
+        t[i] = _mm256_unpacklo_ps(R[i], R[i + 1]);
+        t[i + 1] = _mm256_unpackhi_ps(R[i], R[i + 1]);
+      }
+      for (INT i = 0; i < 8; i += 4)
+      {
+        u[i] = _mm256_shuffle_ps(t[i], t[i + 2], 0x44);
+        u[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], 0xEE);
+        u[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+        u[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0xEE);
+      }
+      for (INT i = 0; i < 4; i++)
+      {
+        R[i] = _mm256_permute2f128_ps(u[i], u[i + 4], 0x20);
+        R[i + 4] = _mm256_permute2f128_ps(u[i], u[i + 4], 0x31);
+      }
+    } /* End of 'Transpose8' function */
+
+    /* Load 3 component vectors of 8 vertices as components function.
+     * ARGUMENTS:
+     *   - first vertex vector:
+     *       const FLT *S;
+     *   - components to fill:
+     *       __m256 *X;
+     * RETURNS: None.
+     */
+    static VOID Load3x8( const FLT *S, __m256 *X )
+    {
+      for (INT c = 0; c < 3; c++)
+        X[c] = _mm256_setr_ps(S[c], S[3 + c], S[6 + c], S[9 + c], S[12 + c], S[15 + c], S[18 + c], S[21 + c]);
+    } /* End of 'Load3x8' function */
+
+    /* Store components of 8 vertices as 3 component vectors function.
+     * ARGUMENTS:
+     *   - first vertex vector:
+     *       FLT *D;
+     *   - components:
+     *       const __m256 *X;
+     * RETURNS: None.
+     */
+    static VOID Store3x8( FLT *D, const __m256 *X )
+    {
+      FLT Tmp[3][8];
+
+      for (INT c = 0; c < 3; c++)
+        _mm256_storeu_ps(Tmp[c], X[c]);
+      for (INT i = 0; i < 8; i++)
+        D[i * 3] = Tmp[0][i], D[i * 3 + 1] = Tmp[1][i], D[i * 3 + 2] = Tmp[2][i];
+    } /* End of 'Store3x8' function */
+
+    /* Rotate 8 vectors by 8 unit quaternions function.
+     * ARGUMENTS:
+     *   - quaternions (X, Y, Z, W components):
+     *       const __m256 *Q;
+     *   - vectors to rotate (X, Y, Z components):
+     *       __m256 *X;
+     * RETURNS: None.
+     */
+    static VOID Rotate8( const __m256 *Q, __m256 *X )
+    {
+      __m256 Two = _mm256_set1_ps(2), c[3];
+
+      /* X + 2 * Vr x (Vr x X + Wr * X) */
+      c[0] = MulAdd(Q[3], X[0], _mm256_sub_ps(_mm256_mul_ps(Q[1], X[2]), _mm256_mul_ps(Q[2], X[1])));
+      c[1] = MulAdd(Q[3], X[1], _mm256_sub_ps(_mm256_mul_ps(Q[2], X[0]), _mm256_mul_ps(Q[0], X[2])));
+      c[2] = MulAdd(Q[3], X[2], _mm256_sub_ps(_mm256_mul_ps(Q[0], X[1]), _mm256_mul_ps(Q[1], X[0])));
+      X[0] = MulAdd(Two, _mm256_sub_ps(_mm256_mul_ps(Q[1], c[2]), _mm256_mul_ps(Q[2], c[1])), X[0]);
+      X[1] = MulAdd(Two, _mm256_sub_ps(_mm256_mul_ps(Q[2], c[0]), _mm256_mul_ps(Q[0], c[2])), X[1]);
+      X[2] = MulAdd(Two, _mm256_sub_ps(_mm256_mul_ps(Q[0], c[1]), _mm256_mul_ps(Q[1], c[0])), X[2]);
+    } /* End of 'Rotate8' function */
+
+    /* Dual quaternion skinning of 8 vertices function.
+     * ARGUMENTS:
+     *   - mesh:
+     *       const skin_mesh &M;
+     *   - source positions and normals of first vertex:
+     *       const FLT *P, *N;
+     *   - first vertex index:
+     *       INT v;
+     *   - results:
+     *       FLT *OutP, *OutN;
+     * RETURNS: None.
+     */
+    template<INT NumOfInf>
+      VOID DualQuatBlock( const skin_mesh &M, const FLT *P, const FLT *N, INT v, FLT *OutP, FLT *OutN ) const
+      {
+        const FLT *Dq = DualQuats.data(), *w = &M.Weights[(size_t)v * NumOfInf];
+        const USHORT *b = &M.Bones[(size_t)v * NumOfInf];
+        const __m256 Sign = _mm256_set1_ps(-0.0f), Zero = _mm256_setzero_ps();
+        __m256 q0[4], d[8], q[8], x[3], t[3], Len;
+
+        /* Lanes are vertices: one transposed load gives one influence of 8 vertices */
+        for (INT k = 0; k < NumOfInf; k++)
+        {
+          __m256 Dot, s;
+
+          for (INT i = 0; i < 8; i++)
+            d[i] = _mm256_loadu_ps(Dq + (size_t)b[i * NumOfInf + k] * 8);
+          Transpose8(d);
+          if (k == 0)
+            for (INT j = 0; j < 4; j++)
+              q0[j] = d[j];
+          /* Keep blended quaternions in the same hemisphere */
+          Dot = MulAdd(q0[3], d[3], MulAdd(q0[2], d[2], MulAdd(q0[1], d[1], _mm256_mul_ps(q0[0], d[0]))));
+          s = _mm256_setr_ps(w[k], w[NumOfInf + k], w[2 * NumOfInf + k], w[3 * NumOfInf + k],
+                             w[4 * NumOfInf + k], w[5 * NumOfInf + k], w[6 * NumOfInf + k], w[7 * NumOfInf + k]);
+          s = _mm256_xor_ps(s, _mm256_and_ps(_mm256_cmp_ps(Dot, Zero, _CMP_LT_OQ), Sign));
+          for (INT j = 0; j < 8; j++)
+            q[j] = k == 0 ? _mm256_mul_ps(s, d[j]) : MulAdd(s, d[j], q[j]);
+        }
+        Len = MulAdd(q[3], q[3], MulAdd(q[2], q[2], MulAdd(q[1], q[1], _mm256_mul_ps(q[0], q[0]))));
+        Len = _mm256_div_ps(_mm256_set1_ps(1), _mm256_sqrt_ps(Len));
+        for (INT j = 0; j < 8; j++)
+          q[j] = _mm256_mul_ps(q[j], Len);
+
+        /* Translation: 2 * (Wr * Vd - Wd * Vr + Vr x Vd) */
+        t[0] = _mm256_sub_ps(MulAdd(q[3], q[4], _mm256_mul_ps(q[1], q[6])), MulAdd(q[7], q[0], _mm256_mul_ps(q[2], q[5])));
+        t[1] = _mm256_sub_ps(MulAdd(q[3], q[5], _mm256_mul_ps(q[2], q[4])), MulAdd(q[7], q[1], _mm256_mul_ps(q[0], q[6])));
+        t[2] = _mm256_sub_ps(MulAdd(q[3], q[6], _mm256_mul_ps(q[0], q[5])), MulAdd(q[7], q[2], _mm256_mul_ps(q[1], q[4])));
+
+        Load3x8(P, x);
+        Rotate8(q, x);
+        for (INT c = 0; c < 3; c++)
+          x[c] = MulAdd(_mm256_set1_ps(2), t[c], x[c]);
+        Store3x8(OutP + (size_t)v * 3, x);
+        Load3x8(N, x);
+        Rotate8(q, x);
+        Store3x8(OutN + (size_t)v * 3, x);
+      } /* End of 'DualQuatBlock' function */
+#endif /* NIDX_SKIN_AVX */
+
+    /* Dual quaternion skinning of vertices range function.
+     * ARGUMENTS:
+     *   - mesh:
+     *       const skin_mesh &M;
+     *   - source positions and normals of first vertex:
+     *       const FLT *P, *N;
+     *   - vertices range:
+     *       INT Begin, End;
+     *   - results:
+     *       FLT *OutP, *OutN;
+     * RETURNS: None.
+     */
+    template<INT NumOfInf>
+      VOID DualQuatRange( const skin_mesh &M, const FLT *P, const FLT *N, INT Begin, INT End, FLT *OutP, FLT *OutN ) const
+      {
+        const FLT *Dq = DualQuats.data();
+        INT v = Begin;
+
+#ifdef NIDX_SKIN_AVX
+        for (; v + 8 <= End; v += 8, P += 24, N += 24)
+          DualQuatBlock<NumOfInf>(M, P, N, v, OutP, OutN);
+#endif /* NIDX_SKIN_AVX */
+        for (; v < End; v++, P += 3, N += 3)
+        {
+          const USHORT *b = &M.Bones[(size_t)v * NumOfInf];
+          const FLT *w = &M.Weights[(size_t)v * NumOfInf], *q0 = Dq + (size_t)b[0] * 8;
+          FLT q[8], Len, r[3], n[3], t[3], c[3];
+
+#ifdef NIDX_SKIN_AVX
+          __m256 Acc = _mm256_setzero_ps();
+
+          for (INT k = 0; k < NumOfInf; k++)
+          {
+            const FLT *d = Dq + (size_t)b[k] * 8;
+            /* Keep blended quaternions in the same hemisphere */
+            FLT s = q0[0] * d[0] + q0[1] * d[1] + q0[2] * d[2] + q0[3] * d[3] < 0 ? -w[k] : w[k];
+
+            Acc = _mm256_add_ps(Acc, _mm256_mul_ps(_mm256_set1_ps(s), _mm256_loadu_ps(d)));
+          }
+          _mm256_storeu_ps(q, Acc);
+#else /* NIDX_SKIN_AVX */
+          memset(q, 0, sizeof(q));
+          for (INT k = 0; k < NumOfInf; k++)
+          {
+            const FLT *d = Dq + (size_t)b[k] * 8;
+            FLT s = q0[0] * d[0] + q0[1] * d[1] + q0[2] * d[2] + q0[3] * d[3] < 0 ? -w[k] : w[k];
+
+            for (INT j = 0; j < 8; j++)
+              q[j] += s * d[j];
+          }
+#endif /* NIDX_SKIN_AVX */
+          Len = 1 / (FLT)sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+          for (INT j = 0; j < 8; j++)
+            q[j] *= Len;
+
+          /* Translation: 2 * (Wr * Vd - Wd * Vr + Vr x Vd) */
+          t[0] = 2 * (q[3] * q[4] - q[7] * q[0] + q[1] * q[6] - q[2] * q[5]);
+          t[1] = 2 * (q[3] * q[5] - q[7] * q[1] + q[2] * q[4] - q[0] * q[6]);
+          t[2] = 2 * (q[3] * q[6] - q[7] * q[2] + q[0] * q[5] - q[1] * q[4]);
+
+          /* Rotation: X + 2 * Vr x (Vr x X + Wr * X) */
+          c[0] = q[1] * P[2] - q[2] * P[1] + q[3] * P[0];
+          c[1] = q[2] * P[0] - q[0] * P[2] + q[3] * P[1];
+          c[2] = q[0] * P[1] - q[1] * P[0] + q[3] * P[2];
+          r[0] = P[0] + 2 * (q[1] * c[2] - q[2] * c[1]) + t[0];
+          r[1] = P[1] + 2 * (q[2] * c[0] - q[0] * c[2]) + t[1];
+          r[2] = P[2] + 2 * (q[0] * c[1] - q[1] * c[0]) + t[2];
+          c[0] = q[1] * N[2] - q[2] * N[1] + q[3] * N[0];
+          c[1] = q[2] * N[0] - q[0] * N[2] + q[3] * N[1];
+          c[2] = q[0] * N[1] - q[1] * N[0] + q[3] * N[2];
+          n[0] = N[0] + 2 * (q[1] * c[2] - q[2] * c[1]);
+          n[1] = N[1] + 2 * (q[2] * c[0] - q[0] * c[2]);
+          n[2] = N[2] + 2 * (q[0] * c[1] - q[1] * c[0]);
+          Store3(OutP + (size_t)v * 3, r);
+          Store3(OutN + (size_t)v * 3, n);
+        }
+      } /* End of 'DualQuatRange' function */
+
+  public:
+    /* Skinner initializing function.
+     * ARGUMENTS:
+     *   - worker threads:
+     *       jobs &NewPool;
+     */
+    skinner( jobs &NewPool = jobs::Get() ) : Pool(NewPool), Scratch(NewPool.GetNumOfThreads())
+    {
+    } /* End of 'skinner' function */
+
+    /* Set bone transformations function.
+     * ARGUMENTS:
+     *   - bone matrices (rigid for dual quaternion skinning):
+     *       const matr *Bones;
+     *       INT N;
+     * RETURNS: None.
+     */
+    VOID SetBones( const matr *Bones, INT N )
+    {
+      Palette.resize((size_t)N * 16);
+      DualQuats.resize((size_t)N * 8);
+      for (INT i = 0; i < N; i++)
+      {
+        const FLT *m = Bones[i];
+        FLT *p = &Palette[(size_t)i * 16], *d = &DualQuats[(size_t)i * 8], Tr, s;
+
+        memcpy(p, m, sizeof(FLT) * 16);
+        p[3] = p[7] = p[11] = p[15] = 0;
+
+        /* Rotation quaternion of column vector matrix Rc[j][k] = M[k][j] */
+#define NIDX_RC(J, K) m[(K) * 4 + (J)]
+        Tr = NIDX_RC(0, 0) + NIDX_RC(1, 1) + NIDX_RC(2, 2);
+        if (Tr > 0)
+        {
+          s = 0.5f / (FLT)sqrt(Tr + 1);
+          d[3] = 0.25f / s;
+          d[0] = (NIDX_RC(2, 1) - NIDX_RC(1, 2)) * s;
+          d[1] = (NIDX_RC(0, 2) - NIDX_RC(2, 0)) * s;
+          d[2] = (NIDX_RC(1, 0) - NIDX_RC(0, 1)) * s;
+        }
+        else if (NIDX_RC(0, 0) > NIDX_RC(1, 1) && NIDX_RC(0, 0) > NIDX_RC(2, 2))
+        {
+          s = 2 * (FLT)sqrt(1 + NIDX_RC(0, 0) - NIDX_RC(1, 1) - NIDX_RC(2, 2));
+          d[3] = (NIDX_RC(2, 1) - NIDX_RC(1, 2)) / s;
+          d[0] = 0.25f * s;
+          d[1] = (NIDX_RC(0, 1) + NIDX_RC(1, 0)) / s;
+          d[2] = (NIDX_RC(0, 2) + NIDX_RC(2, 0)) / s;
+        }
+        else if (NIDX_RC(1, 1) > NIDX_RC(2, 2))
+        {
+          s = 2 * (FLT)sqrt(1 + NIDX_RC(1, 1) - NIDX_RC(0, 0) - NIDX_RC(2, 2));
+          d[3] = (NIDX_RC(0, 2) - NIDX_RC(2, 0)) / s;
+          d[0] = (NIDX_RC(0, 1) + NIDX_RC(1, 0)) / s;
+          d[1] = 0.25f * s;
+          d[2] = (NIDX_RC(1, 2) + NIDX_RC(2, 1)) / s;
+        }
+        else
+        {
+          s = 2 * (FLT)sqrt(1 + NIDX_RC(2, 2) - NIDX_RC(0, 0) - NIDX_RC(1, 1));
+          d[3] = (NIDX_RC(1, 0) - NIDX_RC(0, 1)) / s;
+          d[0] = (NIDX_RC(0, 2) + NIDX_RC(2, 0)) / s;
+          d[1] = (NIDX_RC(1, 2) + NIDX_RC(2, 1)) / s;
+          d[2] = 0.25f * s;
+        }
+#undef NIDX_RC
+        /* Dual part: 0.5 * (T, 0) * Qr */
+        d[4] = 0.5f * (m[12] * d[3] + m[13] * d[2] - m[14] * d[1]);
+        d[5] = 0.5f * (-m[12] * d[2] + m[13] * d[3] + m[14] * d[0]);
+        d[6] = 0.5f * (m[12] * d[1] - m[13] * d[0] + m[14] * d[3]);
+        d[7] = -0.5f * (m[12] * d[0] + m[13] * d[1] + m[14] * d[2]);
+      }
+    } /* End of 'SetBones' function */
+
+    /* Skin mesh on worker threads function.
+     * ARGUMENTS:
+     *   - mesh:
+     *       const skin_mesh &M;
+     *   - skinning method:
+     *       skin_method Method;
+     *   - results, 3 floats per vertex:
+     *       FLT *OutPos, *OutNormal;
+     *   - morph target weights (nullptr - no morphing):
+     *       const FLT *MorphWeights;
+     * RETURNS: None.
+     */
+    VOID Skin( const skin_mesh &M, skin_method Method, FLT *OutPos, FLT *OutNormal, const FLT *MorphWeights = nullptr )
+    {
+      BOOL IsMorph = FALSE;
+
+      if (MorphWeights != nullptr)
+        for (size_t t = 0; t < M.Morphs.size(); t++)
+          IsMorph |= MorphWeights[t] != 0;
+
+      Pool.ParallelFor((M.NumOfVertices + Chunk - 1) / Chunk, [&]( INT c, INT Thread )
+        {
+          INT Begin = c * Chunk, End = std::min(M.NumOfVertices, Begin + Chunk);
+          const FLT *P = &M.Pos[(size_t)Begin * 3], *N = &M.Normal[(size_t)Begin * 3];
+
+          if (IsMorph)
+          {
+            std::vector<FLT> &S = Scratch[Thread];
+
+            S.resize(Chunk * 6);
+            memcpy(S.data(), P, sizeof(FLT) * 3 * (End - Begin));
+            memcpy(S.data() + Chunk * 3, N, sizeof(FLT) * 3 * (End - Begin));
+            for (size_t t = 0; t < M.Morphs.size(); t++)
+            {
+              const morph_target &Mt = M.Morphs[t];
+              FLT w = MorphWeights[t];
+
+              if (w == 0)
+                continue;
+              for (size_t i = std::lower_bound(Mt.Indices.begin(), Mt.Indices.end(), (UINT)Begin) - Mt.Indices.begin();
+                   i < Mt.Indices.size() && Mt.Indices[i] < (UINT)End; i++)
+              {
+                FLT *sp = &S[(Mt.Indices[i] - Begin) * 3], *sn = sp + Chunk * 3;
+
+                for (INT k = 0; k < 3; k++)
+                {
+                  sp[k] += w * Mt.DPos[i * 3 + k];
+                  sn[k] += w * Mt.DNormal[i * 3 + k];
+                }
+              }
+            }
+            P = S.data(), N = S.data() + Chunk * 3;
+          }
+          if (Method == skin_method::LINEAR && M.NumOfInfluences == 8)
+            LinearRange<8>(M, P, N, Begin, End, OutPos, OutNormal);
+          else if (Method == skin_method::LINEAR)
+            LinearRange<4>(M, P, N, Begin, End, OutPos, OutNormal);
+          else if (M.NumOfInfluences == 8)
+            DualQuatRange<8>(M, P, N, Begin, End, OutPos, OutNormal);
+          else
+            DualQuatRange<4>(M, P, N, Begin, End, OutPos, OutNormal);
+        });
+    } /* End of 'Skin' function */
+  }; /* end of 'skinner' class */
+} /* end of 'nidx' spacename */
+
+#endif // !_skin_h_
+
+/* END OF 'skin.h' FILE */
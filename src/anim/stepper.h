@@ -0,0 +1,195 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : stepper.h
+  * PURPOSE     : T51DX12 project.
+  *               Fixed timestep simulation scheduler declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Simulation always advances by 'StepTime' so its state
+  *               depends only on the number of steps, not on frame rate
+  *               (checked by 'stepper_determinism' benchmark).
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _stepper_h_
+#define _stepper_h_
+
+#include "../def.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace nidx
+{
+  /* Fixed timestep scheduler class */
+  class stepper
+  {
+  private:
+    DBL Accumulator;                  /* Not yet simulated real time */
+    std::thread Worker;               /* Simulation thread (threaded mode only) */
+    std::atomic<BOOL> IsThreadRun;    /* Simulation thread run flag */
+    mutable std::mutex Lock;          /* Simulation state lock (threaded mode only) */
+
+  public:
+    DBL
+      StepTime,      /* Fixed simulation interval in seconds */
+      MaxFrameTime,  /* Maximum real interval consumed by one 'Advance' call */
+      SimTime,       /* Simulated time (StepCounter * StepTime) */
+      Alpha,         /* Interpolation factor between two last states [0..1) */
+      LostTime;      /* Real time discarded by spiral-of-death clamping */
+    INT MaxSteps;    /* Maximum number of steps per one 'Advance' call */
+    UINT64 StepCounter; /* Number of performed steps */
+
+    /* Scheduler initializing function.
+     * ARGUMENTS:
+     *   - fixed simulation interval in seconds:
+     *       DBL Step;
+     *   - maximum number of steps per frame:
+     *       INT MaxStepsPerFrame;
+     */
+    stepper( DBL Step = 1.0 / 60, INT MaxStepsPerFrame = 8 ) :
+      Accumulator(0), IsThreadRun(FALSE), StepTime(Step), MaxFrameTime(0.25), SimTime(0),
+      Alpha(0), LostTime(0), MaxSteps(MaxStepsPerFrame), StepCounter(0)
+    {
+    } /* End of 'stepper' function */
+
+    /* Scheduler deinitializing function.
+     * ARGUMENTS: None.
+     */
+    ~stepper( VOID )
+    {
+      StopThread();
+    } /* End of '~stepper' function */
+
+    /* Reset simulation clock function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Reset( VOID )
+    {
+      std::lock_guard<std::mutex> Guard(Lock);
+
+      Accumulator = 0;
+      SimTime = 0;
+      Alpha = 0;
+      LostTime = 0;
+      StepCounter = 0;
+    } /* End of 'Reset' function */
+
+    /* Advance simulation by real interval function.
+     * ARGUMENTS:
+     *   - real interframe interval (0 while paused):
+     *       DBL DeltaTime;
+     *   - fixed step update callback, called with 'StepTime':
+     *       Func Update;
+     * RETURNS:
+     *   (INT) number of performed steps.
+     */
+    template<typename Func>
+      INT Advance( DBL DeltaTime, Func Update )
+      {
+        INT n = 0;
+        /* Frame intervals are sums of rounded values (1/144 s etc.): steps that
+         * are due up to rounding error are taken, so the number of steps
+         * depends only on total real time, not on how it was split in frames */
+        DBL Eps = StepTime * 1e-6;
+
+        if (DeltaTime < 0)
+          DeltaTime = 0;
+        /* Spiral of death: a long hitch must not require unbounded catch-up */
+        if (DeltaTime > MaxFrameTime)
+        {
+          LostTime += DeltaTime - MaxFrameTime;
+          DeltaTime = MaxFrameTime;
+        }
+        Accumulator += DeltaTime;
+        while (Accumulator >= StepTime - Eps && n < MaxSteps)
+        {
+          Update(StepTime);
+          StepCounter++;
+          SimTime = StepCounter * StepTime;
+          Accumulator -= StepTime;
+          n++;
+        }
+        /* Steps limit reached - keep only the fractional part */
+        if (Accumulator >= StepTime - Eps)
+        {
+          DBL Keep = fmod(Accumulator, StepTime);
+
+          LostTime += Accumulator - Keep;
+          Accumulator = Keep;
+        }
+        Alpha = std::max(Accumulator, 0.0) / StepTime;
+        return n;
+      } /* End of 'Advance' function */
+
+    /* Start simulation on own thread function.
+     * ARGUMENTS:
+     *   - fixed step update callback (called under scheduler lock):
+     *       const std::function<VOID( DBL )> &Update;
+     * RETURNS: None.
+     */
+    VOID StartThread( const std::function<VOID( DBL )> &Update )
+    {
+      if (IsThreadRun)
+        return;
+      IsThreadRun = TRUE;
+      Worker = std::thread([this, Update]( VOID )
+        {
+          auto Old = std::chrono::steady_clock::now();
+
+          while (IsThreadRun)
+          {
+            auto Now = std::chrono::steady_clock::now();
+            DBL Wait;
+
+            {
+              std::lock_guard<std::mutex> Guard(Lock);
+
+              Advance(std::chrono::duration<DBL>(Now - Old).count(), Update);
+              Wait = (1 - Alpha) * StepTime;
+            }
+            Old = Now;
+            std::this_thread::sleep_for(std::chrono::duration<DBL>(Wait));
+          }
+        });
+    } /* End of 'StartThread' function */
+
+    /* Stop simulation thread function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID StopThread( VOID )
+    {
+      IsThreadRun = FALSE;
+      if (Worker.joinable())
+        Worker.join();
+    } /* End of 'StopThread' function */
+
+    /* Read simulation state consistently function.
+     * ARGUMENTS:
+     *   - state reader callback, called with interpolation factor:
+     *       Func Read;
+     * RETURNS: None.
+     */
+    template<typename Func>
+      VOID Sync( Func Read ) const
+      {
+        std::lock_guard<std::mutex> Guard(Lock);
+
+        Read(Alpha);
+      } /* End of 'Sync' function */
+  }; /* end of 'stepper' class */
+} /* end of 'nidx' spacename */
+#endif // !_stepper_h_
+
+/* END OF 'stepper.h' FILE */
@@ -0,0 +1,58 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : bench.cpp
+  * PURPOSE     : T51DX12 project.
+  *               Frame time benchmark suite module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Allocations are counted in NIDX_COUNT_ALLOCS builds
+  *               (see 'allocs.cpp').
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#include "bench.h"
+
+/* Run suite, save and check results function.
+ * ARGUMENTS:
+ *   - output JSON file name:
+ *       const std::string &OutName;
+ *   - baseline JSON file name (empty - no check):
+ *       const std::string &BaseName;
+ *   - name filter (empty - run all):
+ *       const std::string &Filter;
+ * RETURNS:
+ *   (INT) process exit code (0 - no regressions and failed checks).
+ */
+INT nidx::bench::Main( const std::string &OutName, const std::string &BaseName, const std::string &Filter )
+{
+  std::vector<result> Res, Base;
+  std::string Report;
+  INT n;
+
+  RegisterSuite();
+  Res = Run(Filter);
+  if (!OutName.empty() && !Save(Res, OutName))
+    return 2;
+  if (!Failures.empty())
+  {
+    fprintf(stderr, "%d failed check(s):\n", (INT)Failures.size());
+    for (auto &f : Failures)
+      fprintf(stderr, "  %s\n", f.c_str());
+    return 4;
+  }
+  if (BaseName.empty())
+    return 0;
+  if ((Base = Load(BaseName)).empty())
+    return 3;
+  if ((n = Compare(Res, Base, Report)) == 0)
+    return 0;
+  fprintf(stderr, "%d benchmark regression(s):\n%s", n, Report.c_str());
+  return 1;
+} /* End of 'nidx::bench::Main' function */
+
+/* END OF 'bench.cpp' FILE */
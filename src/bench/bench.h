@@ -0,0 +1,377 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : bench.h
+  * PURPOSE     : T51DX12 project.
+  *               Frame time benchmark suite declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Platform independent. Workloads are registered in
+  *               'bench_suite.cpp' and use fixed seeds. Workloads also
+  *               verify their results with 'Check', standalone target
+  *               ('bench_main.cpp', 'CMakeLists.txt') runs as test.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _bench_h_
+#define _bench_h_
+
+#include "../def.h"
+#include "../anim/allocs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nidx
+{
+  /* Benchmark suite class */
+  class bench
+  {
+  public:
+    /* Fixed workload seed */
+    static const UINT Seed = 30;
+
+    /* Benchmark result structure */
+    struct result
+    {
+      std::string Name;       /* Benchmark name */
+      INT Samples;            /* Number of measured samples */
+      DBL
+        Median, P99,          /* Sample time percentiles in milliseconds */
+        Mean, StdDev;         /* Sample time mean and deviation in milliseconds */
+      DBL Allocs;             /* General heap allocations per sample */
+      std::vector<std::pair<std::string, DBL>> Metrics; /* Workload reported values (not checked) */
+    }; /* End of 'result' structure */
+
+  private:
+    /* Registered benchmark structure */
+    struct entry
+    {
+      std::string Name;                /* Benchmark name */
+      std::function<VOID( VOID )> Run; /* One sample workload */
+      INT Samples;                     /* Number of samples */
+    }; /* End of 'entry' structure */
+
+    std::vector<entry> Entries;        /* Registered benchmarks */
+    result *Current;                   /* Result of running benchmark */
+    std::vector<std::string> Failures; /* Failed workload checks */
+
+    /* Obtain number value of key in JSON line function.
+     * ARGUMENTS:
+     *   - line to search in:
+     *       const std::string &Line;
+     *   - key name:
+     *       const std::string &Key;
+     *   - value to fill:
+     *       DBL &Val;
+     * RETURNS:
+     *   (BOOL) TRUE if key is found.
+     */
+    static BOOL GetNumber( const std::string &Line, const std::string &Key, DBL &Val )
+    {
+      size_t p = Line.find("\"" + Key + "\":");
+
+      if (p == std::string::npos)
+        return FALSE;
+      Val = atof(Line.c_str() + p + Key.size() + 3);
+      return TRUE;
+    } /* End of 'GetNumber' function */
+
+    /* Obtain string value of key in JSON line function.
+     * ARGUMENTS:
+     *   - line to search in:
+     *       const std::string &Line;
+     *   - key name:
+     *       const std::string &Key;
+     *   - value to fill:
+     *       std::string &Val;
+     * RETURNS:
+     *   (BOOL) TRUE if key is found.
+     */
+    static BOOL GetString( const std::string &Line, const std::string &Key, std::string &Val )
+    {
+      size_t p = Line.find("\"" + Key + "\": \""), e;
+
+      if (p == std::string::npos)
+        return FALSE;
+      p += Key.size() + 5;
+      if ((e = Line.find('"', p)) == std::string::npos)
+        return FALSE;
+      Val = Line.substr(p, e - p);
+      return TRUE;
+    } /* End of 'GetString' function */
+
+  public:
+    DBL
+      Threshold,     /* Allowed relative median growth */
+      TailThreshold; /* Allowed relative 99th percentile growth */
+    INT
+      Warmups,       /* Number of unmeasured runs of every workload */
+      MaxSamples;    /* Samples limit of every workload (0 - registered number) */
+    std::string GoldenDir; /* Golden images directory (empty - images are not compared) */
+    BOOL IsGoldenUpdate;   /* Write golden images instead of comparing flag */
+
+    /* Suite initializing function.
+     * ARGUMENTS: None.
+     */
+    bench( VOID ) : Current(nullptr), Threshold(0.10), TailThreshold(0.25), Warmups(3), MaxSamples(0),
+      IsGoldenUpdate(FALSE)
+    {
+    } /* End of 'bench' function */
+
+    /* Register benchmark function.
+     * ARGUMENTS:
+     *   - benchmark name:
+     *       const std::string &Name;
+     *   - one sample workload:
+     *       const std::function<VOID( VOID )> &Run;
+     *   - number of samples:
+     *       INT Samples;
+     * RETURNS: None.
+     */
+    VOID Register( const std::string &Name, const std::function<VOID( VOID )> &Run, INT Samples = 50 )
+    {
+      Entries.push_back({Name, Run, Samples});
+    } /* End of 'Register' function */
+
+    /* Report workload value function (last reported value is saved).
+     * ARGUMENTS:
+     *   - value name:
+     *       const CHAR *Key;
+     *   - value:
+     *       DBL Val;
+     * RETURNS: None.
+     */
+    VOID Metric( const CHAR *Key, DBL Val )
+    {
+      if (Current == nullptr)
+        return;
+      for (auto &m : Current->Metrics)
+        if (m.first == Key)
+        {
+          m.second = Val;
+          return;
+        }
+      Current->Metrics.push_back({Key, Val});
+    } /* End of 'Metric' function */
+
+    /* Check workload result function (any failed check fails the run).
+     * ARGUMENTS:
+     *   - checked condition:
+     *       BOOL IsOk;
+     *   - check description:
+     *       const CHAR *What;
+     * RETURNS:
+     *   (BOOL) checked condition.
+     */
+    BOOL Check( BOOL IsOk, const CHAR *What )
+    {
+      if (!IsOk && std::find(Failures.begin(), Failures.end(), What) == Failures.end())
+        Failures.push_back(What);
+      return IsOk;
+    } /* End of 'Check' function */
+
+    /* Obtain failed checks function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const std::vector<std::string> &) failed checks descriptions.
+     */
+    const std::vector<std::string> & GetFailures( VOID ) const
+    {
+      return Failures;
+    } /* End of 'GetFailures' function */
+
+    /* Register all suite workloads function (see 'bench_suite.cpp').
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID RegisterSuite( VOID );
+
+    /* Run suite, save and check results function.
+     * ARGUMENTS:
+     *   - output JSON file name:
+     *       const std::string &OutName;
+     *   - baseline JSON file name (empty - no check):
+     *       const std::string &BaseName;
+     *   - name filter (empty - run all):
+     *       const std::string &Filter;
+     * RETURNS:
+     *   (INT) process exit code (0 - no regressions and failed checks).
+     */
+    INT Main( const std::string &OutName, const std::string &BaseName, const std::string &Filter = "" );
+
+    /* Run all benchmarks function.
+     * ARGUMENTS:
+     *   - name filter (empty - run all):
+     *       const std::string &Filter;
+     * RETURNS:
+     *   (std::vector<result>) results.
+     */
+    std::vector<result> Run( const std::string &Filter = "" )
+    {
+      std::vector<result> Res;
+      std::vector<DBL> Times;
+
+      for (auto &e : Entries)
+      {
+        result r;
+        UINT64 Allocs;
+        DBL Sum = 0, Sum2 = 0;
+        INT Samples = MaxSamples > 0 ? std::min(e.Samples, MaxSamples) : e.Samples;
+
+        if (!Filter.empty() && e.Name.find(Filter) == std::string::npos)
+          continue;
+        Times.resize(Samples);
+        Current = &r;
+        /* Warm up caches and lazy initialization */
+        for (INT i = 0; i < Warmups; i++)
+          e.Run();
+        Allocs = allocs::Get();
+        for (INT i = 0; i < Samples; i++)
+        {
+          auto Start = std::chrono::steady_clock::now();
+
+          e.Run();
+          Times[i] = std::chrono::duration<DBL, std::milli>(std::chrono::steady_clock::now() - Start).count();
+        }
+        Allocs = allocs::Get() - Allocs;
+        Current = nullptr;
+        for (DBL t : Times)
+          Sum += t, Sum2 += t * t;
+        std::sort(Times.begin(), Times.end());
+        r.Name = e.Name;
+        r.Samples = Samples;
+        r.Median = Times[Samples / 2];
+        r.P99 = Times[std::min(Samples - 1, (INT)ceil(Samples * 0.99) - 1)];
+        r.Mean = Sum / Samples;
+        r.StdDev = sqrt(std::max(0.0, Sum2 / Samples - r.Mean * r.Mean));
+        r.Allocs = (DBL)Allocs / Samples;
+        Res.push_back(r);
+      }
+      return Res;
+    } /* End of 'Run' function */
+
+    /* Save results to JSON file function.
+     * ARGUMENTS:
+     *   - results:
+     *       const std::vector<result> &Res;
+     *   - file name:
+     *       const std::string &FileName;
+     * RETURNS:
+     *   (BOOL) TRUE on success.
+     */
+    static BOOL Save( const std::vector<result> &Res, const std::string &FileName )
+    {
+      std::ofstream F(FileName);
+
+      if (!F.is_open())
+        return FALSE;
+      F << "{\n  \"seed\": " << Seed << ",\n  \"benchmarks\": [\n";
+      for (size_t i = 0; i < Res.size(); i++)
+      {
+        const result &r = Res[i];
+        CHAR Buf[512];
+
+        snprintf(Buf, sizeof(Buf),
+          "    {\"name\": \"%s\", \"samples\": %d, \"median_ms\": %.6f, \"p99_ms\": %.6f, "
+          "\"mean_ms\": %.6f, \"stddev_ms\": %.6f, \"allocs\": %.2f",
+          r.Name.c_str(), r.Samples, r.Median, r.P99, r.Mean, r.StdDev, r.Allocs);
+        F << Buf;
+        for (auto &m : r.Metrics)
+        {
+          snprintf(Buf, sizeof(Buf), ", \"%s\": %.6g", m.first.c_str(), m.second);
+          F << Buf;
+        }
+        F << (i + 1 < Res.size() ? "},\n" : "}\n");
+      }
+      F << "  ]\n}\n";
+      return TRUE;
+    } /* End of 'Save' function */
+
+    /* Load results from JSON file written by 'Save' function.
+     * ARGUMENTS:
+     *   - file name:
+     *       const std::string &FileName;
+     * RETURNS:
+     *   (std::vector<result>) results (empty on failure).
+     */
+    static std::vector<result> Load( const std::string &FileName )
+    {
+      std::ifstream F(FileName);
+      std::vector<result> Res;
+      std::string Line;
+
+      while (std::getline(F, Line))
+      {
+        result r;
+        DBL Samples = 0;
+
+        if (!GetString(Line, "name", r.Name))
+          continue;
+        GetNumber(Line, "samples", Samples);
+        r.Samples = (INT)Samples;
+        if (GetNumber(Line, "median_ms", r.Median) && GetNumber(Line, "p99_ms", r.P99) &&
+            GetNumber(Line, "mean_ms", r.Mean) && GetNumber(Line, "stddev_ms", r.StdDev) &&
+            GetNumber(Line, "allocs", r.Allocs))
+          Res.push_back(r);
+      }
+      return Res;
+    } /* End of 'Load' function */
+
+    /* Compare results with baseline function.
+     * ARGUMENTS:
+     *   - current results:
+     *       const std::vector<result> &Res;
+     *   - baseline results:
+     *       const std::vector<result> &Base;
+     *   - report text to fill:
+     *       std::string &Report;
+     * RETURNS:
+     *   (INT) number of regressed metrics.
+     */
+    INT Compare( const std::vector<result> &Res, const std::vector<result> &Base, std::string &Report ) const
+    {
+      std::ostringstream Out;
+      INT n = 0;
+
+      for (auto &r : Res)
+        for (auto &b : Base)
+          if (r.Name == b.Name)
+          {
+            if (r.Median > b.Median * (1 + Threshold))
+            {
+              Out << r.Name << ": median " << b.Median << " -> " << r.Median << " ms\n";
+              n++;
+            }
+            if (r.P99 > b.P99 * (1 + TailThreshold))
+            {
+              Out << r.Name << ": p99 " << b.P99 << " -> " << r.P99 << " ms\n";
+              n++;
+            }
+            if (r.Allocs > b.Allocs + 0.5)
+            {
+              Out << r.Name << ": allocs " << b.Allocs << " -> " << r.Allocs << "\n";
+              n++;
+            }
+            break;
+          }
+      Report = Out.str();
+      return n;
+    } /* End of 'Compare' function */
+  }; /* end of 'bench' class */
+} /* end of 'nidx' spacename */
+#endif // !_bench_h_
+
+/* END OF 'bench.h' FILE */
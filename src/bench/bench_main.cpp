@@ -0,0 +1,62 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : bench_main.cpp
+  * PURPOSE     : T51DX12 project.
+  *               Benchmark suite startup module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Platform independent, no window and device are used.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#include "bench.h"
+
+#include <cstring>
+
+/* The main program function.
+ * ARGUMENTS:
+ *   - number of command line arguments:
+ *       INT argc;
+ *   - command line arguments:
+ *       CHAR *argv[];
+ * RETURNS:
+ *   (INT) Error level for operation system (0 for success).
+ */
+INT main( INT argc, CHAR *argv[] )
+{
+  std::string OutName, BaseName, Filter;
+  nidx::bench Bench;
+
+  /* Benchmark options (exit code 1 on regression, 4 on failed check):
+   *   [-out <results .json>] [-baseline <.json>] [-threshold <rel>] [-filter <name>]
+   *   [-quick] (single sample without warm up, checks only)
+   *   [-golden <images directory>] [-update-golden] (write images instead of comparing) */
+  for (INT i = 1; i < argc; i++)
+    if (strcmp(argv[i], "-out") == 0 && i + 1 < argc)
+      OutName = argv[++i];
+    else if (strcmp(argv[i], "-baseline") == 0 && i + 1 < argc)
+      BaseName = argv[++i];
+    else if (strcmp(argv[i], "-threshold") == 0 && i + 1 < argc)
+      Bench.Threshold = atof(argv[++i]);
+    else if (strcmp(argv[i], "-filter") == 0 && i + 1 < argc)
+      Filter = argv[++i];
+    else if (strcmp(argv[i], "-quick") == 0)
+      Bench.Warmups = 0, Bench.MaxSamples = 1;
+    else if (strcmp(argv[i], "-golden") == 0 && i + 1 < argc)
+      Bench.GoldenDir = argv[++i];
+    else if (strcmp(argv[i], "-update-golden") == 0)
+      Bench.IsGoldenUpdate = TRUE;
+    else
+    {
+      fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+      return 5;
+    }
+  return Bench.Main(OutName, BaseName, Filter);
+} /* End of 'main' function */
+
+/* END OF 'bench_main.cpp' FILE */
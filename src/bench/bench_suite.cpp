@@ -0,0 +1,2035 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : bench_suite.cpp
+  * PURPOSE     : T51DX12 project.
+  *               Benchmark suite workloads module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Every workload builds its data once from 'bench::Seed'
+  *               and must not depend on the window or device.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#include "bench.h"
+#include "../anim/arena.h"
+#include "../anim/broadphase.h"
+#include "../anim/clip.h"
+#include "../anim/events.h"
+#include "../anim/jobs.h"
+#include "../anim/pacer.h"
+#include "../anim/replay.h"
+#include "../anim/skin.h"
+#include "../anim/stepper.h"
+#include "../anim/render/accel.h"
+#include "../anim/render/bvh.h"
+#include "../anim/render/lights.h"
+#include "../anim/render/lod.h"
+#include "../anim/render/meshlet.h"
+#include "../anim/render/meshopt.h"
+#include "../anim/render/occlusion.h"
+#include "../anim/render/packet.h"
+#include "../anim/render/particles.h"
+#include "../anim/render/pool.h"
+#include "../anim/render/shadow.h"
+#include "../anim/render/soft.h"
+#include "../anim/render/trace.h"
+#include "../anim/render/vertex.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+#include <memory>
+#include <random>
+
+/* Result sink to keep workloads from being optimized out */
+static volatile FLT BenchSink;
+
+/* Math library workloads registration function.
+ * ARGUMENTS:
+ *   - suite to register in:
+ *       nidx::bench &B;
+ * RETURNS: None.
+ */
+static VOID RegisterMath( nidx::bench &B )
+{
+  const INT N = 10000;
+  auto Mats = std::make_shared<std::vector<nidx::matr>>();
+  auto Pts = std::make_shared<std::vector<nidx::vec3>>();
+  std::mt19937 Rnd(nidx::bench::Seed);
+  std::uniform_real_distribution<FLT> Dist(-10, 10);
+
+  for (INT i = 0; i < N; i++)
+  {
+    Mats->push_back(nidx::matr::RotateX(Dist(Rnd) * 18) * nidx::matr::RotateY(Dist(Rnd) * 18) *
+                    nidx::matr::Translate(nidx::vec3(Dist(Rnd), Dist(Rnd), Dist(Rnd))));
+    Pts->push_back(nidx::vec3(Dist(Rnd), Dist(Rnd), Dist(Rnd)));
+  }
+
+  B.Register("mth_matr_mul", [Mats]( VOID )
+    {
+      nidx::matr R = nidx::matr::Identity();
+
+      for (auto &m : *Mats)
+        R = m * R;
+      BenchSink = R[0];
+    });
+  B.Register("mth_matr_inverse", [Mats]( VOID )
+    {
+      FLT s = 0;
+
+      for (auto &m : *Mats)
+        s += m.Inverse()[0];
+      BenchSink = s;
+    });
+  B.Register("mth_transform_point", [Mats, Pts]( VOID )
+    {
+      nidx::matr M = (*Mats)[0];
+      FLT s = 0;
+
+      for (auto &p : *Pts)
+        s += M.TransformPoint(p)[0];
+      BenchSink = s;
+    });
+  B.Register("mth_camera_build", [Pts]( VOID )
+    {
+      FLT s = 0;
+
+      for (size_t i = 1; i < Pts->size(); i++)
+      {
+        nidx::matr VP = nidx::matr::View((*Pts)[i], (*Pts)[i - 1], nidx::vec3(0, 1, 0)) *
+                        nidx::matr::Frustum(-1, 1, -1, 1, 1, 1000);
+
+        s += VP[5];
+      }
+      BenchSink = s;
+    });
+  /* Half conversions: every compiled path (scalar, SSE2 and F16C bulk) against software reference
+   * on all 65536 halves, rounding ties, float denormals, NaN payloads and random float bits */
+  B.Register("mth_half_exhaustive", [&B]( VOID )
+    {
+      std::mt19937 R(nidx::bench::Seed);
+      std::vector<nidx::half> H(65536), Out;
+      std::vector<FLT> RefF(65536), F(65536), In;
+      std::vector<USHORT> RefH;
+      INT ScalarMismatch = 0, SSE2Mismatch = 0, F16CMismatch = 0, RoundTripMismatch = 0, RoundingMismatch = 0;
+
+      auto CountF = [&]( const std::vector<FLT> &A )
+      {
+        INT n = 0;
+
+        for (INT i = 0; i < 65536; i++)
+          n += memcmp(&A[i], &RefF[i], 4) != 0;
+        return n;
+      };
+      auto CountH = [&]( const std::vector<nidx::half> &A )
+      {
+        INT n = 0;
+
+        for (size_t i = 0; i < In.size(); i++)
+          n += A[i].GetBits() != RefH[i];
+        return n;
+      };
+
+      /* Reference itself: round trip keeps bits (signaling NaN comes back quiet), ties round to even */
+      for (INT i = 0; i < 65536; i++)
+      {
+        USHORT Expect = (i & 0x7C00) == 0x7C00 && (i & 0x3FF) != 0 ? (USHORT)(i | 0x200) : (USHORT)i;
+
+        H[i] = nidx::half::FromBits((USHORT)i);
+        RefF[i] = nidx::half::ToFloatRef((USHORT)i);
+        RoundTripMismatch += nidx::half::FromFloatRef(RefF[i]) != Expect;
+        In.push_back(RefF[i]);
+      }
+      for (INT i = 0; i < 0x7BFF; i++)
+      {
+        DBL m = ((DBL)RefF[i] + RefF[i + 1]) / 2;
+        USHORT e = (USHORT)((i & 1) ? i + 1 : i);
+
+        RoundingMismatch += nidx::half::FromFloatRef((FLT)m) != e || nidx::half::FromFloatRef(-(FLT)m) != (e | 0x8000);
+        In.push_back((FLT)m), In.push_back(-(FLT)m);
+      }
+      /* Float denormals, overflow edge and random bits (NaN payloads included) */
+      for (UINT x : {0x00000001u, 0x007FFFFFu, 0x80400000u, 0x477FEFFFu, 0x477FF000u, 0x7F800001u, 0xFFC00001u, 0x7FBFE000u})
+      {
+        FLT f;
+
+        memcpy(&f, &x, 4);
+        In.push_back(f);
+      }
+      for (INT i = 0; i < 65536; i++)
+      {
+        UINT x = (UINT)R();
+        FLT f;
+
+        memcpy(&f, &x, 4);
+        In.push_back(f);
+      }
+      for (FLT f : In)
+        RefH.push_back(nidx::half::FromFloatRef(f));
+      Out.resize(In.size());
+
+      /* Scalar (F16C instructions if compiled with them) */
+      for (INT i = 0; i < 65536; i++)
+        F[i] = nidx::half::ToFloat((USHORT)i);
+      for (size_t i = 0; i < In.size(); i++)
+        Out[i] = nidx::half::FromBits(nidx::half::FromFloat(In[i]));
+      ScalarMismatch = CountF(F) + CountH(Out);
+#ifdef MTH_HALF_SSE2
+      mth::HalfToFloatSSE2(F.data(), H.data(), F.size());
+      mth::HalfFromFloatSSE2(Out.data(), In.data(), In.size());
+      SSE2Mismatch = CountF(F) + CountH(Out);
+#endif /* MTH_HALF_SSE2 */
+#ifdef MTH_HALF_F16C
+      mth::HalfToFloatF16C(F.data(), H.data(), F.size());
+      mth::HalfFromFloatF16C(Out.data(), In.data(), In.size());
+      F16CMismatch = CountF(F) + CountH(Out);
+#endif /* MTH_HALF_F16C */
+      B.Metric("scalar_mismatch", ScalarMismatch);
+      B.Metric("sse2_mismatch", SSE2Mismatch);
+      B.Metric("f16c_mismatch", F16CMismatch);
+      B.Metric("roundtrip_mismatch", RoundTripMismatch);
+      B.Metric("rounding_mismatch", RoundingMismatch);
+      B.Check(ScalarMismatch == 0, "scalar half conversions match software reference");
+      B.Check(SSE2Mismatch == 0, "SSE2 bulk half conversions match software reference");
+      B.Check(F16CMismatch == 0, "F16C bulk half conversions match software reference");
+      B.Check(RoundTripMismatch == 0, "half to float to half round trip keeps bits");
+      B.Check(RoundingMismatch == 0, "half rounding of midpoints is to even");
+      BenchSink = F[0x3C00];
+    }, 5);
+
+  auto HalfSrc = std::make_shared<std::vector<FLT>>(1 << 20);
+  auto HalfDst = std::make_shared<std::vector<nidx::half>>(1 << 20);
+
+  for (auto &f : *HalfSrc)
+    f = Dist(Rnd) * 100;
+  B.Register("mth_half_from_float_1m", [HalfSrc, HalfDst]( VOID )
+    {
+      mth::HalfFromFloat(HalfDst->data(), HalfSrc->data(), HalfSrc->size());
+      BenchSink = (*HalfDst)[12345];
+    });
+  B.Register("mth_half_to_float_1m", [HalfSrc, HalfDst]( VOID )
+    {
+      mth::HalfToFloat(HalfSrc->data(), HalfDst->data(), HalfDst->size());
+      BenchSink = (*HalfSrc)[12345];
+    });
+  B.Register("mth_half_scalar_1m", [HalfSrc, HalfDst]( VOID )
+    {
+      for (size_t i = 0; i < HalfSrc->size(); i++)
+        (*HalfDst)[i] = nidx::half((*HalfSrc)[i]);
+      BenchSink = (*HalfDst)[12345];
+    });
+  /* Rotation matrices and normalization: current scalar paths against fast kernels */
+  const INT NumOfRot = 100000;
+  auto Angles = std::make_shared<std::vector<FLT>>(NumOfRot);
+  auto Axes = std::make_shared<std::vector<nidx::vec3>>(NumOfRot);
+  auto Rots = std::make_shared<std::vector<nidx::matr>>(NumOfRot);
+
+  for (INT i = 0; i < NumOfRot; i++)
+  {
+    (*Angles)[i] = Dist(Rnd) * 36;
+    (*Axes)[i] = nidx::vec3(Dist(Rnd), Dist(Rnd), Dist(Rnd)).Normalizing();
+  }
+  B.Register("mth_rotate_x_100k", [Angles, Rots]( VOID )
+    {
+      for (INT i = 0; i < NumOfRot; i++)
+        (*Rots)[i] = nidx::matr::RotateX((*Angles)[i]);
+      BenchSink = (*Rots)[NumOfRot / 2][5];
+    });
+  B.Register("mth_rotate_x_100k_fast", [Angles, Rots]( VOID )
+    {
+      mth::FastRotateX(Rots->data(), Angles->data(), NumOfRot);
+      BenchSink = (*Rots)[NumOfRot / 2][5];
+    });
+  B.Register("mth_rotate_axis_100k", [Angles, Axes, Rots]( VOID )
+    {
+      for (INT i = 0; i < NumOfRot; i++)
+        (*Rots)[i] = nidx::matr::Rotate((*Angles)[i], (*Axes)[i]);
+      BenchSink = (*Rots)[NumOfRot / 2][5];
+    });
+  B.Register("mth_rotate_axis_100k_fast", [Angles, Axes, Rots]( VOID )
+    {
+      mth::FastRotate(Rots->data(), Angles->data(), Axes->data(), NumOfRot);
+      BenchSink = (*Rots)[NumOfRot / 2][5];
+    });
+  /* Normalizing in place keeps vectors unit, so every sample does same work */
+  auto Norms = std::make_shared<std::vector<nidx::vec3>>(*Axes);
+
+  B.Register("mth_normalize_100k", [Norms]( VOID )
+    {
+      for (auto &v : *Norms)
+        v.Normalize();
+      BenchSink = (*Norms)[NumOfRot / 2][0];
+    });
+  B.Register("mth_normalize_100k_fast", [Norms]( VOID )
+    {
+      mth::FastNormalize(Norms->data(), Norms->size());
+      BenchSink = (*Norms)[NumOfRot / 2][0];
+    });
+
+  /* Maximal errors in ULP of fast kernels against double precision */
+  B.Register("mth_fast_accuracy", [&B, Angles]( VOID )
+    {
+      auto Ulp = []( DBL Ref, FLT F )
+      {
+        FLT a = std::max((FLT)fabs(Ref), 1.17549435e-38f);
+
+        return fabs(F - Ref) / (nextafterf(a, 2 * a) - a);
+      };
+      std::vector<FLT> A(*Angles), S(A.size()), C(A.size());
+      DBL MaxRad = 0, MaxDeg = 0, MaxRsqrt = 0;
+
+      for (auto &a : A)
+        a = (FLT)D2R(a);
+      mth::FastSinCos(A.data(), S.data(), C.data(), A.size());
+      for (size_t i = 0; i < A.size(); i++)
+        MaxRad = std::max(MaxRad, std::max(Ulp(sin((DBL)A[i]), S[i]), Ulp(cos((DBL)A[i]), C[i])));
+      mth::FastSinCosDeg(Angles->data(), S.data(), C.data(), A.size());
+      for (size_t i = 0; i < A.size(); i++)
+      {
+        /* Reduce exactly in degrees before double evaluation */
+        DBL q = floor((*Angles)[i] / 90.0 + 0.5), r = D2R((*Angles)[i] - q * 90), s = sin(r), c = cos(r);
+        INT Q = (INT)q & 3;
+
+        MaxDeg = std::max(MaxDeg, Ulp(Q == 0 ? s : Q == 1 ? c : Q == 2 ? -s : -c, S[i]));
+        MaxDeg = std::max(MaxDeg, Ulp(Q == 0 ? c : Q == 1 ? -s : Q == 2 ? -c : s, C[i]));
+      }
+      for (size_t i = 0; i < A.size(); i++)
+      {
+        FLT x = (FLT)exp(A[i] * 10);
+
+        MaxRsqrt = std::max(MaxRsqrt, Ulp(1 / sqrt((DBL)x), mth::FastRsqrt(x)));
+      }
+      B.Metric("max_ulp_sincos", MaxRad);
+      B.Metric("max_ulp_sincos_deg", MaxDeg);
+      B.Metric("max_ulp_rsqrt", MaxRsqrt);
+      BenchSink = S[0];
+    }, 5);
+} /* End of 'RegisterMath' function */
+
+/* Engine core workloads registration function.
+ * ARGUMENTS:
+ *   - suite to register in:
+ *       nidx::bench &B;
+ * RETURNS: None.
+ */
+static VOID RegisterCore( nidx::bench &B )
+{
+  const INT N = 1000;
+  auto Pos = std::make_shared<std::vector<nidx::vec3>>(N);
+  auto Vel = std::make_shared<std::vector<nidx::vec3>>(N);
+  auto Queue = std::make_shared<nidx::event_queue>();
+  std::mt19937 Rnd(nidx::bench::Seed);
+  std::uniform_real_distribution<FLT> Dist(-1, 1);
+
+  for (INT i = 0; i < N; i++)
+    (*Vel)[i] = nidx::vec3(Dist(Rnd), Dist(Rnd), Dist(Rnd));
+
+  /* One second of fixed step scene update at uneven frame rate */
+  B.Register("scene_update_1k", [Pos, Vel]( VOID )
+    {
+      nidx::stepper S;
+
+      for (INT f = 0; f < 60; f++)
+        S.Advance(f % 3 == 0 ? 1.0 / 30 : 1.0 / 90, [&]( DBL Dt )
+          {
+            for (INT i = 0; i < N; i++)
+            {
+              (*Vel)[i] += nidx::vec3(0, -9.8f * (FLT)Dt, 0);
+              (*Pos)[i] += (*Vel)[i] * (FLT)Dt;
+            }
+          });
+      BenchSink = (*Pos)[0][1];
+    });
+
+  /* Same real time at 30, 60, 144 Hz and jittered frames must give identical simulation */
+  B.Register("stepper_determinism", [&B]( VOID )
+    {
+      const DBL Total = 3;
+      const INT NumOfBodies = 64;
+      std::vector<nidx::vec3> Ref;
+      UINT64 RefSteps = 0;
+
+      for (INT Run = 0; Run < 6; Run++)
+      {
+        static const DBL Rates[] = {60, 30, 144};
+        std::vector<nidx::vec3> State(NumOfBodies * 2);
+        std::mt19937 Rnd(nidx::bench::Seed + Run);
+        std::uniform_real_distribution<DBL> Jitter(0.2, 1.8);
+        nidx::stepper S;
+        DBL Time = 0;
+
+        for (INT i = 0; i < NumOfBodies; i++)
+          State[i * 2 + 1] = nidx::vec3((FLT)i, 5, (FLT)-i) * 0.1f;
+        while (Time < Total)
+        {
+          /* Last frame lands exactly on total time */
+          DBL Dt = std::min(Total - Time, Run < 3 ? 1 / Rates[Run] : Jitter(Rnd) / 60);
+
+          Time = Total - Time - Dt < 1e-9 ? Total : Time + Dt;
+          S.Advance(Dt, [&]( DBL Step )
+            {
+              for (INT i = 0; i < NumOfBodies; i++)
+              {
+                State[i * 2 + 1] = State[i * 2 + 1] * 0.999f + nidx::vec3(0, -9.8f * (FLT)Step, 0);
+                State[i * 2] += State[i * 2 + 1] * (FLT)Step;
+              }
+            });
+        }
+        if (Run == 0)
+        {
+          Ref = State;
+          RefSteps = S.StepCounter;
+          B.Check(RefSteps == (UINT64)(Total * 60 + 0.5), "stepper_determinism: wrong number of steps");
+          continue;
+        }
+        B.Check(S.StepCounter == RefSteps, "stepper_determinism: step count depends on frame rate");
+        B.Check(memcmp(State.data(), Ref.data(), sizeof(nidx::vec3) * State.size()) == 0,
+          "stepper_determinism: state depends on frame rate");
+      }
+    }, 10);
+  /* Simulated 60 Hz display: input is sampled late, spikes are counted as misses */
+  B.Register("pacer_fake_clock", [&B]( VOID )
+    {
+      const DBL Work = 0.004, Spike = 0.025;
+      DBL Now = 0, MaxLatency = 0;
+      nidx::pacer P(60, [&]( VOID ){ return Now; }, [&]( DBL Time ){ Now += Time; });
+
+      for (INT f = 0; f < 300; f++)
+      {
+        DBL Input;
+
+        P.Pace();
+        P.InputSampled();
+        Input = Now;
+        Now += f == 100 || f == 150 || f == 200 ? Spike : Work;
+        /* Present is queued, frame is shown at next vertical blank */
+        P.Presented();
+        /* Steady frames after the estimate settled (spikes and recovery skipped) */
+        if (f >= 30 && (f < 100 || f >= 270))
+          MaxLatency = std::max(MaxLatency, ceil(Now * 60 - 1e-6) / 60 - Input);
+      }
+      B.Check(MaxLatency < Work + P.Margin * 2, "pacer_fake_clock: input is not sampled late");
+      B.Check(P.MissCounter == 3, "pacer_fake_clock: misses are not counted once per spike");
+      B.Check(P.PresentCounter == 300, "pacer_fake_clock: wrong number of presented frames");
+      B.Metric("input_to_vblank_ms", MaxLatency * 1000);
+    }, 10);
+  /* Scripted input, recorded and played twice (second time with live events arriving):
+   * actions, clicks of keys released within a frame, identical played state */
+  B.Register("input_replay_script", [&B]( VOID )
+    {
+      const CHAR *LogName = "nidx_bench_input.log";
+      const INT NumOfFrames = 9;
+      /* Expected action state of every frame */
+      const CHAR
+        *Move = "011110100", *MoveClick = "010000100",
+        *Jump = "000000000", *JumpClick = "000100000";
+      nidx::event_queue Live;
+      nidx::event_script Script;
+      nidx::replay R;
+      std::vector<BYTE> Played[2];
+      DBL Dt;
+
+      Script.
+        Add(1, nidx::event_type::KEY_DOWN, 'W').Add(1, nidx::event_type::MOUSE_MOVE, 0, 10, 20).
+        Add(3, nidx::event_type::KEY_DOWN, ' ').Add(3, nidx::event_type::KEY_UP, ' ').
+        Add(5, nidx::event_type::KEY_UP, 'W').
+        Add(6, nidx::event_type::KEY_DOWN, 'W').Add(7, nidx::event_type::FOCUS_LOST);
+      for (INT Pass = 0; Pass < 3; Pass++)
+      {
+        nidx::input In(Live);
+        BOOL IsOk = TRUE;
+
+        In.Bind("move", 'W');
+        In.Bind("jump", ' ');
+        if (!B.Check(Pass == 0 ? R.StartRecord(LogName) : R.StartPlay(LogName),
+              "input_replay_script: log is not opened"))
+          break;
+        for (INT f = 0; f < NumOfFrames; f++)
+        {
+          if (Pass == 0)
+          {
+            Script.Feed(f, Live);
+            In.InputResponse();
+            R.WriteFrame(Script.FrameTime, In);
+          }
+          else
+          {
+            /* Live input during second play must be ignored */
+            if (Pass == 2)
+              Live.Push(nidx::event_type::KEY_DOWN, f % 2 ? 'W' : ' ', f, f);
+            IsOk &= R.PlayFrame(Dt, Live, In);
+            Played[Pass - 1].insert(Played[Pass - 1].end(), In.Keys, In.Keys + 256);
+            Played[Pass - 1].insert(Played[Pass - 1].end(), In.KeysClick, In.KeysClick + 256);
+            Played[Pass - 1].push_back((BYTE)In.FrameEvents.size());
+          }
+          IsOk &=
+            In.IsAction("move") == (Move[f] == '1') && In.IsActionClick("move") == (MoveClick[f] == '1') &&
+            In.IsAction("jump") == (Jump[f] == '1') && In.IsActionClick("jump") == (JumpClick[f] == '1') &&
+            In.MouseX == (f >= 1 ? 10 : 0) && In.MouseY == (f >= 1 ? 20 : 0);
+        }
+        /* Log end switches input back to live events */
+        if (Pass > 0)
+          IsOk &= !R.PlayFrame(Dt, Live, In);
+        R.Stop();
+        B.Check(IsOk, Pass == 0 ? "input_replay_script: live input state is wrong" :
+          "input_replay_script: played input state differs from live");
+      }
+      B.Check(Played[0] == Played[1], "input_replay_script: two plays of one log differ");
+      remove(LogName);
+    }, 10);
+  /* Headless replay: simulation driven by played log ends in the recorded state */
+  B.Register("replay_headless_state", [&B]( VOID )
+    {
+      const CHAR *LogName = "nidx_bench_headless.log";
+      const INT NumOfFrames = 240;
+      /* Simulation state, hash folds state after every step */
+      struct state
+      {
+        DBL X = 0, V = 0, Steer = 0;
+        INT Jumps = 0, Look = 0;
+        UINT64 Hash = 14695981039346656037ULL;
+
+        VOID Mix( const VOID *Data, size_t Size )
+        {
+          for (size_t i = 0; i < Size; i++)
+            Hash = (Hash ^ static_cast<const BYTE *>(Data)[i]) * 1099511628211ULL;
+        }
+
+        VOID Step( const nidx::input &In, DBL Dt )
+        {
+          V += (In.IsAction("move") ? 4 : -1) * Dt;
+          V = std::max(V, 0.0);
+          X += V * Dt;
+          Steer += In.JX * Dt;
+          Jumps += In.IsActionClick("jump");
+          Look = In.MouseX - In.MouseY;
+          Mix(&X, sizeof(X));
+          Mix(&V, sizeof(V));
+          Mix(&Steer, sizeof(Steer));
+          Mix(&Jumps, sizeof(Jumps));
+          Mix(&Look, sizeof(Look));
+        }
+      } Recorded, Played;
+      nidx::event_queue Live;
+      nidx::event_script Script;
+      nidx::replay R;
+      nidx::stepper Sim, PlaySim;
+      nidx::input In(Live), PlayIn(Live);
+
+      for (INT f = 0; f < NumOfFrames; f += 20)
+        Script.
+          Add(f + 1, nidx::event_type::KEY_DOWN, 'W').Add(f + 2, nidx::event_type::MOUSE_MOVE, 0, f, f / 3).
+          Add(f + 7, nidx::event_type::KEY_DOWN, ' ').Add(f + 8, nidx::event_type::KEY_UP, ' ').
+          Add(f + 13, nidx::event_type::KEY_UP, 'W');
+      In.Bind("move", 'W');
+      In.Bind("jump", ' ');
+      PlayIn.Bind("move", 'W');
+      PlayIn.Bind("jump", ' ');
+      if (!B.Check(R.StartRecord(LogName), "replay_headless_state: log is not opened"))
+        return;
+      for (INT f = 0; f < NumOfFrames; f++)
+      {
+        /* Uneven frames, several steps per frame or none */
+        DBL Dt = (f % 5 + 1) / 144.0;
+
+        Script.Feed(f, Live);
+        In.InputResponse();
+        /* Axis is exact in log quantization, live and played values are equal */
+        In.JX = (f % 7 - 3) * 1000 / 32767.0;
+        R.WriteFrame(Dt, In);
+        Sim.Advance(Dt, [&]( DBL StepDt ){ Recorded.Step(In, StepDt); });
+      }
+      R.Stop();
+
+      B.Check(R.PlayHeadless(LogName, Live, PlayIn, PlaySim,
+                [&]( const nidx::input &I, DBL StepDt ){ Played.Step(I, StepDt); }),
+        "replay_headless_state: log is not played");
+      B.Check(R.FrameCounter == (UINT64)NumOfFrames && PlaySim.StepCounter == Sim.StepCounter,
+        "replay_headless_state: played frame or step count differs");
+      B.Check(Played.Hash == Recorded.Hash, "replay_headless_state: played state hash differs from recorded");
+      B.Check(Recorded.Jumps > 0 && Recorded.X > 0, "replay_headless_state: script does not drive simulation");
+      remove(LogName);
+    }, 10);
+  /* Resource churn with fence-deferred release: nothing is released before its fence,
+   * handles of reused slots are stale */
+  B.Register("resource_pool_retire", [&B]( VOID )
+    {
+      const INT NumOfFrames = 1000, Latency = 2;
+      nidx::pool<INT, nidx::buffer_tag> Buffers;
+      nidx::descriptor_allocator Descs(8);
+      nidx::retire_queue Retired;
+      std::vector<UINT64> RetireFence(NumOfFrames, 0), ReleaseFence(NumOfFrames, 0);
+      nidx::buffer_handle Live[4];
+      nidx::descriptor_handle LiveDesc[4];
+      BOOL IsEarly = FALSE, IsLate = FALSE, IsStale = TRUE, IsDescOk = TRUE;
+      UINT64 Completed = 0;
+
+      for (INT f = 0; f < NumOfFrames; f++)
+      {
+        /* Frame f signals fence value f + 1, GPU lags 'Latency' frames behind */
+        UINT64 Fence = f + 1;
+        INT k = f % 4;
+
+        if (Live[k].IsValid())
+        {
+          nidx::buffer_handle Old = Live[k];
+          nidx::descriptor_handle OldDesc = LiveDesc[k];
+          INT Id = 0;
+
+          Buffers.Remove(Old, &Id);
+          RetireFence[Id] = Fence;
+          Retired.Retire(Fence, [&, Id, Fence]( VOID )
+            {
+              IsEarly |= Completed < Fence;
+              ReleaseFence[Id] = Completed;
+            });
+          Descs.Free(OldDesc, Fence, Retired);
+          Live[k] = Buffers.Add(f);
+          /* Slot is reused at once, old handle must not reach new item */
+          IsStale &= Live[k].Index == Old.Index && Buffers.Get(Old) == nullptr && !Buffers.Remove(Old);
+          IsStale &= Descs.Get(OldDesc) == nullptr && !Descs.Free(OldDesc, Fence, Retired);
+        }
+        else
+          Live[k] = Buffers.Add(f);
+        LiveDesc[k] = Descs.Alloc();
+        IsDescOk &= LiveDesc[k].IsValid();
+        /* 4 live descriptors and retired ones of last frames fit into 8 */
+        if (f >= Latency)
+          Retired.Collect(Completed = f + 1 - Latency);
+      }
+      /* Released at first collect reaching fence (all but last frames) */
+      for (INT i = 0; i < NumOfFrames; i++)
+        IsLate |= RetireFence[i] != 0 && RetireFence[i] <= Completed && ReleaseFence[i] != RetireFence[i];
+      Retired.Collect(Completed = NumOfFrames);
+      B.Check(!IsEarly, "resource_pool_retire: object released before its fence");
+      B.Check(IsStale, "resource_pool_retire: stale handle passes generation check");
+      B.Check(IsDescOk && Descs.GetNumOfFree() == 4, "resource_pool_retire: descriptor indices are lost");
+      B.Check(!IsLate && Retired.Size() == 0, "resource_pool_retire: object is not released when its fence completes");
+    }, 20);
+  B.Register("input_event_queue", [Queue]( VOID )
+    {
+      nidx::input_event E;
+      INT s = 0;
+
+      for (INT k = 0; k < 100; k++)
+      {
+        for (INT i = 0; i < 1000; i++)
+          Queue->Push(nidx::event_type::MOUSE_MOVE, 0, i, k);
+        while (Queue->Pop(E))
+          s += E.X;
+      }
+      BenchSink = (FLT)s;
+    });
+
+  /* Per-frame transient lists, must not touch general heap in steady state */
+  B.Register("frame_arena_lists", [Pos]( VOID )
+    {
+      nidx::arena &A = nidx::arena::Frame();
+      FLT s = 0;
+
+      for (INT f = 0; f < 10; f++)
+      {
+        nidx::frame_vector<INT> Visible;
+        nidx::frame_vector<nidx::vec3> Packets;
+
+        for (INT i = 0; i < N; i++)
+          if ((*Pos)[i][1] < 0 || (i & 1))
+          {
+            Visible.push_back(i);
+            Packets.push_back((*Pos)[i]);
+          }
+        for (auto &p : Packets)
+          s += p[0];
+        A.Reset();
+      }
+      BenchSink = s;
+    });
+
+  /* Over-aligned transient data: addresses are aligned, grown block absorbs padding */
+  B.Register("frame_arena_aligned", [&B]( VOID )
+    {
+      nidx::arena A(4096);
+      UINT64 Overflows = 0;
+      BOOL IsAligned = TRUE;
+
+      for (INT f = 0; f < 3; f++)
+      {
+        for (INT i = 0; i < 200; i++)
+        {
+          BYTE *P1 = A.Alloc<BYTE>(1 + i % 7);
+          VOID *P64 = A.Alloc(24, 64);
+
+          IsAligned &= ((size_t)P64 & 63) == 0;
+          P1[0] = 0;
+        }
+        if (f == 0)
+          Overflows = A.OverflowCounter;
+        A.Reset();
+      }
+      B.Check(IsAligned, "frame_arena_aligned: over-aligned allocation is misaligned");
+      B.Check(Overflows > 0 && A.OverflowCounter == Overflows,
+        "frame_arena_aligned: grown arena still overflows");
+    }, 20);
+
+  /* Allocations through every replaced form are counted (nothrow one is used by 'std::stable_sort') */
+  B.Register("allocs_counter", [&B]( VOID )
+    {
+      std::vector<INT> V(1000);
+      UINT64 Start = nidx::allocs::Get(), Plain, Nothrow;
+      INT *P = new INT(1), *Q = new (std::nothrow) INT[4];
+
+      Plain = nidx::allocs::Get() - Start;
+      delete P;
+      delete[] Q;
+      for (size_t i = 0; i < V.size(); i++)
+        V[i] = (INT)((i * 7919) % 1000);
+      Start = nidx::allocs::Get();
+      std::stable_sort(V.begin(), V.end());
+      Nothrow = nidx::allocs::Get() - Start;
+      B.Check(Plain == 2, "allocs_counter: plain and nothrow new are counted");
+      B.Check(Nothrow > 0, "allocs_counter: stable sort buffer is counted");
+      BenchSink = (FLT)V[500];
+    }, 5);
+
+  /* Nested parallel loops (from workers, from submitting thread, after other pool loop):
+   * no two threads run with same index at once, nested calls keep caller index */
+  B.Register("jobs_nested_index", [&B]( VOID )
+    {
+      nidx::jobs Pool(3), Other(1);
+      std::vector<std::atomic<INT>> Busy(Pool.GetNumOfThreads());
+      std::atomic<INT> Shared(0), Moved(0), Items(0);
+
+      for (auto &b : Busy)
+        b = 0;
+      Pool.ParallelFor(64, [&]( INT, INT Thread )
+        {
+          if (Busy[Thread]++ != 0)
+            Shared++;
+          Pool.ParallelFor(8, [&]( INT, INT Inner )
+            {
+              if (Inner != Thread)
+                Moved++;
+              Items++;
+            });
+          Other.ParallelFor(4, [&]( INT, INT )
+            {
+              Items++;
+            });
+          Pool.ParallelFor(2, [&]( INT, INT Inner )
+            {
+              if (Inner != Thread)
+                Moved++;
+              Items++;
+            });
+          Busy[Thread]--;
+        });
+      Pool.ParallelFor(1, [&]( INT, INT Thread )
+        {
+          Pool.ParallelFor(4, [&]( INT, INT Inner )
+            {
+              if (Inner != Thread)
+                Moved++;
+              Items++;
+            });
+        });
+      B.Check(Shared == 0, "jobs_nested_index: thread index is used by two threads at once");
+      B.Check(Moved == 0, "jobs_nested_index: nested loop changes thread index");
+      B.Check(Items == 64 * (8 + 4 + 2) + 4, "jobs_nested_index: nested loop items are lost");
+    }, 5);
+
+  /* Ten seconds of 60 bone character motion: swinging joints, moving root, constant scales */
+  auto ClipSrc = std::make_shared<nidx::clip_source>();
+  auto Clip = std::make_shared<std::unique_ptr<nidx::clip>>();
+
+  ClipSrc->SampleRate = 30;
+  ClipSrc->NumOfFrames = 301;
+  for (INT b = 0; b < 60; b++)
+  {
+    nidx::vec3 Axis = nidx::vec3(Dist(Rnd), Dist(Rnd), Dist(Rnd)).Normalizing();
+    FLT Amp = 0.2f + Dist(Rnd) * 0.2f, Freq = 1 + Dist(Rnd) * 0.5f, Phase = Dist(Rnd) * 3, Ofs = Dist(Rnd) * 0.3f;
+    nidx::clip_track_source R {nidx::clip_track_type::QUATERNION, 1e-3f, {}},
+      T {nidx::clip_track_type::VECTOR, 1e-3f, {}}, S {nidx::clip_track_type::VECTOR, 1e-4f, {}};
+
+    for (INT f = 0; f < ClipSrc->NumOfFrames; f++)
+    {
+      FLT t = f / ClipSrc->SampleRate, a = (Amp * (FLT)sin(Freq * t * 2 * PI + Phase) + Ofs) / 2;
+
+      R.Values.insert(R.Values.end(), {Axis[0] * (FLT)sin(a), Axis[1] * (FLT)sin(a), Axis[2] * (FLT)sin(a), (FLT)cos(a)});
+      T.Values.insert(T.Values.end(), {b == 0 ? t * 1.4f : 0, b == 0 ? 0.9f + 0.02f * (FLT)sin(t * 12) : 0.2f, 0});
+      S.Values.insert(S.Values.end(), {1, 1, 1});
+    }
+    ClipSrc->Tracks.push_back(R);
+    ClipSrc->Tracks.push_back(T);
+    ClipSrc->Tracks.push_back(S);
+  }
+  B.Register("clip_compress_60b", [&B, ClipSrc, Clip]( VOID )
+    {
+      Clip->reset(new nidx::clip(*ClipSrc));
+      nidx::clip_sampler Sm(**Clip, FALSE);
+      std::vector<FLT> Pose((*Clip)->NumOfValues);
+      size_t Raw = sizeof(nidx::clip_source);
+      DBL MaxErr = 0;
+
+      for (auto &t : ClipSrc->Tracks)
+        Raw += sizeof(t) + t.Values.size() * sizeof(FLT);
+      for (INT f = 0; f < ClipSrc->NumOfFrames; f++)
+      {
+        Sm.Sample(f / ClipSrc->SampleRate, Pose.data());
+        for (size_t i = 0; i < ClipSrc->Tracks.size(); i++)
+        {
+          const nidx::clip::track &T = (*Clip)->Tracks[i];
+          const FLT *Src = &ClipSrc->Tracks[i].Values[(size_t)f * T.Dim], *v = &Pose[T.Offset];
+          FLT Sign = 1;
+
+          /* Quaternions are compared up to sign */
+          if (T.Type == nidx::clip_track_type::QUATERNION && Src[0] * v[0] + Src[1] * v[1] + Src[2] * v[2] + Src[3] * v[3] < 0)
+            Sign = -1;
+          for (INT k = 0; k < T.Dim; k++)
+            MaxErr = std::max(MaxErr, (DBL)fabs(Sign * v[k] - Src[k]));
+        }
+      }
+      B.Metric("raw_bytes", (DBL)Raw);
+      B.Metric("clip_bytes", (DBL)(*Clip)->GetMemorySize());
+      B.Metric("ratio", (DBL)Raw / (*Clip)->GetMemorySize());
+      B.Metric("keys", (DBL)(*Clip)->Frames.size());
+      B.Metric("max_error", MaxErr);
+      BenchSink = Pose[0];
+    }, 10);
+
+  /* 1000 characters playing one clip forward with own phases, or seeking randomly */
+  auto ClipSamplers = std::make_shared<std::vector<nidx::clip_sampler>>();
+  auto ClipTimes = std::make_shared<std::vector<DBL>>(1000);
+  auto ClipPoses = std::make_shared<std::vector<FLT>>();
+  auto ClipFrame = std::make_shared<INT>(0);
+
+  for (INT IsSeek = 0; IsSeek < 2; IsSeek++)
+    B.Register(IsSeek ? "clip_sample_seek_1k" : "clip_sample_1k",
+      [&B, ClipSrc, Clip, ClipSamplers, ClipTimes, ClipPoses, ClipFrame, IsSeek]( VOID )
+      {
+        if (*Clip == nullptr)
+          Clip->reset(new nidx::clip(*ClipSrc));
+        if (ClipSamplers->empty())
+        {
+          ClipSamplers->assign(ClipTimes->size(), nidx::clip_sampler(**Clip));
+          ClipPoses->resize(ClipTimes->size() * (*Clip)->NumOfValues);
+        }
+        INT f = (*ClipFrame)++, N = (INT)ClipTimes->size();
+
+        for (INT i = 0; i < N; i++)
+          (*ClipTimes)[i] = IsSeek ? ((i * 7919 + f * 104729) % 9973) * 1e-3 : i * 0.37 + f / 60.0;
+
+        auto Start = std::chrono::steady_clock::now();
+
+        nidx::clip_sampler::SampleBatch(ClipSamplers->data(), ClipTimes->data(), N, ClipPoses->data(), (*Clip)->NumOfValues);
+        DBL Sec = std::chrono::duration<DBL>(std::chrono::steady_clock::now() - Start).count();
+
+        B.Metric("poses_per_s", N / Sec);
+        B.Metric("mtracks_per_s", N * (*Clip)->Tracks.size() / Sec * 1e-6);
+        BenchSink = (*ClipPoses)[f % ClipPoses->size()];
+      });
+
+  /* 50k bodies in 100 m cube: all bodies move, few bodies move (mostly static world) */
+  for (INT Kind = 0; Kind < 3; Kind++)
+  {
+    const INT NumOfBodies = 50000;
+    std::shared_ptr<nidx::broadphase> Bp;
+    auto Bodies = std::make_shared<std::vector<nidx::vec3>>(NumOfBodies * 3);
+    auto BpPairs = std::make_shared<std::vector<nidx::broadphase_pair>>();
+    INT Step = Kind == 1 ? 50 : 1;
+
+    if (Kind == 2)
+      Bp = std::make_shared<nidx::spatial_hash>(2.0f);
+    else
+      Bp = std::make_shared<nidx::sweep_prune>();
+    for (INT i = 0; i < NumOfBodies; i++)
+    {
+      /* Center, half size and velocity */
+      nidx::vec3 *b = &(*Bodies)[i * 3];
+
+      b[0] = nidx::vec3(Dist(Rnd), Dist(Rnd), Dist(Rnd)) * 50;
+      b[1] = nidx::vec3(0.25f + (Dist(Rnd) + 1) * 0.375f);
+      b[2] = nidx::vec3(Dist(Rnd), Dist(Rnd), Dist(Rnd)) * 5;
+      Bp->Add(b[0] - b[1], b[0] + b[1]);
+    }
+    B.Register(Kind == 2 ? "broadphase_hash_50k" : Kind == 1 ? "broadphase_sap_static_50k" : "broadphase_sap_50k",
+      [&B, Bp, Bodies, BpPairs, Step]( VOID )
+      {
+        for (INT i = 0; i < NumOfBodies; i += Step)
+        {
+          nidx::vec3 *b = &(*Bodies)[i * 3];
+
+          b[0] += b[2] * (1.0f / 60);
+          for (INT k = 0; k < 3; k++)
+            if (fabs(b[0][k]) > 50)
+              b[2][k] = -b[2][k];
+          Bp->Update(i, b[0] - b[1], b[0] + b[1]);
+        }
+
+        auto Start = std::chrono::steady_clock::now();
+
+        Bp->FindPairs(*BpPairs);
+        DBL Sec = std::chrono::duration<DBL>(std::chrono::steady_clock::now() - Start).count();
+
+        B.Metric("pairs", (DBL)BpPairs->size());
+        B.Metric("mpairs_per_s", BpPairs->size() / Sec * 1e-6);
+        BenchSink = (FLT)BpPairs->size();
+      }, 30);
+  }
+  /* Broadphases against brute force: few moved, many moved, removed boxes and box reaching FLT_MAX */
+  B.Register("broadphase_agree_2k", [&B]( VOID )
+    {
+      std::mt19937 R(nidx::bench::Seed);
+      std::uniform_real_distribution<FLT> D(-1, 1);
+      nidx::sweep_prune Sap;
+      nidx::spatial_hash Hash(2.0f);
+      std::vector<nidx::vec3> Min, Max;
+      std::vector<BYTE> IsAlive;
+      std::vector<nidx::broadphase_pair> P;
+      INT Bad = 0;
+
+      auto Sorted = []( std::vector<nidx::broadphase_pair> &Pairs )
+      {
+        std::vector<UINT64> K;
+
+        for (auto &p : Pairs)
+          K.push_back((UINT64)p.A << 32 | (UINT)p.B);
+        std::sort(K.begin(), K.end());
+        return K;
+      };
+      auto Set = [&]( INT Id, nidx::vec3 C, FLT Size )
+      {
+        Min[Id] = C - nidx::vec3(Size), Max[Id] = C + nidx::vec3(Size);
+        if (Id == 0)
+          Max[Id][0] = FLT_MAX;
+        Sap.Update(Id, Min[Id], Max[Id]);
+        Hash.Update(Id, Min[Id], Max[Id]);
+      };
+
+      for (INT i = 0; i < 2000; i++)
+      {
+        Min.push_back(nidx::vec3(0)), Max.push_back(nidx::vec3(0)), IsAlive.push_back(1);
+        Sap.Add(Min[i], Max[i]);
+        Hash.Add(Min[i], Max[i]);
+        Set(i, nidx::vec3(D(R), D(R), D(R)) * 30, 0.3f + (D(R) + 1) * 0.5f);
+      }
+      /* Overlapping pairs far outside of cell coordinates range */
+      for (INT i = 2000; i < 2004; i++)
+      {
+        Min.push_back(nidx::vec3(0)), Max.push_back(nidx::vec3(0)), IsAlive.push_back(1);
+        Sap.Add(Min[i], Max[i]);
+        Hash.Add(Min[i], Max[i]);
+        Set(i, i < 2002 ? nidx::vec3(1e30f, 0, 0) : nidx::vec3(-1e30f, 1e30f, 0), 0.5f);
+      }
+      for (INT f = 0; f < 12; f++)
+      {
+        std::vector<nidx::broadphase_pair> Ref;
+
+        /* Frames alternate few and all moved boxes, some boxes are removed */
+        for (INT i = 0; i < 2000; i += f % 3 == 2 ? 1 : 97)
+          if (IsAlive[i])
+            Set(i, (Min[i] + Max[i]) * 0.5f + nidx::vec3(D(R), D(R), D(R)), 0.3f + (D(R) + 1) * 0.5f);
+        if (f == 4)
+          for (INT i = 5; i < 2000; i += 301)
+            Sap.Remove(i), Hash.Remove(i), IsAlive[i] = 0;
+        for (INT i = 0; i < (INT)Min.size(); i++)
+          for (INT j = i + 1; j < (INT)Min.size(); j++)
+            if (IsAlive[i] && IsAlive[j] &&
+                Min[i][0] <= Max[j][0] && Min[j][0] <= Max[i][0] &&
+                Min[i][1] <= Max[j][1] && Min[j][1] <= Max[i][1] &&
+                Min[i][2] <= Max[j][2] && Min[j][2] <= Max[i][2])
+              Ref.push_back({i, j});
+        Sap.FindPairs(P);
+        Bad += Sorted(P) != Sorted(Ref);
+        Hash.FindPairs(P);
+        Bad += Sorted(P) != Sorted(Ref);
+      }
+      B.Metric("mismatch", Bad);
+      B.Check(Bad == 0, "broadphase pairs match brute force");
+    }, 3);
+} /* End of 'RegisterCore' function */
+
+/* Render workloads registration function.
+ * ARGUMENTS:
+ *   - suite to register in:
+ *       nidx::bench &B;
+ * RETURNS: None.
+ */
+static VOID RegisterRender( nidx::bench &B )
+{
+  const INT N = 128;
+  auto Raster = std::make_shared<nidx::soft_raster>(1280, 720);
+  auto Verts = std::make_shared<std::vector<nidx::soft_vertex>>();
+  auto Ind = std::make_shared<std::vector<INT>>();
+  std::mt19937 Rnd(nidx::bench::Seed);
+  std::uniform_real_distribution<FLT> Dist(0, 1);
+
+  /* Rough terrain of 2 * N * N triangles seen from above at an angle */
+  for (INT y = 0; y <= N; y++)
+    for (INT x = 0; x <= N; x++)
+      Verts->push_back({x * 40.0f / N - 20, Dist(Rnd), y * 40.0f / N - 20, {Dist(Rnd), Dist(Rnd), Dist(Rnd), 1}});
+  for (INT y = 0; y < N; y++)
+    for (INT x = 0; x < N; x++)
+    {
+      INT v = y * (N + 1) + x;
+
+      Ind->insert(Ind->end(), {v, v + N + 1, v + N + 2, v, v + N + 2, v + 1});
+    }
+  Raster->SetTransform(nidx::matr::View(nidx::vec3(0, 12, 24), nidx::vec3(0, 0, 0), nidx::vec3(0, 1, 0)) *
+                       nidx::matr::Frustum(-0.1f, 0.1f, -0.05625f, 0.05625f, 0.1f, 100));
+
+  B.Register("soft_raster_terrain_32k", [Raster, Verts, Ind]( VOID )
+    {
+      Raster->Clear(0xFF000000);
+      Raster->Draw(Verts->data(), (INT)Verts->size(), Ind->data(), (INT)Ind->size());
+      Raster->Flush();
+      BenchSink = (FLT)Raster->GetColor()[1280 * 360 + 640];
+    });
+  /* Same terrain with AVX and scalar block kernels: buffers are bit identical */
+  B.Register("soft_raster_avx_scalar", [&B, Raster, Verts, Ind]( VOID )
+    {
+      std::vector<UINT> Color[2];
+      std::vector<FLT> Depth[2];
+      INT Size = Raster->GetW() * Raster->GetH(), ColorBad = 0, DepthBad = 0;
+
+      if (!nidx::soft_raster::IsAVX2Supported())
+      {
+        B.Metric("avx_skipped", 1);
+        return;
+      }
+      for (INT k = 0; k < 2; k++)
+      {
+        Raster->IsAVX = k == 0;
+        Raster->Clear(0xFF000000);
+        Raster->Draw(Verts->data(), (INT)Verts->size(), Ind->data(), (INT)Ind->size());
+        Raster->Flush();
+        Color[k].assign(Raster->GetColor(), Raster->GetColor() + Size);
+        Depth[k].assign(Raster->GetDepth(), Raster->GetDepth() + Size);
+      }
+      Raster->IsAVX = TRUE;
+      for (INT i = 0; i < Size; i++)
+      {
+        ColorBad += Color[0][i] != Color[1][i];
+        DepthBad += memcmp(&Depth[0][i], &Depth[1][i], sizeof(FLT)) != 0;
+      }
+      B.Metric("color_mismatch", ColorBad);
+      B.Metric("depth_mismatch", DepthBad);
+      B.Check(ColorBad == 0 && DepthBad == 0, "soft_raster_avx_scalar: AVX and scalar kernels give different pixels");
+    }, 3);
+  /* Small golden scene: near plane clipped floor, intersecting triangles, back face, shared edge */
+  B.Register("soft_raster_golden", [&B]( VOID )
+    {
+      const std::string Name = "soft_raster_scene.tga";
+      nidx::soft_raster R(160, 120);
+      const nidx::soft_vertex V[] =
+      {
+        /* Floor from behind camera to far away */
+        {-20, 0, 20, {0.2f, 0.2f, 0.2f, 1}}, {20, 0, 20, {0.8f, 0.8f, 0.8f, 1}}, {20, 0, -40, {0.2f, 0.4f, 0.2f, 1}},
+        {-20, 0, 20, {0.2f, 0.2f, 0.2f, 1}}, {20, 0, -40, {0.2f, 0.4f, 0.2f, 1}}, {-20, 0, -40, {0.4f, 0.2f, 0.2f, 1}},
+        /* Intersecting pair */
+        {-3, 0, 0, {1, 0, 0, 1}}, {1, 0, -2, {1, 1, 0, 1}}, {-1, 3, -1, {1, 0, 1, 1}},
+        {-3, 0, -2, {0, 0, 1, 1}}, {1, 0, 0, {0, 1, 1, 1}}, {-1, 3, -1, {0, 1, 0, 1}},
+        /* Back face (culled) */
+        {2, 0.5f, 1, {1, 1, 1, 1}}, {2, 2.5f, 1, {1, 1, 1, 1}}, {4, 0.5f, 1, {1, 1, 1, 1}},
+        /* Quad of two triangles with shared diagonal */
+        {1.5f, 0.5f, 1, {1, 0.5f, 0, 1}}, {3.5f, 0.5f, 1, {1, 0.5f, 0, 1}}, {3.5f, 2.5f, 1, {0, 0.5f, 1, 1}},
+        {1.5f, 0.5f, 1, {1, 0.5f, 0, 1}}, {3.5f, 2.5f, 1, {0, 0.5f, 1, 1}}, {1.5f, 2.5f, 1, {0, 0.5f, 1, 1}},
+      };
+      INT Bad;
+
+      R.SetTransform(nidx::matr::View(nidx::vec3(0, 2, 8), nidx::vec3(0, 1, 0), nidx::vec3(0, 1, 0)) *
+                     nidx::matr::Frustum(-0.1f, 0.1f, -0.075f, 0.075f, 0.1f, 100));
+      R.Clear(0xFF102030);
+      R.Draw(V, sizeof(V) / sizeof(V[0]));
+      R.Flush();
+      if (B.GoldenDir.empty())
+        return;
+      if (B.IsGoldenUpdate)
+      {
+        B.Check(R.SaveTGA(B.GoldenDir + "/" + Name), "soft_raster_golden: golden image is not written");
+        return;
+      }
+      Bad = R.CompareTGA(B.GoldenDir + "/" + Name);
+      B.Metric("mismatch", Bad);
+      B.Check(Bad == 0, "soft_raster_golden: image differs from golden one (-1 - golden image is not read)");
+    }, 3);
+
+  /* Street level walk through a city of buildings and small props */
+  auto Occl = std::make_shared<nidx::occlusion>();
+  auto Boxes = std::make_shared<std::vector<nidx::occlusion::box>>();
+  auto Vis = std::make_shared<std::vector<BYTE>>();
+  const INT NumOfBlocks = 48, NumOfBuildings = NumOfBlocks * NumOfBlocks;
+
+  for (INT y = 0; y < NumOfBlocks; y++)
+    for (INT x = 0; x < NumOfBlocks; x++)
+    {
+      FLT cx = (x - NumOfBlocks / 2) * 10.0f, cz = (y - NumOfBlocks / 2) * 10.0f, s = 3 + Dist(Rnd);
+
+      Boxes->push_back({nidx::vec3(cx - s, 0, cz - s), nidx::vec3(cx + s, 5 + 35 * Dist(Rnd), cz + s)});
+    }
+  for (INT i = 0; i < NumOfBuildings * 4; i++)
+  {
+    nidx::occlusion::box &b = (*Boxes)[i / 4];
+    FLT px = b.Min[0] - 1 + (i & 1) * (b.Max[0] - b.Min[0] + 1), pz = b.Min[2] - 1 + Dist(Rnd) * (b.Max[2] - b.Min[2] + 1);
+
+    Boxes->push_back({nidx::vec3(px, 0, pz), nidx::vec3(px + 0.5f, 1 + Dist(Rnd), pz + 0.5f)});
+  }
+  Vis->resize(Boxes->size());
+
+  B.Register("occlusion_city_frame", [&B, Occl, Boxes, Vis, NumOfBuildings]( VOID )
+    {
+      UINT64 Tested = 0, Culled = 0, Occluded = 0;
+      INT Missed = 0;
+      static const INT BoxInd[36] =
+      {
+        0, 2, 3, 0, 3, 1,  4, 5, 7, 4, 7, 6,  0, 1, 5, 0, 5, 4,
+        2, 6, 7, 2, 7, 3,  0, 4, 6, 0, 6, 2,  1, 3, 7, 1, 7, 5,
+      };
+      static nidx::soft_raster Ref(256, 128);
+      static BOOL IsChecked = FALSE;
+
+      for (INT f = 0; f < 4; f++)
+      {
+        nidx::vec3 Loc(-5 + f * 40.0f, 2, -5), At = Loc + nidx::vec3(cos(f * 0.7f), -0.05f, sin(f * 0.7f));
+        nidx::matr VP = nidx::matr::View(Loc, At, nidx::vec3(0, 1, 0)) *
+                        nidx::matr::Frustum(-0.1f, 0.1f, -0.05f, 0.05f, 0.1f, 1000);
+
+        Occl->Begin(VP);
+        /* Nearby buildings are the occluders */
+        for (INT i = 0; i < NumOfBuildings; i++)
+        {
+          nidx::occlusion::box b = (*Boxes)[i];
+          FLT dx = (b.Min[0] + b.Max[0]) / 2 - Loc[0], dz = (b.Min[2] + b.Max[2]) / 2 - Loc[2];
+
+          if (dx * dx + dz * dz < 120 * 120)
+            Occl->AddOccluder(b);
+        }
+        Occl->Build();
+        Occl->Cull(Boxes->data(), (INT)Boxes->size(), Vis->data());
+        Tested += Occl->TestCounter;
+        Culled += Occl->OutsideCounter + Occl->OccludedCounter;
+        Occluded += Occl->OccludedCounter;
+        /* Reference once per run (first warm up sample): every box with own color
+         * at culling resolution, any box seen at some pixel must be kept */
+        if (!IsChecked && (f == 0 || f == 3))
+        {
+          Ref.SetTransform(VP);
+          Ref.Clear(0);
+          for (INT i = 0; i < (INT)Boxes->size(); i++)
+          {
+            nidx::vec3 Min = (*Boxes)[i].Min, Max = (*Boxes)[i].Max;
+            FLT Id[4] = {((i + 1) & 0xFF) / 255.0f, (((i + 1) >> 8) & 0xFF) / 255.0f, ((i + 1) >> 16) / 255.0f, 1};
+            nidx::soft_vertex V[8];
+
+            for (INT k = 0; k < 8; k++)
+              V[k] = {(k & 1) ? Max[0] : Min[0], (k & 2) ? Max[1] : Min[1], (k & 4) ? Max[2] : Min[2],
+                      {Id[0], Id[1], Id[2], Id[3]}};
+            Ref.Draw(V, 8, BoxInd, 36);
+          }
+          Ref.Flush();
+          for (INT p = 0; p < Ref.GetW() * Ref.GetH(); p++)
+          {
+            UINT c = Ref.GetColor()[p];
+            INT i = (INT)(((c >> 16) & 0xFF) | (c & 0xFF00) | ((c & 0xFF) << 16)) - 1;
+
+            Missed += i >= 0 && !(*Vis)[i];
+          }
+        }
+      }
+      B.Metric("culled_fraction", (DBL)Culled / Tested);
+      B.Metric("occluded_fraction", (DBL)Occluded / Tested);
+      if (!IsChecked)
+      {
+        IsChecked = TRUE;
+        B.Metric("missed_pixels", Missed);
+        B.Check(Missed == 0, "occlusion_city_frame: box seen in reference render is culled");
+      }
+      BenchSink = (FLT)(*Vis)[0];
+    });
+
+  /* Meshlets of a 64k triangles sphere */
+  auto SpherePos = std::make_shared<std::vector<FLT>>();
+  auto SphereInd = std::make_shared<std::vector<UINT>>();
+  auto Meshlets = std::make_shared<nidx::meshlet_mesh>();
+  auto MeshletVis = std::make_shared<std::vector<UINT>>();
+  const INT Slices = 256, Stacks = 128;
+
+  for (INT j = 0; j <= Stacks; j++)
+    for (INT i = 0; i <= Slices; i++)
+    {
+      DBL Theta = j * PI / Stacks, Phi = i * 2 * PI / Slices;
+
+      SpherePos->insert(SpherePos->end(), {(FLT)(sin(Theta) * cos(Phi)), (FLT)cos(Theta), (FLT)(-sin(Theta) * sin(Phi))});
+    }
+  for (INT j = 0; j < Stacks; j++)
+    for (INT i = 0; i < Slices; i++)
+    {
+      UINT v = j * (Slices + 1) + i;
+
+      SphereInd->insert(SphereInd->end(), {v, v + Slices + 1, v + Slices + 2, v, v + Slices + 2, v + 1});
+    }
+  Meshlets->Build(SpherePos->data(), (INT)SpherePos->size() / 3, sizeof(FLT) * 3, SphereInd->data(), (INT)SphereInd->size());
+
+  B.Register("meshlet_build_64k", [&B, SpherePos, SphereInd]( VOID )
+    {
+      nidx::meshlet_mesh M;
+      static BOOL IsChecked = FALSE;
+
+      M.Build(SpherePos->data(), (INT)SpherePos->size() / 3, sizeof(FLT) * 3, SphereInd->data(), (INT)SphereInd->size());
+      B.Metric("meshlets", (DBL)M.Meshlets.size());
+      B.Metric("verts_per_tri", (DBL)M.Vertices.size() / (SphereInd->size() / 3));
+      /* Once per run (first warm up sample): limits and every source triangle
+       * emitted once with same winding (rotated to smallest index first) */
+      if (!IsChecked)
+      {
+        typedef std::array<UINT, 3> tri;
+        auto Rotate = []( UINT A, UINT B, UINT C ) -> tri
+        {
+          return A <= B && A <= C ? tri {A, B, C} : B <= C ? tri {B, C, A} : tri {C, A, B};
+        };
+        std::vector<tri> Src, Out;
+        INT Bad = 0;
+
+        for (size_t i = 0; i + 2 < SphereInd->size(); i += 3)
+          Src.push_back(Rotate((*SphereInd)[i], (*SphereInd)[i + 1], (*SphereInd)[i + 2]));
+        for (auto &m : M.Meshlets)
+        {
+          if (m.VertexCount > (UINT)nidx::meshlet_mesh::MaxVertices || m.TriangleCount > (UINT)nidx::meshlet_mesh::MaxTriangles ||
+              m.VertexOffset + m.VertexCount > M.Vertices.size() || m.TriangleOffset + m.TriangleCount * 3 > M.Triangles.size())
+          {
+            Bad++;
+            continue;
+          }
+          for (UINT t = 0; t < m.TriangleCount; t++)
+          {
+            const BYTE *l = &M.Triangles[m.TriangleOffset + t * 3];
+
+            if (l[0] >= m.VertexCount || l[1] >= m.VertexCount || l[2] >= m.VertexCount)
+              Bad++;
+            else
+              Out.push_back(Rotate(M.Vertices[m.VertexOffset + l[0]], M.Vertices[m.VertexOffset + l[1]], M.Vertices[m.VertexOffset + l[2]]));
+          }
+        }
+        std::sort(Src.begin(), Src.end());
+        std::sort(Out.begin(), Out.end());
+        B.Check(Bad == 0, "meshlet_build: meshlet exceeds vertex or triangle limit");
+        B.Check(Src == Out, "meshlet_build: triangles are not emitted exactly once");
+        IsChecked = TRUE;
+      }
+      BenchSink = M.Bounds[0].Radius;
+    }, 20);
+  B.Register("meshlet_cull", [&B, Meshlets, MeshletVis]( VOID )
+    {
+      INT Visible = 0, Tested = 0;
+
+      /* Orbit around with the sphere partially out of view */
+      for (INT f = 0; f < 64; f++)
+      {
+        nidx::vec3 Loc(3 * (FLT)cos(f * 0.1), 0.5f, 3 * (FLT)sin(f * 0.1));
+        nidx::matr VP = nidx::matr::View(Loc, nidx::vec3(0.5f, 0, 0), nidx::vec3(0, 1, 0)) *
+                        nidx::matr::Frustum(-0.05f, 0.05f, -0.05f, 0.05f, 0.1f, 100);
+
+        Visible += Meshlets->Cull(nidx::meshlet_view::Build(VP, Loc), *MeshletVis);
+        Tested += (INT)Meshlets->Meshlets.size();
+      }
+      B.Metric("cull_rate", 1 - (DBL)Visible / Tested);
+      BenchSink = (FLT)Visible;
+    });
+
+  /* Levels of detail of the same sphere on a 100k instances field */
+  auto Chain = std::make_shared<nidx::lod_chain>();
+  auto Instances = std::make_shared<std::vector<nidx::lod_instance>>();
+  const INT Side = 316;
+
+  Chain->Build(SpherePos->data(), (INT)SpherePos->size() / 3, sizeof(FLT) * 3, SphereInd->data(), (INT)SphereInd->size(), 8);
+  for (INT y = 0; y < Side; y++)
+    for (INT x = 0; x < Side; x++)
+      Instances->push_back({Chain.get(), {x * 4.0f - Side * 2, 0, y * 4.0f - Side * 2}, 1, 0});
+
+  B.Register("lod_build_64k", [&B, SpherePos, SphereInd]( VOID )
+    {
+      nidx::lod_chain C;
+      INT Bad = 0;
+
+      C.Build(SpherePos->data(), (INT)SpherePos->size() / 3, sizeof(FLT) * 3, SphereInd->data(), (INT)SphereInd->size(), 8);
+      /* Coarser level has fewer triangles and not smaller error */
+      for (size_t l = 1; l < C.Levels.size(); l++)
+        Bad += !(C.Levels[l].Error >= C.Levels[l - 1].Error) || C.Levels[l].IndexCount >= C.Levels[l - 1].IndexCount;
+      B.Metric("levels", (DBL)C.Levels.size());
+      B.Check(C.Levels.size() > 1 && C.Levels[0].Error == 0, "lod_build: no coarser levels or original mesh error is not 0");
+      B.Check(Bad == 0, "lod_build: error or triangle count is not monotonic across levels");
+      BenchSink = C.Levels.back().Error;
+    }, 5);
+  B.Register("lod_select_100k", [&B, Chain, Instances]( VOID )
+    {
+      nidx::lod_selector S;
+      UINT64 Tris = 0;
+
+      /* Camera flies over the field, levels carry over between frames */
+      for (INT f = 0; f < 8; f++)
+      {
+        S.SetCamera(nidx::vec3(f * 20.0f - 80, 10, 0), nidx::matr::Frustum(-0.1f, 0.1f, -0.05625f, 0.05625f, 0.1f, 1000), 1080);
+        Tris += S.SelectAll(Instances->data(), (INT)Instances->size());
+      }
+      B.Metric("tris_per_frame", (DBL)Tris / 8);
+      B.Metric("tri_ratio", (DBL)Tris / 8 / ((DBL)Instances->size() * Chain->Levels[0].IndexCount / 3));
+      BenchSink = (FLT)Tris;
+    });
+
+  /* Import time buffers optimization of the sphere in random triangle order */
+  auto Shuffled = std::make_shared<std::vector<UINT>>();
+  std::vector<INT> Order(SphereInd->size() / 3);
+
+  for (size_t t = 0; t < Order.size(); t++)
+    Order[t] = (INT)t;
+  std::shuffle(Order.begin(), Order.end(), Rnd);
+  for (INT t : Order)
+    Shuffled->insert(Shuffled->end(), SphereInd->begin() + t * 3, SphereInd->begin() + t * 3 + 3);
+
+  B.Register("meshopt_sphere_64k", [&B, SpherePos, Shuffled]( VOID )
+    {
+      std::vector<UINT> Ind = *Shuffled;
+      std::vector<BYTE> Verts((const BYTE *)SpherePos->data(), (const BYTE *)(SpherePos->data() + SpherePos->size()));
+      nidx::mesh_optimizer::cache_stats
+        Before = nidx::mesh_optimizer::AnalyzeVertexCache(Ind.data(), (INT)Ind.size(), (INT)SpherePos->size() / 3), After;
+      static BOOL IsChecked = FALSE;
+
+      nidx::mesh_optimizer::Optimize(Ind, Verts, sizeof(FLT) * 3);
+      After = nidx::mesh_optimizer::AnalyzeVertexCache(Ind.data(), (INT)Ind.size(), (INT)Verts.size() / 12);
+      B.Metric("acmr_before", Before.ACMR);
+      B.Metric("acmr_after", After.ACMR);
+      B.Metric("atvr_before", Before.ATVR);
+      B.Metric("atvr_after", After.ATVR);
+      B.Metric("overfetch_after", nidx::mesh_optimizer::AnalyzeVertexFetch(Ind.data(), (INT)Ind.size(), (INT)Verts.size() / 12, 12).Overfetch);
+      B.Check(After.ACMR <= Before.ACMR, "meshopt: vertex cache miss ratio grows");
+      /* Once per run (first warm up sample): same triangles of same positions, vertices are reordered too */
+      if (!IsChecked)
+      {
+        typedef std::array<FLT, 3> pos;
+        typedef std::array<pos, 3> tri;
+        auto Triangles = []( const UINT *I, size_t N, const FLT *P ) -> std::vector<tri>
+        {
+          std::vector<tri> T;
+
+          for (size_t i = 0; i + 2 < N; i += 3)
+          {
+            tri t;
+
+            for (INT k = 0; k < 3; k++)
+              t[k] = {P[I[i + k] * 3], P[I[i + k] * 3 + 1], P[I[i + k] * 3 + 2]};
+            /* Same winding: rotate to smallest vertex first */
+            while (t[1] < t[0] || t[2] < t[0])
+              t = {t[1], t[2], t[0]};
+            T.push_back(t);
+          }
+          std::sort(T.begin(), T.end());
+          return T;
+        };
+
+        B.Check(Triangles(Shuffled->data(), Shuffled->size(), SpherePos->data()) ==
+                Triangles(Ind.data(), Ind.size(), (const FLT *)Verts.data()),
+          "meshopt: triangles differ from source ones");
+        IsChecked = TRUE;
+      }
+      BenchSink = After.ACMR;
+    }, 20);
+  /* Sphere vertices with tangent frame and UV, scaled off origin */
+  auto SphereVerts = std::make_shared<std::vector<nidx::vertex_src>>(SpherePos->size() / 3);
+
+  for (size_t i = 0; i < SphereVerts->size(); i++)
+  {
+    nidx::vertex_src &V = (*SphereVerts)[i];
+    const FLT *p = SpherePos->data() + i * 3;
+    FLT l = (FLT)sqrt(p[0] * p[0] + p[2] * p[2]);
+
+    for (INT k = 0; k < 3; k++)
+      V.P[k] = p[k] * 30 + 100, V.N[k] = p[k];
+    V.T[0] = l > 0 ? -p[2] / l : 1, V.T[1] = 0, V.T[2] = l > 0 ? p[0] / l : 0, V.T[3] = (i & 1) ? 1.0f : -1.0f;
+    V.UV[0] = Dist(Rnd) * 4, V.UV[1] = Dist(Rnd) * 4;
+  }
+
+  B.Register("vertex_quantize_64k", [&B, SphereVerts]( VOID )
+    {
+      const std::vector<nidx::vertex_src> &Src = *SphereVerts;
+      INT N = (INT)Src.size();
+      nidx::vertex_quant Q = nidx::vertex_quant::Compute(Src.data(), N);
+      std::vector<BYTE> Data((size_t)N * nidx::vertex_compact::Size);
+      std::vector<nidx::vertex_src> Dst(N);
+      DBL MaxPos = 0, MaxN = 0, MaxT = 0, MaxUV = 0;
+      /* Octahedral decode moves vector by at most 3 / sqrt(2) of half step (in radians) */
+      const DBL NormalBound = R2D(3 / sqrt(2.0) / 32767), TangentBound = R2D(3 / sqrt(2.0) / 127);
+      INT PosBad = 0, NormalBad = 0, TangentBad = 0, UVBad = 0;
+
+      nidx::vertex_compact::Encode(Data.data(), Src.data(), N, Q);
+      nidx::vertex_compact::Decode(Dst.data(), Data.data(), N, Q);
+      for (INT i = 0; i < N; i++)
+      {
+        DBL Angle[2];
+
+        for (INT k = 0; k < 3; k++)
+        {
+          FLT e = fabs(Dst[i].P[k] - Src[i].P[k]);
+
+          MaxPos = std::max(MaxPos, (DBL)e);
+          /* Half of snorm16 step of bounds plus float rounding */
+          PosBad += e > Q.Scale[k] * (0.5f / 32767) + fabs(Src[i].P[k]) * 4 * FLT_EPSILON;
+        }
+        /* Angle from cross and dot products, 'acos' of float dot is too coarse near 1 */
+        for (INT a = 0; a < 2; a++)
+        {
+          const FLT *u = a == 0 ? Src[i].N : Src[i].T, *v = a == 0 ? Dst[i].N : Dst[i].T;
+          DBL
+            cx = (DBL)u[1] * v[2] - (DBL)u[2] * v[1],
+            cy = (DBL)u[2] * v[0] - (DBL)u[0] * v[2],
+            cz = (DBL)u[0] * v[1] - (DBL)u[1] * v[0];
+
+          Angle[a] = R2D(atan2(sqrt(cx * cx + cy * cy + cz * cz), (DBL)u[0] * v[0] + (DBL)u[1] * v[1] + (DBL)u[2] * v[2]));
+        }
+        MaxN = std::max(MaxN, Angle[0]);
+        MaxT = std::max(MaxT, Angle[1]);
+        NormalBad += Angle[0] > NormalBound;
+        TangentBad += Angle[1] > TangentBound || Dst[i].T[3] != Src[i].T[3];
+        for (INT k = 0; k < 2; k++)
+        {
+          FLT e = fabs(Dst[i].UV[k] - Src[i].UV[k]);
+
+          MaxUV = std::max(MaxUV, (DBL)e);
+          /* Half of half float step (10 bit mantissa), denormal step below */
+          UVBad += e > std::max((FLT)fabs(Src[i].UV[k]) / 2048, 1.0f / (1 << 25));
+        }
+      }
+      B.Metric("size_ratio", (DBL)nidx::vertex_compact::Size / nidx::vertex_full::Size);
+      B.Metric("max_pos_error", MaxPos);
+      B.Metric("max_normal_deg", MaxN);
+      B.Metric("max_tangent_deg", MaxT);
+      B.Metric("max_uv_error", MaxUV);
+      B.Check(nidx::vertex_compact::Size < nidx::vertex_full::Size && nidx::vertex_compact::Size < sizeof(nidx::vertex_src),
+        "vertex_quantize: compact stride is not smaller than source one");
+      B.Check(PosBad == 0, "vertex_quantize: position error exceeds half snorm16 step");
+      B.Check(NormalBad == 0, "vertex_quantize: normal error exceeds octahedral snorm16 bound");
+      B.Check(TangentBad == 0, "vertex_quantize: tangent error exceeds octahedral snorm8 bound or sign is lost");
+      B.Check(UVBad == 0, "vertex_quantize: texture coordinate error exceeds half float rounding");
+      BenchSink = Dst[N / 2].P[0];
+    }, 20);
+  /* City lights (quarter spots) seen by street level camera */
+  auto Lights = std::make_shared<std::vector<nidx::light>>(10000);
+  auto Clusters = std::make_shared<nidx::light_clusters>();
+  auto Upload = std::make_shared<std::vector<BYTE>>();
+
+  for (auto &l : *Lights)
+  {
+    FLT a = Dist(Rnd) * 2 * (FLT)PI;
+
+    l = {{Dist(Rnd) * 400 - 200, Dist(Rnd) * 30, Dist(Rnd) * 400 - 200}, 2 + Dist(Rnd) * 6,
+         {(FLT)cos(a) * 0.6f, -0.8f, (FLT)sin(a) * 0.6f}, 0.8f, {1, 1, 1},
+         Dist(Rnd) < 0.25f ? nidx::light_type::SPOT : nidx::light_type::POINT};
+  }
+  Clusters->SetProjection(-0.1f, 0.1f, -0.05625f, 0.05625f, 0.1f, 500);
+  for (INT Count : {1000, 4000, 10000})
+    B.Register("lights_assign_" + std::to_string(Count / 1000) + "k", [&B, Lights, Clusters, Upload, Count]( VOID )
+      {
+        nidx::matr View = nidx::matr::View(nidx::vec3(0, 10, 120), nidx::vec3(0, 0, 0), nidx::vec3(0, 1, 0));
+        UINT Total = Clusters->Assign(View, Lights->data(), Count), Max = 0, NonEmpty = 0;
+        static BOOL IsChecked = FALSE;
+
+        Upload->resize(Clusters->GetUploadSize());
+        Clusters->Upload(Upload->data());
+        for (auto &c : Clusters->GetGrid())
+          Max = std::max(Max, c.Count), NonEmpty += c.Count != 0;
+        B.Metric("indices", Total);
+        B.Metric("max_per_cluster", Max);
+        B.Metric("avg_per_nonempty", NonEmpty != 0 ? (DBL)Total / NonEmpty : 0);
+        /* Once per run (1k lights, first warm up sample): every light against every cluster in double,
+         * lists must hold lights surely touching cluster frustum (spots: and passing cone test)
+         * and only lights touching cluster bound box (and cone test) within tolerance */
+        if (Count == 1000 && !IsChecked)
+        {
+          typedef nidx::light_clusters lc;
+          const DBL L = -0.1, R = 0.1, Bt = -0.05625, T = 0.05625, Near = 0.1, Far = 500, Tol = 1e-3;
+          const FLT *M = View;
+          const std::vector<lc::cell> &Grid = Clusters->GetGrid();
+          const std::vector<UINT> &Ind = Clusters->GetIndices();
+          std::vector<BYTE> InList(Count);
+          INT Missing = 0, Extra = 0, Unordered = 0;
+
+          for (INT k = 0; k < lc::SizeZ; k++)
+            for (INT y = 0; y < lc::SizeY; y++)
+              for (INT x = 0; x < lc::SizeX; x++)
+              {
+                const lc::cell &c = Grid[((size_t)k * lc::SizeY + y) * lc::SizeX + x];
+                DBL
+                  d0 = Near * pow(Far / Near, (DBL)k / lc::SizeZ), d1 = Near * pow(Far / Near, (DBL)(k + 1) / lc::SizeZ),
+                  tx0 = (L + (R - L) * x / lc::SizeX) / Near, tx1 = (L + (R - L) * (x + 1) / lc::SizeX) / Near,
+                  ty0 = (Bt + (T - Bt) * y / lc::SizeY) / Near, ty1 = (Bt + (T - Bt) * (y + 1) / lc::SizeY) / Near,
+                  Min[3] = {std::min(tx0 * d0, tx0 * d1), std::min(ty0 * d0, ty0 * d1), d0},
+                  Max[3] = {std::max(tx1 * d0, tx1 * d1), std::max(ty1 * d0, ty1 * d1), d1},
+                  Ctr[3] = {(Min[0] + Max[0]) / 2, (Min[1] + Max[1]) / 2, (d0 + d1) / 2},
+                  CR = sqrt((Max[0] - Ctr[0]) * (Max[0] - Ctr[0]) + (Max[1] - Ctr[1]) * (Max[1] - Ctr[1]) + (d1 - Ctr[2]) * (d1 - Ctr[2]));
+
+                std::fill(InList.begin(), InList.end(), 0);
+                for (UINT j = 0; j < c.Count; j++)
+                {
+                  UINT i = Ind[c.Offset + j];
+
+                  Unordered += i >= (UINT)Count || (j > 0 && i <= Ind[c.Offset + j - 1]);
+                  if (i < (UINT)Count)
+                    InList[i] = 1;
+                }
+                for (INT i = 0; i < Count; i++)
+                {
+                  const nidx::light &Lt = (*Lights)[i];
+                  const FLT *p = Lt.Pos, *d = Lt.Dir;
+                  DBL
+                    C[3] =
+                    {
+                      (DBL)p[0] * M[0] + (DBL)p[1] * M[4] + (DBL)p[2] * M[8] + M[12],
+                      (DBL)p[0] * M[1] + (DBL)p[1] * M[5] + (DBL)p[2] * M[9] + M[13],
+                      -((DBL)p[0] * M[2] + (DBL)p[1] * M[6] + (DBL)p[2] * M[10] + M[14])
+                    },
+                    Q[3], Dist, Lo;
+                  BOOL Must, May;
+
+                  /* Nearest point of cluster bound box, sphere surely touches cluster if it is in cluster frustum */
+                  for (INT a = 0; a < 3; a++)
+                    Q[a] = std::min(std::max(C[a], Min[a]), Max[a]);
+                  Dist = sqrt((Q[0] - C[0]) * (Q[0] - C[0]) + (Q[1] - C[1]) * (Q[1] - C[1]) + (Q[2] - C[2]) * (Q[2] - C[2]));
+                  Must = Dist < Lt.Radius - Tol &&
+                    Q[0] > tx0 * Q[2] && Q[0] < tx1 * Q[2] && Q[1] > ty0 * Q[2] && Q[1] < ty1 * Q[2];
+                  /* Or sphere holds a cluster frustum corner or center */
+                  for (INT v = 0; v < 9 && !Must; v++)
+                  {
+                    DBL
+                      pd = v == 8 ? (d0 + d1) / 2 : (v & 4) ? d1 : d0,
+                      px = (v == 8 ? (tx0 + tx1) / 2 : (v & 1) ? tx1 : tx0) * pd - C[0],
+                      py = (v == 8 ? (ty0 + ty1) / 2 : (v & 2) ? ty1 : ty0) * pd - C[1];
+
+                    Must = sqrt(px * px + py * py + (pd - C[2]) * (pd - C[2])) < Lt.Radius - Tol;
+                  }
+                  May = Dist <= Lt.Radius + Tol;
+                  if (Lt.Type == nidx::light_type::SPOT && May)
+                  {
+                    DBL
+                      Dir[3] =
+                      {
+                        (DBL)d[0] * M[0] + (DBL)d[1] * M[4] + (DBL)d[2] * M[8],
+                        (DBL)d[0] * M[1] + (DBL)d[1] * M[5] + (DBL)d[2] * M[9],
+                        -((DBL)d[0] * M[2] + (DBL)d[1] * M[6] + (DBL)d[2] * M[10])
+                      },
+                      v[3] = {Ctr[0] - C[0], Ctr[1] - C[1], Ctr[2] - C[2]},
+                      v1 = v[0] * Dir[0] + v[1] * Dir[1] + v[2] * Dir[2],
+                      Sin = sqrt(std::max(0.0, 1 - (DBL)Lt.CosAngle * Lt.CosAngle)),
+                      Cone = Lt.CosAngle * sqrt(std::max(v[0] * v[0] + v[1] * v[1] + v[2] * v[2] - v1 * v1, 0.0)) - v1 * Sin;
+
+                    Lo = std::min(std::min(CR - Cone, CR + Lt.Radius - v1), v1 + CR);
+                    Must = Must && Lo > Tol;
+                    May = Lo >= -Tol;
+                  }
+                  Missing += Must && !InList[i];
+                  Extra += !May && InList[i];
+                }
+              }
+          B.Metric("missing", Missing);
+          B.Metric("extra", Extra);
+          B.Check(Missing == 0 && Extra == 0 && Unordered == 0, "lights_assign: cluster lists differ from brute force assignment");
+          IsChecked = TRUE;
+        }
+        BenchSink = (FLT)Total;
+      });
+  /* Shadow casters over 1 x 1 km, camera drifts a bit every sample */
+  auto ShadowObjects = std::make_shared<std::vector<nidx::shadow_caster>>(500000);
+  auto Shadows = std::make_shared<nidx::shadow_cascades>(4, 2048);
+  auto ShadowFrame = std::make_shared<INT>(0);
+
+  for (auto &o : *ShadowObjects)
+    o = {{Dist(Rnd) * 1000 - 500, Dist(Rnd) * 40, Dist(Rnd) * 1000 - 500}, 0.5f + Dist(Rnd) * 4};
+  B.Register("shadow_cull_500k", [&B, ShadowObjects, Shadows, ShadowFrame]( VOID )
+    {
+      INT f = (*ShadowFrame)++;
+      nidx::vec3 Loc(f * 0.37f, 5, 20 + f * 0.11f);
+      nidx::matr View = nidx::matr::View(Loc, Loc + nidx::vec3(1, -0.2f, -1), nidx::vec3(0, 1, 0));
+      DBL MaxShift = 0;
+
+      Shadows->Setup(View, -0.1f, 0.1f, -0.05625f, 0.05625f, 0.1f, 400, nidx::vec3(-1, -2, -0.5f));
+      BenchSink = (FLT)Shadows->Cull(ShadowObjects->data(), (INT)ShadowObjects->size());
+      /* World origin must stay on texel grid of every cascade */
+      for (INT c = 0; c < Shadows->NumOfCascades; c++)
+      {
+        const FLT *M = Shadows->Cascades[c].VP;
+        DBL sx = M[12] * Shadows->MapSize / 2.0, sy = M[13] * Shadows->MapSize / 2.0;
+
+        MaxShift = std::max(MaxShift, std::max(fabs(sx - floor(sx + 0.5)), fabs(sy - floor(sy + 0.5))));
+        B.Metric(("casters_" + std::to_string(c)).c_str(), (DBL)Shadows->Casters[c].size());
+      }
+      B.Metric("origin_subtexel", MaxShift);
+
+      /* Cascade count is clamped to [1, MaxCascades] */
+      nidx::shadow_cascades One(0, 512), Many(100, 512);
+
+      One.Setup(View, -0.1f, 0.1f, -0.05625f, 0.05625f, 0.1f, 400, nidx::vec3(-1, -2, -0.5f));
+      B.Check(One.NumOfCascades == 1 && Many.NumOfCascades == nidx::shadow_cascades::MaxCascades &&
+        std::isfinite(One.Cascades[0].SplitFar) && std::isfinite(One.Cascades[0].Radius), "shadow cascade count is clamped");
+    }, 20);
+  /* Skinned crowd mesh: 100k vertices over 64 bones, 2 sparse morph targets */
+  auto SkinMeshes = std::make_shared<std::vector<nidx::skin_mesh>>(2);
+  auto Skinner = std::make_shared<nidx::skinner>();
+  auto SkinOut = std::make_shared<std::vector<FLT>>(100000 * 6);
+  auto SkinFrame = std::make_shared<INT>(0);
+
+  for (INT k = 0; k < 2; k++)
+  {
+    nidx::skin_mesh &M = (*SkinMeshes)[k];
+
+    M.NumOfVertices = 100000;
+    M.NumOfInfluences = 4 << k;
+    M.Pos.resize(M.NumOfVertices * 3);
+    M.Normal.resize(M.NumOfVertices * 3);
+    M.Weights.resize(M.NumOfVertices * M.NumOfInfluences);
+    M.Bones.resize(M.NumOfVertices * M.NumOfInfluences);
+    for (INT i = 0; i < M.NumOfVertices; i++)
+    {
+      nidx::vec3 N = nidx::vec3(Dist(Rnd) - 0.5f, Dist(Rnd) - 0.5f, Dist(Rnd) - 0.5f).Normalizing();
+      FLT Sum = 0;
+
+      for (INT c = 0; c < 3; c++)
+        M.Pos[i * 3 + c] = Dist(Rnd) * 2 - 1, M.Normal[i * 3 + c] = N[c];
+      for (INT j = 0; j < M.NumOfInfluences; j++)
+      {
+        M.Weights[i * M.NumOfInfluences + j] = Dist(Rnd);
+        M.Bones[i * M.NumOfInfluences + j] = (USHORT)(Dist(Rnd) * 63.99f);
+        Sum += M.Weights[i * M.NumOfInfluences + j];
+      }
+      for (INT j = 0; j < M.NumOfInfluences; j++)
+        M.Weights[i * M.NumOfInfluences + j] /= Sum;
+    }
+    for (INT t = 0; t < 2; t++)
+    {
+      nidx::morph_target Mt;
+
+      for (INT i = t; i < M.NumOfVertices; i += 7)
+      {
+        Mt.Indices.push_back(i);
+        for (INT c = 0; c < 3; c++)
+          Mt.DPos.push_back(Dist(Rnd) * 0.1f), Mt.DNormal.push_back(Dist(Rnd) * 0.1f);
+      }
+      M.Morphs.push_back(Mt);
+    }
+  }
+  for (INT Morph = 0; Morph < 2; Morph++)
+    for (INT k = 0; k < 2; k++)
+      for (INT Dq = 0; Dq < 2 - Morph; Dq++)
+        B.Register(std::string(Dq ? "skin_dqs" : "skin_lbs") + std::to_string(4 << k) + (Morph ? "_morph" : "") + "_100k",
+          [&B, SkinMeshes, Skinner, SkinOut, SkinFrame, k, Dq, Morph]( VOID )
+          {
+            const nidx::skin_mesh &M = (*SkinMeshes)[k];
+            nidx::matr Bones[64];
+            FLT MorphWeights[2] = {0.3f, 0.7f};
+            INT f = (*SkinFrame)++;
+
+            for (INT i = 0; i < 64; i++)
+              Bones[i] = nidx::matr::Rotate((FLT)(f * 3 + i * 5), nidx::vec3(1, (FLT)(i % 3), 0.5f).Normalizing()) *
+                nidx::matr::Translate(nidx::vec3(i * 0.1f, (FLT)sin(f * 0.1 + i), 0));
+            Skinner->SetBones(Bones, 64);
+
+            auto Start = std::chrono::steady_clock::now();
+
+            Skinner->Skin(M, Dq ? nidx::skin_method::DUAL_QUATERNION : nidx::skin_method::LINEAR,
+              SkinOut->data(), SkinOut->data() + M.NumOfVertices * 3, Morph ? MorphWeights : nullptr);
+            DBL Sec = std::chrono::duration<DBL>(std::chrono::steady_clock::now() - Start).count();
+
+            B.Metric("mverts_per_s", M.NumOfVertices / Sec * 1e-6);
+            BenchSink = (*SkinOut)[f % M.NumOfVertices];
+            if (Dq)
+            {
+              /* Single vertex mesh takes scalar path, whole mesh goes by 8 vertex blocks */
+              nidx::skin_mesh One;
+              INT v = (f * 7919) % M.NumOfVertices, n = M.NumOfInfluences;
+              FLT Out[6], MaxErr = 0;
+
+              One.NumOfVertices = 1;
+              One.NumOfInfluences = n;
+              One.Pos.assign(M.Pos.begin() + v * 3, M.Pos.begin() + v * 3 + 3);
+              One.Normal.assign(M.Normal.begin() + v * 3, M.Normal.begin() + v * 3 + 3);
+              One.Weights.assign(M.Weights.begin() + v * n, M.Weights.begin() + v * n + n);
+              One.Bones.assign(M.Bones.begin() + v * n, M.Bones.begin() + v * n + n);
+              Skinner->Skin(One, nidx::skin_method::DUAL_QUATERNION, Out, Out + 3);
+              for (INT c = 0; c < 3; c++)
+              {
+                MaxErr = std::max(MaxErr, fabsf(Out[c] - (*SkinOut)[v * 3 + c]));
+                MaxErr = std::max(MaxErr, fabsf(Out[3 + c] - (*SkinOut)[(M.NumOfVertices + v) * 3 + c]));
+              }
+              B.Check(MaxErr < 1e-4f, "wide dual quaternion skinning matches scalar");
+            }
+          }, 30);
+  /* Fountain emitter with 1M particles kept alive, respawn pool is cycled */
+  const INT NumOfParticles = 1000000;
+  auto Parts = std::make_shared<nidx::particles>(NumOfParticles);
+  auto PartPos = std::make_shared<std::vector<FLT>>((size_t)NumOfParticles * 3);
+  auto PartVel = std::make_shared<std::vector<FLT>>((size_t)NumOfParticles * 3);
+  auto PartLife = std::make_shared<std::vector<FLT>>(NumOfParticles);
+  auto PartFrame = std::make_shared<INT>(0), SortFrame = std::make_shared<INT>(0);
+
+  for (INT i = 0; i < NumOfParticles; i++)
+  {
+    FLT *P = &(*PartPos)[(size_t)i * 3], *V = &(*PartVel)[(size_t)i * 3], a = Dist(Rnd) * 2 * (FLT)PI, r = Dist(Rnd) * 0.5f;
+
+    P[0] = r * (FLT)cos(a), P[1] = 0, P[2] = r * (FLT)sin(a);
+    V[0] = (Dist(Rnd) - 0.5f) * 4, V[1] = 8 + Dist(Rnd) * 4, V[2] = (Dist(Rnd) - 0.5f) * 4;
+    (*PartLife)[i] = 1 + Dist(Rnd) * 2;
+  }
+  Parts->Drag = 0.1f;
+  Parts->Spawn(NumOfParticles, PartPos->data(), PartVel->data(), PartLife->data());
+  for (INT f = 0; f < 30; f++)
+    Parts->Update(1.0f / 30);
+  B.Register("particles_update_1m", [&B, Parts, PartPos, PartVel, PartLife, PartFrame]( VOID )
+    {
+      INT Spawned = 0, i = (*PartFrame)++ * 7919 % NumOfParticles;
+
+      while (Parts->GetCount() < NumOfParticles)
+      {
+        INT n = Parts->Spawn(std::min(NumOfParticles - Parts->GetCount(), NumOfParticles - i),
+          &(*PartPos)[(size_t)i * 3], &(*PartVel)[(size_t)i * 3], &(*PartLife)[i]);
+
+        Spawned += n;
+        i = (i + n) % NumOfParticles;
+      }
+      Parts->Update(1.0f / 60);
+      B.Metric("spawned", Spawned);
+      B.Metric("alive", Parts->GetCount());
+      BenchSink = Parts->GetAge(0);
+    }, 30);
+  B.Register("particles_sort_1m", [&B, Parts, SortFrame]( VOID )
+    {
+      INT f = (*SortFrame)++;
+      FLT a = f * 0.05f;
+      nidx::vec3 Eye(30 * (FLT)cos(a), 10, 30 * (FLT)sin(a)), Dir = (nidx::vec3(0, 8, 0) - Eye).Normalizing();
+      const UINT *Order;
+
+      Parts->Sort(Eye, Dir);
+      Order = Parts->GetOrder();
+      /* Check back to front order once per run (first warm up sample) */
+      if (f == 0)
+      {
+        FLT d[3] = {Dir[0], Dir[1], Dir[2]}, e[3] = {Eye[0], Eye[1], Eye[2]}, Prev = 1e30f, P[3];
+        INT Errors = 0;
+        std::vector<BYTE> Seen(Parts->GetCount(), 0);
+
+        for (INT i = 0; i < Parts->GetCount(); i++)
+        {
+          FLT z;
+
+          Parts->GetPos(Order[i], P);
+          z = (P[0] - e[0]) * d[0] + (P[1] - e[1]) * d[1] + (P[2] - e[2]) * d[2];
+          Errors += z > Prev + 1e-4f * (1 + fabs(z)) || Seen[Order[i]]++ != 0;
+          Prev = z;
+        }
+        B.Metric("order_errors", Errors);
+        B.Check(Errors == 0, "particles_sort: order is not back to front permutation");
+      }
+      BenchSink = (FLT)Order[0];
+    }, 30);
+  /* Terrain with 64k triangles sphere on it, rays through 256 x 144 pixels of 1280 x 720 screen */
+  auto BvhPos = std::make_shared<std::vector<FLT>>();
+  auto BvhInd = std::make_shared<std::vector<INT>>(*Ind);
+  auto Bvh = std::make_shared<nidx::bvh>();
+  auto BvhRays = std::make_shared<std::vector<nidx::bvh_ray>>();
+  auto BvhHits = std::make_shared<std::vector<nidx::bvh_hit>>(256 * 144);
+  nidx::matr BvhVP = nidx::matr::View(nidx::vec3(0, 12, 24), nidx::vec3(0, 0, 0), nidx::vec3(0, 1, 0)) *
+                     nidx::matr::Frustum(-0.1f, 0.1f, -0.05625f, 0.05625f, 0.1f, 100);
+
+  for (auto &v : *Verts)
+    BvhPos->insert(BvhPos->end(), {v.X, v.Y, v.Z});
+  for (size_t i = 0; i < SpherePos->size(); i++)
+    BvhPos->push_back((*SpherePos)[i] * 3 + (i % 3 == 1 ? 3 : 0));
+  for (UINT i : *SphereInd)
+    BvhInd->push_back((INT)(i + Verts->size()));
+  Bvh->Build(BvhPos->data(), BvhInd->data(), (INT)BvhInd->size() / 3);
+  for (INT y = 0; y < 144; y++)
+    for (INT x = 0; x < 256; x++)
+      BvhRays->push_back(nidx::bvh::Unproject(BvhVP, x * 5.0f, y * 5.0f, 1280, 720));
+  B.Register("bvh_build_97k", [&B, Bvh, BvhPos, BvhInd]( VOID )
+    {
+      Bvh->Build(BvhPos->data(), BvhInd->data(), (INT)BvhInd->size() / 3);
+      B.Metric("nodes", Bvh->GetNumOfNodes());
+      BenchSink = (FLT)Bvh->GetNumOfNodes();
+    }, 10);
+  for (INT Mode = 0; Mode < 3; Mode++)
+    B.Register(Mode == 0 ? "bvh_rays_packet_37k" : Mode == 1 ? "bvh_rays_single_37k" : "bvh_rays_random_37k",
+      [&B, Bvh, BvhRays, BvhHits, Mode]( VOID )
+      {
+        std::vector<nidx::bvh_ray> Random;
+        const std::vector<nidx::bvh_ray> *Rays = BvhRays.get();
+        INT N = (INT)BvhRays->size(), Hits = 0;
+
+        if (Mode == 2)
+        {
+          /* Incoherent: every ray through random pixel */
+          Random.resize(N);
+          for (INT i = 0; i < N; i++)
+            Random[i] = (*BvhRays)[(INT)((i * 2654435761u) % (UINT)N)];
+          Rays = &Random;
+        }
+
+        auto Start = std::chrono::steady_clock::now();
+
+        if (Mode == 1)
+          for (INT i = 0; i < N; i++)
+            Bvh->Intersect((*Rays)[i], (*BvhHits)[i]);
+        else
+          Bvh->Intersect(Rays->data(), N, BvhHits->data());
+        DBL Sec = std::chrono::duration<DBL>(std::chrono::steady_clock::now() - Start).count();
+
+        for (auto &h : *BvhHits)
+          Hits += h.Tri >= 0;
+        B.Metric("mrays_per_s", N / Sec * 1e-6);
+        B.Metric("hit_fraction", (DBL)Hits / N);
+        BenchSink = (*BvhHits)[N / 2].T;
+      }, 30);
+  /* Path traced reference of the same scene: grey terrain, glowing sphere, one sample per pixel */
+  auto Tracer = std::make_shared<nidx::path_tracer>(320, 180);
+  auto TraceMtl = std::make_shared<std::vector<INT>>(BvhInd->size() / 3, 0);
+  nidx::trace_material TraceMaterials[] =
+  {
+    {{0.6f, 0.6f, 0.55f}, {0, 0, 0}},
+    {{0.8f, 0.4f, 0.2f}, {0.4f, 0.2f, 0.1f}},
+  };
+
+  std::fill(TraceMtl->begin() + Ind->size() / 3, TraceMtl->end(), 1);
+  Tracer->SetScene(*Bvh, TraceMtl->data(), (INT)TraceMtl->size(), TraceMaterials, 2);
+  Tracer->SetCamera(BvhVP);
+  B.Register("trace_spp_320x180", [&B, Bvh, BvhPos, BvhInd, Tracer, TraceMtl]( VOID )
+    {
+      static BOOL IsChecked = FALSE;
+
+      /* Once per run (first warm up sample): incoherent bounce like rays through
+       * tracer stream path against every triangle in double (near edge hits are not counted) */
+      if (!IsChecked)
+      {
+        const INT NumOfRays = 256, NumOfTris = (INT)BvhInd->size() / 3;
+        const DBL Margin = 1e-6;
+        const FLT *P = BvhPos->data();
+        std::mt19937 Rnd(nidx::bench::Seed);
+        std::uniform_real_distribution<FLT> D(-1, 1);
+        std::vector<nidx::bvh_ray> Rays(NumOfRays);
+        std::vector<nidx::bvh_hit> Hits(NumOfRays);
+        INT Bad = 0, NumOfHits = 0;
+
+        for (auto &r : Rays)
+        {
+          FLT dx, dy, dz;
+
+          do
+            dx = D(Rnd), dy = D(Rnd), dz = D(Rnd);
+          while (dx * dx + dy * dy + dz * dz > 1 || dx * dx + dy * dy + dz * dz < 0.01f);
+          r = {{D(Rnd) * 15, 2 + D(Rnd) * 1.5f, D(Rnd) * 15}, {dx, dy, dz}, 1e30f};
+        }
+        Bvh->IntersectStream(Rays.data(), NumOfRays, Hits.data());
+        for (INT i = 0; i < NumOfRays; i++)
+        {
+          const nidx::bvh_ray &r = Rays[i];
+          INT Tri = Bvh->GetTriangle(Hits[i]);
+          /* Nearest surely hit distance and nearest maybe hit distance */
+          DBL Sure = HUGE_VAL, Maybe = HUGE_VAL, Own = -1;
+
+          for (INT t = 0; t < NumOfTris; t++)
+          {
+            const FLT
+              *v0 = P + (*BvhInd)[t * 3] * 3, *v1 = P + (*BvhInd)[t * 3 + 1] * 3, *v2 = P + (*BvhInd)[t * 3 + 2] * 3;
+            DBL
+              e1[3] = {(DBL)v1[0] - v0[0], (DBL)v1[1] - v0[1], (DBL)v1[2] - v0[2]},
+              e2[3] = {(DBL)v2[0] - v0[0], (DBL)v2[1] - v0[1], (DBL)v2[2] - v0[2]},
+              s[3] = {(DBL)r.Org[0] - v0[0], (DBL)r.Org[1] - v0[1], (DBL)r.Org[2] - v0[2]},
+              p[3] = {r.Dir[1] * e2[2] - r.Dir[2] * e2[1], r.Dir[2] * e2[0] - r.Dir[0] * e2[2], r.Dir[0] * e2[1] - r.Dir[1] * e2[0]},
+              q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]},
+              det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2], u, v, d;
+
+            if (det == 0)
+              continue;
+            u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) / det;
+            v = (r.Dir[0] * q[0] + r.Dir[1] * q[1] + r.Dir[2] * q[2]) / det;
+            d = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / det;
+            if (d <= Margin || u < -Margin || v < -Margin || u + v > 1 + Margin)
+              continue;
+            Maybe = std::min(Maybe, d);
+            if (t == Tri)
+              Own = d;
+            if (u > Margin && v > Margin && u + v < 1 - Margin)
+              Sure = std::min(Sure, d);
+          }
+          /* Hit triangle is really hit at reported distance, nothing surely hit is nearer */
+          if (Tri < 0)
+            Bad += Sure != HUGE_VAL;
+          else
+            Bad += Own < 0 || fabs(Own - Hits[i].T) > 1e-4 * (1 + Own) || Hits[i].T > Sure + 1e-4 * (1 + Sure) ||
+              Hits[i].T < Maybe - 1e-4 * (1 + Maybe), NumOfHits++;
+        }
+        B.Metric("check_hits", NumOfHits);
+        B.Check(Bad == 0, "trace: stream BVH hits differ from brute force hits");
+        IsChecked = TRUE;
+      }
+
+      auto Start = std::chrono::steady_clock::now();
+
+      Tracer->Render();
+      DBL Sec = std::chrono::duration<DBL>(std::chrono::steady_clock::now() - Start).count();
+
+      B.Metric("mrays_per_s", Tracer->GetNumOfRays() / Sec * 1e-6);
+      B.Metric("mpaths_per_s", 320 * 180 / Sec * 1e-6);
+      B.Metric("rays_per_path", Tracer->GetNumOfRays() / (320.0 * 180));
+      BenchSink = (FLT)(Tracer->GetColor()[180 / 2 * 320 + 160] & 0xFF);
+    }, 20);
+  /* Acceleration structures of 1500 static and 300 deforming meshes over 240 frames, 2 ms budget,
+   * simulated GPU: estimate error up to 25%, 2 frames latency, compaction to 55% */
+  B.Register("accel_schedule_1800", [&B]( VOID )
+    {
+      const INT NumOfFrames = 240, Latency = 2;
+      const DBL BudgetMs = 2;
+      std::mt19937 Rnd(7);
+      std::uniform_int_distribution<INT> StaticTris(1000, 40000), DynamicTris(2000, 10000);
+      std::uniform_real_distribution<FLT> Noise(0.8f, 1.25f), Deform(0.01f, 0.05f);
+      nidx::accel_manager M;
+      std::vector<nidx::accel_handle> Dynamic;
+      std::vector<std::pair<UINT64, nidx::accel_handle>> Queries;
+      std::vector<UINT64> ResultSizes;
+      INT Ready = -1, Over = 0, Rebuilds = 0, MissedRefits = 0, OverByOptional = 0;
+      DBL GpuMs = 0, CpuSec = 0;
+      std::vector<INT> Updates;
+      std::vector<BYTE> IsBuilt;
+
+      for (INT i = 0; i < 1800; i++)
+      {
+        BOOL IsDynamic = i % 6 == 0;
+        nidx::accel_desc D {IsDynamic ? DynamicTris(Rnd) : StaticTris(Rnd), IsDynamic, 0, 0, 0};
+
+        if (IsDynamic)
+          Dynamic.push_back(M.Add(D));
+        else
+          M.Add(D);
+      }
+      for (INT f = 0; f < NumOfFrames; f++)
+      {
+        UINT64 Fence = f + 1, Completed = f + 1 > Latency ? f + 1 - Latency : 0;
+        DBL Ms = 0;
+
+        /* Backend reads compacted sizes of completed builds */
+        M.Collect(Completed);
+        for (size_t i = 0; i < Queries.size(); )
+          if (Queries[i].first <= Completed)
+          {
+            M.SetCompactedSize(Queries[i].second, M.GetMemory(Queries[i].second).Size * 55 / 100);
+            Queries[i] = Queries.back();
+            Queries.pop_back();
+          }
+          else
+            i++;
+        for (auto H : Dynamic)
+          M.Deform(H, Deform(Rnd));
+
+        auto Start = std::chrono::steady_clock::now();
+        const nidx::accel_frame &F = M.Schedule(BudgetMs, Fence);
+        CpuSec += std::chrono::duration<DBL>(std::chrono::steady_clock::now() - Start).count();
+
+        Updates.assign(Updates.size(), 0);
+        for (auto &Op : F.Ops)
+        {
+          Ms += Op.Ms * Noise(Rnd);
+          if (Op.Type == nidx::accel_op_type::BUILD && Op.Src == 0 && Op.Blas.IsValid())
+            Queries.push_back({Fence, Op.Blas});
+          if (Op.Type == nidx::accel_op_type::BUILD || Op.Type == nidx::accel_op_type::REFIT)
+          {
+            if (Op.Blas.Index >= Updates.size())
+              Updates.resize(Op.Blas.Index + 1, 0), IsBuilt.resize(Op.Blas.Index + 1, 0);
+            Updates[Op.Blas.Index]++;
+          }
+        }
+        /* Deformed built structures are refit (or rebuilt) exactly once */
+        for (auto H : Dynamic)
+          MissedRefits += H.Index < Updates.size() && (Updates[H.Index] > 1 || (IsBuilt[H.Index] && Updates[H.Index] != 1));
+        for (size_t i = 0; i < Updates.size(); i++)
+          IsBuilt[i] |= Updates[i] != 0;
+        /* Only required work (refits, top level, first new build) may exceed budget */
+        OverByOptional += F.Ms > BudgetMs && (F.NumOfRebuilds > 0 || F.NumOfCompactions > 0 || F.NumOfBuilds > 1);
+        GpuMs += Ms;
+        Over += Ms > BudgetMs;
+        Rebuilds += F.NumOfRebuilds;
+        if (Ready < 0 && F.NumOfWaiting == 0)
+          Ready = f + 1;
+      }
+      nidx::accel_stats S = M.GetStats();
+
+      B.Metric("frames_to_ready", Ready);
+      B.Metric("gpu_ms_per_frame", GpuMs / NumOfFrames);
+      B.Metric("over_budget_pct", 100.0 * Over / NumOfFrames);
+      B.Metric("rebuilds_per_frame", (DBL)Rebuilds / NumOfFrames);
+      B.Metric("compacted_pct", 100.0 * S.CompactedBytes / (S.ResultBytes + S.CompactedBytes));
+      B.Metric("scratch_blocks", S.NumOfScratchBlocks);
+      B.Metric("schedule_us", CpuSec / NumOfFrames * 1e6);
+      B.Check(Ready > 0 && S.NumOfReady == 1800, "accel_schedule: not every structure is built");
+      B.Check(MissedRefits == 0, "accel_schedule: deformed structure is not refit exactly once per frame");
+      B.Check(OverByOptional == 0, "accel_schedule: optional work exceeds budget");
+      BenchSink = (FLT)S.ResultBytes;
+    }, 10);
+  /* Render thread fed by 1, 2 and 3 frame packets: 2000 proxies per frame, simulation spins
+   * 0.4 ms (1.2 ms every 6th frame), render waits 0.4 ms for GPU (1.2 ms every 7th frame) */
+  for (INT Buffers = 1; Buffers <= nidx::packet_ring::MaxPackets; Buffers++)
+    B.Register("render_thread_" + std::to_string(Buffers) + "_packets", [&B, Buffers]( VOID )
+      {
+        const INT NumOfFrames = 120, NumOfProxies = 2000;
+        nidx::packet_ring Ring(Buffers);
+        nidx::render_thread Thread(Ring);
+        std::atomic<UINT64> Rendered(0);
+        FLT Sum = 0;
+
+        auto Start = std::chrono::steady_clock::now();
+
+        Thread.Start([&]( const nidx::frame_packet &P )
+          {
+            for (auto &Pr : P.Proxies)
+              Sum += ((const FLT *)Pr.World)[12];
+            std::this_thread::sleep_for(std::chrono::microseconds(P.Frame % 7 == 0 ? 1200 : 400));
+            Rendered++;
+          });
+        for (INT f = 0; f < NumOfFrames; f++)
+        {
+          nidx::frame_packet *P = Ring.BeginWrite();
+          auto Until = std::chrono::steady_clock::now() + std::chrono::microseconds(f % 6 == 0 ? 1200 : 400);
+
+          P->Frame = f;
+          P->Time = f / 60.0;
+          P->Alpha = 0;
+          P->Proxies.resize(NumOfProxies);
+          for (INT i = 0; i < NumOfProxies; i++)
+          {
+            P->Proxies[i].World = nidx::matr::Translate(nidx::vec3((FLT)i, (FLT)f, 0));
+            P->Proxies[i].Mesh = i % 16;
+            P->Proxies[i].Material = i % 4;
+          }
+          while (std::chrono::steady_clock::now() < Until)
+            ;
+          Ring.EndWrite();
+        }
+        Thread.Stop();
+        DBL Sec = std::chrono::duration<DBL>(std::chrono::steady_clock::now() - Start).count();
+
+        B.Metric("frames_per_s", Rendered / Sec);
+        B.Metric("producer_waits_per_frame", (DBL)Ring.WriteWaits / NumOfFrames);
+        BenchSink = Sum;
+      }, 10);
+} /* End of 'RegisterRender' function */
+
+/* Register all suite workloads function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID nidx::bench::RegisterSuite( VOID )
+{
+  RegisterMath(*this);
+  RegisterCore(*this);
+  RegisterRender(*this);
+} /* End of 'nidx::bench::RegisterSuite' function */
+
+/* END OF 'bench_suite.cpp' FILE */
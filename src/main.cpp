@@ -7,7 +7,7 @@
   * PURPOSE     : T51DX12 project.
   *               Main startup module.
   * PROGRAMMER  : ND4.
-  * LAST UPDATE : 07.10.2021
+  * LAST UPDATE : 19.10.2026
   * NOTE        : None.
   *
   * No part of this file may be changed without agreement of
@@ -17,6 +17,8 @@
 //#include <nidx.h>
 #include "nidx.h"
 
+#include <sstream>
+
 /* The main program function.
  * ARGUMENTS:
  *   - handle of application instance:
@@ -33,8 +35,27 @@
 INT WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, CHAR* CmdLine, INT CmdShow )
 {
   nidx::anim* MyW = nidx::anim::GetPtr();
+  std::istringstream Args(CmdLine);
+  std::string Arg, RecordName, ReplayName, ProfileName;
+
   SetDbgMemHooks();
-  
+
+  /* Input session options:
+   *   -record <log>
+   *   -replay <log> [-profile <frame times .csv>]
+   * (benchmark suite is separate 'nidx_bench' target, see 'CMakeLists.txt') */
+  while (Args >> Arg)
+    if (Arg == "-record")
+      Args >> RecordName;
+    else if (Arg == "-replay")
+      Args >> ReplayName;
+    else if (Arg == "-profile")
+      Args >> ProfileName;
+  if (!ReplayName.empty())
+    MyW->StartReplay(ReplayName, ProfileName);
+  else if (!RecordName.empty())
+    MyW->StartRecord(RecordName);
+
   MyW->Run();
   
   return 2;
@@ -17,6 +17,8 @@
 #ifndef _mth_h_
 #define _mth_h_
 
+#include "mth_fast.h"
+#include "mth_half.h"
 #include "mth_matr.h"
 #include "mth_vec2.h"
 #include "mth_vec3.h"
@@ -0,0 +1,390 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : mth_fast.h
+  * PURPOSE     : T51DX12 project.
+  *               Fast approximate math functions declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Single precision kernels, scalar and SSE2 paths do the
+  *               same operations (up to FMA contraction by compiler).
+  *               Maximal errors against exact values:
+  *                 FastSinCos    - 2 ULP for |A| <= 8192, absolute
+  *                                 error 8e-8 near zeroes of result;
+  *                 FastSinCosDeg - 2 ULP for |A| <= 1e6 degrees, exact
+  *                                 for multiples of 90 degrees;
+  *                 FastRsqrt     - 5 ULP (one Newton step over 12 bit
+  *                                 hardware estimate, 1 ULP without SSE).
+  *               Argument range reduction is Cody-Waite, polynomials
+  *               are Cephes minimax ones.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _mth_fast_h_
+#define _mth_fast_h_
+
+#include "mth_matr.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define MTH_FAST_SSE2
+#endif /* __SSE2__ */
+
+namespace mth
+{
+  /* Fast math kernels namespace */
+  namespace fast
+  {
+    /* Reduction constants: Pi / 2 split into exactly multiplied parts */
+    const FLT
+      PiDiv2A = 1.5703125f,
+      PiDiv2B = 4.837512969970703125e-4f,
+      PiDiv2C = 7.54978995489188216e-8f,
+      Deg2Rad = (FLT)(PI / 180);
+
+    /* Evaluate sine and cosine of reduced argument function.
+     * ARGUMENTS:
+     *   - argument in [-Pi / 4..Pi / 4]:
+     *       FLT R;
+     *   - quadrant:
+     *       INT Q;
+     *   - results to fill:
+     *       FLT *S, *C;
+     * RETURNS: None.
+     */
+    inline VOID SinCosReduced( FLT R, INT Q, FLT *S, FLT *C )
+    {
+      FLT
+        z = R * R,
+        s = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * R + R,
+        c = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1;
+
+      if (Q & 1)
+      {
+        FLT t = s;
+
+        s = c, c = -t;
+      }
+      if (Q & 2)
+        s = -s, c = -c;
+      *S = s, *C = c;
+    } /* End of 'SinCosReduced' function */
+
+#ifdef MTH_FAST_SSE2
+    /* Evaluate sine and cosine of 4 reduced arguments function.
+     * ARGUMENTS:
+     *   - arguments in [-Pi / 4..Pi / 4]:
+     *       __m128 R;
+     *   - quadrants:
+     *       __m128i Q;
+     *   - results to fill:
+     *       __m128 *S, *C;
+     * RETURNS: None.
+     */
+    inline VOID SinCosReduced4( __m128 R, __m128i Q, __m128 *S, __m128 *C )
+    {
+      __m128
+        z = _mm_mul_ps(R, R),
+        s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z),
+          _mm_set1_ps(8.3321608736e-3f)), z), _mm_set1_ps(1.6666654611e-1f)), z), R), R),
+        c = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z),
+          _mm_set1_ps(1.388731625493765e-3f)), z), _mm_set1_ps(4.166664568298827e-2f)), z), z), _mm_mul_ps(_mm_set1_ps(0.5f), z)),
+          _mm_set1_ps(1)),
+        Swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(Q, _mm_set1_epi32(1)), _mm_set1_epi32(1))),
+        SinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(Q, _mm_set1_epi32(2)), 30)),
+        CosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(Q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+      *S = _mm_xor_ps(_mm_or_ps(_mm_and_ps(Swap, c), _mm_andnot_ps(Swap, s)), SinSign);
+      *C = _mm_xor_ps(_mm_or_ps(_mm_and_ps(Swap, s), _mm_andnot_ps(Swap, c)), CosSign);
+    } /* End of 'SinCosReduced4' function */
+#endif /* MTH_FAST_SSE2 */
+  } /* End of 'fast' namespace */
+
+  /* Fast sine and cosine function.
+   * ARGUMENTS:
+   *   - angle in radians:
+   *       FLT A;
+   *   - results to fill:
+   *       FLT *S, *C;
+   * RETURNS: None.
+   */
+  inline VOID FastSinCos( FLT A, FLT *S, FLT *C )
+  {
+    FLT j = (FLT)floor(A * (FLT)(2 / PI) + 0.5f);
+
+    fast::SinCosReduced(((A - j * fast::PiDiv2A) - j * fast::PiDiv2B) - j * fast::PiDiv2C, (INT)j, S, C);
+  } /* End of 'FastSinCos' function */
+
+  /* Fast sine and cosine of angle in degrees function.
+   * ARGUMENTS:
+   *   - angle in degrees:
+   *       FLT A;
+   *   - results to fill:
+   *       FLT *S, *C;
+   * RETURNS: None.
+   */
+  inline VOID FastSinCosDeg( FLT A, FLT *S, FLT *C )
+  {
+    FLT j = (FLT)floor(A * (1.0f / 90) + 0.5f);
+
+    fast::SinCosReduced((A - j * 90) * fast::Deg2Rad, (INT)j, S, C);
+  } /* End of 'FastSinCosDeg' function */
+
+  /* Fast sine and cosine of arrays function.
+   * ARGUMENTS:
+   *   - angles in radians:
+   *       const FLT *A;
+   *   - results to fill:
+   *       FLT *S, *C;
+   *   - number of angles:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID FastSinCos( const FLT *A, FLT *S, FLT *C, size_t N )
+  {
+    size_t i = 0;
+
+#ifdef MTH_FAST_SSE2
+    for (; i + 4 <= N; i += 4)
+    {
+      __m128 a = _mm_loadu_ps(A + i), j, s, c;
+      __m128i q;
+
+      /* Round half up like scalar version */
+      j = _mm_add_ps(_mm_mul_ps(a, _mm_set1_ps((FLT)(2 / PI))), _mm_set1_ps(0.5f));
+      q = _mm_cvttps_epi32(j);
+      q = _mm_sub_epi32(q, _mm_castps_si128(_mm_and_ps(_mm_cmplt_ps(j, _mm_cvtepi32_ps(q)), _mm_castsi128_ps(_mm_set1_epi32(1)))));
+      j = _mm_cvtepi32_ps(q);
+      a = _mm_sub_ps(a, _mm_mul_ps(j, _mm_set1_ps(fast::PiDiv2A)));
+      a = _mm_sub_ps(a, _mm_mul_ps(j, _mm_set1_ps(fast::PiDiv2B)));
+      a = _mm_sub_ps(a, _mm_mul_ps(j, _mm_set1_ps(fast::PiDiv2C)));
+      fast::SinCosReduced4(a, q, &s, &c);
+      _mm_storeu_ps(S + i, s);
+      _mm_storeu_ps(C + i, c);
+    }
+#endif /* MTH_FAST_SSE2 */
+    for (; i < N; i++)
+      FastSinCos(A[i], S + i, C + i);
+  } /* End of 'FastSinCos' function */
+
+  /* Fast sine and cosine of arrays of angles in degrees function.
+   * ARGUMENTS:
+   *   - angles in degrees:
+   *       const FLT *A;
+   *   - results to fill:
+   *       FLT *S, *C;
+   *   - number of angles:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID FastSinCosDeg( const FLT *A, FLT *S, FLT *C, size_t N )
+  {
+    size_t i = 0;
+
+#ifdef MTH_FAST_SSE2
+    for (; i + 4 <= N; i += 4)
+    {
+      __m128 a = _mm_loadu_ps(A + i), j, s, c;
+      __m128i q;
+
+      j = _mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(1.0f / 90)), _mm_set1_ps(0.5f));
+      q = _mm_cvttps_epi32(j);
+      q = _mm_sub_epi32(q, _mm_castps_si128(_mm_and_ps(_mm_cmplt_ps(j, _mm_cvtepi32_ps(q)), _mm_castsi128_ps(_mm_set1_epi32(1)))));
+      j = _mm_cvtepi32_ps(q);
+      a = _mm_mul_ps(_mm_sub_ps(a, _mm_mul_ps(j, _mm_set1_ps(90))), _mm_set1_ps(fast::Deg2Rad));
+      fast::SinCosReduced4(a, q, &s, &c);
+      _mm_storeu_ps(S + i, s);
+      _mm_storeu_ps(C + i, c);
+    }
+#endif /* MTH_FAST_SSE2 */
+    for (; i < N; i++)
+      FastSinCosDeg(A[i], S + i, C + i);
+  } /* End of 'FastSinCosDeg' function */
+
+  /* Fast reciprocal square root function.
+   * ARGUMENTS:
+   *   - positive value:
+   *       FLT X;
+   * RETURNS:
+   *   (FLT) 1 / sqrt(X).
+   */
+  inline FLT FastRsqrt( FLT X )
+  {
+#ifdef MTH_FAST_SSE2
+    FLT y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(X)));
+
+    /* Newton step */
+    return y * (1.5f - 0.5f * X * y * y);
+#else /* MTH_FAST_SSE2 */
+    return 1 / (FLT)sqrt(X);
+#endif /* MTH_FAST_SSE2 */
+  } /* End of 'FastRsqrt' function */
+
+  /* Fast normalize vectors function.
+   * ARGUMENTS:
+   *   - vectors (non zero) to normalize:
+   *       vec3<FLT> *V;
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID FastNormalize( vec3<FLT> *V, size_t N )
+  {
+    static_assert(sizeof(vec3<FLT>) == sizeof(FLT) * 3, "vec3 must be tightly packed");
+    FLT *P = reinterpret_cast<FLT *>(V);
+    size_t i = 0;
+
+#ifdef MTH_FAST_SSE2
+    for (; i + 4 <= N; i += 4)
+    {
+      /* 4 vectors are 3 registers: x0y0z0x1 y1z1x2y2 z2x3y3z3 */
+      __m128
+        a = _mm_loadu_ps(P + i * 3), b = _mm_loadu_ps(P + i * 3 + 4), c = _mm_loadu_ps(P + i * 3 + 8),
+        x = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 2, 3, 0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0)),
+        y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)),
+        z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)),
+        l = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)),
+        r = _mm_rsqrt_ps(l);
+
+      r = _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), l), _mm_mul_ps(r, r))));
+      /* Scale in interleaved layout: r0r0r0r1 r1r1r2r2 r2r3r3r3 */
+      _mm_storeu_ps(P + i * 3, _mm_mul_ps(a, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 0, 0, 0))));
+      _mm_storeu_ps(P + i * 3 + 4, _mm_mul_ps(b, _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 1, 1))));
+      _mm_storeu_ps(P + i * 3 + 8, _mm_mul_ps(c, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 2))));
+    }
+#endif /* MTH_FAST_SSE2 */
+    for (; i < N; i++)
+    {
+      FLT *p = P + i * 3, r = FastRsqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+
+      p[0] *= r, p[1] *= r, p[2] *= r;
+    }
+  } /* End of 'FastNormalize' function */
+
+  /* Build rotation matrices around X axis function.
+   * ARGUMENTS:
+   *   - matrices to fill:
+   *       matr<FLT> *M;
+   *   - angles in degrees:
+   *       const FLT *AngleInDegree;
+   *   - number of matrices:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID FastRotateX( matr<FLT> *M, const FLT *AngleInDegree, size_t N )
+  {
+    const size_t Batch = 256;
+    FLT S[Batch], C[Batch];
+
+    for (size_t b = 0; b < N; b += Batch)
+    {
+      size_t n = N - b < Batch ? N - b : Batch;
+
+      FastSinCosDeg(AngleInDegree + b, S, C, n);
+      for (size_t i = 0; i < n; i++)
+        M[b + i] = matr<FLT>(1, 0, 0, 0,
+                             0, C[i], S[i], 0,
+                             0, -S[i], C[i], 0,
+                             0, 0, 0, 1);
+    }
+  } /* End of 'FastRotateX' function */
+
+  /* Build rotation matrices around Y axis function.
+   * ARGUMENTS:
+   *   - matrices to fill:
+   *       matr<FLT> *M;
+   *   - angles in degrees:
+   *       const FLT *AngleInDegree;
+   *   - number of matrices:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID FastRotateY( matr<FLT> *M, const FLT *AngleInDegree, size_t N )
+  {
+    const size_t Batch = 256;
+    FLT S[Batch], C[Batch];
+
+    for (size_t b = 0; b < N; b += Batch)
+    {
+      size_t n = N - b < Batch ? N - b : Batch;
+
+      FastSinCosDeg(AngleInDegree + b, S, C, n);
+      for (size_t i = 0; i < n; i++)
+        M[b + i] = matr<FLT>(C[i], 0, -S[i], 0,
+                             0, 1, 0, 0,
+                             S[i], 0, C[i], 0,
+                             0, 0, 0, 1);
+    }
+  } /* End of 'FastRotateY' function */
+
+  /* Build rotation matrices around Z axis function.
+   * ARGUMENTS:
+   *   - matrices to fill:
+   *       matr<FLT> *M;
+   *   - angles in degrees:
+   *       const FLT *AngleInDegree;
+   *   - number of matrices:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID FastRotateZ( matr<FLT> *M, const FLT *AngleInDegree, size_t N )
+  {
+    const size_t Batch = 256;
+    FLT S[Batch], C[Batch];
+
+    for (size_t b = 0; b < N; b += Batch)
+    {
+      size_t n = N - b < Batch ? N - b : Batch;
+
+      FastSinCosDeg(AngleInDegree + b, S, C, n);
+      for (size_t i = 0; i < n; i++)
+        M[b + i] = matr<FLT>(C[i], S[i], 0, 0,
+                             -S[i], C[i], 0, 0,
+                             0, 0, 1, 0,
+                             0, 0, 0, 1);
+    }
+  } /* End of 'FastRotateZ' function */
+
+  /* Build rotation matrices around arbitrary axes function.
+   * ARGUMENTS:
+   *   - matrices to fill:
+   *       matr<FLT> *M;
+   *   - angles in degrees:
+   *       const FLT *AngleInDegree;
+   *   - unit rotation axes:
+   *       const vec3<FLT> *Axis;
+   *   - number of matrices:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID FastRotate( matr<FLT> *M, const FLT *AngleInDegree, const vec3<FLT> *Axis, size_t N )
+  {
+    const size_t Batch = 256;
+    const FLT *A = reinterpret_cast<const FLT *>(Axis);
+    FLT S[Batch], C[Batch];
+
+    for (size_t b = 0; b < N; b += Batch)
+    {
+      size_t n = N - b < Batch ? N - b : Batch;
+
+      FastSinCosDeg(AngleInDegree + b, S, C, n);
+      for (size_t i = 0; i < n; i++)
+      {
+        const FLT *a = A + (b + i) * 3;
+        FLT s = S[i], c = C[i], d = 1 - c;
+
+        M[b + i] = matr<FLT>(c + a[0] * a[0] * d,        a[0] * a[1] * d + a[2] * s, a[0] * a[2] * d - a[1] * s, 0,
+                             a[1] * a[0] * d - a[2] * s, c + a[1] * a[1] * d,        a[1] * a[2] * d + a[0] * s, 0,
+                             a[2] * a[0] * d + a[1] * s, a[2] * a[1] * d - a[0] * s, c + a[2] * a[2] * d,        0,
+                             0,                          0,                          0,                          1);
+      }
+    }
+  } /* End of 'FastRotate' function */
+} /* End of 'mth' namespace */
+
+#endif // !_mth_fast_h_
+
+/* END OF 'mth_fast.h' FILE */
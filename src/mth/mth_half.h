@@ -0,0 +1,446 @@
+/***************************************************************
+ * Copyright (C) 2020-2021
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ ***************************************************************/
+
+ /* FILE NAME   : mth_half.h
+  * PURPOSE     : T51DX12 project.
+  *               Half precision float declaration module.
+  * PROGRAMMER  : ND4.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : IEEE 754 binary16, conversions round to nearest even
+  *               and keep NaN payload like F16C does. Arithmetic goes
+  *               through FLT, so 'vec2/3/4<half>' work as storage types.
+  *               Bulk kernels use F16C if compiled with it or AVX2,
+  *               SSE2 otherwise. Software 'FromFloatRef'/'ToFloatRef'
+  *               are always compiled as reference for every path.
+  *               SSE2 path assumes denormals are not flushed to zero.
+  *
+  * No part of this file may be changed without agreement of
+  * Computer Graphics Support Group of 30 Phys-Math Lyceum
+  */
+
+#ifndef _mth_half_h_
+#define _mth_half_h_
+
+#include "mthdef.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define MTH_HALF_SSE2
+#endif /* __SSE2__ */
+/* MSVC never defines '__F16C__', AVX2 processors all have F16C
+ * (GCC/Clang '-mf16c' also enables AVX) */
+#if defined(__F16C__) || defined(__AVX2__)
+#  include <immintrin.h>
+#  define MTH_HALF_F16C
+#endif /* __F16C__ */
+
+namespace mth
+{
+  /* Half precision float class */
+  class half
+  {
+  private:
+    USHORT Bits; /* Binary16 representation */
+
+  public:
+    /* Convert float to half bits in software function (reference for all paths).
+     * ARGUMENTS:
+     *   - value:
+     *       FLT F;
+     * RETURNS:
+     *   (USHORT) half bits.
+     */
+    static USHORT FromFloatRef( FLT F )
+    {
+      UINT x, Sign, Exp, Mant;
+
+      memcpy(&x, &F, 4);
+      Sign = (x >> 16) & 0x8000;
+      Exp = (x >> 23) & 0xFF;
+      Mant = x & 0x7FFFFF;
+      if (Exp == 0xFF)
+        return (USHORT)(Sign | 0x7C00 | (Mant != 0 ? 0x200 | (Mant >> 13) : 0));
+      if (Exp > 142)
+        return (USHORT)(Sign | 0x7C00);
+      if (Exp < 113)
+      {
+        /* Subnormal or zero */
+        UINT Shift, h;
+
+        if (Exp < 102)
+          return (USHORT)Sign;
+        Mant |= 0x800000;
+        Shift = 126 - Exp;
+        h = Mant >> Shift;
+        if ((Mant >> (Shift - 1) & 1) && ((Mant & ((1u << (Shift - 1)) - 1)) != 0 || (h & 1)))
+          h++;
+        return (USHORT)(Sign | h);
+      }
+      /* Mantissa rounding carry moves into exponent correctly */
+      return (USHORT)(Sign | ((((Exp - 112) << 10) | (Mant >> 13)) + ((Mant & 0x1000) && (Mant & 0x2FFF))));
+    } /* End of 'FromFloatRef' function */
+
+    /* Convert half bits to float in software function (reference for all paths).
+     * ARGUMENTS:
+     *   - half bits:
+     *       USHORT H;
+     * RETURNS:
+     *   (FLT) value.
+     */
+    static FLT ToFloatRef( USHORT H )
+    {
+      UINT Sign = (UINT)(H & 0x8000) << 16, Exp = (H >> 10) & 0x1F, Mant = H & 0x3FF, x;
+      FLT F;
+
+      if (Exp == 0)
+      {
+        F = Mant * (1.0f / (1 << 24));
+        return Sign ? -F : F;
+      }
+      /* NaN comes out quiet (as F16C converts it) */
+      x = Sign | (Exp == 0x1F ? 0x7F800000 | (Mant != 0 ? 0x400000 : 0) : (Exp + 112) << 23) | (Mant << 13);
+      memcpy(&F, &x, 4);
+      return F;
+    } /* End of 'ToFloatRef' function */
+
+    /* Convert float to half bits function.
+     * ARGUMENTS:
+     *   - value:
+     *       FLT F;
+     * RETURNS:
+     *   (USHORT) half bits.
+     */
+    static USHORT FromFloat( FLT F )
+    {
+#ifdef MTH_HALF_F16C
+      return (USHORT)_cvtss_sh(F, 0);
+#else /* MTH_HALF_F16C */
+      return FromFloatRef(F);
+#endif /* MTH_HALF_F16C */
+    } /* End of 'FromFloat' function */
+
+    /* Convert half bits to float function.
+     * ARGUMENTS:
+     *   - half bits:
+     *       USHORT H;
+     * RETURNS:
+     *   (FLT) value.
+     */
+    static FLT ToFloat( USHORT H )
+    {
+#ifdef MTH_HALF_F16C
+      return _cvtsh_ss(H);
+#else /* MTH_HALF_F16C */
+      return ToFloatRef(H);
+#endif /* MTH_HALF_F16C */
+    } /* End of 'ToFloat' function */
+
+    /* Half init function.
+     * ARGUMENTS: None.
+     */
+    half( VOID ) : Bits(0)
+    {
+    } /* End of 'half' function */
+
+    /* Half init function.
+     * ARGUMENTS:
+     *   - value:
+     *       FLT F;
+     */
+    half( FLT F ) : Bits(FromFloat(F))
+    {
+    } /* End of 'half' function */
+
+    /* Create half from bits function.
+     * ARGUMENTS:
+     *   - half bits:
+     *       USHORT B;
+     * RETURNS:
+     *   (half) value.
+     */
+    static half FromBits( USHORT B )
+    {
+      half h;
+
+      h.Bits = B;
+      return h;
+    } /* End of 'FromBits' function */
+
+    /* Obtain half bits function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (USHORT) half bits.
+     */
+    USHORT GetBits( VOID ) const
+    {
+      return Bits;
+    } /* End of 'GetBits' function */
+
+    /* Convert to float function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (FLT) value.
+     */
+    operator FLT( VOID ) const
+    {
+      return ToFloat(Bits);
+    } /* End of 'operator FLT' function */
+
+    /* Add and assign function.
+     * ARGUMENTS:
+     *   - value to add:
+     *       FLT F;
+     * RETURNS:
+     *   (half &) self reference.
+     */
+    half & operator+=( FLT F )
+    {
+      return *this = half(FLT(*this) + F);
+    } /* End of 'operator+=' function */
+
+    /* Subtract and assign function.
+     * ARGUMENTS:
+     *   - value to subtract:
+     *       FLT F;
+     * RETURNS:
+     *   (half &) self reference.
+     */
+    half & operator-=( FLT F )
+    {
+      return *this = half(FLT(*this) - F);
+    } /* End of 'operator-=' function */
+
+    /* Multiply and assign function.
+     * ARGUMENTS:
+     *   - value to multiply by:
+     *       FLT F;
+     * RETURNS:
+     *   (half &) self reference.
+     */
+    half & operator*=( FLT F )
+    {
+      return *this = half(FLT(*this) * F);
+    } /* End of 'operator*=' function */
+
+    /* Divide and assign function.
+     * ARGUMENTS:
+     *   - value to divide by:
+     *       FLT F;
+     * RETURNS:
+     *   (half &) self reference.
+     */
+    half & operator/=( FLT F )
+    {
+      return *this = half(FLT(*this) / F);
+    } /* End of 'operator/=' function */
+  }; /* End of 'half' class */
+
+#ifdef MTH_HALF_SSE2
+  /* Convert 4 floats to half bits in 32 bit lanes function (SSE2).
+   * ARGUMENTS:
+   *   - floats:
+   *       __m128 F;
+   * RETURNS:
+   *   (__m128i) half bits.
+   */
+  inline __m128i HalfFromFloatSSE2( __m128 F )
+  {
+    const __m128i
+      SubMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23),
+      NormalBias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+    __m128
+      Sign = _mm_and_ps(F, _mm_castsi128_ps(_mm_set1_epi32((INT)0x80000000))),
+      Abs = _mm_xor_ps(F, Sign);
+    __m128i
+      AbsI = _mm_castps_si128(Abs),
+      IsNaN = _mm_castps_si128(_mm_cmpunord_ps(Abs, Abs)),
+      IsRegular = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), AbsI),
+      IsSub = _mm_cmpgt_epi32(_mm_set1_epi32((127 - 14) << 23), AbsI),
+      /* Infinity or NaN with payload */
+      Special = _mm_or_si128(_mm_set1_epi32(0x7C00),
+        _mm_and_si128(IsNaN, _mm_or_si128(_mm_set1_epi32(0x200), _mm_and_si128(_mm_srli_epi32(AbsI, 13), _mm_set1_epi32(0x3FF))))),
+      /* Subnormal result: let float addition round mantissa */
+      Sub = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(Abs, _mm_castsi128_ps(SubMagic))), SubMagic),
+      /* Normal result: rebias and round to nearest even */
+      Odd = _mm_srai_epi32(_mm_slli_epi32(AbsI, 31 - 13), 31),
+      Normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(AbsI, NormalBias), Odd), 13),
+      R = _mm_or_si128(_mm_and_si128(IsSub, Sub), _mm_andnot_si128(IsSub, Normal));
+
+    R = _mm_or_si128(_mm_and_si128(IsRegular, R), _mm_andnot_si128(IsRegular, Special));
+    return _mm_or_si128(R, _mm_srai_epi32(_mm_castps_si128(Sign), 16));
+  } /* End of 'HalfFromFloatSSE2' function */
+
+  /* Convert half bits in 32 bit lanes to 4 floats function (SSE2).
+   * ARGUMENTS:
+   *   - half bits (zero extended):
+   *       __m128i H;
+   * RETURNS:
+   *   (__m128) floats.
+   */
+  inline __m128 HalfToFloatSSE2( __m128i H )
+  {
+    __m128i
+      ExpMant = _mm_and_si128(H, _mm_set1_epi32(0x7FFF)),
+      Sign = _mm_slli_epi32(_mm_xor_si128(H, ExpMant), 16),
+      IsInfNaN = _mm_cmpgt_epi32(ExpMant, _mm_set1_epi32(0x7BFF)),
+      IsNaN = _mm_cmpgt_epi32(ExpMant, _mm_set1_epi32(0x7C00));
+    /* Multiplication rebiases exponent and normalizes subnormals */
+    __m128 Scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(ExpMant, 13)),
+                               _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+
+    /* NaN comes out quiet (as F16C converts it) */
+    return _mm_or_ps(Scaled, _mm_castsi128_ps(_mm_or_si128(_mm_or_si128(Sign, _mm_and_si128(IsInfNaN, _mm_set1_epi32(255 << 23))),
+                                                           _mm_and_si128(IsNaN, _mm_set1_epi32(0x400000)))));
+  } /* End of 'HalfToFloatSSE2' function */
+#endif /* MTH_HALF_SSE2 */
+
+#ifdef MTH_HALF_SSE2
+  /* Convert float array to half array function (SSE2).
+   * ARGUMENTS:
+   *   - destination:
+   *       half *Dst;
+   *   - source:
+   *       const FLT *Src;
+   *   - number of values:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID HalfFromFloatSSE2( half *Dst, const FLT *Src, size_t N )
+  {
+    size_t i = 0;
+
+    for (; i + 8 <= N; i += 8)
+    {
+      __m128i
+        a = HalfFromFloatSSE2(_mm_loadu_ps(Src + i)),
+        b = HalfFromFloatSSE2(_mm_loadu_ps(Src + i + 4));
+
+      /* Sign extend low words so signed pack keeps bits */
+      a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+      b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+      _mm_storeu_si128((__m128i *)(Dst + i), _mm_packs_epi32(a, b));
+    }
+    for (; i < N; i++)
+      Dst[i] = half::FromBits(half::FromFloatRef(Src[i]));
+  } /* End of 'HalfFromFloatSSE2' function */
+
+  /* Convert half array to float array function (SSE2).
+   * ARGUMENTS:
+   *   - destination:
+   *       FLT *Dst;
+   *   - source:
+   *       const half *Src;
+   *   - number of values:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID HalfToFloatSSE2( FLT *Dst, const half *Src, size_t N )
+  {
+    size_t i = 0;
+
+    for (; i + 8 <= N; i += 8)
+    {
+      __m128i h = _mm_loadu_si128((const __m128i *)(Src + i)), z = _mm_setzero_si128();
+
+      _mm_storeu_ps(Dst + i, HalfToFloatSSE2(_mm_unpacklo_epi16(h, z)));
+      _mm_storeu_ps(Dst + i + 4, HalfToFloatSSE2(_mm_unpackhi_epi16(h, z)));
+    }
+    for (; i < N; i++)
+      Dst[i] = half::ToFloatRef(Src[i].GetBits());
+  } /* End of 'HalfToFloatSSE2' function */
+#endif /* MTH_HALF_SSE2 */
+
+#ifdef MTH_HALF_F16C
+  /* Convert float array to half array function (F16C).
+   * ARGUMENTS:
+   *   - destination:
+   *       half *Dst;
+   *   - source:
+   *       const FLT *Src;
+   *   - number of values:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID HalfFromFloatF16C( half *Dst, const FLT *Src, size_t N )
+  {
+    size_t i = 0;
+
+    for (; i + 8 <= N; i += 8)
+      _mm_storeu_si128((__m128i *)(Dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(Src + i), 0));
+    for (; i < N; i++)
+      Dst[i] = half::FromBits((USHORT)_cvtss_sh(Src[i], 0));
+  } /* End of 'HalfFromFloatF16C' function */
+
+  /* Convert half array to float array function (F16C).
+   * ARGUMENTS:
+   *   - destination:
+   *       FLT *Dst;
+   *   - source:
+   *       const half *Src;
+   *   - number of values:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID HalfToFloatF16C( FLT *Dst, const half *Src, size_t N )
+  {
+    size_t i = 0;
+
+    for (; i + 8 <= N; i += 8)
+      _mm256_storeu_ps(Dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(Src + i))));
+    for (; i < N; i++)
+      Dst[i] = _cvtsh_ss(Src[i].GetBits());
+  } /* End of 'HalfToFloatF16C' function */
+#endif /* MTH_HALF_F16C */
+
+  /* Convert float array to half array function.
+   * ARGUMENTS:
+   *   - destination:
+   *       half *Dst;
+   *   - source:
+   *       const FLT *Src;
+   *   - number of values:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID HalfFromFloat( half *Dst, const FLT *Src, size_t N )
+  {
+#ifdef MTH_HALF_F16C
+    HalfFromFloatF16C(Dst, Src, N);
+#elif defined(MTH_HALF_SSE2)
+    HalfFromFloatSSE2(Dst, Src, N);
+#else /* MTH_HALF_F16C */
+    for (size_t i = 0; i < N; i++)
+      Dst[i] = half(Src[i]);
+#endif /* MTH_HALF_F16C */
+  } /* End of 'HalfFromFloat' function */
+
+  /* Convert half array to float array function.
+   * ARGUMENTS:
+   *   - destination:
+   *       FLT *Dst;
+   *   - source:
+   *       const half *Src;
+   *   - number of values:
+   *       size_t N;
+   * RETURNS: None.
+   */
+  inline VOID HalfToFloat( FLT *Dst, const half *Src, size_t N )
+  {
+#ifdef MTH_HALF_F16C
+    HalfToFloatF16C(Dst, Src, N);
+#elif defined(MTH_HALF_SSE2)
+    HalfToFloatSSE2(Dst, Src, N);
+#else /* MTH_HALF_F16C */
+    for (size_t i = 0; i < N; i++)
+      Dst[i] = Src[i];
+#endif /* MTH_HALF_F16C */
+  } /* End of 'HalfToFloat' function */
+} /* End of 'mth' namespace */
+
+#endif // !_mth_half_h_
+
+/* END OF 'mth_half.h' FILE */
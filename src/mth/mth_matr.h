@@ -219,16 +219,16 @@ namespace mth
     {
       return M[0][0] * Determ3x3(M[1][1], M[1][2], M[1][3],
                                  M[2][1], M[2][2], M[2][3],
-                                 M[3][1], M[3][2], M[2][3]) -
+                                 M[3][1], M[3][2], M[3][3]) -
              M[0][1] * Determ3x3(M[1][0], M[1][2], M[1][3],
                                  M[2][0], M[2][2], M[2][3],
-                                 M[3][0], M[3][2], M[2][3]) +
+                                 M[3][0], M[3][2], M[3][3]) +
              M[0][2] * Determ3x3(M[1][0], M[1][1], M[1][3],
                                  M[2][0], M[2][1], M[2][3],
-                                 M[3][0], M[3][1], M[2][3]) - 
+                                 M[3][0], M[3][1], M[3][3]) - 
              M[0][3] * Determ3x3(M[1][0], M[1][1], M[1][2],
                                  M[2][0], M[2][1], M[2][2],
-                                 M[3][0], M[3][1], M[2][2]);
+                                 M[3][0], M[3][1], M[3][2]);
     } /* End of 'Determ' function */
 
 
@@ -249,19 +249,19 @@ namespace mth
                             M[2][1], M[2][2], M[2][3],
                             M[3][1], M[3][2], M[3][3]) / det;
 
-      InvM[0][1] = -Determ3x3(M[1][0], M[1][2], M[1][3],
+      InvM[1][0] = -Determ3x3(M[1][0], M[1][2], M[1][3],
                              M[2][0], M[2][2], M[2][3],
                              M[3][0], M[3][2], M[3][3]) / det;
 
-      InvM[0][2] = Determ3x3(M[1][0], M[1][1], M[1][3],
+      InvM[2][0] = Determ3x3(M[1][0], M[1][1], M[1][3],
                             M[2][0], M[2][1], M[2][3],
                             M[3][0], M[3][1], M[3][3]) / det;
 
-      InvM[0][3] = -Determ3x3(M[1][0], M[1][1], M[1][2],
+      InvM[3][0] = -Determ3x3(M[1][0], M[1][1], M[1][2],
                              M[2][0], M[2][1], M[2][2],
                              M[3][0], M[3][1], M[3][2]) / det;
 
-      InvM[1][0] = -Determ3x3(M[0][1], M[0][2], M[0][3],
+      InvM[0][1] = -Determ3x3(M[0][1], M[0][2], M[0][3],
                               M[2][1], M[2][2], M[2][3],
                               M[3][1], M[3][2], M[3][3]) / det;
 
@@ -269,19 +269,19 @@ namespace mth
                              M[2][0], M[2][2], M[2][3],
                              M[3][0], M[3][2], M[3][3]) / det;
 
-      InvM[1][2] = -Determ3x3(M[0][0], M[0][1], M[0][3],
+      InvM[2][1] = -Determ3x3(M[0][0], M[0][1], M[0][3],
                               M[2][0], M[2][1], M[2][3],
                               M[3][0], M[3][1], M[3][3]) / det;
 
-      InvM[1][3] = Determ3x3(M[0][0], M[0][1], M[0][2],
+      InvM[3][1] = Determ3x3(M[0][0], M[0][1], M[0][2],
                             M[2][0], M[2][1], M[2][2],
                             M[3][0], M[3][1], M[3][2]) / det;
 
-      InvM[2][0] = Determ3x3(M[0][1], M[0][2], M[0][3],
+      InvM[0][2] = Determ3x3(M[0][1], M[0][2], M[0][3],
                              M[1][1], M[1][2], M[1][3],
                              M[3][1], M[3][2], M[3][3]) / det;
 
-      InvM[2][1] = -Determ3x3(M[0][0], M[0][2], M[0][3],
+      InvM[1][2] = -Determ3x3(M[0][0], M[0][2], M[0][3],
                               M[1][0], M[1][2], M[1][3],
                               M[3][0], M[3][2], M[3][3]) / det;
 
@@ -289,19 +289,19 @@ namespace mth
                              M[1][0], M[1][1], M[1][3],
                              M[3][0], M[3][1], M[3][3]) / det;
 
-      InvM[2][3] = -Determ3x3(M[0][0], M[0][1], M[0][2],
+      InvM[3][2] = -Determ3x3(M[0][0], M[0][1], M[0][2],
                              M[1][0], M[1][1], M[1][2],
                              M[3][0], M[3][1], M[3][2]) / det;
 
-      InvM[3][0] = -Determ3x3(M[0][1], M[0][2], M[0][3],
+      InvM[0][3] = -Determ3x3(M[0][1], M[0][2], M[0][3],
                               M[1][1], M[1][2], M[1][3],
                               M[2][1], M[2][2], M[2][3]) / det;
 
-      InvM[3][1] = Determ3x3(M[0][0], M[0][2], M[0][3],
+      InvM[1][3] = Determ3x3(M[0][0], M[0][2], M[0][3],
                              M[1][0], M[1][2], M[1][3],
                              M[2][0], M[2][2], M[2][3]) / det;
 
-      InvM[3][2] = -Determ3x3(M[0][0], M[0][1], M[0][3],
+      InvM[2][3] = -Determ3x3(M[0][0], M[0][1], M[0][3],
                               M[1][0], M[1][1], M[1][3],
                               M[2][0], M[2][1], M[2][3]) / det;
 
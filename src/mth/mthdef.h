@@ -7,8 +7,9 @@
   * PURPOSE     : T51DX12 project.
   *               Math definition library.
   * PROGRAMMER  : ND4.
-  * LAST UPDATE : 07.10.2021
-  * NOTE        : None.
+  * LAST UPDATE : 19.10.2026
+  * NOTE        : Non Windows builds (benchmark suite) use portable
+  *               subset of 'commondf.h' types.
   *
   * No part of this file may be changed without agreement of
   * Computer Graphics Support Group of 30 Phys-Math Lyceum
@@ -18,7 +19,30 @@
 #define _mthdef_h_
 
 #include <cmath>
-#include <commondf.h>
+
+#ifdef _WIN32
+#  include <commondf.h>
+#else /* _WIN32 */
+/* Portable subset of 'commondf.h' types (platform independent modules only) */
+#  include <cstring>
+#  include <cstdio>
+
+typedef void VOID;
+typedef char CHAR;
+typedef unsigned char BYTE;
+typedef signed char INT8;
+typedef short SHORT;
+typedef unsigned short USHORT, WORD;
+typedef int INT, INT32, BOOL;
+typedef unsigned int UINT, UINT32;
+typedef long LONG;
+typedef unsigned long ULONG, DWORD;
+
+#  define TRUE 1
+#  define FALSE 0
+#  define ZeroMemory(Dest, Len) memset((Dest), 0, (Len))
+#  define CopyMemory(Dest, Src, Len) memcpy((Dest), (Src), (Len))
+#endif /* _WIN32 */
 
 #define PI 3.14159265358979323846
 #define D2R(A) ((A) * (PI / 180.0))
@@ -29,6 +53,7 @@ typedef double DBL;
 typedef float FLT;
 
 namespace mth {
+  class half;
   template<typename Type> class vec2;
   template<typename Type> class vec3;
   template<typename Type> class vec4;
@@ -41,6 +66,10 @@ namespace nidx
   typedef mth::vec3<FLT> vec3;
   typedef mth::vec4<FLT> vec4;
   typedef mth::matr<FLT> matr;
+  typedef mth::half half;
+  typedef mth::vec2<mth::half> hvec2;
+  typedef mth::vec3<mth::half> hvec3;
+  typedef mth::vec4<mth::half> hvec4;
 }
 #endif // !_mthdef_h_
 
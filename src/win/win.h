@@ -7,7 +7,7 @@
   * PURPOSE     : T51DX12 project.
   *               Window declaration module.
   * PROGRAMMER  : ND4.
-  * LAST UPDATE : 07.10.2021
+  * LAST UPDATE : 19.10.2026
   * NOTE        : None.
   *
   * No part of this file may be changed without agreement of
@@ -18,6 +18,7 @@
 #define _win_h_
 
 #include "../def.h"
+#include "../anim/events.h"
 
 #define WND_CLASS_NAME "DirectX12 proj"
 
@@ -59,13 +60,26 @@ namespace nidx
           Win->OnGetMinMaxInfo((MINMAXINFO*)lParam);
         return 0;
       case WM_LBUTTONDOWN:
+      case WM_RBUTTONDOWN:
+      case WM_MBUTTONDOWN:
       {
         SetCapture(hWnd);
+        Win = reinterpret_cast<win *>(GetWindowLongPtr(hWnd, 0));
+        if (Win != nullptr)
+          Win->OnButtonDown(Msg == WM_LBUTTONDOWN ? VK_LBUTTON : Msg == WM_RBUTTONDOWN ? VK_RBUTTON : VK_MBUTTON,
+                            (INT)(SHORT)LOWORD(lParam), (INT)(SHORT)HIWORD(lParam), (UINT)wParam);
         return 0;
       }
       case WM_LBUTTONUP:
+      case WM_RBUTTONUP:
+      case WM_MBUTTONUP:
       {
-        ReleaseCapture();
+        if (!(wParam & (MK_LBUTTON | MK_RBUTTON | MK_MBUTTON)))
+          ReleaseCapture();
+        Win = reinterpret_cast<win *>(GetWindowLongPtr(hWnd, 0));
+        if (Win != nullptr)
+          Win->OnButtonUp(Msg == WM_LBUTTONUP ? VK_LBUTTON : Msg == WM_RBUTTONUP ? VK_RBUTTON : VK_MBUTTON,
+                          (INT)(SHORT)LOWORD(lParam), (INT)(SHORT)HIWORD(lParam), (UINT)wParam);
         return 0;
       }
       case WM_CREATE:
@@ -104,6 +118,28 @@ namespace nidx
             Win->OnKeyDown(wParam);
             return 0;
           }
+          case WM_KEYUP:
+          {
+            Win->OnKeyUp(wParam);
+            return 0;
+          }
+          /* Alt and F10 combinations: same input, system handling (Alt+F4) is kept */
+          case WM_SYSKEYDOWN:
+            Win->OnKeyDown(wParam);
+            break;
+          case WM_SYSKEYUP:
+            Win->OnKeyUp(wParam);
+            break;
+          case WM_MOUSEMOVE:
+          {
+            Win->OnMouseMove((INT)(SHORT)LOWORD(lParam),
+                             (INT)(SHORT)HIWORD(lParam),
+                             (UINT)wParam);
+            return 0;
+          }
+          case WM_KILLFOCUS:
+            Win->OnKillFocus();
+            return 0;
           case WM_DESTROY:
             Win->OnDestroy();
             return 0;
@@ -117,9 +153,9 @@ namespace nidx
   public:
     BOOL IsActive;
     BOOL IsInit;
-    INT MouseWheel;
+    event_queue Events; // input events from window procedure
 
-    win( HINSTANCE hInst = GetModuleHandle(nullptr) ) : hInstance(hInst), MouseWheel(0), IsFullScreen(FALSE), W(0), H(0), FullScreenSaveRect(), 
+    win( HINSTANCE hInst = GetModuleHandle(nullptr) ) : hInstance(hInst), IsFullScreen(FALSE), W(0), H(0), FullScreenSaveRect(), 
                                                         IsActive(TRUE), hWnd((HWND)0), IsInit(FALSE)
     {
       WNDCLASS wc;
@@ -305,7 +341,7 @@ namespace nidx
      */
     VOID OnMouseWheel( INT X, INT Y, INT Z, UINT Keys );
 
-    /* WM_MOUSEWHEEL window message handle function.
+    /* WM_KEYDOWN window message handle function.
      * ARGUMENTS:
      *   - keys:
      *       UINT Keys;
@@ -313,27 +349,53 @@ namespace nidx
      */
     VOID OnKeyDown( UINT Keys );
 
-    /* WM_MBUTTONDOWN window message handle function.
+    /* WM_KEYUP window message handle function.
+     * ARGUMENTS:
+     *   - keys:
+     *       UINT Keys;
+     * RETURNS: None.
+     */
+    VOID OnKeyUp( UINT Keys );
+
+    /* WM_MOUSEMOVE window message handle function.
      * ARGUMENTS:
      *   - mouse window position:
      *       INT X, Y;
-     *   - mouse wheel relative delta value:
-     *       INT Z;
      *   - mouse keys bits (see MK_*** bits constants):
      *       UINT Keys;
      * RETURNS: None.
      */
-    VOID OnButtonDown( BOOL IsDoubleClick, INT X, INT Y, UINT Keys );
+    VOID OnMouseMove( INT X, INT Y, UINT Keys );
+
+    /* WM_KILLFOCUS window message handle function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID OnKillFocus( VOID );
+
+    /* WM_*BUTTONDOWN window message handle function.
+     * ARGUMENTS:
+     *   - button virtual key code (VK_LBUTTON, VK_RBUTTON or VK_MBUTTON):
+     *       BYTE Button;
+     *   - mouse window position:
+     *       INT X, Y;
+     *   - mouse keys bits (see MK_*** bits constants):
+     *       UINT Keys;
+     * RETURNS: None.
+     */
+    VOID OnButtonDown( BYTE Button, INT X, INT Y, UINT Keys );
 
-    /* WM_MBUTTONUP window message handle function.
+    /* WM_*BUTTONUP window message handle function.
      * ARGUMENTS:
+     *   - button virtual key code (VK_LBUTTON, VK_RBUTTON or VK_MBUTTON):
+     *       BYTE Button;
      *   - mouse window position:
      *       INT X, Y;
      *   - mouse keys bits (see MK_*** bits constants):
      *       UINT Keys;
      * RETURNS: None.
      */
-    VOID OnButtonUp( INT X, INT Y, UINT Keys );
+    VOID OnButtonUp( BYTE Button, INT X, INT Y, UINT Keys );
 
         /* Initialization function.
      * ARGUMENTS: None.
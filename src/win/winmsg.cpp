@@ -7,7 +7,7 @@
   * PURPOSE     : T51DX12 project.
   *               Window declaration module.
   * PROGRAMMER  : ND4.
-  * LAST UPDATE : 07.10.2021
+  * LAST UPDATE : 19.10.2026
   * NOTE        : None.
   *
   * No part of this file may be changed without agreement of
@@ -162,36 +162,64 @@ VOID nidx::win::OnTimer( INT Id )
  */
 VOID nidx::win::OnMouseWheel( INT X, INT Y, INT Z, UINT Keys )
 {
-  MouseWheel += Z;
+  Events.Push(event_type::MOUSE_WHEEL, 0, Z);
 } /* End of 'win::OnMouseWheel' function */
 
-/* WM_MBUTTONDOWN window message handle function.
+/* WM_MOUSEMOVE window message handle function.
  * ARGUMENTS:
  *   - mouse window position:
  *       INT X, Y;
- *   - mouse wheel relative delta value:
- *       INT Z;
  *   - mouse keys bits (see MK_*** bits constants):
  *       UINT Keys;
  * RETURNS: None.
  */
-VOID nidx::win::OnButtonDown( BOOL IsDoubleClick, INT X, INT Y, UINT Keys )
-{ 
+VOID nidx::win::OnMouseMove( INT X, INT Y, UINT Keys )
+{
+  Events.Push(event_type::MOUSE_MOVE, 0, X, Y);
+} /* End of 'win::OnMouseMove' function */
+
+/* WM_KILLFOCUS window message handle function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID nidx::win::OnKillFocus( VOID )
+{
+  Events.Push(event_type::FOCUS_LOST);
+} /* End of 'win::OnKillFocus' function */
+
+/* WM_*BUTTONDOWN window message handle function.
+ * ARGUMENTS:
+ *   - button virtual key code (VK_LBUTTON, VK_RBUTTON or VK_MBUTTON):
+ *       BYTE Button;
+ *   - mouse window position:
+ *       INT X, Y;
+ *   - mouse keys bits (see MK_*** bits constants):
+ *       UINT Keys;
+ * RETURNS: None.
+ */
+VOID nidx::win::OnButtonDown( BYTE Button, INT X, INT Y, UINT Keys )
+{
+  Events.Push(event_type::MOUSE_MOVE, 0, X, Y);
+  Events.Push(event_type::KEY_DOWN, Button);
 } /* End of 'win::OnButtonDown' function */
 
-/* WM_MBUTTONUP window message handle function.
+/* WM_*BUTTONUP window message handle function.
  * ARGUMENTS:
+ *   - button virtual key code (VK_LBUTTON, VK_RBUTTON or VK_MBUTTON):
+ *       BYTE Button;
  *   - mouse window position:
  *       INT X, Y;
  *   - mouse keys bits (see MK_*** bits constants):
  *       UINT Keys;
  * RETURNS: None.
  */
-VOID nidx::win::OnButtonUp( INT X, INT Y, UINT Keys )
-{ 
+VOID nidx::win::OnButtonUp( BYTE Button, INT X, INT Y, UINT Keys )
+{
+  Events.Push(event_type::MOUSE_MOVE, 0, X, Y);
+  Events.Push(event_type::KEY_UP, Button);
 } /* End of 'win::OnButtonUp' function */
 
-/* WM_MOUSEWHEEL window message handle function.
+/* WM_KEYDOWN window message handle function.
  * ARGUMENTS:
  *   - keys:
  *       UINT Keys;
@@ -199,10 +227,22 @@ VOID nidx::win::OnButtonUp( INT X, INT Y, UINT Keys )
  */
 VOID nidx::win::OnKeyDown( UINT Keys )
 {
+  Events.Push(event_type::KEY_DOWN, (BYTE)Keys);
   if (Keys == 'F')
     this->FlipFullScreen();
   if (Keys == 27)
     this->OnDestroy();
 }
 
+/* WM_KEYUP window message handle function.
+ * ARGUMENTS:
+ *   - keys:
+ *       UINT Keys;
+ * RETURNS: None.
+ */
+VOID nidx::win::OnKeyUp( UINT Keys )
+{
+  Events.Push(event_type::KEY_UP, (BYTE)Keys);
+} /* End of 'win::OnKeyUp' function */
+
 /* END OF 'win.cpp' FILE */
\ No newline at end of file